@@ -16,6 +16,7 @@
 
 #include "MinotaurConfig.h"
 #include "BranchAndBound.h"
+#include "CsrCutMan.h"
 #include "EngineFactory.h"
 #include "Environment.h"
 #include "IntVarHandler.h"
@@ -99,11 +100,17 @@ BranchAndBound* createBab (EnvPtr env, ProblemPtr p, EnginePtr e,
   NodeIncRelaxerPtr nr;
   RelaxationPtr rel;
   BrancherPtr br;
-  SimpleCutMan* cutman = new SimpleCutMan(env, p);
+  CutManager* cutman;
   KnapCovHandlerPtr khand = (KnapCovHandlerPtr) new KnapCovHandler(env, p);
   OptionDBPtr options = env->getOptions();
   const std::string me("bnc main: ");
 
+  if (options->findString("cut_manager")->getValue()=="csr") {
+    cutman = (CsrCutManPtr) new CsrCutMan(env, p);
+  } else {
+    cutman = new SimpleCutMan(env, p);
+  }
+
   handlers.push_back(v_hand);
   handlers.push_back(l_hand);
   handlers.push_back(khand);
@@ -155,6 +155,17 @@ int transform(EnvPtr env, ProblemPtr p, ProblemPtr &newp,
     trans = (QuadTranPtr) new QuadTransformer(env, p);
   }
   trans->reformulate(newp, handlers, status);
+
+  // bound tightening at nodes by solving LPs needs an engine of its own.
+  if (env->getOptions()->findInt("obbt_node_freq")->getValue() > 0) {
+    for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end();
+         ++it) {
+      QuadHandlerPtr qhand = dynamic_cast<QuadHandler*>(*it);
+      if (qhand) {
+        qhand->setLPEngine(getEngine(env));
+      }
+    }
+  }
   
   env->getLogger()->msgStream(LogInfo) << me 
     << "handlers used in transformer: " << std::endl;
@@ -0,0 +1,86 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file McCommon.h
+ * \brief Declare the functions shared by the main functions of the parallel
+ * branch-and-bound solvers mcbnb and mcrace.
+ *
+ * Functions that write log messages start them with the string me.
+ */
+
+#ifndef MINOTAURMCCOMMON_H
+#define MINOTAURMCCOMMON_H
+
+#include <string>
+#include <vector>
+
+#include "Types.h"
+#include "ParBranchAndBound.h"
+#include "ParNodeIncRelaxer.h"
+#include "ParPCBProcessor.h"
+#include "Presolver.h"
+
+#include "AMPLInterface.h"
+
+using namespace Minotaur;
+
+/**
+ * \brief Create the parallel branch-and-bound of problem p, and the
+ * handlers, engine copies, relaxations, node processors and node relaxers
+ * of each of its threads.
+ */
+ParBranchAndBound* createParBab(EnvPtr env, ProblemPtr p, EnginePtr e,
+                                UInt numThreads,
+                                RelaxationPtr relCopy[],
+                                ParPCBProcessorPtr nodePrcssr[],
+                                ParNodeIncRelaxerPtr parNodeRlxr[],
+                                HandlerVector handlersCopy[],
+                                EnginePtr eCopy[], const std::string &me);
+
+/// Create the brancher given by the option "brancher".
+BrancherPtr createBrancher(EnvPtr env, ProblemPtr p, HandlerVector handlers,
+                           EnginePtr e, const std::string &me);
+
+/// Return an engine for the relaxations of p. err is 1 if none is found.
+EnginePtr getEngine(EnvPtr env, ProblemPtr p, int &err,
+                    const std::string &me);
+
+/// Read the instance given by the option "problem_file" into oinst.
+void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
+                 ProblemPtr &oinst, double *obj_sense,
+                 const std::string &me);
+
+/// Set the options that the user cannot change.
+void overrideOptions(EnvPtr env);
+
+/// Presolve p with the handlers, which are added to the handlers vector.
+PresolverPtr presolve(EnvPtr env, ProblemPtr p, size_t ndefs, 
+                      HandlerVector &handlers, const std::string &me);
+
+/// Set the default values of options for these solvers.
+void setInitialOptions(EnvPtr env);
+
+/// Write the statistics of the engines, added over all threads.
+void writeNLPStats(EnvPtr env, std::string name, std::vector<double> stats);
+
+/// Write the solution of the original problem, or display it.
+void writeSol(EnvPtr env, VarVector *orig_v,
+              PresolverPtr pres, SolutionPtr sol, SolveStatus status,
+              MINOTAUR_AMPL::AMPLInterface* iface);
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
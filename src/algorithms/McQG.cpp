@@ -52,6 +52,7 @@
 #include "Solution.h"
 #include "SOS1Handler.h"
 #include "SOS2Handler.h"
+#include "NLPCache.h"
 #include "ParQGHandler.h"
 #include "Timer.h"
 #include "UnambRelBrancher.h"
@@ -71,7 +72,7 @@ ParQGBranchAndBound* createParBab(EnvPtr env, UInt numThreads, NodePtr &node,
                                   ParNodeIncRelaxerPtr parNodeRlxr[],
                                   HandlerVector handlersCopy[],
                                   LPEnginePtr lpeCopy[], EnginePtr eCopy[],
-                                  bool &prune)
+                                  NLPCachePtr nlp_cache, bool &prune)
 {
   ParQGBranchAndBound *bab = new ParQGBranchAndBound(env, pCopy[0]);
   const std::string me("mcqg main: ");
@@ -92,6 +93,7 @@ ParQGBranchAndBound* createParBab(EnvPtr env, UInt numThreads, NodePtr &node,
 
     ParQGHandlerPtr qg_hand = (ParQGHandlerPtr) new ParQGHandler(env, pCopy[i], eCopy[i]);
     qg_hand->setModFlags(false, true);
+    qg_hand->setNLPCache(nlp_cache);
     qg_hand->loadProbToEngine();
     if (i>0) {
       qg_hand->nlCons();
@@ -552,6 +554,7 @@ void writeParQGStats(EnvPtr env, ParQGBranchAndBound *parbab, UInt numThreads,
   if (parbab) {
     const std::string me("ParQGHandler: ");
     UInt nlpSolved = 0, nlpInf = 0, nlpFeas = 0, nlpItLim = 0, numCuts = 0;
+    UInt nlpCached = 0;
     for (UInt i=0; i < numThreads; i++) {
       for (HandlerVector::iterator it=handlersCopy[i].begin(); it!=handlersCopy[i].end(); ++it) {
         if ((*it)->getName() == "ParQGHandler (Quesada-Grossmann)") {
@@ -560,6 +563,7 @@ void writeParQGStats(EnvPtr env, ParQGBranchAndBound *parbab, UInt numThreads,
           nlpInf += parqgHand->getStats()->nlpI;
           nlpFeas += parqgHand->getStats()->nlpF;
           nlpItLim += parqgHand->getStats()->nlpIL;
+          nlpCached += parqgHand->getStats()->nlpC;
           numCuts += parqgHand->getStats()->cuts;
         }
       }
@@ -573,6 +577,8 @@ void writeParQGStats(EnvPtr env, ParQGBranchAndBound *parbab, UInt numThreads,
       << nlpFeas << std::endl
       << me << "number of nlps hit engine iterations limit  = "
       << nlpItLim << std::endl
+      << me << "number of nlps found in cache               = "
+      << nlpCached << std::endl
       << me << "number of cuts added                        = "
       << numCuts << std::endl;
   }
@@ -634,6 +640,7 @@ int main(int argc, char** argv)
   EngineFactory *efac = 0;
   LPEnginePtr *lpeCopy = 0;
   EnginePtr *eCopy = 0;
+  NLPCachePtr nlpCache = 0;
   ObjectivePtr oPtr = 0;
   NodePtr node = 0;
   std::string name = "";
@@ -726,8 +733,11 @@ int main(int argc, char** argv)
       << "Number of threads = " << numThreads 
       << ". Requires a thread-safe LP and NLP solver." << std::endl;
   }
+  // the handlers of all threads share the results of fixed-integer NLPs.
+  nlpCache = (NLPCachePtr) new NLPCache(env);
   parbab = createParBab(env, numThreads, node, relCopy, pCopy, nodePrcssr,
-                        parNodeRlxr, handlersCopy, lpeCopy, eCopy, prune);
+                        parNodeRlxr, handlersCopy, lpeCopy, eCopy, nlpCache,
+                        prune);
   if (true==env->getOptions()->findBool("mcbnb_deter_mode")->getValue()) {
     //assert(!"Deterministic mode not available right now!");
     parbab->parsolveSync(parNodeRlxr, nodePrcssr, numThreads, prune);
@@ -795,6 +805,9 @@ CLEANUP:
       delete nodePrcssr[i];
     }
   }
+  if (nlpCache) {
+    delete nlpCache;
+  }
   if (node) {
     delete node;
   }
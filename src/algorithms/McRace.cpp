@@ -0,0 +1,503 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file McRace.cpp
+ * \brief The main function for solving instances in ampl format (.nl) by
+ * racing differently configured branch-and-bound runs in parallel.
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/time.h>
+#if USE_OPENMP
+#include <omp.h>
+#else
+#error "Cannot compile parallel algorithms: turn USE_OpenMP flag ON."
+#endif
+#include "MinotaurConfig.h"
+#include "BranchAndBound.h"
+#include "Engine.h"
+#include "Environment.h"
+#include "Logger.h"
+#include "McCommon.h"
+#include "Option.h"
+#include "ParBranchAndBound.h"
+#include "ParNodeIncRelaxer.h"
+#include "ParPCBProcessor.h"
+#include "Presolver.h"
+#include "Problem.h"
+#include "Relaxation.h"
+#include "Solution.h"
+#include "SolutionPool.h"
+
+#include "AMPLInterface.h"
+
+using namespace Minotaur;
+
+
+/// A branch-and-bound run with its own options, engines and handlers.
+struct Racer {
+  /// The configuration string from which the options were read.
+  std::string config;
+
+  /// Environment with the options of this run.
+  EnvPtr env;
+
+  /// The engine from which a copy is made for each thread.
+  EnginePtr engine;
+
+  /// The branch-and-bound.
+  ParBranchAndBound *bab;
+
+  /// Number of threads used by bab.
+  UInt numThreads;
+
+  /// Handlers for each thread.
+  HandlerVector *handlersCopy;
+
+  /// Engines for each thread.
+  EnginePtr *eCopy;
+
+  /// Node processors for each thread.
+  ParPCBProcessorPtr *nodePrcssr;
+
+  /// Node relaxers for each thread.
+  ParNodeIncRelaxerPtr *parNodeRlxr;
+
+  /// Relaxations for each thread.
+  RelaxationPtr *relCopy;
+};
+
+
+void showHelp()
+{
+  std::cout << "NLP-based branch-and-bound solver for convex MINLP that "
+            << "races several configurations in parallel"
+            << std::endl
+            << "**Works in parallel with a thread-safe NLP solver only "
+            << "(e.g. IPOPT with MA97)**" << std::endl
+            << "Usage:" << std::endl
+            << "To show version: mcrace -v (or --display_version yes) "
+            << std::endl
+            << "To show all options: mcrace -= (or --display_options yes)"
+            << std::endl
+            << "To solve an instance: mcrace --option1 [value] "
+            << "--option2 [value] ... " << " .nl-file" << std::endl
+            << "Configurations are given by --race_configs "
+            << "\"--brancher rel;--brancher maxvio\"" << std::endl;
+}
+
+
+int showInfo(EnvPtr env)
+{
+  OptionDBPtr options = env->getOptions();
+  const std::string me("mcrace main: ");
+
+  if (options->findBool("display_options")->getValue() ||
+      options->findFlag("=")->getValue()) {
+    options->write(std::cout);
+    return 1;
+  }
+
+  if (options->findBool("display_help")->getValue() ||
+      options->findFlag("?")->getValue()) {
+    showHelp();
+    return 1;
+  }
+
+  if (options->findBool("display_version")->getValue() ||
+      options->findFlag("v")->getValue()) {
+    env->getLogger()->msgStream(LogNone) << me << "Minotaur version "
+      << env->getVersion() << std::endl << me 
+      << "NLP-based branch-and-bound solver for convex MINLP that races "
+      << "several configurations" << std::endl;
+    return 1;
+  }
+
+  if (options->findString("problem_file")->getValue()=="") {
+    showHelp();
+    return 1;
+  }
+
+  env->getLogger()->msgStream(LogInfo)
+    << me << "Minotaur version " << env->getVersion() << std::endl
+    << me << "NLP-based branch-and-bound solver for convex MINLP that races "
+    << "several configurations" << std::endl;
+  return 0;
+}
+
+
+EnvPtr createRacerEnv(int argc, char **argv, std::string config,
+                      double time_limit)
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  int err = 0;
+
+  env->startTimer(err);
+  setInitialOptions(env);
+  env->readOptions(argc, argv);
+  overrideOptions(env);
+  env->readOptions(config);
+  env->getOptions()->findDouble("bnb_time_limit")->setValue(time_limit);
+  return env;
+}
+
+
+Racer* createRacer(EnvPtr env, std::string config, ProblemPtr p,
+                   UInt numThreads, int &err)
+{
+  Racer *r = new Racer();
+  const std::string me("mcrace main: ");
+
+  r->config = config;
+  r->env = env;
+  r->numThreads = numThreads;
+  r->handlersCopy = new HandlerVector[numThreads];
+  r->eCopy = new EnginePtr[numThreads]();
+  r->nodePrcssr = new ParPCBProcessorPtr[numThreads]();
+  r->parNodeRlxr = new ParNodeIncRelaxerPtr[numThreads]();
+  r->relCopy = new RelaxationPtr[numThreads]();
+  r->bab = 0;
+  r->engine = getEngine(env, p, err, me);
+  if (0==err) {
+    r->bab = createParBab(env, p, r->engine, numThreads, r->relCopy,
+                          r->nodePrcssr, r->parNodeRlxr, r->handlersCopy,
+                          r->eCopy, me);
+  }
+  return r;
+}
+
+
+void freeRacer(Racer *r)
+{
+  for (UInt i=0; i < r->numThreads; i++) {
+    for (HandlerVector::iterator it=r->handlersCopy[i].begin();
+         it!=r->handlersCopy[i].end(); ++it) {
+      delete (*it);
+    }
+    if (r->eCopy[i]) {
+      delete r->eCopy[i];
+    }
+    if (r->parNodeRlxr[i]) {
+      delete r->parNodeRlxr[i];
+      r->relCopy[i] = 0;
+    }
+    if (r->nodePrcssr[i]) {
+      delete r->nodePrcssr[i];
+    }
+  }
+  delete[] r->handlersCopy;
+  delete[] r->eCopy;
+  delete[] r->relCopy;
+  delete[] r->nodePrcssr;
+  delete[] r->parNodeRlxr;
+  if (r->bab) {
+    delete r->bab;
+  }
+  if (r->engine) {
+    delete r->engine;
+  }
+  delete r->env;
+  delete r;
+}
+
+
+/// Get wall clock time
+double getWallTime() {
+  struct timeval time;
+  if (gettimeofday(&time,NULL)) {
+    // Handle error
+    return 0;
+  }
+  return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+
+/// Return true if the status shows that the run has solved the problem.
+bool isSolved(SolveStatus status)
+{
+  return (SolvedOptimal==status || SolvedInfeasible==status ||
+          SolvedUnbounded==status || SolvedGapLimit==status);
+}
+
+
+/**
+ * Return the racer that has solved the problem, or if none has, the one with
+ * the best lower bound. All racers share the upper bound.
+ */
+UInt pickWinner(Racer **racers, UInt numRacers)
+{
+  UInt w = 0;
+  for (UInt r=0; r<numRacers; ++r) {
+    if (isSolved(racers[r]->bab->getStatus())) {
+      return r;
+    }
+    if (racers[r]->bab->getLb() > racers[w]->bab->getLb()) {
+      w = r;
+    }
+  }
+  return w;
+}
+
+
+void runRacer(Racer *r)
+{
+  OptionDBPtr options = r->env->getOptions();
+
+  if (true==options->findBool("mcbnb_deter_mode")->getValue()) {
+    r->bab->parsolveSync(r->parNodeRlxr, r->nodePrcssr, r->numThreads);
+  } else if (true==options->findBool("mcbnb_oppor_mode")->getValue()) {
+    r->bab->parsolveOppor(r->parNodeRlxr, r->nodePrcssr, r->numThreads);
+  } else {
+    r->bab->parsolve(r->parNodeRlxr, r->nodePrcssr, r->numThreads);
+  }
+}
+
+
+std::vector<std::string> splitConfigs(std::string s)
+{
+  std::vector<std::string> configs;
+  std::istringstream istr(s);
+  std::string config;
+
+  while (getline(istr, config, ';')) {
+    if (config.find_first_not_of(" \t")!=std::string::npos) {
+      configs.push_back(config);
+    }
+  }
+  if (configs.empty()) {
+    configs.push_back("");
+  }
+  return configs;
+}
+
+
+void writeRaceStatus(EnvPtr env, ParBranchAndBound *parbab,
+                     SolutionPoolPtr pool, double obj_sense,
+                     double wallTimeStart)
+{
+  const std::string me("mcrace main: ");
+  int err = 0;
+  double ub = INFINITY;
+  double lb = INFINITY;
+  double pergap = INFINITY;
+  SolveStatus status = NotStarted;
+
+  if (parbab) {
+    ub = pool->getBestSolutionValue();
+    lb = std::min(parbab->getLb(), ub);
+    pergap = parbab->getPerGap();
+    status = parbab->getStatus();
+  }
+  env->getLogger()->msgStream(LogInfo)
+    << me << std::fixed << std::setprecision(4)
+    << "best solution value = " << obj_sense*ub << std::endl
+    << me << std::fixed << std::setprecision(4)
+    << "best bound estimate from remaining nodes = " << obj_sense*lb
+    << std::endl
+    << me << "gap = " << ((parbab) ? std::max(0.0, ub-lb) : INFINITY)
+    << std::endl
+    << me << "gap percentage = " << pergap << std::endl
+    << me << "time used (s) = " << std::fixed << std::setprecision(2)
+    << getWallTime() - wallTimeStart << std::endl
+    << me << "status of branch-and-bound: "
+    << getSolveStatusString(status) << std::endl;
+  env->stopTimer(err); assert(0==err);
+}
+
+
+int main(int argc, char** argv)
+{
+  EnvPtr env      = (EnvPtr) new Environment();
+  MINOTAUR_AMPL::AMPLInterface* iface = 0;
+  ProblemPtr oinst;     // instance that needs to be solved
+  double wallTimeStart = getWallTime();
+  PresolverPtr pres = 0;
+  const std::string me("mcrace main: ");
+  VarVector *orig_v = 0;
+  HandlerVector handlers;
+  int err = 0;
+  double obj_sense = 1.0;
+  UInt numThreads = 0;
+  UInt numRacers = 0;
+  UInt winner = 0;
+  Racer **racers = 0;
+  Racer *result = 0;    // the run whose result is reported.
+  Racer *all = 0;       // the winner, run again with all threads.
+  SolutionPoolPtr racePool = 0;
+  std::vector<std::string> configs;
+  double rampUp = 0.0, timeLimit = 0.0, timeLeft = 0.0;
+  bool stop = false;
+
+  std::vector<double> nlpStats(9,0);
+
+  env->startTimer(err);
+  if (err) {
+    goto CLEANUP;
+  }
+
+  setInitialOptions(env);
+
+  // Important to setup AMPL Interface first as it adds several options.
+  iface = new MINOTAUR_AMPL::AMPLInterface(env, "mcrace");
+
+  // Parse command line for options set by the user.
+  env->readOptions(argc, argv);
+
+  overrideOptions(env);
+  if (0!=showInfo(env)) {
+    goto CLEANUP;
+  }
+
+  numThreads = std::min(env->getOptions()->findInt("threads")->getValue(),
+                        omp_get_num_procs());
+  numThreads = std::max(numThreads, (UInt) 1);
+  configs = splitConfigs(env->getOptions()->findString("race_configs")
+                         ->getValue());
+  numRacers = std::min((UInt) configs.size(), numThreads);
+  if (numRacers < configs.size()) {
+    env->getLogger()->msgStream(LogInfo) << me << "only the first "
+      << numRacers << " of " << configs.size() << " configurations race "
+      << "with " << numThreads << " threads" << std::endl;
+  }
+  rampUp = env->getOptions()->findDouble("race_ramp_up")->getValue();
+  timeLimit = env->getOptions()->findDouble("bnb_time_limit")->getValue();
+
+  loadProblem(env, iface, oinst, &obj_sense, me);
+  orig_v = new VarVector(oinst->varsBegin(), oinst->varsEnd());
+  pres = presolve(env, oinst, iface->getNumDefs(), handlers, me);
+  for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end(); ++it) {
+    delete (*it);
+  }
+  handlers.clear();
+  if (Finished != pres->getStatus() && NotStarted != pres->getStatus()) {
+    env->getLogger()->msgStream(LogInfo) << me
+      << "status of presolve: "
+      << getSolveStatusString(pres->getStatus()) << std::endl;
+    writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
+    writeRaceStatus(env, 0, 0, obj_sense, wallTimeStart);
+    goto CLEANUP;
+  }
+
+  if (false==env->getOptions()->findBool("solve")->getValue()) {
+    goto CLEANUP;
+  }
+
+  if (numThreads > 1) {
+    env->getLogger()->msgStream(LogInfo)
+      << "**Works in parallel with a thread-safe "
+      << "NLP solver only (e.g. IPOPT with MA97)**" << std::endl;
+  }
+
+  // each racer reads the options of the command line and then its own. It
+  // runs on one thread.
+  racers = new Racer*[numRacers]();
+  for (UInt r=0; r<numRacers; ++r) {
+    racers[r] = createRacer(createRacerEnv(argc, argv, configs[r],
+                                           (rampUp>0) ?
+                                           std::min(rampUp, timeLimit) :
+                                           timeLimit),
+                            configs[r], oinst, 1, err);
+    if (err) {
+      goto CLEANUP;
+    }
+  }
+  racePool = (SolutionPoolPtr) new SolutionPool(env, oinst, 1);
+
+  env->getLogger()->msgStream(LogInfo) << me << "racing " << numRacers
+    << " configurations" << std::endl;
+#pragma omp parallel for num_threads(numRacers) schedule(static,1)
+  for (UInt r=0; r<numRacers; ++r) {
+    racers[r]->bab->setRace(racePool, &stop);
+    runRacer(racers[r]);
+    if (isSolved(racers[r]->bab->getStatus())) {
+#pragma omp atomic write
+      stop = true;
+    }
+  }
+  winner = pickWinner(racers, numRacers);
+  result = racers[winner];
+  env->getLogger()->msgStream(LogInfo) << me << "configuration " << winner
+    << " (\"" << configs[winner] << "\") wins the race" << std::endl;
+
+  // after the ramp-up, all threads work on the winning configuration. Its
+  // tree is built again, but the incumbent found in the race is kept.
+  timeLeft = timeLimit - (getWallTime() - wallTimeStart);
+  if (rampUp>0 && false==isSolved(result->bab->getStatus()) && timeLeft>0) {
+    env->getLogger()->msgStream(LogInfo) << me << "switching all "
+      << numThreads << " threads to configuration " << winner << std::endl;
+    all = createRacer(createRacerEnv(argc, argv, configs[winner], timeLeft),
+                      configs[winner], oinst, numThreads, err);
+    if (err) {
+      goto CLEANUP;
+    }
+    stop = false;
+    all->bab->setRace(racePool, &stop);
+    runRacer(all);
+    result = all;
+  }
+
+  //Take care of important engine statistics
+  for (UInt i=0; i < result->numThreads; i++) {
+    result->eCopy[i]->fillStats(nlpStats);
+  }
+  writeNLPStats(env, result->eCopy[0]->getName(), nlpStats);
+
+  writeSol(env, orig_v, pres, racePool->getBestSolution(),
+           result->bab->getStatus(), iface);
+  writeRaceStatus(env, result->bab, racePool, obj_sense, wallTimeStart);
+
+CLEANUP:
+  for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end(); ++it) {
+    delete (*it);
+  }
+  if (iface) {
+    delete iface;
+  }
+  if (pres) {
+    delete pres;
+  }
+  if (all) {
+    freeRacer(all);
+  }
+  if (racers) {
+    for (UInt r=0; r<numRacers; ++r) {
+      if (racers[r]) {
+        freeRacer(racers[r]);
+      }
+    }
+    delete[] racers;
+  }
+  if (racePool) {
+    delete racePool;
+  }
+  if (oinst) {
+    delete oinst;
+  }
+  if (orig_v) {
+    delete orig_v;
+  }
+  if (env) {
+    delete env;
+  }
+
+  return 0;
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -32,6 +32,7 @@
 #include "Logger.h"
 #include "MILPEngine.h"
 #include "Modification.h"
+#include "NLPCache.h"
 #include "NLPEngine.h"
 #include "NlPresHandler.h"
 #include "NodeRelaxer.h"
@@ -410,6 +411,7 @@ int main(int argc, char* argv[])
   //engines
   EnginePtr *nlp_e = 0;
   MILPEnginePtr milp_e = 0;
+  NLPCachePtr nlp_cache = 0;
   VarVector *orig_v=0;
   int err = 0;
   UInt numSols = 1, totNumSols = 0, solsPerIter = 0;
@@ -482,6 +484,9 @@ int main(int argc, char* argv[])
     oa_hand[0] = (OAHandlerPtr) new OAHandler(env, inst[0], nlp_e[0], milp_e);
     oa_hand[0]->setModFlags(false, true);
     assert(oa_hand[0]);
+    // all threads look up and save results of NLPs in one cache.
+    nlp_cache = (NLPCachePtr) new NLPCache(env);
+    oa_hand[0]->setNLPCache(nlp_cache);
     handlers.push_back(oa_hand[0]);
 
     //! initialize the MILP master problem by copying variables & linear constraints and by 
@@ -502,6 +507,7 @@ int main(int argc, char* argv[])
       oa_hand[i]->setObjVar(oa_hand[0]->getObjVar());
       oa_hand[i]->setObjType(oa_hand[0]->getObjType());
       oa_hand[i]->setNonlinCons(oa_hand[0]->getNonlinCons());
+      oa_hand[i]->setNLPCache(nlp_cache);
       assert(oa_hand[i]);
     }
 
@@ -635,6 +641,7 @@ int main(int argc, char* argv[])
          ++it) {
       (*it)->writeStats(env->getLogger()->msgStream(LogExtraInfo));
     }
+    nlp_cache->writeStats(env->getLogger()->msgStream(LogExtraInfo));
     //MS: Other solve status and right way of writing them
     //writeSol(env, orig_v, pres, solPool->getBestSolution(), solveStatus, iface);
     solPool->writeStats(env->getLogger()->msgStream(LogExtraInfo));
@@ -657,6 +664,9 @@ CLEANUP:
       delete oa_hand[i];
     }
   }
+  if (nlp_cache) {
+    delete nlp_cache;
+  }
   if (milp_e) {
     delete milp_e;
   }
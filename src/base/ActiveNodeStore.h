@@ -57,6 +57,23 @@ namespace Minotaur {
        /// Remove the best node from the store.
        virtual void pop() = 0;
 
+       /**
+        * \brief Remove the best node from the store and return it.
+        *
+        * Stores that are shared by several threads override it so that
+        * finding and removing the node is done in one step.
+        * \return The node removed. NULL if the store is empty.
+        */
+       virtual NodePtr popTop()
+       {
+         NodePtr n = 0;
+         if (false==isEmpty()) {
+           n = top();
+           pop();
+         }
+         return n;
+       }
+
        /**
         * \brief Add a node to the set of active nodes.
         *
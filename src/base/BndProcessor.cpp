@@ -230,8 +230,8 @@ void BndProcessor::process(NodePtr node, RelaxationPtr rel,
     } else if (br_status==ModifiedByBrancher) {
       for (ModificationConstIterator miter=mods.begin(); miter!=mods.end();
            ++miter) {
-        node->addRMod(*miter);
         (*miter)->applyToProblem(relaxation_);
+        node->addRMod(*miter);
       }
       should_resolve = true;
     } 
@@ -11,6 +11,7 @@
  */
 
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
 #include "MinotaurConfig.h"
@@ -18,12 +19,22 @@
 #include "Branch.h"
 #include "Modification.h"
 #include "Operations.h"
+#include "SpillFile.h"
+#include "VarBoundMod.h"
 #include "Variable.h"
 
 using namespace Minotaur;
 
 const std::string Branch::me_ = "Branch: "; 
 
+// a bound change of a branch as it is written to a spill file.
+struct SpilledBnd {
+  VariablePtr var;
+  BoundType lu;
+  double newVal;
+  double oldVal;
+};
+
 Branch::Branch()
 : pMods_(0),
   rMods_(0),
@@ -81,6 +92,76 @@ void Branch::setActivity(double value)
   activity_ = value;
 }
 
+bool Branch::spillMods(SpillFilePtr f, size_t *at)
+{
+  UInt np = pMods_.size();
+  UInt nr = rMods_.size();
+  std::vector<char> buf(2*sizeof(UInt)+(np+nr)*sizeof(SpilledBnd));
+  char *pos = &buf[0]+2*sizeof(UInt);
+  VarBoundModPtr bmod;
+  SpilledBnd b;
+
+  if (0==np+nr) {
+    return false;
+  }
+  memcpy(&buf[0], &np, sizeof(UInt));
+  memcpy(&buf[0]+sizeof(UInt), &nr, sizeof(UInt));
+  for (UInt i=0; i<np+nr; ++i) {
+    bmod = dynamic_cast<VarBoundModPtr>((i<np) ? pMods_[i] : rMods_[i-np]);
+    if (!bmod) {
+      return false;
+    }
+    b.var = bmod->getVar();
+    b.lu = bmod->getLU();
+    b.newVal = bmod->getNewVal();
+    b.oldVal = bmod->getOldVal();
+    memcpy(pos, &b, sizeof(SpilledBnd));
+    pos += sizeof(SpilledBnd);
+  }
+  if (false==f->write(&buf[0], buf.size(), at)) {
+    return false;
+  }
+
+  for (ModificationConstIterator it = pMods_.begin(); it != pMods_.end();
+       ++it) {
+    delete (*it);
+  }
+  for (ModificationConstIterator it = rMods_.begin(); it != rMods_.end();
+       ++it) {
+    delete (*it);
+  }
+  pMods_.clear();
+  rMods_.clear();
+  return true;
+}
+
+
+void Branch::unspillMods(SpillFilePtr f, size_t at)
+{
+  std::vector<char> buf;
+  const char *pos;
+  UInt np, nr;
+  SpilledBnd b;
+  ModificationPtr mod;
+
+  f->read(at, buf);
+  memcpy(&np, &buf[0], sizeof(UInt));
+  memcpy(&nr, &buf[0]+sizeof(UInt), sizeof(UInt));
+  pos = &buf[0]+2*sizeof(UInt);
+  for (UInt i=0; i<np+nr; ++i) {
+    memcpy(&b, pos, sizeof(SpilledBnd));
+    pos += sizeof(SpilledBnd);
+    mod = (VarBoundModPtr) new VarBoundMod(b.var, b.lu, b.newVal, b.oldVal);
+    if (i<np) {
+      pMods_.push_back(mod);
+    } else {
+      rMods_.push_back(mod);
+    }
+  }
+  f->release(at);
+}
+
+
 void Branch::write(std::ostream &out) const
 {
   out << me_ << "Problem modifications:" << std::endl;
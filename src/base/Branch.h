@@ -18,6 +18,9 @@
 
 namespace Minotaur {
 
+class   SpillFile;
+typedef SpillFile* SpillFilePtr;
+
 class   BrCand;
 class   Modification;
 
@@ -119,6 +122,25 @@ public:
   /// Return the branching candidate that was used to create this branch.
   BrCandPtr getBrCand() {return brCand_;};
 
+  /**
+   * \brief Write the modifications to a spill file and delete them.
+   *
+   * Only branches whose modifications all change one bound of a variable
+   * (VarBoundMod) are written.
+   * \param[in] f The spill file.
+   * \param[out] at The position of the record in f.
+   * \return True if the modifications were written.
+   */
+  bool spillMods(SpillFilePtr f, size_t *at);
+
+  /**
+   * \brief Read back the modifications written by spillMods() and release
+   * their record.
+   * \param[in] f The spill file.
+   * \param[in] at The position returned by spillMods().
+   */
+  void unspillMods(SpillFilePtr f, size_t at);
+
   /// Write the branch to 'out'
   void write(std::ostream &out) const;
 
@@ -16,10 +16,12 @@
 #include "MinotaurConfig.h"
 #include "BranchAndBound.h"
 #include "Brancher.h"
+#include "Engine.h"
 #include "Environment.h"
 #include "Heuristic.h"
 #include "Logger.h"
 #include "Node.h"
+#include "NodeIncRelaxer.h"
 #include "NodeProcessor.h"
 #include "NodeRelaxer.h"
 #include "Option.h"
@@ -242,7 +244,12 @@ void BranchAndBound::setNodeProcessor(NodeProcessorPtr p)
 
 void BranchAndBound::setNodeRelaxer(NodeRelaxerPtr nr)
 {
+  NodeIncRelaxerPtr inc_rlxr = dynamic_cast <NodeIncRelaxer*> (nr);
+
   nodeRlxr_ = nr;
+  if (inc_rlxr) {
+    inc_rlxr->setTreeManager(tm_);
+  }
 }
 
 
@@ -490,6 +497,14 @@ void BranchAndBound::solve()
 #endif
     }
   } 
+
+  // undo the modifications that are still applied to the relaxation. If we
+  // stopped right after a dive, those of the parent of current_node are.
+  if (current_node && dived_prev) {
+    nodeRlxr_->reset(current_node->getParent(), false);
+  }
+  nodeRlxr_->reset(NodePtr(), false);
+
   logger_->msgStream(LogInfo) << me_ << "stopping branch-and-bound"
     << std::endl
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
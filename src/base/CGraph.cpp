@@ -12,6 +12,8 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <iostream>
 #include <sstream>
@@ -26,6 +28,8 @@
 #include "VarBoundMod.h"
 #include "Variable.h"
 
+#define BATCH_SIZE 64
+
 using namespace Minotaur;
 
 CGraph::CGraph()
@@ -36,16 +40,27 @@ CGraph::CGraph()
     hOffs_(0),
     hStarts_(0),
     gOffs_(0),
-    oNode_(0)
+    oNode_(0),
+    tape_(0),
+    lazy_(false),
+    shared_(0),
+    shOk_(false)
 {
   dq_.clear();
   varNode_.clear();
   vq_.clear();
+  tape_ = new Tape_();
+  tape_->nv = 0;
+  tape_->out = 0;
+  tape_->refs = 1;
+  tape_->type = Constant;
 }
 
 
 CGraph::~CGraph()
 {
+  unshare_();
+  releaseTape_();
   varNode_.clear();
   vq_.clear();
   dq_.clear();
@@ -58,7 +73,10 @@ CGraph::~CGraph()
 
 void CGraph::addConst(const double eps, int &)
 {
-  CNode *n = newNode(eps);
+  CNode *n;
+
+  makeNodes_();
+  n = newNode(eps);
 
   if (oNode_) {
     oNode_ = newNode(OpPlus, oNode_, n);
@@ -85,6 +103,7 @@ CGraphPtr CGraph::clone_(int *err) const
   CNode *node = 0;
   VariablePtr v;
 
+  makeNodes_();
   for (UInt i=0; i<aNodes_.size(); ++i) {
     const_node = aNodes_[i];
 #if DEBUG
@@ -126,13 +145,18 @@ CGraphPtr CGraph::clone_(int *err) const
 NonlinearFunctionPtr CGraph::cloneWithVars(VariableConstIterator vbeg,
                                            int *) const
 {
-  CGraphPtr cg = (CGraphPtr) new CGraph();
+  CGraphPtr cg = cloneLazy_(vbeg);
   std::map<const CNode*, CNode*>nnmap;
   std::map<const CNode*, CNode*>::iterator mit;
   const CNode *const_node;
   CNode *node = 0;
   VariablePtr v;
 
+  if (cg) {
+    return cg;
+  }
+  makeNodes_();
+  cg = (CGraphPtr) new CGraph();
   for (UInt i=0; i<aNodes_.size(); ++i) {
     const_node = aNodes_[i];
 #if DEBUG
@@ -169,9 +193,314 @@ NonlinearFunctionPtr CGraph::cloneWithVars(VariableConstIterator vbeg,
 }
 
 
+CGraphPtr CGraph::cloneLazy_(VariableConstIterator vbeg) const
+{
+  CGraphPtr cg;
+  VarVector vars;
+  UInt i;
+
+  // the hessian sparsity of the clone is copied from this graph. It must be
+  // up to date.
+  if (true==changed_ || (!oNode_ && false==lazy_) ||
+      hStarts_.size()!=tape_->nv+1) {
+    return CGraphPtr();
+  }
+
+  // the variable of slot i in the clone is vbeg+(index of slot i). The slots
+  // must still be in the order of the variables of the clone.
+  if (sVars_.size()!=tape_->nv) {
+    return CGraphPtr();
+  }
+  vars.reserve(tape_->nv);
+  for (VarVector::const_iterator it=sVars_.begin(); it!=sVars_.end(); ++it) {
+    vars.push_back(*(vbeg+(*it)->getIndex()));
+  }
+  for (i=1; i<vars.size(); ++i) {
+    if (vars[i]->getId()<=vars[i-1]->getId()) {
+      return CGraphPtr();
+    }
+  }
+
+  cg = (CGraphPtr) new CGraph();
+  cg->releaseTape_();
+#pragma omp atomic
+  ++(tape_->refs);
+  cg->tape_ = tape_;
+  cg->lazy_ = true;
+  cg->vars_.insert(vars.begin(), vars.end());
+  cg->sVars_.swap(vars);
+  cg->hInds_ = hInds_;
+  cg->hNnz_ = hNnz_;
+  cg->hOffs_ = hOffs_;
+  cg->hStarts_ = hStarts_;
+  cg->gOffs_ = gOffs_;
+
+  // the clone keeps its hessian sparsity by slots, since the indices of its
+  // variables may change.
+  if (hSlots_.size()==hNnz_) {
+    cg->hSlots_ = hSlots_;
+  } else {
+    setHessSlots_(&(cg->hSlots_));
+  }
+  return cg;
+}
+
+
+void CGraph::colorHess_()
+{
+  const UInt nv = tape_->nv;
+  std::vector<UIntVector> adj(nv);
+  std::vector<bool> used(nv, false);
+  UIntVector color(nv, nv);
+  UIntVector forb(nv+1, nv);
+  UIntVector ecol(hNnz_), erow(hNnz_);
+  UInt nc = 0, nsweeps = 0;
+  UInt c, s, cnt;
+
+  hCEnt_.clear();
+  hCEntB_.clear();
+  hCRow_.clear();
+  hCSeeds_.clear();
+  hCSeedB_.clear();
+
+  // adjacency graph of the hessian. Row i has the lower triangle entries of
+  // the variable in slot i.
+  for (UInt i=0; i<nv; ++i) {
+    if (hStarts_[i]<hStarts_[i+1]) {
+      ++nsweeps;
+      used[i] = true;
+    }
+    for (UInt j=hStarts_[i]; j<hStarts_[i+1]; ++j) {
+      s = hSlots_[j];
+      used[s] = true;
+      if (s!=i) {
+        adj[i].push_back(s);
+        adj[s].push_back(i);
+      }
+    }
+  }
+
+  // greedy star coloring: neighbors get different colors, and no path on
+  // four slots uses only two colors. A slot v may not take the color of x
+  // at distance two through w if w is not colored, or if x has another
+  // neighbor with the color of w.
+  for (UInt v=0; v<nv; ++v) {
+    if (false==used[v]) {
+      continue;
+    }
+    for (UIntVector::iterator w=adj[v].begin(); w!=adj[v].end(); ++w) {
+      if (color[*w]<nv) {
+        forb[color[*w]] = v;
+      }
+    }
+    for (UIntVector::iterator w=adj[v].begin(); w!=adj[v].end(); ++w) {
+      for (UIntVector::iterator x=adj[*w].begin(); x!=adj[*w].end(); ++x) {
+        if (*x==v || color[*x]==nv) {
+          continue;
+        } else if (color[*w]==nv) {
+          forb[color[*x]] = v;
+          continue;
+        }
+        for (UIntVector::iterator y=adj[*x].begin(); y!=adj[*x].end();
+             ++y) {
+          if (*y!=*w && color[*y]==color[*w]) {
+            forb[color[*x]] = v;
+            break;
+          }
+        }
+      }
+    }
+    for (c=0; forb[c]==v; ++c) {
+    }
+    color[v] = c;
+    nc = std::max(nc, c+1);
+  }
+  if (nc>=nsweeps) {
+    return;
+  }
+
+  // entry (i, s) is read from row i of the sweep of color(s) if i has no
+  // other neighbor of that color, and from row s of the sweep of color(i)
+  // otherwise.
+  for (UInt i=0; i<nv; ++i) {
+    for (UInt j=hStarts_[i]; j<hStarts_[i+1]; ++j) {
+      s = hSlots_[j];
+      ecol[j] = color[s];
+      erow[j] = i;
+      if (s==i) {
+        continue;
+      }
+      cnt = 0;
+      for (UIntVector::iterator m=adj[i].begin(); m!=adj[i].end(); ++m) {
+        cnt += (color[*m]==color[s]) ? 1 : 0;
+      }
+      if (cnt>1) {
+        cnt = 0;
+        for (UIntVector::iterator m=adj[s].begin(); m!=adj[s].end(); ++m) {
+          cnt += (color[*m]==color[i]) ? 1 : 0;
+        }
+        if (cnt>1) {
+          return;
+        }
+        ecol[j] = color[i];
+        erow[j] = s;
+      }
+    }
+  }
+
+  hCEntB_.assign(nc+1, 0);
+  hCSeedB_.assign(nc+1, 0);
+  for (UInt j=0; j<hNnz_; ++j) {
+    ++hCEntB_[ecol[j]+1];
+  }
+  for (UInt v=0; v<nv; ++v) {
+    if (true==used[v]) {
+      ++hCSeedB_[color[v]+1];
+    }
+  }
+  for (c=0; c<nc; ++c) {
+    hCEntB_[c+1] += hCEntB_[c];
+    hCSeedB_[c+1] += hCSeedB_[c];
+  }
+  hCEnt_.resize(hNnz_);
+  hCRow_.resize(hNnz_);
+  hCSeeds_.resize(hCSeedB_[nc]);
+  forb.assign(hCEntB_.begin(), hCEntB_.end()-1);
+  for (UInt j=0; j<hNnz_; ++j) {
+    hCEnt_[forb[ecol[j]]] = j;
+    hCRow_[forb[ecol[j]]] = erow[j];
+    ++forb[ecol[j]];
+  }
+  forb.assign(hCSeedB_.begin(), hCSeedB_.end()-1);
+  for (UInt v=0; v<nv; ++v) {
+    if (true==used[v]) {
+      hCSeeds_[forb[color[v]]] = v;
+      ++forb[color[v]];
+    }
+  }
+}
+
+
+void CGraph::compileTape_()
+{
+  std::map<const CNode*, UInt> slot;
+  std::map<const CNode*, UInt>::iterator mit;
+  DoubleVector cvals;
+  UInt nd = dq_.size();
+  UInt k, ns;
+  CNode *n;
+
+  // the slots of the old tape may be used by graphs that share nodes with
+  // this graph, and the old tape may be used by clones. Build a new one.
+  unshare_();
+  releaseTape_();
+  tape_ = new Tape_();
+  tape_->refs = 1;
+  tape_->type = (oNode_) ? oNode_->getType() : Constant;
+  tape_->nv = 0;
+  sVars_.clear();
+  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
+    slot[it->second] = tape_->nv;
+    sVars_.push_back(it->first);
+    ++tape_->nv;
+  }
+  k = tape_->nv;
+  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it, ++k) {
+    slot[*it] = k;
+  }
+
+  // children that are neither variables nor dependent nodes are constants
+  // (OpNum, OpInt or nodes removed by simplifyDq_). They get slots at the
+  // end of the tape.
+  ns = tape_->nv+nd;
+  tape_->op.resize(nd);
+  tape_->left.resize(nd);
+  tape_->right.resize(nd);
+  tape_->kidB.resize(nd+1);
+  tape_->kids.clear();
+  for (k=0; k<nd; ++k) {
+    n = dq_[k];
+    tape_->op[k] = n->getOp();
+    tape_->kidB[k] = tape_->kids.size();
+    tape_->left[k] = tape_->right[k] = tape_->nv+k;
+    if (OpSumList==n->getOp()) {
+      for (CNode **c=n->getListL(); c<n->getListR(); ++c) {
+        mit = slot.find(*c);
+        if (mit==slot.end()) {
+          mit = slot.insert(std::pair<const CNode*, UInt>(*c, ns)).first;
+          cvals.push_back((*c)->getVal());
+          ++ns;
+        }
+        tape_->kids.push_back(mit->second);
+      }
+    } else {
+      for (UInt j=0; j<2; ++j) {
+        CNode *c = (0==j) ? n->getL() : n->getR();
+        if (!c) {
+          continue;
+        }
+        mit = slot.find(c);
+        if (mit==slot.end()) {
+          mit = slot.insert(std::pair<const CNode*, UInt>(c, ns)).first;
+          cvals.push_back(c->getVal());
+          ++ns;
+        }
+        if (0==j) {
+          tape_->left[k] = mit->second;
+        } else {
+          tape_->right[k] = mit->second;
+        }
+      }
+    }
+  }
+  tape_->kidB[nd] = tape_->kids.size();
+
+  tape_->out = 0;
+  if (oNode_) {
+    mit = slot.find(oNode_);
+    if (mit==slot.end()) {
+      tape_->out = ns;
+      cvals.push_back(oNode_->getVal());
+      ++ns;
+    } else {
+      tape_->out = mit->second;
+    }
+  }
+
+  tape_->vals.assign(ns, 0.0);
+  std::copy(cvals.begin(), cvals.end(), tape_->vals.begin()+tape_->nv+nd);
+  tVal_.clear();
+  hSlots_.clear();
+  hCEntB_.clear();
+  initSlots_();
+}
+
+
+bool CGraph::copyShared_(const double *x)
+{
+  const UInt ns = shSlots_.size();
+  const double *sv;
+
+  if (false==shared_->shOk_ || shared_->tVal_.empty()) {
+    return false;
+  }
+  sv = &shared_->tVal_[0];
+  for (UInt i=0; i<tape_->nv; ++i) {
+    if (sv[shSlots_[i]]!=x[sVars_[i]->getIndex()]) {
+      return false;
+    }
+  }
+  for (UInt i=0; i<ns; ++i) {
+    tVal_[i] = sv[shSlots_[i]];
+  }
+  return true;
+}
+
+
 void CGraph::computeBounds(double *lb, double *ub, int *error)
 {
   *error = 0;
+  makeNodes_();
   for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
     (*it)->updateBnd(error);
   }
@@ -185,17 +514,58 @@ void CGraph::computeBounds(double *lb, double *ub, int *error)
 
 double CGraph::eval(const double *x, int *error)
 {
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->eval(x, error);
+  int err = 0;
+
+  initSlots_();
+  if (!shared_ || false==copyShared_(x)) {
+    evalTape_(x, &err);
+  }
+  shOk_ = (0==err);
+  if (0!=err) {
+    *error = err;
   }
+  if (oNode_) {
+    oNode_->setVal(tVal_[tape_->out]);
+  }
+  return tVal_[tape_->out];
+}
 
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->eval(x, error);
-    if (0!=*error) {
-      break;
+
+void CGraph::evalBatch(UInt k, UInt n, const double *x, double *f,
+                       int *error)
+{
+  UInt kb;
+  for (UInt p0=0; p0<k; p0+=kb) {
+    kb = std::min(k-p0, (UInt) BATCH_SIZE);
+    evalTapeBatch_(kb, n, x+p0*n, error);
+    std::copy(&bVal_[0]+tape_->out*kb, &bVal_[0]+(tape_->out+1)*kb, f+p0);
+  }
+}
+
+
+void CGraph::evalGradientBatch(UInt k, UInt n, const double *x,
+                               double *grad_f, int *error)
+{
+  UInt kb;
+  int err = 0;
+  for (UInt p0=0; p0<k; p0+=kb) {
+    kb = std::min(k-p0, (UInt) BATCH_SIZE);
+    evalTapeBatch_(kb, n, x+p0*n, &err);
+    if (0==err) {
+      gradTapeBatch_(kb, &err);
+    }
+    if (0!=err) {
+      *error = err;
+      return;
+    }
+    for (UInt i=0; i<tape_->nv; ++i) {
+      const double *g = &bG_[0]+i*kb;
+      double *gf = grad_f+p0*n+sVars_[i]->getIndex();
+      for (UInt p=0; p<kb; ++p) {
+        gf[p*n] += g[p];
+      }
     }
   }
-  return oNode_->getVal();
 }
 
 
@@ -205,12 +575,12 @@ void CGraph::evalGradient(const double *x, double *grad_f, int *error)
   if (*error>0) {
     return;
   }
-  grad_(error);
+  gradTape_(error);
   if (*error>0) {
     return;
   }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    grad_f[(*it)->getV()->getIndex()] += (*it)->getG();
+  for (UInt i=0; i<tape_->nv; ++i) {
+    grad_f[sVars_[i]->getIndex()] += tG_[i];
   }
 }
 
@@ -219,74 +589,328 @@ void CGraph::evalHessian(double mult, const double *x,
                          const LTHessStor *, double *values, int *error)
 {
   UInt i = 0;
-  UInt vind;
-  VariablePtr v;
-  UInt nz = 0;
-  bool use2 = true;
-  std::stack<CNode *> st2;
-  // double thresh = vq_.size();
-
-  // thresh = thresh*(thresh-1.0)/2.0 * 0.75;
 
-  // if (hNnz_>thresh) {
-  //   use2 = false;
-  // }
-  // use2 = true;
+  if (hSlots_.size()!=hNnz_) {
+    setHessSlots_(&hSlots_);
+    colorHess_();
+  }
 
   // always eval. We do not assume that evaluations of x are already
   // available. It creates a big mess and doesn't save much.
   eval(x, error);
-  if (true==use2) {
-    for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-      (*it)->setB(false);
-      (*it)->setGi(0.0);
-      (*it)->setH(0.0);
-      (*it)->setTempI(0);
-    }
-    for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-      (*it)->setB(false);
-      (*it)->setGi(0.0);
-      (*it)->setH(0.0);
-      (*it)->setTempI(0);
+  gradTape_(error);
+
+  if (!hCEntB_.empty()) {
+    for (i=0; i+1<hCEntB_.size(); ++i) {
+      hessTape_(&hCSeeds_[0]+hCSeedB_[i], &hCSeeds_[0]+hCSeedB_[i+1],
+                error);
+      for (UInt j=hCEntB_[i]; j<hCEntB_[i+1]; ++j) {
+        values[hOffs_[hCEnt_[j]]] += mult * tH_[hCRow_[j]];
+      }
     }
-    grad_(error);
+    return;
   }
 
-  //std::cout << std::endl << " evaling hessian ";
-  //write(std::cout);
-  //std::cout << std::endl;
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it, 
-       ++i) {
+  // variable slots are in the same order as varNode_.
+  for (i=0; i<tape_->nv; ++i) {
     if (hStarts_[i]<hStarts_[i+1]) {
-      v = it->first;
-      vind = v->getIndex();
-      if (true==use2) {
-        fwdGrad2_(&st2, it->second); 
-        revHess2_(&st2, mult, vind, values, &nz, error);
+      hessTape_(&i, &i+1, error);
+      for (UInt j=hStarts_[i]; j<hStarts_[i+1]; ++j) {
+        values[hOffs_[j]] += mult * tH_[hSlots_[j]];
+      }
+    }
+  }
+}
+
+
+void CGraph::evalTape_(const double *x, int *error)
+{
+  const UInt nd = tape_->op.size();
+  const UInt *l = (nd>0) ? &tape_->left[0] : 0;
+  const UInt *r = (nd>0) ? &tape_->right[0] : 0;
+  double *val = (tVal_.size()>0) ? &tVal_[0] : 0;
+  double *v = val+tape_->nv;
+  double lv, rv;
+
+  for (UInt i=0; i<tape_->nv; ++i) {
+    val[i] = x[sVars_[i]->getIndex()];
+  }
+
+  errno = 0; //declared in cerrno
+  for (UInt i=0; i<nd; ++i) {
+    lv = val[l[i]];
+    rv = val[r[i]];
+    switch (tape_->op[i]) {
+    case (OpAbs):
+      v[i] = fabs(lv);
+      break;
+    case (OpAcos):
+      v[i] = acos(lv);
+      break;
+    case (OpAcosh):
+      v[i] = acosh(lv);
+      break;
+    case (OpAsin):
+      v[i] = asin(lv);
+      break;
+    case (OpAsinh):
+      v[i] = asinh(lv);
+      break;
+    case (OpAtan):
+      v[i] = atan(lv);
+      break;
+    case (OpAtanh):
+      v[i] = atanh(lv);
+      break;
+    case (OpCeil):
+      v[i] = ceil(lv);
+      break;
+    case (OpCos):
+      v[i] = cos(lv);
+      break;
+    case (OpCosh):
+      v[i] = cosh(lv);
+      break;
+    case (OpCPow):
+    case (OpPow):
+    case (OpPowK):
+      v[i] = pow(lv, rv);
+      break;
+    case (OpDiv):
+      if (fabs(rv) > DIV_BY_ZERO_TOL) {
+        v[i] = lv/rv;
       } else {
-        fwdGrad_(it->second); 
-        revHess_(error);
-        for (CNodeQ::iterator it2=vq_.begin(); 
-             it2!=vq_.end() && (*it2)->getV()->getIndex() <= vind; ++it2) {
-          //std::cout << std::endl << v->getName() << " " 
-          //<< (*it2)->getV()->getName() << " " << (*it2)->getH() 
-          //<< " hinds = " << hInds_[nz] << " my index = " 
-          //<< (*it2)->getV()->getIndex() << std::endl;
-          if (hInds_[nz] == (*it2)->getV()->getIndex()) {
-            values[hOffs_[nz]] += mult * (*it2)->getH();
-            ++nz;
-            if (nz == hStarts_[i+1]) {
-              break;
-            }
-          }
+        *error = 1;
+      }
+      break;
+    case (OpExp):
+      v[i] = exp(lv);
+      break;
+    case (OpFloor):
+      v[i] = floor(lv);
+      break;
+    case (OpIntDiv):
+      // always round towards zero
+      v[i] = lv/rv;
+      if (v[i]>0) {
+        v[i] = floor(v[i]);
+      } else {
+        v[i] = ceil(v[i]);
+      }
+      break;
+    case (OpLog):
+      v[i] = log(lv);
+      break;
+    case (OpLog10):
+      v[i] = log10(lv);
+      break;
+    case (OpMinus):
+      v[i] = lv - rv;
+      break;
+    case (OpMult):
+      v[i] = lv * rv;
+      break;
+    case (OpPlus):
+      v[i] = lv + rv;
+      break;
+    case (OpRound):
+      v[i] = floor(lv+0.5);
+      break;
+    case (OpSin):
+      v[i] = sin(lv);
+      break;
+    case (OpSinh):
+      v[i] = sinh(lv);
+      break;
+    case (OpSqr):
+      v[i] = lv*lv;
+      break;
+    case (OpSqrt):
+      v[i] = sqrt(lv);
+      break;
+    case (OpSumList):
+      {
+        const UInt *c = &tape_->kids[0]+tape_->kidB[i];
+        const UInt *ce = &tape_->kids[0]+tape_->kidB[i+1];
+        v[i] = 0.0;
+        for (; c<ce; ++c) {
+          v[i] += val[*c];
+        }
+      }
+      break;
+    case (OpTan):
+      v[i] = tan(lv);
+      break;
+    case (OpTanh):
+      v[i] = tanh(lv);
+      break;
+    case (OpUMinus):
+      v[i] = -lv;
+      break;
+    case (OpInt):
+    case (OpNone):
+    case (OpNum):
+    case (OpVar):
+      break;
+    default:
+      assert(!"cannot evaluate!");
+    }
+    if (0!=*error) {
+      break;
+    }
+  }
+  if (errno!=0) {
+    *error = errno;
+  }
+}
+
+
+void CGraph::evalTapeBatch_(UInt kb, UInt n, const double *x, int *error)
+{
+  const UInt nd = tape_->op.size();
+  const UInt ns = tape_->vals.size();
+  double *val;
+  double *o;
+  const double *a, *b;
+  UInt p;
+
+  bVal_.resize(ns*kb);
+  if (0==ns) {
+    return;
+  }
+  val = &bVal_[0];
+  for (UInt i=0; i<tape_->nv; ++i) {
+    const double *xi = x+sVars_[i]->getIndex();
+    o = val+i*kb;
+    for (p=0; p<kb; ++p) {
+      o[p] = xi[p*n];
+    }
+  }
+  for (UInt i=tape_->nv+nd; i<ns; ++i) {
+    std::fill(val+i*kb, val+(i+1)*kb, tape_->vals[i]);
+  }
+
+  errno = 0; //declared in cerrno
+  for (UInt i=0; i<nd; ++i) {
+    o = val+(tape_->nv+i)*kb;
+    a = val+tape_->left[i]*kb;
+    b = val+tape_->right[i]*kb;
+    switch (tape_->op[i]) {
+    case (OpAbs):
+      for (p=0; p<kb; ++p) o[p] = fabs(a[p]);
+      break;
+    case (OpAcos):
+      for (p=0; p<kb; ++p) o[p] = acos(a[p]);
+      break;
+    case (OpAcosh):
+      for (p=0; p<kb; ++p) o[p] = acosh(a[p]);
+      break;
+    case (OpAsin):
+      for (p=0; p<kb; ++p) o[p] = asin(a[p]);
+      break;
+    case (OpAsinh):
+      for (p=0; p<kb; ++p) o[p] = asinh(a[p]);
+      break;
+    case (OpAtan):
+      for (p=0; p<kb; ++p) o[p] = atan(a[p]);
+      break;
+    case (OpAtanh):
+      for (p=0; p<kb; ++p) o[p] = atanh(a[p]);
+      break;
+    case (OpCeil):
+      for (p=0; p<kb; ++p) o[p] = ceil(a[p]);
+      break;
+    case (OpCos):
+      for (p=0; p<kb; ++p) o[p] = cos(a[p]);
+      break;
+    case (OpCosh):
+      for (p=0; p<kb; ++p) o[p] = cosh(a[p]);
+      break;
+    case (OpCPow):
+    case (OpPow):
+    case (OpPowK):
+      for (p=0; p<kb; ++p) o[p] = pow(a[p], b[p]);
+      break;
+    case (OpDiv):
+      for (p=0; p<kb; ++p) {
+        if (fabs(b[p]) > DIV_BY_ZERO_TOL) {
+          o[p] = a[p]/b[p];
+        } else {
+          *error = 1;
         }
       }
+      break;
+    case (OpExp):
+      for (p=0; p<kb; ++p) o[p] = exp(a[p]);
+      break;
+    case (OpFloor):
+      for (p=0; p<kb; ++p) o[p] = floor(a[p]);
+      break;
+    case (OpIntDiv):
+      // always round towards zero
+      for (p=0; p<kb; ++p) {
+        o[p] = a[p]/b[p];
+        o[p] = (o[p]>0) ? floor(o[p]) : ceil(o[p]);
+      }
+      break;
+    case (OpLog):
+      for (p=0; p<kb; ++p) o[p] = log(a[p]);
+      break;
+    case (OpLog10):
+      for (p=0; p<kb; ++p) o[p] = log10(a[p]);
+      break;
+    case (OpMinus):
+      for (p=0; p<kb; ++p) o[p] = a[p] - b[p];
+      break;
+    case (OpMult):
+      for (p=0; p<kb; ++p) o[p] = a[p] * b[p];
+      break;
+    case (OpPlus):
+      for (p=0; p<kb; ++p) o[p] = a[p] + b[p];
+      break;
+    case (OpRound):
+      for (p=0; p<kb; ++p) o[p] = floor(a[p]+0.5);
+      break;
+    case (OpSin):
+      for (p=0; p<kb; ++p) o[p] = sin(a[p]);
+      break;
+    case (OpSinh):
+      for (p=0; p<kb; ++p) o[p] = sinh(a[p]);
+      break;
+    case (OpSqr):
+      for (p=0; p<kb; ++p) o[p] = a[p]*a[p];
+      break;
+    case (OpSqrt):
+      for (p=0; p<kb; ++p) o[p] = sqrt(a[p]);
+      break;
+    case (OpSumList):
+      std::fill(o, o+kb, 0.0);
+      for (UInt j=tape_->kidB[i]; j<tape_->kidB[i+1]; ++j) {
+        a = val+tape_->kids[j]*kb;
+        for (p=0; p<kb; ++p) o[p] += a[p];
+      }
+      break;
+    case (OpTan):
+      for (p=0; p<kb; ++p) o[p] = tan(a[p]);
+      break;
+    case (OpTanh):
+      for (p=0; p<kb; ++p) o[p] = tanh(a[p]);
+      break;
+    case (OpUMinus):
+      for (p=0; p<kb; ++p) o[p] = -a[p];
+      break;
+    case (OpInt):
+    case (OpNone):
+    case (OpNum):
+    case (OpVar):
+      break;
+    default:
+      assert(!"cannot evaluate!");
     }
   }
-  //for (UInt i=0; i<hNnz_; ++i) {
-  //  std::cout << "h[" << i << "] = " << values[i] << std::endl;
-  //}
-  //exit(0);
+  if (errno!=0) {
+    *error = errno;
+  }
 }
 
 
@@ -418,15 +1042,27 @@ void CGraph::fillHessStor(LTHessStor *stor)
   UIntQ::iterator it2, it_st;
   VariablePtr *stor_rows = stor->rows;
   UIntQ *st_inds = stor->colQs;
+  UIntVector lSlots, lStarts;
+  VarVector::const_iterator vit = sVars_.begin();
+  VarNodeMap::iterator nit = varNode_.begin();
+  UInt nv = (true==lazy_) ? tape_->nv : varNode_.size();
   UInt vind;
   bool use2 = true;
 
+  // a lazy graph has the pattern of the graph it was cloned from. It is
+  // kept by slots, since the indices of the variables may have changed.
+  if (true==lazy_) {
+    lSlots.swap(hSlots_);
+    lStarts.swap(hStarts_);
+  }
   hInds_.clear();
   hOffs_.clear();
   hStarts_.clear();
-  hStarts_.reserve(varNode_.size()+1);
+  hStarts_.reserve(nv+1);
   hStarts_.push_back(0);
   hNnz_ = 0;
+  hSlots_.clear();
+  hCEntB_.clear();
 
   if (true == changed_) {
     simplifyDq_();
@@ -448,17 +1084,26 @@ void CGraph::fillHessStor(LTHessStor *stor)
   }
 
 
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
-    v = it->first;
-    vind = v->getIndex();
+  for (UInt i=0; i<nv; ++i) {
     inds->clear();
-    //std::cout << "variable " << v->getName() << std::endl;
-    if (use2) {
-      fillHessInds2_(it->second, inds);
+    if (true==lazy_) {
+      v = *vit;
+      ++vit;
+      for (UInt j=lStarts[i]; j<lStarts[i+1]; ++j) {
+        inds->push_back(sVars_[lSlots[j]]->getIndex());
+      }
     } else {
-      fillHessInds_(it->second, inds);
+      v = nit->first;
+      //std::cout << "variable " << v->getName() << std::endl;
+      if (use2) {
+        fillHessInds2_(nit->second, inds);
+      } else {
+        fillHessInds_(nit->second, inds);
+      }
+      //std::cout << "size = " << inds->size() << std::endl;
+      ++nit;
     }
-    //std::cout << "size = " << inds->size() << std::endl;
+    vind = v->getIndex();
 
     while (*stor_rows != v) {
       ++stor_rows;
@@ -489,36 +1134,46 @@ void CGraph::fillHessStor(LTHessStor *stor)
   }
   inds->clear();
   delete inds;
+  setHessSlots_(&hSlots_);
+  colorHess_();
 }
 
 
 void CGraph::fillJac(const double *x, double *values, int *error)
 {
-  UInt *goff = &gOffs_[0];
-
   *error = 0;
   eval(x, error);
   if (*error>0) {
     return;
   }
-  grad_(error);
+  gradTape_(error);
   if (*error>0) {
     return;
   }
 
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); 
-       ++it,++goff) {
-    values[*goff] += it->second->getG();
+  // variable slots are in the same order as varNode_ and gOffs_.
+  for (UInt i=0; i<tape_->nv; ++i) {
+    values[gOffs_[i]] += tG_[i];
   }
 }
 
 
+bool CGraph::getHessOffs(UIntVector *offs) const
+{
+  offs->insert(offs->end(), hOffs_.begin(), hOffs_.end());
+  return true;
+}
+
+
 void CGraph::finalHessStor(const LTHessStor *stor)
 {
   UInt *st_cols;
   UInt *st_starts = stor->starts;
   VariablePtr *stor_rows = stor->rows;
   VariablePtr v;
+  VarVector::const_iterator vit = sVars_.begin();
+  VarNodeMap::iterator nit = varNode_.begin();
+  UInt nv = (true==lazy_) ? tape_->nv : varNode_.size();
   UInt i, j, ind2, off;
 
   // we need to fill offsets.
@@ -527,12 +1182,16 @@ void CGraph::finalHessStor(const LTHessStor *stor)
 
   // visit all indices in hInds_ and see what position (i) do they appear in
   // stor. Then put i in hOffs_.
-  i = 0;
   off = 0;
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end();
-       ++it, ++i) {
+  for (i=0; i<nv; ++i) {
     // find v in stor_rows.
-    v = it->first;
+    if (true==lazy_) {
+      v = *vit;
+      ++vit;
+    } else {
+      v = nit->first;
+      ++nit;
+    }
     while (*stor_rows != v) {
       ++st_starts;
       ++stor_rows;
@@ -560,6 +1219,12 @@ void CGraph::finalize()
   CNode *n1, *lchild, *rchild;
   CNode **p1, **p2;
   UInt id = 0, index = 0;
+
+  if (true==lazy_) {
+    // makeNodes_() finalizes the new nodes.
+    makeNodes_();
+    return;
+  }
   assert(oNode_);
   st.push(oNode_);
 
@@ -641,93 +1306,19 @@ void CGraph::finalize()
     dq_[i]->setIndex(index);
     index++;
   }
+  compileTape_();
 }
 
 
-void CGraph::fwdGrad_(CNode *node) 
+double CGraph::getFixVarOffset(VariablePtr, double)
 {
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->setGi(0.0);
-    (*it)->setG(0.0);
-    (*it)->setH(0.0);
-  }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->setGi(0.0);
-    (*it)->setG(0.0);
-    (*it)->setH(0.0);
-  }
-  node->setGi(1.0);
-
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->fwdGrad();
-  }
-}
-
-
-void CGraph::fwdGrad2_(std::stack<CNode *> *st2, CNode *node) 
-{
-  
-  CNode *n, *n2;
-  CNodeSet nset; // different compare method.
-  CNodeSet::iterator sit; 
-  CNodeQ qq;
-
-  while(!(st2->empty())) {
-    st2->pop();
-  }
-
-  node->setGi(1.0);
-
-  node->setTempI(1);
-  nset.insert(node);
-  while (!nset.empty()) {
-    sit = nset.begin();
-    n = *sit;
-    nset.erase(sit);
-    qq.push_back(n);
-    switch(n->numPar()) {
-    case 0:
-      assert(n==oNode_);
-      break;
-    case 1:
-      n2 = n->getUPar();
-      if (0==n2->getTempI()) {
-        n2->setTempI(1);
-        nset.insert(n2);
-      }
-      break;
-    default:
-      {
-      CQIter2 *it = n->getParB();
-      while (it) {
-        n2 = it->node;
-        if (0==n2->getTempI()) {
-          n2->setTempI(1);
-          nset.insert(n2);
-        }
-        it = it->next;
-      }
-      }
-    }
-  }
-
-  for (CNodeQ::iterator it=qq.begin(); it!=qq.end(); ++it) {
-    n = *it;
-    n->fwdGrad();
-    st2->push(n);
-  }
-  qq.clear();
-}
-
-
-double CGraph::getFixVarOffset(VariablePtr, double)
-{
-  return 0.0;
+  return 0.0;
 }
 
 
 UInt CGraph::getNumNodes()
 {
+  makeNodes_();
   return aNodes_.size();
 }
 
@@ -735,6 +1326,7 @@ UInt CGraph::getNumNodes()
 std::string CGraph::getNlString(int *err)
 {
   std::stringstream s;
+  makeNodes_();
   if (oNode_) {
     oNode_->writeSubNl(s, err);
   }
@@ -745,6 +1337,7 @@ CNode* CGraph::getVarNode(VariablePtr v)
 {
   VarNodeMap::iterator mit;
 
+  makeNodes_();
   mit = varNode_.find(v);
 
   if (mit != varNode_.end()) {
@@ -1050,6 +1643,7 @@ NonlinearFunctionPtr CGraph::getPersp(VariablePtr z, double eps, int *err) const
 
 const CNode* CGraph::getOut() const
 {
+  makeNodes_();
   return oNode_;
 }
 
@@ -1064,6 +1658,8 @@ FunctionType CGraph::getType() const
 { 
   if (vars_.empty()) {
     return Constant;
+  } else if (true==lazy_) {
+    return tape_->type;
   } else if (oNode_) {
     return oNode_->getType();
   } 
@@ -1071,18 +1667,631 @@ FunctionType CGraph::getType() const
 }
 
 
-void CGraph::grad_(int *error)
+void CGraph::gradTape_(int *error)
 {
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->setG(0.0);
+  const UInt nd = tape_->op.size();
+  const UInt *l = (nd>0) ? &tape_->left[0] : 0;
+  const UInt *r = (nd>0) ? &tape_->right[0] : 0;
+  const double *val = (tVal_.size()>0) ? &tVal_[0] : 0;
+  const double *v = val+tape_->nv;
+  double *g = (tG_.size()>0) ? &tG_[0] : 0;
+  double gv, lv, rv;
+
+  std::fill(tG_.begin(), tG_.end(), 0.0);
+  if (tG_.empty()) {
+    return;
   }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->setG(0.0);
+  g[tape_->out] = 1.0;
+
+  errno = 0; // declared in cerrno
+  for (UInt i=nd; i-->0; ) {
+    gv = g[tape_->nv+i];
+    lv = val[l[i]];
+    rv = val[r[i]];
+    switch (tape_->op[i]) {
+    case (OpAbs):
+      if (lv>1e-10) {
+        g[l[i]] += gv;
+      } else if (lv<-1e-10) {
+        g[l[i]] -= gv;
+      }
+      break;
+    case (OpAcos):
+      g[l[i]] -= gv/sqrt(1-lv*lv); // -1/sqrt(1-x^2)
+      break;
+    case (OpAcosh):
+      g[l[i]] += gv/sqrt(lv*lv - 1.0); // 1/sqrt(x^2-1)
+      break;
+    case (OpAsin):
+      g[l[i]] += gv/sqrt(1-lv*lv); // 1/sqrt(1-x^2)
+      break;
+    case (OpAsinh):
+      g[l[i]] += gv/sqrt(lv*lv + 1.0); // 1/sqrt(x^2+1)
+      break;
+    case (OpAtan):
+      g[l[i]] += gv/(1+lv*lv); // 1/(1+x^2)
+      break;
+    case (OpAtanh):
+      g[l[i]] += gv/(1-lv*lv); // 1/(1-x^2)
+      break;
+    case (OpCeil):
+      if (fabs(lv - floor(0.5+lv))<1e-12) {
+        g[l[i]] += gv;
+      }
+      break;
+    case (OpCos):
+      g[l[i]] -= gv*sin(lv);
+      break;
+    case (OpCosh):
+      g[l[i]] += gv*sinh(lv);
+      break;
+    case (OpCPow):
+      g[r[i]] += gv*log(lv)*v[i];
+      break;
+    case (OpDiv):
+      if (fabs(rv) > DIV_BY_ZERO_TOL) {
+        g[l[i]] += gv/rv;
+        g[r[i]] -= gv*lv/(rv*rv);
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpExp):
+      g[l[i]] += gv*v[i]; // v[i] = e^(lv)
+      break;
+    case (OpFloor):
+      g[l[i]] += gv; // assuming that gradient is 1.
+      break;
+    case (OpIntDiv):
+      assert(!"derivative of OpIntDiv not implemented!");
+      break;
+    case (OpLog):
+      g[l[i]] += gv/lv;
+      break;
+    case (OpLog10):
+      g[l[i]] += gv/lv/log(10.0);
+      break;
+    case (OpMinus):
+      g[l[i]] += gv;
+      g[r[i]] -= gv;
+      break;
+    case (OpMult):
+      g[l[i]] += gv*rv;
+      g[r[i]] += gv*lv;
+      break;
+    case (OpPlus):
+      g[l[i]] += gv;
+      g[r[i]] += gv;
+      break;
+    case (OpPow):
+      assert(!"derivative of OpPow not implemented!");
+      break;
+    case (OpPowK):
+      g[l[i]] += gv*rv*pow(lv, rv-1.0);
+      break;
+    case (OpRound):
+      assert(!"derivative of OpRound not implemented!");
+      break;
+    case (OpSin):
+      g[l[i]] += gv*cos(lv);
+      break;
+    case (OpSinh):
+      g[l[i]] += gv*cosh(lv);
+      break;
+    case (OpSqr):
+      g[l[i]] += 2.0*gv*lv; 
+      break;
+    case (OpSqrt):
+      if (fabs(v[i]) > DIV_BY_ZERO_TOL) {
+        g[l[i]] += gv*0.5/v[i]; // same as gv*0.5/sqrt(lv).
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpSumList):
+      if (gv!=0.0) {
+        const UInt *c = &tape_->kids[0]+tape_->kidB[i];
+        const UInt *ce = &tape_->kids[0]+tape_->kidB[i+1];
+        for (; c<ce; ++c) {
+          g[*c] += gv;
+        }
+      }
+      break;
+    case (OpTan):
+      {
+        double d = cos(lv);
+        g[l[i]] += gv/(d*d);
+      }
+      break;
+    case (OpTanh):
+      { 
+        double d = cosh(lv);
+        g[l[i]] += gv/(d*d);
+      }
+      break;
+    case (OpUMinus):
+      g[l[i]] -= gv;
+      break;
+    default:
+      break;
+    }
+  }
+  if (errno != 0) {
+    *error = errno;
   }
+}
 
-  oNode_->setG(1.0);
-  for (CNodeQ::reverse_iterator it=dq_.rbegin(); it!=dq_.rend(); ++it) {
-    (*it)->grad(error);
+
+void CGraph::gradTapeBatch_(UInt kb, int *error)
+{
+  const UInt nd = tape_->op.size();
+  const double *val;
+  const double *o, *a, *b, *go;
+  double *g, *ga, *gb;
+  UInt p;
+
+  bG_.assign(tape_->vals.size()*kb, 0.0);
+  if (bG_.empty()) {
+    return;
+  }
+  val = &bVal_[0];
+  g = &bG_[0];
+  std::fill(g+tape_->out*kb, g+(tape_->out+1)*kb, 1.0);
+
+  errno = 0; // declared in cerrno
+  for (UInt i=nd; i-->0; ) {
+    o = val+(tape_->nv+i)*kb;
+    go = g+(tape_->nv+i)*kb;
+    a = val+tape_->left[i]*kb;
+    b = val+tape_->right[i]*kb;
+    ga = g+tape_->left[i]*kb;
+    gb = g+tape_->right[i]*kb;
+    switch (tape_->op[i]) {
+    case (OpAbs):
+      for (p=0; p<kb; ++p) {
+        if (a[p]>1e-10) {
+          ga[p] += go[p];
+        } else if (a[p]<-1e-10) {
+          ga[p] -= go[p];
+        }
+      }
+      break;
+    case (OpAcos):
+      for (p=0; p<kb; ++p) ga[p] -= go[p]/sqrt(1-a[p]*a[p]);
+      break;
+    case (OpAcosh):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/sqrt(a[p]*a[p] - 1.0);
+      break;
+    case (OpAsin):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/sqrt(1-a[p]*a[p]);
+      break;
+    case (OpAsinh):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/sqrt(a[p]*a[p] + 1.0);
+      break;
+    case (OpAtan):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/(1+a[p]*a[p]);
+      break;
+    case (OpAtanh):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/(1-a[p]*a[p]);
+      break;
+    case (OpCeil):
+      for (p=0; p<kb; ++p) {
+        if (fabs(a[p] - floor(0.5+a[p]))<1e-12) {
+          ga[p] += go[p];
+        }
+      }
+      break;
+    case (OpCos):
+      for (p=0; p<kb; ++p) ga[p] -= go[p]*sin(a[p]);
+      break;
+    case (OpCosh):
+      for (p=0; p<kb; ++p) ga[p] += go[p]*sinh(a[p]);
+      break;
+    case (OpCPow):
+      for (p=0; p<kb; ++p) gb[p] += go[p]*log(a[p])*o[p];
+      break;
+    case (OpDiv):
+      for (p=0; p<kb; ++p) {
+        if (fabs(b[p]) > DIV_BY_ZERO_TOL) {
+          ga[p] += go[p]/b[p];
+          gb[p] -= go[p]*a[p]/(b[p]*b[p]);
+        } else {
+          *error = 1;
+        }
+      }
+      break;
+    case (OpExp):
+      for (p=0; p<kb; ++p) ga[p] += go[p]*o[p];
+      break;
+    case (OpFloor):
+      for (p=0; p<kb; ++p) ga[p] += go[p];
+      break;
+    case (OpIntDiv):
+      assert(!"derivative of OpIntDiv not implemented!");
+      break;
+    case (OpLog):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/a[p];
+      break;
+    case (OpLog10):
+      for (p=0; p<kb; ++p) ga[p] += go[p]/a[p]/log(10.0);
+      break;
+    case (OpMinus):
+      for (p=0; p<kb; ++p) {
+        ga[p] += go[p];
+        gb[p] -= go[p];
+      }
+      break;
+    case (OpMult):
+      for (p=0; p<kb; ++p) {
+        ga[p] += go[p]*b[p];
+        gb[p] += go[p]*a[p];
+      }
+      break;
+    case (OpPlus):
+      for (p=0; p<kb; ++p) {
+        ga[p] += go[p];
+        gb[p] += go[p];
+      }
+      break;
+    case (OpPow):
+      assert(!"derivative of OpPow not implemented!");
+      break;
+    case (OpPowK):
+      for (p=0; p<kb; ++p) ga[p] += go[p]*b[p]*pow(a[p], b[p]-1.0);
+      break;
+    case (OpRound):
+      assert(!"derivative of OpRound not implemented!");
+      break;
+    case (OpSin):
+      for (p=0; p<kb; ++p) ga[p] += go[p]*cos(a[p]);
+      break;
+    case (OpSinh):
+      for (p=0; p<kb; ++p) ga[p] += go[p]*cosh(a[p]);
+      break;
+    case (OpSqr):
+      for (p=0; p<kb; ++p) ga[p] += 2.0*go[p]*a[p];
+      break;
+    case (OpSqrt):
+      for (p=0; p<kb; ++p) {
+        if (fabs(o[p]) > DIV_BY_ZERO_TOL) {
+          ga[p] += go[p]*0.5/o[p];
+        } else {
+          *error = 1;
+        }
+      }
+      break;
+    case (OpSumList):
+      for (UInt j=tape_->kidB[i]; j<tape_->kidB[i+1]; ++j) {
+        ga = g+tape_->kids[j]*kb;
+        for (p=0; p<kb; ++p) ga[p] += go[p];
+      }
+      break;
+    case (OpTan):
+      for (p=0; p<kb; ++p) {
+        double d = cos(a[p]);
+        ga[p] += go[p]/(d*d);
+      }
+      break;
+    case (OpTanh):
+      for (p=0; p<kb; ++p) {
+        double d = cosh(a[p]);
+        ga[p] += go[p]/(d*d);
+      }
+      break;
+    case (OpUMinus):
+      for (p=0; p<kb; ++p) ga[p] -= go[p];
+      break;
+    default:
+      break;
+    }
+  }
+  if (errno != 0) {
+    *error = errno;
+  }
+}
+
+
+void CGraph::hessTape_(const UInt *sb, const UInt *se, int *error)
+{
+  const UInt nd = tape_->op.size();
+  const UInt *l = (nd>0) ? &tape_->left[0] : 0;
+  const UInt *r = (nd>0) ? &tape_->right[0] : 0;
+  const UInt *kids = (tape_->kids.size()>0) ? &tape_->kids[0] : 0;
+  const double *val = &tVal_[0];
+  const double *v = val+tape_->nv;
+  const double *g = &tG_[0]+tape_->nv;
+  double *gi = &tGi_[0];
+  double *h = &tH_[0];
+  unsigned char *dep = &tDep_[0];
+  double *gid = gi+tape_->nv;
+  double *hd = h+tape_->nv;
+  double lv, rv, lgi, rgi;
+
+  std::fill(tGi_.begin(), tGi_.end(), 0.0);
+  std::fill(tH_.begin(), tH_.end(), 0.0);
+  std::fill(tDep_.begin(), tDep_.end(), 0);
+  for (const UInt *vs=sb; vs<se; ++vs) {
+    gi[*vs] = 1.0;
+    dep[*vs] = 1;
+  }
+
+  // forward mode derivative, only on nodes that depend on the seeds.
+  for (UInt i=0; i<nd; ++i) {
+    if (OpSumList==tape_->op[i]) {
+      for (UInt j=tape_->kidB[i]; j<tape_->kidB[i+1]; ++j) {
+        if (dep[kids[j]]) {
+          dep[tape_->nv+i] = 1;
+          gid[i] += gi[kids[j]];
+        }
+      }
+      continue;
+    } else if (0==dep[l[i]] && 0==dep[r[i]]) {
+      continue;
+    }
+    dep[tape_->nv+i] = 1;
+    lv = val[l[i]];
+    rv = val[r[i]];
+    lgi = gi[l[i]];
+    rgi = gi[r[i]];
+    switch (tape_->op[i]) {
+    case (OpAbs):
+      if (lv>1e-10) {
+        gid[i] += 1.0;
+      } else if (lv<-1e-10) {
+        gid[i] -= 1.0;
+      }
+      break;
+    case (OpAcos):
+      gid[i] -= lgi/sqrt(1-lv*lv); // -1/sqrt(1-x^2)
+      break;
+    case (OpAcosh):
+      gid[i] += lgi/sqrt(lv*lv - 1.0); // 1/sqrt(x^2-1)
+      break;
+    case (OpAsin):
+      gid[i] += lgi/sqrt(1-lv*lv); // 1/sqrt(1-x^2)
+      break;
+    case (OpAsinh):
+      gid[i] += lgi/sqrt(lv*lv + 1.0); // 1/sqrt(x^2+1)
+      break;
+    case (OpAtan):
+      gid[i] += lgi/(1+lv*lv); // 1/(1+x^2)
+      break;
+    case (OpAtanh):
+      gid[i] += lgi/(1-lv*lv); // 1/(1-x^2)
+      break;
+    case (OpCeil):
+      if (fabs(lv - floor(0.5+lv))<1e-12) {
+        gid[i] += lgi;
+      }
+      break;
+    case (OpCos):
+      gid[i] -= lgi*sin(lv);
+      break;
+    case (OpCosh):
+      gid[i] += lgi*sinh(lv);
+      break;
+    case (OpCPow):
+      gid[i] += rgi*log(lv)*v[i]; // v[i] = a^(rv)
+      break;
+    case (OpDiv):
+      gid[i] += lgi/rv;
+      gid[i] -= rgi*lv/(rv*rv);
+      break;
+    case (OpExp):
+      gid[i] += lgi*v[i]; // v[i] = e^(lv)
+      break;
+    case (OpFloor):
+      gid[i] += lgi;
+      break;
+    case (OpLog):
+      gid[i] += lgi/lv;
+      break;
+    case (OpLog10):
+      gid[i] += lgi/lv/log(10.0);
+      break;
+    case (OpMinus):
+      gid[i] += lgi;
+      gid[i] -= rgi;
+      break;
+    case (OpMult):
+      gid[i] += lgi*rv;
+      gid[i] += rgi*lv;
+      break;
+    case (OpPlus):
+      gid[i] += lgi;
+      gid[i] += rgi;
+      break;
+    case (OpPowK):
+      gid[i] += lgi*rv*pow(lv,rv-1.0);
+      break;
+    case (OpSin):
+      gid[i] += lgi*cos(lv);
+      break;
+    case (OpSinh):
+      gid[i] += lgi*cosh(lv);
+      break;
+    case (OpSqr):
+      gid[i] += 2.0*lgi*lv; 
+      break;
+    case (OpSqrt):
+      gid[i] += lgi*0.5/v[i]; // since v[i] = sqrt(lv).
+      break;
+    case (OpTan):
+      {
+        double d = cos(lv);
+        gid[i] += lgi/(d*d);
+      }
+      break;
+    case (OpTanh):
+      { 
+        double d = cosh(lv);
+        gid[i] += lgi/(d*d);
+      }
+      break;
+    case (OpUMinus):
+      gid[i] -= lgi;
+      break;
+    case (OpIntDiv):
+      assert(!"derivative of OpIntDiv not implemented!");
+      break;
+    case (OpPow):
+      assert(!"derivative of OpPow not implemented!");
+      break;
+    case (OpRound):
+      assert(!"derivative of OpRound not implemented!");
+      break;
+    default:
+      break;
+    }
+  }
+
+  // reverse sweep of second order adjoints. A node that does not depend on
+  // the seeds and has no second order adjoint contributes nothing.
+  errno = 0;
+  for (UInt i=nd; i-->0; ) {
+    if (0==dep[tape_->nv+i] && 0.0==hd[i]) {
+      continue;
+    }
+    lv = val[l[i]];
+    rv = val[r[i]];
+    lgi = gi[l[i]];
+    rgi = gi[r[i]];
+    switch (tape_->op[i]) {
+    case (OpAcos):
+      h[l[i]] += -hd[i]/sqrt(1-lv*lv) 
+                 - g[i] * lgi * lv/pow((1.0-lv*lv),1.5); 
+      // -x/(1-x^2)^1.5
+      break;
+    case (OpAcosh):
+      h[l[i]] +=  hd[i]/sqrt(lv*lv-1.0) 
+                 - g[i] * lgi * lv/pow((lv*lv-1.0),1.5); 
+      break;
+    case (OpAsin):
+      h[l[i]] +=  hd[i]/sqrt(1-lv*lv) 
+                 + g[i] * lgi * lv/pow((1-lv*lv),1.5); 
+      break;
+    case (OpAsinh):
+      h[l[i]] +=  hd[i]/sqrt(1+lv*lv) 
+                 - g[i] * lgi * lv/pow((1+lv*lv),1.5); 
+      break;
+    case (OpAtan):
+      {
+      double d = 1+lv*lv;
+      h[l[i]] +=  hd[i]/d - 2.0 * g[i] * lgi * lv/(d*d); 
+      }
+      break;
+    case (OpAtanh):
+      {
+      double d = (1.0 - lv*lv);
+      h[l[i]] +=  hd[i]/d + 2.0 * g[i] * lgi * lv/(d*d);
+      }
+      break;
+    case (OpCeil):
+      h[l[i]] +=  hd[i];
+      break;
+    case (OpCos):
+      h[l[i]] += -hd[i]*sin(lv) - g[i] * lgi * v[i]; // since v[i] = cos(). 
+      break;
+    case (OpCosh):
+      h[l[i]] += hd[i]*sinh(lv) + g[i] * lgi * v[i]; // since v[i] = cosh().
+      break;
+    case (OpCPow):
+      h[r[i]] += hd[i]*log(lv)*v[i] + g[i]*rgi*log(lv)*log(lv)*v[i];
+      break;
+    case (OpDiv):
+      if (fabs(rv) > DIV_BY_ZERO_TOL) {
+        h[l[i]] += hd[i]/rv - g[i] * rgi /(rv*rv);
+        h[r[i]] += -hd[i]*lv/(rv*rv) 
+                   - g[i] * lgi /(rv*rv)
+                   + g[i] * rgi * lv * 2.0 /(rv*rv*rv);
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpExp):
+      h[l[i]] += hd[i]*v[i] + g[i] * lgi * v[i];
+      break;
+    case (OpFloor):
+      h[l[i]] += hd[i];
+      break;
+    case (OpLog):
+      h[l[i]] += hd[i]/lv - g[i] * lgi  / (lv * lv); // -1/x^2
+      break;
+    case (OpLog10):
+      h[l[i]] += hd[i]/lv/log(10) - g[i] * lgi / (log(10)*lv*lv);
+      break;
+    case (OpMinus):
+      h[l[i]] += hd[i];
+      h[r[i]] -= hd[i];
+      break;
+    case (OpMult):
+      h[l[i]] += hd[i]*rv + g[i]*rgi;
+      h[r[i]] += hd[i]*lv + g[i]*lgi;
+      break;
+    case (OpPlus):
+      h[l[i]] += hd[i];
+      h[r[i]] += hd[i];
+      break;
+    case (OpPowK):
+      h[l[i]] += hd[i] * rv * pow(lv,rv-1.0) 
+                 + g[i]*lgi*rv*(rv-1.0)*pow(lv, rv-2.0);
+      break;
+    case (OpSin):
+      h[l[i]] += hd[i]*cos(lv) - g[i] * lgi * v[i]; // since v[i] = sin(). 
+      break;
+    case (OpSinh):
+      h[l[i]] += hd[i]*cosh(lv) + g[i] * lgi * v[i]; // since v[i] = sinh().
+      break;
+    case (OpSqr):
+      h[l[i]] += 2.0*hd[i]*lv + g[i] * 2.0 * lgi;
+      break;
+    case (OpSqrt):
+      if (fabs(v[i]) > DIV_BY_ZERO_TOL) {
+        h[l[i]] += hd[i]*0.5/v[i] - g[i] * lgi * 0.25 /(v[i] * lv); 
+        // -1/4/x^1.5
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpSumList):
+      if (hd[i]!=0.0) {
+        for (UInt j=tape_->kidB[i]; j<tape_->kidB[i+1]; ++j) {
+          h[kids[j]] += hd[i];
+        }
+      }
+      break;
+    case (OpTan):
+      {
+      double d = cos(lv);
+             d *= d;
+      h[l[i]] += hd[i]/d  + 2.0 * g[i] * lgi * tan(lv)/d;
+      }
+      break;
+    case (OpTanh):
+      { 
+      double d = cosh(lv);
+             d *= d;
+      h[l[i]] += hd[i]/d  - 2.0 * g[i] * lgi * tanh(lv)/d;
+      }
+      break;
+    case (OpUMinus):
+      h[l[i]] -= hd[i];
+      break;
+    case (OpIntDiv):
+      assert(!"derivative of OpIntDiv not implemented!");
+      break;
+    case (OpPow):
+      assert(!"derivative of OpPow not implemented!");
+      break;
+    case (OpRound):
+      assert(!"derivative of OpRound not implemented!");
+      break;
+    default:
+      break;
+    }
+  }
+  if (errno != 0) {
+    *error = errno;
   }
 }
 
@@ -1103,12 +2312,31 @@ VariablePtr CGraph::getVar(const CNode *cnode) const
 
 void CGraph::getVars(VariableSet *vars)
 {
+  if (true==lazy_) {
+    vars->insert(sVars_.begin(), sVars_.end());
+    return;
+  }
   for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
     vars->insert(it->first);
   }
 }
 
 
+void CGraph::initSlots_()
+{
+  const UInt ns = tape_->vals.size();
+
+  if (tVal_.size()==ns) {
+    return;
+  }
+  tVal_ = tape_->vals;
+  tG_.assign(ns, 0.0);
+  tGi_.assign(ns, 0.0);
+  tH_.assign(ns, 0.0);
+  tDep_.assign(ns, 0);
+}
+
+
 bool CGraph::isIdenticalTo(CGraphPtr cg)
 {
   CNodeVector::iterator it1, it2;
@@ -1118,6 +2346,8 @@ bool CGraph::isIdenticalTo(CGraphPtr cg)
     return false;
   }
 
+  makeNodes_();
+  cg->makeNodes_();
   if (cg->aNodes_.size()!=aNodes_.size() ||
       cg->varNode_.size()!=varNode_.size() ||
       cg->dq_.size()!=dq_.size()) {
@@ -1146,6 +2376,7 @@ bool CGraph::isIdenticalTo(CGraphPtr cg)
 
 bool CGraph::isSumOfSquares() const
 {
+  makeNodes_();
   return isSOSRec_(oNode_);
 }
 
@@ -1173,6 +2404,52 @@ bool CGraph::isSOSRec_(CNode *node) const
 }
 
 
+void CGraph::makeNodes_() const
+{
+  CGraphPtr cg;
+  CNodeVector sn;
+  CNodeVector kids;
+  CNode *l, *r;
+  UInt nd, s;
+
+  if (false==lazy_) {
+    return;
+  }
+
+  // nodes are created from the tape that is shared with other graphs. The
+  // tape is not changed. Only this graph gets new nodes and a new tape.
+  cg = const_cast<CGraph *>(this);
+  cg->lazy_ = false;
+  nd = tape_->op.size();
+  sn.resize(tape_->vals.size(), 0);
+  s = 0;
+  for (VarVector::const_iterator it=sVars_.begin(); it!=sVars_.end();
+       ++it, ++s) {
+    sn[s] = cg->newNode(*it);
+  }
+  for (s=tape_->nv+nd; s<sn.size(); ++s) {
+    sn[s] = cg->newNode(tape_->vals[s]);
+  }
+  for (UInt i=0; i<nd; ++i) {
+    s = tape_->nv+i;
+    if (OpSumList==tape_->op[i]) {
+      kids.clear();
+      for (UInt j=tape_->kidB[i]; j<tape_->kidB[i+1]; ++j) {
+        kids.push_back(sn[tape_->kids[j]]);
+      }
+      sn[s] = cg->newNode(OpSumList, &kids[0], kids.size());
+    } else {
+      // a child that is missing has the slot of the node itself.
+      l = (tape_->left[i]!=s) ? sn[tape_->left[i]] : 0;
+      r = (tape_->right[i]!=s) ? sn[tape_->right[i]] : 0;
+      sn[s] = cg->newNode(tape_->op[i], l, r);
+    }
+  }
+  cg->oNode_ = sn[tape_->out];
+  cg->finalize();
+}
+
+
 void CGraph::multiply(double c)
 {
   if (c == 1) {
@@ -1181,6 +2458,7 @@ void CGraph::multiply(double c)
     assert(!"cannot multiply INFINITY in cgraph!");
     return;
   }
+  makeNodes_();
   CNode *node;
   if (c == -1) {
     node = new CNode(OpUMinus, oNode_, 0);
@@ -1210,6 +2488,7 @@ void CGraph::multiply(double c)
 
 CNode* CGraph::newNode(OpCode op, CNode *lnode, CNode *rnode)
 {
+  makeNodes_();
   CNode *node = new CNode(op, lnode, rnode);
   aNodes_.push_back(node);
   return node;
@@ -1218,6 +2497,7 @@ CNode* CGraph::newNode(OpCode op, CNode *lnode, CNode *rnode)
 
 CNode* CGraph::newNode(OpCode op, CNode **child, UInt n)
 {
+  makeNodes_();
   CNode *node = new CNode(op, child, n);
   aNodes_.push_back(node);
   return node;
@@ -1227,7 +2507,10 @@ CNode* CGraph::newNode(OpCode op, CNode **child, UInt n)
 CNode* CGraph::newNode(double d)
 {
   CNode *z = 0;
-  CNode *node = new CNode(OpNum, z, z);
+  CNode *node;
+
+  makeNodes_();
+  node = new CNode(OpNum, z, z);
   node->setDouble(d);
   node->setVal(d);
   aNodes_.push_back(node);
@@ -1238,7 +2521,10 @@ CNode* CGraph::newNode(double d)
 CNode* CGraph::newNode(int i)
 {
   CNode *z = 0;
-  CNode *node = new CNode(OpInt, z, z);
+  CNode *node;
+
+  makeNodes_();
+  node = new CNode(OpInt, z, z);
   node->setVal(i);
   aNodes_.push_back(node);
   return node;
@@ -1247,7 +2533,10 @@ CNode* CGraph::newNode(int i)
 CNode* CGraph::newNode(VariablePtr v)
 {
   CNode *z = 0;
-  VarNodeMap::iterator it = varNode_.find(v);
+  VarNodeMap::iterator it;
+
+  makeNodes_();
+  it = varNode_.find(v);
   if (it==varNode_.end()) {
     CNode *node = new CNode(OpVar, z, z);
     node->setV(v);
@@ -1283,9 +2572,28 @@ void CGraph::prepJac(VarSetConstIter vb, VarSetConstIter ve)
 }
 
 
+void CGraph::releaseTape_()
+{
+  UInt refs;
+
+  if (!tape_) {
+    return;
+  }
+#pragma omp atomic capture
+  refs = --(tape_->refs);
+  if (0==refs) {
+    delete tape_;
+  }
+  tape_ = 0;
+}
+
+
 void CGraph::removeVar(VariablePtr v, double val)
 {
-  VarNodeMap::iterator it = varNode_.find(v);
+  VarNodeMap::iterator it;
+
+  makeNodes_();
+  it = varNode_.find(v);
 
   if (it!=varNode_.end()) {
     CNode *cnode = it->second;
@@ -1304,22 +2612,15 @@ void CGraph::removeVar(VariablePtr v, double val)
     vars_.erase(v);
     varNode_.erase(it);
     changed_ = true;
+    compileTape_();
   }
 }
 
 
-void CGraph::revHess_(int *error)
-{
-  oNode_->setG(1.0);
-  for (CNodeQ::reverse_iterator it=dq_.rbegin(); it!=dq_.rend(); ++it) {
-    (*it)->grad(error); // reverse mode gradient.
-    (*it)->hess(error);
-  }
-}
-
 void CGraph::resetNodeIndex()
 {
   UInt index =0;
+  makeNodes_();
   for (UInt i=0; i<aNodes_.size(); i++) {
     if (aNodes_[i]->getOp() == OpNum || aNodes_[i]->getOp() == OpInt ) {
       aNodes_[i]->setIndex(index);
@@ -1336,37 +2637,126 @@ void CGraph::resetNodeIndex()
   } 
 }
 
-void CGraph::revHess2_(std::stack<CNode *> *st2, double mult, UInt vind,
-                       double *values, UInt *nz, int *error)
+void CGraph::share(const std::vector<CGraphPtr> &cgs)
 {
-  CNodeRSet nset;
-  CNodeRSet::iterator sit; 
-  CNode *n;
+  typedef std::pair<int, CNodeVector> NodeKey;
+  std::map<NodeKey, CNode*> dnodes;
+  std::map<NodeKey, CNode*>::iterator dit;
+  std::map<double, CNode*> cnodes;
+  std::map<double, CNode*>::iterator cit;
+  std::map<const CNode*, UInt> slot;
+  std::map<const CNode*, UInt>::iterator mit;
+  std::set<CNode*> outset;
+  std::vector<CNodeVector> gnodes(cgs.size());
+  CNodeVector outs, kids;
+  NodeKey key;
+  CGraphPtr cg;
+  const Tape_ *t;
+  UInt nd, s, k;
+
+  makeNodes_();
+  for (UInt g=0; g<cgs.size(); ++g) {
+    cg = cgs[g];
+    t = cg->tape_;
+    nd = t->op.size();
+    CNodeVector &sn = gnodes[g];
+    sn.resize(t->vals.size(), 0);
+
+    // variables, in the order of the slots of cg.
+    if (true==cg->lazy_) {
+      for (s=0; s<t->nv; ++s) {
+        sn[s] = newNode(cg->sVars_[s]);
+      }
+    } else {
+      s = 0;
+      for (VarNodeMap::iterator it=cg->varNode_.begin();
+           it!=cg->varNode_.end(); ++it, ++s) {
+        sn[s] = newNode((VariablePtr) it->first);
+      }
+    }
 
-  nset.insert(oNode_);
-  oNode_->setG(1.0);
-  while (!nset.empty()) {
-    sit = nset.begin();
-    n = *sit;
-    nset.erase(sit);
-    n->hess2(&nset, error);
-    if (OpVar==n->getOp() && n->getB()==true && vind >= n->getV()->getIndex()) {
-      values[hOffs_[*nz]] += mult * n->getH();
-      (*nz) += 1;
+    // constants. A NaN is never equal to another constant.
+    for (s=t->nv+nd; s<sn.size(); ++s) {
+      cit = cnodes.find(t->vals[s]);
+      if (cit!=cnodes.end()) {
+        sn[s] = cit->second;
+      } else {
+        sn[s] = newNode(t->vals[s]);
+        if (t->vals[s]==t->vals[s]) {
+          cnodes[t->vals[s]] = sn[s];
+        }
+      }
+    }
+
+    // dependent nodes are identical if they have the same operation on the
+    // same children. Children of OpPlus and OpMult are sorted.
+    for (UInt i=0; i<nd; ++i) {
+      s = t->nv+i;
+      key.first = t->op[i];
+      key.second.clear();
+      if (OpSumList==t->op[i]) {
+        for (k=t->kidB[i]; k<t->kidB[i+1]; ++k) {
+          key.second.push_back(sn[t->kids[k]]);
+        }
+      } else {
+        key.second.push_back((t->left[i]!=s) ? sn[t->left[i]] : 0);
+        key.second.push_back((t->right[i]!=s) ? sn[t->right[i]] : 0);
+        if ((OpPlus==t->op[i] || OpMult==t->op[i]) &&
+            key.second[1]<key.second[0]) {
+          std::swap(key.second[0], key.second[1]);
+        }
+      }
+      dit = dnodes.find(key);
+      if (dit!=dnodes.end()) {
+        sn[s] = dit->second;
+      } else if (OpSumList==t->op[i]) {
+        kids = key.second;
+        sn[s] = newNode(OpSumList, &kids[0], kids.size());
+        dnodes[key] = sn[s];
+      } else {
+        sn[s] = newNode(t->op[i], key.second[0], key.second[1]);
+        dnodes[key] = sn[s];
+      }
+    }
+    if (outset.insert(sn[t->out]).second) {
+      outs.push_back(sn[t->out]);
     }
-    n->setB(false);
-    n->setGi(0.0);
-    n->setH(0.0);
-    n->setTempI(0);
-    //std::cout << nset.size() << std::endl;
   }
-  while (!st2->empty()) {
-    n = st2->top();
-    st2->pop();
-    n->setB(false);
-    n->setGi(0.0);
-    n->setH(0.0);
-    n->setTempI(0);
+  if (outs.empty()) {
+    return;
+  }
+  setOut(newNode(OpSumList, &outs[0], outs.size()));
+  finalize();
+
+  // slots of this graph are assigned in the order of varNode_ and dq_.
+  k = 0;
+  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
+    slot[it->second] = k++;
+  }
+  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
+    slot[*it] = k++;
+  }
+  for (UInt g=0; g<cgs.size(); ++g) {
+    cg = cgs[g];
+    if (cg==this || cg->tape_->op.empty()) {
+      continue;
+    }
+    cg->unshare_();
+    nd = cg->tape_->nv+cg->tape_->op.size();
+    cg->shSlots_.resize(nd);
+    for (s=0; s<nd; ++s) {
+      mit = slot.find(gnodes[g][s]);
+      if (mit==slot.end()) {
+        break;
+      }
+      cg->shSlots_[s] = mit->second;
+    }
+    if (s<nd) {
+      cg->shSlots_.clear();
+      continue;
+    }
+    cg->shared_ = this;
+    shGraphs_.push_back(cg);
   }
 }
 
@@ -1383,12 +2773,14 @@ void CGraph::simplifyDq_()
       ++it;
     }
   }
+  compileTape_();
 }
 
 
 void CGraph::sqrRoot(int &err)
 {
   CNode *n = 0;
+  makeNodes_();
   if (!oNode_) {
     err = 1;
     return;
@@ -1410,6 +2802,7 @@ void CGraph::subst(VariablePtr out, VariablePtr in, double rat)
   if (vars_.find(out)==vars_.end()) {
     return;
   }
+  makeNodes_();
   //std::cout << "substituting variable " << out->getName() << " by "
   //  << rat << " " << in->getName() << "\n";
   vars_.erase(out);
@@ -1553,17 +2946,34 @@ void CGraph::subst(VariablePtr out, VariablePtr in, double rat)
   }
   delete nout;
   changed_ = true;
+  compileTape_();
+}
+
+
+void CGraph::setHessSlots_(UIntVector *slots) const
+{
+  std::map<UInt, UInt> islot;
+
+  for (UInt i=0; i<sVars_.size(); ++i) {
+    islot[sVars_[i]->getIndex()] = i;
+  }
+  slots->resize(hNnz_);
+  for (UInt i=0; i<hNnz_; ++i) {
+    (*slots)[i] = islot[hInds_[i]];
+  }
 }
 
 
 void CGraph::setOut(CNode *node)
 {
+  makeNodes_();
   oNode_ = node;
 }
 
 
 bool CGraph::ifLinear(LinearFunctionPtr lf, UInt pv, double *consVal)
 {
+  makeNodes_();
   if (oNode_->findFType() == Linear) {
     int error = 0;
     VariablePtr v;
@@ -1602,6 +3012,27 @@ bool CGraph::ifLinear(LinearFunctionPtr lf, UInt pv, double *consVal)
 }
 
 
+void CGraph::unshare_()
+{
+  std::vector<CGraph *>::iterator it;
+
+  if (shared_) {
+    it = std::find(shared_->shGraphs_.begin(), shared_->shGraphs_.end(),
+                   this);
+    if (it!=shared_->shGraphs_.end()) {
+      shared_->shGraphs_.erase(it);
+    }
+    shared_ = 0;
+    shSlots_.clear();
+  }
+  for (it=shGraphs_.begin(); it!=shGraphs_.end(); ++it) {
+    (*it)->shared_ = 0;
+    (*it)->shSlots_.clear();
+  }
+  shGraphs_.clear();
+}
+
+
 void CGraph::varBoundMods(double lb, double ub, VarBoundModVector &mods,
                           SolveStatus *status)
 {
@@ -1612,6 +3043,7 @@ void CGraph::varBoundMods(double lb, double ub, VarBoundModVector &mods,
   const double bslack = 1e-5;
   const double bslack10 = 1e-4;
 
+  makeNodes_();
   computeBounds(&lb2, &ub2, &error);
   if (error>0) {
     *status = SolveError;
@@ -1646,6 +3078,7 @@ void CGraph::varBoundMods(double lb, double ub, VarBoundModVector &mods,
 
 void CGraph::write(std::ostream &out) const
 {
+  makeNodes_();
   if (oNode_) {
     oNode_->writeSubExp(out);
   } else {
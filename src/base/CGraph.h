@@ -21,6 +21,8 @@
 #include "NonlinearFunction.h"
 #include "OpCode.h"
 
+class CGraphUT;
+
 namespace Minotaur {
 
 class CGraph;
@@ -59,6 +61,13 @@ public:
   // Evaluate gradient at a given array.
   void evalGradient(const double *x, double *grad_f, int *error);
 
+  // base class method.
+  void evalBatch(UInt k, UInt n, const double *x, double *f, int *error);
+
+  // base class method.
+  void evalGradientBatch(UInt k, UInt n, const double *x, double *grad_f,
+                         int *error);
+
   // Evaluate hessian of at a given vector.
   void evalHessian(double mult, const double *x, 
                    const LTHessStor *stor, double *values, 
@@ -70,6 +79,9 @@ public:
   // Finalize hessian offsets, if needed.
   void finalHessStor(const LTHessStor *stor);
 
+  // base class method.
+  bool getHessOffs(UIntVector *offs) const;
+
   // Add gradient values to sparse Jacobian
   void fillJac(const double *x, double *values, int *error);
 
@@ -118,6 +130,20 @@ public:
   // multiply by a constant.
   void multiply(double c);
 
+  /**
+   * \brief Make this graph the sum of the graphs in cgs, with identical
+   * subexpressions added only once.
+   *
+   * The graphs in cgs keep their own nodes. After this call, eval() of a
+   * graph in cgs copies the values of its nodes from this graph if this
+   * graph was last evaluated, without errors, at the same values of its
+   * variables. Otherwise it evaluates its own nodes. A graph stops using
+   * this graph when either graph is changed or deleted.
+   *
+   * \param [in] cgs Graphs of the nonlinear functions of one problem.
+   */
+  void share(const std::vector<CGraphPtr> &cgs);
+
   /**
    * \brief Create a new node with one or two children, and add it to the
    * graph. The children should already be a nodes of the graph.
@@ -199,12 +225,15 @@ public:
                     SolveStatus *status);
 
   // method to return all the dependent nodes of the cgraph.
-  CNodeQ dNodes() {return dq_ ;} ;
+  CNodeQ dNodes() {makeNodes_(); return dq_ ;} ;
 
   // display.
   void write(std::ostream &out) const;
 
 private:
+  /// The unit tests check the tape, its sharing and the hessian coloring.
+  friend class ::CGraphUT;
+
   /// All nodes of the graph.
   CNodeVector aNodes_; 
 
@@ -232,17 +261,175 @@ private:
   /// All nodes with OpCode OpVar.
   CNodeQ vq_;
 
+  /**
+   * The tape is a flat copy of the graph used for evaluating the function
+   * and its derivatives. Each node gets a slot. Slots 0 to nv-1 are the
+   * variables in the order of varNode_, the next dq_.size() slots are the
+   * dependent nodes in the order of dq_, and the remaining slots are
+   * constants. The arrays op, left, right and kidB are indexed by the
+   * position of a dependent node in dq_. The pointer-based nodes are used
+   * only for building and modifying the graph.
+   *
+   * A tape is never changed once it is built. Clones of a graph made by
+   * cloneWithVars() share its tape, so that a copy of a problem does not
+   * pay for a copy of every graph. Each clone has its own values and
+   * derivatives in the per-slot arrays below.
+   */
+  struct Tape_ {
+    UIntVector kidB;       /// Position in kids where children of a
+                           /// dependent node start.
+    UIntVector kids;       /// Slots of all children of OpSumList nodes.
+    UIntVector left;       /// Slot of the left child of a dependent node.
+    UInt nv;               /// Number of variable slots.
+    std::vector<OpCode> op;/// OpCode of each dependent node.
+    UInt out;              /// Slot of the output node.
+    UIntVector right;      /// Slot of the right child of a dependent node.
+    UInt refs;             /// Number of graphs that use this tape.
+    FunctionType type;     /// Type of the function.
+    DoubleVector vals;     /// Values of all slots. Only constants are set.
+  };
+
+  /// The tape. It may be shared with other graphs.
+  Tape_ *tape_;
+
+  /**
+   * True if the nodes of this graph have not been created. Such a graph is
+   * a clone that shares the tape of another graph. Its nodes are created
+   * from the tape by makeNodes_() when a function needs them. Until then
+   * varNode_, vq_, dq_ and aNodes_ are empty.
+   */
+  bool lazy_;
+
+  /**
+   * Variable of each variable slot, in the order of the slots. A slot
+   * reads the value of its variable at the index the variable has at the
+   * time of evaluation, since the variables may be renumbered, e.g. by
+   * Problem::delMarkedVars(), after the tape is built.
+   */
+  VarVector sVars_;
+
+  /// Graph from which the values of the nodes are copied, or NULL.
+  CGraph *shared_;
+
+  /// Graphs that copy the values of their nodes from this graph.
+  std::vector<CGraph *> shGraphs_;
+
+  /// True if the last evaluation of this graph had no errors.
+  bool shOk_;
+
+  /// Slot in shared_ of each variable and dependent slot of this graph.
+  UIntVector shSlots_;
+
+  /// Per-slot flag: true if the slot depends on the current hessian column.
+  std::vector<unsigned char> tDep_;
+
+  /// Per-slot derivative of the output (reverse mode).
+  DoubleVector tG_;
+
+  /// Per-slot derivative w.r.t. one variable (forward mode).
+  DoubleVector tGi_;
+
+  /// Per-slot second order adjoint (one column of the hessian).
+  DoubleVector tH_;
+
+  /// Per-slot function value.
+  DoubleVector tVal_;
+
+  /// Tape slot of the variable for each entry in hInds_.
+  UIntVector hSlots_;
+
+  /**
+   * Hessian by coloring. The variable slots of color c are
+   * hCSeeds_[hCSeedB_[c]] to hCSeeds_[hCSeedB_[c+1]-1]. One sweep with all
+   * of them as seeds gives the entries hCEnt_[hCEntB_[c]] to
+   * hCEnt_[hCEntB_[c+1]-1] of hInds_, whose values are read from tH_ at
+   * slots hCRow_. Empty if the hessian is found one variable at a time.
+   */
+  UIntVector hCEnt_;
+  UIntVector hCEntB_;
+  UIntVector hCRow_;
+  UIntVector hCSeeds_;
+  UIntVector hCSeedB_;
+
+  /**
+   * Values and derivatives for a block of points in batch evaluation. The
+   * entry for point p of slot s is at s*kb+p, where kb is the number of
+   * points in the block.
+   */
+  DoubleVector bG_;
+  DoubleVector bVal_;
+
   CGraphPtr clone_(int *err) const;
 
+  /**
+   * Return a clone that shares the tape of this graph and has variables
+   * vbeg+i in place of the variables of index i. Return NULL if the tape
+   * can not be shared, e.g. if the graph changed since its hessian
+   * sparsity was found.
+   */
+  CGraphPtr cloneLazy_(VariableConstIterator vbeg) const;
+
+  /**
+   * Find a star coloring of the variable slots from the hessian sparsity in
+   * hInds_ and hSlots_, and fill hCEnt_, hCEntB_, hCRow_, hCSeeds_ and
+   * hCSeedB_. They are left empty if the coloring does not need fewer
+   * sweeps than one sweep per variable.
+   */
+  void colorHess_();
+
+  /**
+   * Copy the values of the slots from shared_ if it was evaluated at the
+   * same values of the variables as in x. Return true if copied.
+   */
+  bool copyShared_(const double *x);
+
+  /// Build the tape from dq_, vq_ and varNode_.
+  void compileTape_();
+
+  /// Evaluate all slots of the tape at x.
+  void evalTape_(const double *x, int *error);
+
+  /// Evaluate all slots of the tape at kb points stored in x (stride n).
+  void evalTapeBatch_(UInt kb, UInt n, const double *x, int *error);
+
+  /// Reverse mode gradient over the tape. Call after evalTape_().
+  void gradTape_(int *error);
+
+  /// Reverse mode gradient for kb points. Call after evalTapeBatch_().
+  void gradTapeBatch_(UInt kb, int *error);
+
+  /**
+   * Forward mode derivative in the direction of the sum of the variables in
+   * slots sb to se-1, followed by a reverse sweep of second order adjoints.
+   * Call after gradTape_(). The product of the hessian and the direction is
+   * left in tH_.
+   */
+  void hessTape_(const UInt *sb, const UInt *se, int *error);
+
   void fwdGrad_(CNode *node);
   void fwdGrad2_(std::stack<CNode *> *st2, CNode *node);
 
   void fillHessInds_(CNode *node, UIntQ *inds);
   void fillHessInds2_(CNode *node, UIntQ *inds);
 
+  /**
+   * Allocate the per-slot values and derivatives of this graph if they have
+   * not been allocated since the tape was built.
+   */
+  void initSlots_();
+
   /// Recursive function to check whether CGraph represents a sum of squares.
   bool isSOSRec_(CNode *node) const;
 
+  /**
+   * Create the nodes of a lazy graph from its tape, after which the graph
+   * has a tape of its own. Does nothing if the graph is not lazy.
+   */
+  void makeNodes_() const;
+
+  /// Stop using tape_, and delete it if no other graph uses it.
+  void releaseTape_();
+
   void revHess_(int *error);
   void revHess2_(std::stack<CNode *> *st2, double mult, UInt vind,
                  double *values, UInt *nz, int *error);
@@ -255,11 +442,20 @@ private:
    */
   void grad_(int *error);
 
+  /**
+   * Fill slots with the slot of the variable of each entry in hInds_,
+   * found from the indices the variables have now.
+   */
+  void setHessSlots_(UIntVector *slots) const;
+
   void setupHess_(VariablePtr v, CNode *node, std::set<ConstVariablePair, 
                   CompareVariablePair> & vps);
 
   void simplifyDq_();
 
+  /// Stop copying values from shared_ and from this graph.
+  void unshare_();
+
 };
 }
 #endif
@@ -24,7 +24,6 @@
 
 #define PI 3.141592653589793
 #define MINFTY 1e25
-#define DIV_BY_ZERO_TOL 1e-12
 
 
 using namespace Minotaur;
@@ -18,6 +18,10 @@
 #include "OpCode.h"
 #include "Types.h"
 
+// a divisor smaller than this in absolute value is treated as zero when
+// evaluating a node or its derivatives.
+#define DIV_BY_ZERO_TOL 1e-12
+
 namespace Minotaur {
 
 class CNode;
@@ -38,11 +38,16 @@ using namespace Minotaur;
 
 # define DEBUG_LEVEL -1
 
-CoverCutGenerator::CoverCutGenerator() {}
+CoverCutGenerator::CoverCutGenerator()
+  : stats_(0),
+    sentIndex_(0)
+{
+}
 
 // Currently unused, probably removed later.
 CoverCutGenerator::CoverCutGenerator(ProblemPtr , SolutionPtr , EnvPtr )
-// : stats_(0)
+  : stats_(0),
+    sentIndex_(0)
 {
   // Check if initialization is successful.
   //bool successinit = false;
@@ -53,7 +58,7 @@ CoverCutGenerator::CoverCutGenerator(ProblemPtr , SolutionPtr , EnvPtr )
 }
 
 CoverCutGenerator::CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, EnvPtr env)
-// : stats_(0)
+  : sentIndex_(0)
 {
   //ProblemPtr p;
   //p = rel;
@@ -65,6 +70,15 @@ CoverCutGenerator::CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, En
   }
 }
 
+CoverCutGenerator::CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol,
+                                     EnvPtr env, CoverCutIndexPtr sent)
+  : sentIndex_(sent)
+{
+  if (initialize(rel, sol, env)) {
+    generateAllCuts();
+  }
+}
+
 CoverCutGenerator::~CoverCutGenerator()
 {
   // deallocate heap.
@@ -662,71 +676,68 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
   // Number of variables.
   UInt n = obj->size();
   // Objective functions coefficients.
-  double * c = new double[n];
+  liftC_.resize(n);
   CoverSetConstIterator it;
   CoverSetConstIterator begin = obj->begin();
   CoverSetConstIterator end   = obj->end();
   UInt i = 0;
   for (it=begin; it!=end; ++it) {
-    c[i] = it->second;
+    liftC_[i] = it->second;
     i += 1;
   }
   
   // Constraint Coefficients.
-  double * a = new double[n];
+  liftA_.resize(n);
   CoverSetConstIterator itCoef;
   CoverSetConstIterator beginCoef = constraint->begin();
   CoverSetConstIterator endCoef   = constraint->end();
   i = 0;
   for (itCoef=beginCoef; itCoef!=endCoef; ++itCoef) {
-    a[i] = itCoef->second;
+    liftA_[i] = itCoef->second;
     i += 1;
   }
-  
-  // First I have to order variables suitable for knapsack solver!!!.
-  double * temp = new double[n];
-  for(i = 0; i < n; ++i) {
-    if (a[i] != 0) {
-      temp[i] = c[i]/a[i];
-    } else {
-      temp[i] = 0;
-    }
-  }
- 
-  std::vector<id> ordered;
-  for (i = 0; i < n; ++i) {
-    ordered.push_back(id(i,temp[i]));
-  }
-  // order the vector
-  // This can be made more efficient.
-  CompareIntDouble compare;
-  sort(ordered.begin(), ordered.end(), compare);
-  double * tempa = new double[n];
-  double * tempc = new double[n];
-
-  for (i = 0; i<n; ++i) {
-    // The index of variable in initial a and c vectors.
-    int index = ordered[i].first;
-    tempa[i] = a[index];
-    tempc[i] = c[index];
+
+  // Rhs value of constraint: (b-a_i) where a_i is the variable to lift up,
+  // (b+a_i) where it is the variable to lift down.
+  double b;
+  if (uplift == true) {
+    b = initialb - variable->second;
+  } else {
+    b = initialb + variable->second;
   }
-  // Now, we do not need a and c since we sopied them into tempa and tempc.
-  delete [] a;
-  delete [] c;
-  a = tempa;
-  c = tempc;
 
   // Solution.
   double gamma = 0.0;
 
-  // Solution vector.
-  int * x = new int[n];
+  // Coefficients of the lifting problem are usually integral, then it is
+  // solved by dynamic programming. Otherwise, use the branch-and-bound
+  // solver, which needs the variables ordered by c_i/a_i.
+  if (false == dpKnapsackSolver(n, b, liftC_.data(), liftA_.data(),
+                                gamma)) {
+    liftOrd_.clear();
+    for (i = 0; i < n; ++i) {
+      if (liftA_[i] != 0) {
+        liftOrd_.push_back(id(i, liftC_[i]/liftA_[i]));
+      } else {
+        liftOrd_.push_back(id(i, 0.0));
+      }
+    }
+    CompareIntDouble compare;
+    sort(liftOrd_.begin(), liftOrd_.end(), compare);
+    liftSC_.resize(n);
+    liftSA_.resize(n);
+    for (i = 0; i<n; ++i) {
+      // The index of variable in initial a and c vectors.
+      int index = liftOrd_[i].first;
+      liftSA_[i] = liftA_[index];
+      liftSC_[i] = liftC_[index];
+    }
+    liftX_.resize(n);
+    binaryKnapsackSolver(n, b, liftSC_.data(), liftSA_.data(), gamma,
+                         liftX_.data());
+  }
 
-  // Rhs value of constraint (b-a_i) where a_i is the variable to lift up.
   if (uplift == true) {
-    double b = initialb - variable->second;
-    // Solve binary knapsack solver.
-    binaryKnapsackSolver(n,b,c,a,gamma,x);    
     // Alpha is obtained.
     double alpha = rhs-gamma;   
     // No need to update rhs of inequality for up-ifting.
@@ -735,22 +746,11 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
     if (DEBUG_LEVEL >= 9) {
       printLiftProb(obj,constraint,variable,rhs,initialb,uplift,b,gamma,alpha);
     }
-
-    // Clean-up, deallocate memory.
-    delete [] tempa;
-    delete [] tempc;
-    delete [] temp;
-    delete [] x;
- 
     return alpha;
 
   } else {
     // Order of these statements are important.
 
-    // Rhs value of constraint b.
-    double  b = initialb + variable->second;
-    // Solve binary knapsack solver.
-    binaryKnapsackSolver(n,b,c,a,gamma,x);
     // ksi is obtained.
     double ksi = gamma-rhs;
     // Update rhs of inequality.
@@ -761,15 +761,7 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
     }
     // Update initial bound of constraint.
     initialb += variable->second;
-    
-    // Clean-up, deallocate memory.
-    delete [] tempa;
-    delete [] tempc;
-    delete [] temp;
-    delete [] x;
-  
     return ksi;
-  
   } 
 }
 
@@ -931,6 +923,10 @@ bool CoverCutGenerator::addCut(CoverSetPtr cov, double rhs, UInt cuttype)
   if (cutexists == false) {
     CutPtr cut = generateCut(cov, rhs);
     addCut(cut);
+    // Violated cuts are sent to the cut manager.
+    if (sentIndex_ && !violatedCuts_.empty() && violatedCuts_.back()==cut) {
+      sentIndex_->insert(cov, rhs);
+    }
     // Increment the number of cuts for the type of cut generated.
     stats_->cuts += 1;
     switch(cuttype) {
@@ -962,48 +958,11 @@ bool CoverCutGenerator::addCut(CoverSetPtr cov, double rhs, UInt cuttype)
 // This may cause a problem at the higher level when we check duplicacy in Cut manager.
 bool CoverCutGenerator::checkExists(CoverSetPtr cov, double rhs)
 {
-  // Iterators for variables in cut.
-  CoverSetIterator it;
-  CoverSetIterator begin = cov->begin();
-  CoverSetIterator end = cov->end();
-  // Number of variables in the linear function.
-  UInt numvars = p_->getNumVars();
-  // Vector to include the coefficients.
-  std::vector<double> coeffs(numvars,0);
-  // Index of the variable in the problem.
-  UInt index;
-  // Current variable considered.
-  VariablePtr var;
-  // Coefficient divided by rhs of cover inequality.
-  double dividedcoeff;
-  // Add the coefficients to coefficient vector one by one.
-  if (DEBUG_LEVEL >= 10) {
-    cerr << "Coeffs: ";
-  }
-  for (it=begin; it!=end; ++it) {
-    var = it->first;
-    index  = var->getIndex();
-    // Serdar check this int, what it does, probably it should not be here.
-    dividedcoeff = double(it->second) / rhs;
-    coeffs[index] = dividedcoeff;
-    if (DEBUG_LEVEL >=  10) {
-      cerr << dividedcoeff << " ";
-    } 
-  }
-  if (DEBUG_LEVEL >= 10) {
-    cerr << endl;
-  }
-
-  // Check if the cut already exists.
-  std::map< std::vector<double>, UInt>::iterator found = cutmap.find(coeffs);
-  std::map< std::vector<double>, UInt>::iterator endmap = cutmap.end();
-  if (found == endmap) {
-    cutmap.insert(std::pair< std::vector<double>, UInt > (coeffs,stats_->totalcuts));
-    return false;
-  } else {
+  if (sentIndex_ && sentIndex_->find(cov, rhs)) {
     return true;
   }
-
+  // Check if the cut already exists, add it otherwise.
+  return (false == cutIndex_.insert(cov, rhs));
 }
 
 
@@ -1353,15 +1312,16 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
 {
   // Set the solution as a vector of zeros. // change this to memset.
   memset(x, 0, (n)*sizeof(int));
-  // Current solution vector.
-  UInt * xhat = new UInt[n+1];
-  // Set the solution as a vector of zeros.
-  memset(xhat,0,(n+1)*sizeof(int));
+  // Current solution vector, set as a vector of zeros.
+  knapXhat_.assign(n+1, 0);
+  UInt * xhat = knapXhat_.data();
   UInt j = 0;
  
   // set up: adding extra elements
-  double * cIn = new double[n+2];
-  double * aIn = new double[n+2];
+  knapCIn_.resize(n+2);
+  knapAIn_.resize(n+2);
+  double * cIn = knapCIn_.data();
+  double * aIn = knapAIn_.data();
   UInt ii = 0;
   for (ii=1; ii<n+1; ii++) {
     cIn[ii]=c[ii-1];
@@ -1438,11 +1398,6 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
     }
     // "if (no such i exists) return;"
     if (i==0) {
-      // clean up, deallocate memory.
-      delete [] cIn;
-      delete [] aIn;
-      delete [] xhat;
-
       return 1;
     }
     bhat += aIn[i];
@@ -1454,6 +1409,47 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
 
 }
 
+bool CoverCutGenerator::dpKnapsackSolver(UInt n, double b,
+                                         double const * c, double const * a,
+                                         double & z)
+{
+  // Largest table, n times capacity, solved by dynamic programming.
+  const double maxcells = 1e6;
+  // Same tolerance on the capacity as binaryKnapsackSolver.
+  double cap = floor(b+0.000001);
+
+  if (cap < 0.0 || (double) n*(cap+1.0) > maxcells) {
+    return false;
+  }
+  for (UInt i=0; i<n; ++i) {
+    if (a[i] < 0.0 || fabs(a[i]-floor(a[i]+0.5)) > 1e-9) {
+      return false;
+    }
+  }
+
+  // knapDp_[w] is the best objective value with capacity w.
+  UInt m = (UInt) cap;
+  knapDp_.assign(m+1, 0.0);
+  double * f = knapDp_.data();
+  for (UInt i=0; i<n; ++i) {
+    UInt w = (UInt) floor(a[i]+0.5);
+    if (c[i] <= 0.0 || w > m) {
+      continue;
+    }
+    for (UInt k=m; k>=w; --k) {
+      if (f[k-w]+c[i] > f[k]) {
+        f[k] = f[k-w]+c[i];
+      }
+      if (k==0) {
+        break;
+      }
+    }
+  }
+  z = f[m];
+  return true;
+}
+
+
 /* This function evaluates the function of the cut given for the solution
  * given. Then, it calculates the violation to the lower bound and upper bound
  * of the constraint. 
@@ -20,6 +20,7 @@ using std::ofstream;
 #include <string>
 using std::string;
 
+#include "CoverCutIndex.h"
 #include "KnapsackList.h"
 #include "Problem.h"
 #include "Solution.h"
@@ -95,6 +96,11 @@ namespace Minotaur {
     // Constructor that uses a relaxation and a solution given.
     CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, EnvPtr env);
 
+    // Constructor that also skips the cuts in index sent, which are the
+    // cuts sent to the cut manager earlier. Violated cuts are added to it.
+    CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, EnvPtr env,
+                      CoverCutIndexPtr sent);
+
     // Destructor
     ~CoverCutGenerator();
 
@@ -267,6 +273,13 @@ namespace Minotaur {
     UInt binaryKnapsackSolver(UInt n, double b, double const * c,
                               double const *a, double & z, int * x);
 
+    // Solves the binary knapsack problem by dynamic programming over the
+    // capacity when all a are nonnegative integers. The items need not be
+    // sorted. Only the optimal value z is found. Returns false, without
+    // solving, if a is not integral or the table is too large.
+    bool dpKnapsackSolver(UInt n, double b, double const * c,
+                          double const * a, double & z);
+
     // Calculates the violation for the given cut.
     double violation(CutPtr cut);
 
@@ -355,8 +368,11 @@ namespace Minotaur {
     // Statistics for cover cut generator.
     CovCutGenStatsPtr stats_;
 
-    // Hash map that is used to check if a cut is already created or not.
-    std::map< std::vector<double>, UInt> cutmap;  
+    // Index that is used to check if a cut is already created or not.
+    CoverCutIndex cutIndex_;
+
+    // Index of cuts sent to the cut manager earlier, or NULL. Not owned.
+    CoverCutIndexPtr sentIndex_;
 
     // Integer tolerance.
     double intTol_;
@@ -369,6 +385,22 @@ namespace Minotaur {
 
     // Output file name
     string  outfile_;
+
+    // Scratch space of lift(), reused so that lifting does not allocate.
+    // Objective and constraint coefficients, their copies sorted by ratio,
+    // the order and the solution of the knapsack solver.
+    DoubleVector liftC_;
+    DoubleVector liftA_;
+    DoubleVector liftSC_;
+    DoubleVector liftSA_;
+    std::vector<id> liftOrd_;
+    std::vector<int> liftX_;
+
+    // Scratch space of binaryKnapsackSolver() and dpKnapsackSolver().
+    DoubleVector knapCIn_;
+    DoubleVector knapAIn_;
+    std::vector<UInt> knapXhat_;
+    DoubleVector knapDp_;
   };
 }
 
@@ -0,0 +1,115 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file CoverCutIndex.cpp
+ * \brief Define class CoverCutIndex for finding cover cuts that were
+ * generated before.
+ */
+
+#include <algorithm>
+#include <functional>
+
+#include "MinotaurConfig.h"
+#include "CoverCutIndex.h"
+#include "Variable.h"
+
+using namespace Minotaur;
+
+CoverCutIndex::CoverCutIndex()
+{
+}
+
+
+CoverCutIndex::~CoverCutIndex()
+{
+  keys_.clear();
+}
+
+
+void CoverCutIndex::clear()
+{
+  keys_.clear();
+}
+
+
+bool CoverCutIndex::find(ConstCoverSetPtr cov, double rhs) const
+{
+  Key_ key;
+
+  getKey_(cov, rhs, key);
+  return (keys_.find(key)!=keys_.end());
+}
+
+
+void CoverCutIndex::getKey_(ConstCoverSetPtr cov, double rhs, Key_ &key)
+  const
+{
+  UInt j = 0;
+
+  key.clear();
+  key.reserve(cov->size());
+  for (CoverSetConstIterator it=cov->begin(); it!=cov->end(); ++it) {
+    key.push_back(std::make_pair(it->first->getIndex(), it->second/rhs));
+  }
+
+  // if a variable appears more than once, its last coefficient is used.
+  // Variables with zero coefficients are not in the signature.
+  std::stable_sort(key.begin(), key.end(),
+                   [](const std::pair<UInt, double> &a,
+                      const std::pair<UInt, double> &b)
+                   { return a.first < b.first; });
+  for (UInt i=0; i<key.size(); ++i) {
+    if (i+1<key.size() && key[i+1].first==key[i].first) {
+      continue;
+    }
+    if (key[i].second!=0.0) {
+      key[j] = key[i];
+      ++j;
+    }
+  }
+  key.resize(j);
+}
+
+
+UInt CoverCutIndex::getSize() const
+{
+  return keys_.size();
+}
+
+
+bool CoverCutIndex::insert(ConstCoverSetPtr cov, double rhs)
+{
+  Key_ key;
+
+  getKey_(cov, rhs, key);
+  return keys_.insert(key).second;
+}
+
+
+size_t CoverCutIndex::KeyHash_::operator()(const Key_ &key) const
+{
+  size_t h = key.size();
+  std::hash<double> dhash;
+
+  for (Key_::const_iterator it=key.begin(); it!=key.end(); ++it) {
+    h ^= (size_t) it->first + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= dhash(it->second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
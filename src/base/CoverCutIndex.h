@@ -0,0 +1,89 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file CoverCutIndex.h
+ * \brief Declare class CoverCutIndex for finding cover cuts that were
+ * generated before.
+ */
+
+
+#ifndef MINOTAURCOVERCUTINDEX_H
+#define MINOTAURCOVERCUTINDEX_H
+
+#include <unordered_set>
+#include "Types.h"
+
+namespace Minotaur {
+
+/**
+ * \brief Index of cover cuts, used to find duplicates.
+ *
+ * A cut \f$ \sum_j a_jx_j \leq b \f$ is saved as its signature: the pairs
+ * \f$ (j, a_j/b) \f$ with \f$ a_j \neq 0 \f$, sorted by the index j of the
+ * variable. Two cuts are duplicates if their signatures are equal. The
+ * size of a signature is the number of variables in the cut, not in the
+ * problem, and signatures are found through a hash.
+ *
+ * The index is used by CoverCutGenerator and LGCIGenerator. KnapCovHandler
+ * keeps one index for all calls to separate(), so that a cut already sent
+ * to the cut manager is not generated again, unless the cut manager finds
+ * duplicates itself (see CutManager::findsDuplicates()).
+ */
+class CoverCutIndex {
+public:
+  /// Construct an empty index.
+  CoverCutIndex();
+
+  /// Destroy.
+  ~CoverCutIndex();
+
+  /// Remove all cuts.
+  void clear();
+
+  /// Return true if the cut of cover cov and rhs is in the index.
+  bool find(ConstCoverSetPtr cov, double rhs) const;
+
+  /// Return the number of cuts in the index.
+  UInt getSize() const;
+
+  /**
+   * \brief Add the cut of cover cov and rhs to the index.
+   *
+   * \return True if the cut was added, false if it was already in the
+   * index.
+   */
+  bool insert(ConstCoverSetPtr cov, double rhs);
+
+private:
+  /// Signature of a cut.
+  typedef std::vector<std::pair<UInt, double> > Key_;
+
+  /// Hash of a signature.
+  struct KeyHash_ {
+    size_t operator()(const Key_ &key) const;
+  };
+
+  /// Signatures of the cuts in the index.
+  std::unordered_set<Key_, KeyHash_> keys_;
+
+  /// Fill key with the signature of the cut of cover cov and rhs.
+  void getKey_(ConstCoverSetPtr cov, double rhs, Key_ &key) const;
+};
+typedef CoverCutIndex* CoverCutIndexPtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
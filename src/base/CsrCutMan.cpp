@@ -0,0 +1,567 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file CsrCutMan.cpp
+ * \brief Implement the methods of CsrCutMan class.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "MinotaurConfig.h"
+#include "Constraint.h"
+#include "CsrCutMan.h"
+#include "Cut.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Logger.h"
+#include "Option.h"
+#include "Problem.h"
+#include "Solution.h"
+#include "Timer.h"
+#include "Types.h"
+#include "Variable.h"
+
+//#define SPEW 1
+
+using namespace Minotaur;
+
+const std::string CsrCutMan::me_ = "CsrCutMan: ";
+const UInt CsrCutMan::noHash_ = UINT_MAX;
+
+
+CsrCutMan::CsrCutMan(EnvPtr env, ProblemPtr p)
+  : env_(env),
+    maxPoolAge_(100),
+    maxInactive_(10),
+    minParNnz_(10000),
+    p_(p),
+    threads_(1),
+    violAbs_(1e-4),
+    violRel_(1e-3)
+{
+  int t = env->getOptions()->findInt("cut_pool_threads")->getValue();
+
+  logger_ = env->getLogger();
+  timer_ = env->getNewTimer();
+  hash_ = (CutHashPtr) new CutHash(1e-4);
+  hash_->setVarBounds(p);
+  if (t>1) {
+    threads_ = t;
+  }
+  start_.push_back(0);
+
+  stats_.scans = 0;
+  stats_.toPool = 0;
+  stats_.toRel = 0;
+  stats_.fromRel = 0;
+  stats_.dropped = 0;
+  stats_.checked = 0;
+  stats_.dups = 0;
+  stats_.merged = 0;
+  stats_.parallel = 0;
+  stats_.time = 0.0;
+}
+
+
+CsrCutMan::~CsrCutMan()
+{
+  delete timer_;
+  delete hash_;
+  nlCuts_.clear();
+  rel_.clear();
+}
+
+
+void CsrCutMan::addCut(CutPtr c)
+{
+  FunctionPtr f = c->getFunction();
+  LinearFunctionPtr lf;
+  UInt hid;
+
+  if (!f || f->getQuadraticFunction() || f->getNonlinearFunction()) {
+    nlCuts_.push_back(c);
+    return;
+  }
+  lf = f->getLinearFunction();
+  if (lf && isRedundant_(p_, lf, c->getLb(), c->getUb(), false, 0)) {
+    return;
+  }
+  hid = lf ? hashCut_(lf, c->getLb(), c->getUb()) : noHash_;
+  addRow_(f, c->getLb(), c->getUb(), c->getInfo()->neverDelete, hid);
+  ++(stats_.toPool);
+}
+
+
+ConstraintPtr CsrCutMan::addCut(ProblemPtr p, FunctionPtr f, double lb,
+                                double ub, bool direct_to_rel, bool never_del)
+{
+  LinearFunctionPtr lf;
+  ConstraintPtr c = ConstraintPtr();
+  RelCut rc;
+  UInt hid = noHash_;
+
+  if (f && !f->getQuadraticFunction() && !f->getNonlinearFunction()) {
+    lf = f->getLinearFunction();
+    if (lf) {
+      if (isRedundant_(p, lf, lb, ub, direct_to_rel, &c)) {
+        delete f;
+        return c;
+      }
+      hid = hashCut_(lf, lb, ub);
+    }
+  }
+
+  if (direct_to_rel || false==addRow_(f, lb, ub, never_del, hid)) {
+    rc.c = p->newConstraint(f, lb, ub);
+    rc.hid = hid;
+    rc.cntSinceActive = 0;
+    rc.neverDel = never_del;
+    rc.neverDisable = false;
+    rel_.push_back(rc);
+    if (hid!=noHash_) {
+      hidCon_[hid] = rc.c;
+    }
+    return rc.c;
+  }
+  // the row has been copied. f is not needed anymore.
+  ++(stats_.toPool);
+  delete f;
+  return ConstraintPtr();
+}
+
+
+void CsrCutMan::addCutToPool(CutPtr c)
+{
+  addCut(c);
+}
+
+
+void CsrCutMan::addCuts(CutVectorIter cbeg, CutVectorIter cend)
+{
+  for (CutVectorIter it=cbeg; it!=cend; ++it) {
+    addCut(*it);
+  }
+}
+
+
+bool CsrCutMan::addRow_(FunctionPtr f, double lb, double ub, bool never_del,
+                        UInt hid)
+{
+  LinearFunctionPtr lf;
+
+  if (!f || f->getQuadraticFunction() || f->getNonlinearFunction()) {
+    return false;
+  }
+  lf = f->getLinearFunction();
+  if (lf) {
+    std::vector<std::pair<UInt, double> > row;
+    row.reserve(lf->getNumTerms());
+    for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
+         ++it) {
+      row.push_back(std::make_pair(it->first->getIndex(), it->second));
+    }
+    // sorted indices make the reads of x in findActivities_ go forward.
+    std::sort(row.begin(), row.end());
+    for (UInt k=0; k<row.size(); ++k) {
+      ind_.push_back(row[k].first);
+      val_.push_back(row[k].second);
+    }
+  }
+  start_.push_back(ind_.size());
+  lb_.push_back(lb);
+  ub_.push_back(ub);
+  age_.push_back(0);
+  neverDel_.push_back(never_del ? 1 : 0);
+  hid_.push_back(hid);
+  if (hid!=noHash_) {
+    hidRow_[hid] = lb_.size()-1;
+    hidCon_[hid] = ConstraintPtr();
+  }
+#if SPEW
+  logger_->msgStream(LogDebug) << me_ << "added row with "
+                               << start_[lb_.size()]-start_[lb_.size()-1]
+                               << " nonzeros to pool" << std::endl;
+#endif
+  return true;
+}
+
+
+ConstraintPtr CsrCutMan::addToRel_(ProblemPtr p, UInt i, UInt beg, UInt end)
+{
+  LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+  FunctionPtr f;
+  RelCut rc;
+
+  for (UInt k=beg; k<end; ++k) {
+    lf->addTerm(p->getVariable(ind_[k]), val_[k]);
+  }
+  f = (FunctionPtr) new Function(lf);
+  rc.c = p->newConstraint(f, lb_[i], ub_[i]);
+  rc.hid = hid_[i];
+  if (rc.hid!=noHash_) {
+    hidRow_[rc.hid] = -1;
+    hidCon_[rc.hid] = rc.c;
+  }
+  rc.cntSinceActive = 0;
+  rc.neverDel = (neverDel_[i]!=0);
+  rc.neverDisable = false;
+  rel_.push_back(rc);
+  ++(stats_.toRel);
+  return rc.c;
+}
+
+
+void CsrCutMan::findActivities_(const double *x)
+{
+  const int m = lb_.size();
+  const UInt *start = &start_[0];
+  const UInt *ind = ind_.empty() ? 0 : &ind_[0];
+  const double *val = val_.empty() ? 0 : &val_[0];
+  double *act;
+
+  act_.resize(m);
+  act = act_.empty() ? 0 : &act_[0];
+
+#if USE_OPENMP
+#pragma omp parallel for num_threads(threads_) schedule(static) \
+  if (threads_>1 && ind_.size()>=minParNnz_)
+#endif
+  for (int i=0; i<m; ++i) {
+    const UInt end = start[i+1];
+    double s = 0.0;
+#if USE_OPENMP
+#pragma omp simd reduction(+:s)
+#endif
+    for (UInt k=start[i]; k<end; ++k) {
+      s += val[k]*x[ind[k]];
+    }
+    act[i] = s;
+  }
+}
+
+
+UInt CsrCutMan::hashCut_(LinearFunctionPtr lf, double lb, double ub)
+{
+  UInt hid = hash_->insert(lf, lb, ub);
+
+  if (hidRow_.size()<=hid) {
+    hidRow_.resize(hid+1, -1);
+    hidCon_.resize(hid+1, ConstraintPtr());
+  }
+  hidRow_[hid] = -1;
+  hidCon_[hid] = ConstraintPtr();
+  return hid;
+}
+
+
+bool CsrCutMan::isRedundant_(ProblemPtr p, LinearFunctionPtr lf, double lb,
+                             double ub, bool to_rel, ConstraintPtr *c)
+{
+  CutHashMatch match;
+  CutHashStatus status;
+  int row;
+
+  ++(stats_.checked);
+  status = hash_->find(lf, lb, ub, &match);
+  if (CutHashNew==status) {
+    return false;
+  }
+
+  row = hidRow_[match.id];
+  if (row<0 && (!p || !hidCon_[match.id])) {
+    return false;
+  }
+  if (row<0 && match.tighter) {
+    p->changeBound(hidCon_[match.id], match.isUb ? Upper : Lower,
+                   match.bnd);
+  } else if (match.tighter) {
+    if (match.isUb) {
+      ub_[row] = match.bnd;
+    } else {
+      lb_[row] = match.bnd;
+    }
+  }
+  if (match.tighter) {
+    hash_->tighten(match);
+    ++(stats_.merged);
+  } else if (CutHashParallel==status) {
+    ++(stats_.parallel);
+  } else {
+    ++(stats_.dups);
+  }
+
+  // the cut was meant for the problem: move the row of the pool there.
+  if (row>=0 && to_rel && p) {
+    addToRel_(p, row, start_[row], start_[row+1]);
+    removeRow_(row);
+  }
+  if (c) {
+    *c = hidCon_[match.id];
+  }
+  return true;
+}
+
+
+bool CsrCutMan::findsDuplicates() const
+{
+  return true;
+}
+
+
+UInt CsrCutMan::getNumCuts() const
+{
+  return getNumEnabledCuts() + getNumDisabledCuts();
+}
+
+
+UInt CsrCutMan::getNumEnabledCuts() const
+{
+  return rel_.size();
+}
+
+
+UInt CsrCutMan::getNumDisabledCuts() const
+{
+  return lb_.size() + nlCuts_.size();
+}
+
+
+UInt CsrCutMan::getNumNewCuts() const
+{
+  return 0;
+}
+
+
+std::vector<ConstraintPtr> CsrCutMan::getPoolCons()
+{
+  std::vector<ConstraintPtr> cons;
+
+  cons.reserve(rel_.size());
+  for (std::list<RelCut>::const_iterator it=rel_.begin(); it!=rel_.end();
+       ++it) {
+    cons.push_back(it->c);
+  }
+  return cons;
+}
+
+
+void CsrCutMan::postSolveUpdate(ConstSolutionPtr, EngineStatus)
+{
+}
+
+
+void CsrCutMan::removeRow_(UInt i)
+{
+  const UInt beg = start_[i];
+  const UInt nz = start_[i+1]-beg;
+
+  ind_.erase(ind_.begin()+beg, ind_.begin()+beg+nz);
+  val_.erase(val_.begin()+beg, val_.begin()+beg+nz);
+  start_.erase(start_.begin()+i+1);
+  for (UInt k=i+1; k<start_.size(); ++k) {
+    start_[k] -= nz;
+  }
+  lb_.erase(lb_.begin()+i);
+  ub_.erase(ub_.begin()+i);
+  age_.erase(age_.begin()+i);
+  neverDel_.erase(neverDel_.begin()+i);
+  hid_.erase(hid_.begin()+i);
+  for (UInt k=i; k<hid_.size(); ++k) {
+    if (hid_[k]!=noHash_) {
+      hidRow_[hid_[k]] = k;
+    }
+  }
+}
+
+
+void CsrCutMan::separate(ProblemPtr p, ConstSolutionPtr sol, bool *separated,
+                         UInt *n_added)
+{
+  UInt added = sepPool_(p, sol->getPrimal());
+
+  if (separated) {
+    *separated = (added>0);
+  }
+  if (n_added) {
+    *n_added = added;
+  }
+}
+
+
+UInt CsrCutMan::sepPool_(ProblemPtr p, const double *x)
+{
+  const UInt m = lb_.size();
+  UInt added = 0;
+  UInt w = 0;      // rows kept so far.
+  UInt wnz = 0;    // nonzeros kept so far.
+  UInt beg, end = start_[0];
+  double act, viol;
+  int err;
+
+  timer_->start();
+  ++(stats_.scans);
+  findActivities_(x);
+
+  // add violated rows to p, and move the rows that stay to the front.
+  for (UInt i=0; i<m; ++i) {
+    // start_[i] may have been overwritten already, start_[i+1] not yet.
+    beg = end;
+    end = start_[i+1];
+    viol = std::max(lb_[i]-act_[i], act_[i]-ub_[i]);
+    if (viol > violAbs_ + violRel_*fabs(act_[i])) {
+      addToRel_(p, i, beg, end);
+      ++added;
+      continue;
+    }
+    ++(age_[i]);
+    if (age_[i]>maxPoolAge_ && 0==neverDel_[i]) {
+      if (hid_[i]!=noHash_) {
+        hidRow_[hid_[i]] = -1;
+        hash_->remove(hid_[i]);
+      }
+      ++(stats_.dropped);
+      continue;
+    }
+    if (w<i) {
+      std::copy(ind_.begin()+beg, ind_.begin()+end, ind_.begin()+wnz);
+      std::copy(val_.begin()+beg, val_.begin()+end, val_.begin()+wnz);
+      lb_[w] = lb_[i];
+      ub_[w] = ub_[i];
+      age_[w] = age_[i];
+      neverDel_[w] = neverDel_[i];
+      hid_[w] = hid_[i];
+      if (hid_[w]!=noHash_) {
+        hidRow_[hid_[w]] = w;
+      }
+      start_[w+1] = wnz + end - beg;
+    }
+    wnz = start_[w+1];
+    ++w;
+  }
+  start_.resize(w+1);
+  ind_.resize(wnz);
+  val_.resize(wnz);
+  lb_.resize(w);
+  ub_.resize(w);
+  age_.resize(w);
+  neverDel_.resize(w);
+  hid_.resize(w);
+
+  // cuts that are not linear.
+  for (std::list<CutPtr>::iterator it=nlCuts_.begin(); it!=nlCuts_.end();) {
+    err = 0;
+    act = (*it)->eval(x, &err);
+    viol = std::max((*it)->getLb()-act, act-(*it)->getUb());
+    if (0==err && viol > violAbs_ + violRel_*fabs(act)) {
+      (*it)->applyToProblem(p);
+      ++(stats_.toRel);
+      ++added;
+      it = nlCuts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  stats_.time += timer_->query();
+  timer_->stop();
+  return added;
+}
+
+
+void CsrCutMan::updatePool(ProblemPtr p, ConstSolutionPtr sol)
+{
+  sepPool_(p, sol->getPrimal());
+}
+
+
+void CsrCutMan::updateRel(ConstSolutionPtr sol, ProblemPtr p)
+{
+  const double *y = sol->getDualOfCons();
+  bool del = false;
+  ConstraintPtr c;
+
+  if (!y) {
+    return;
+  }
+  for (std::list<RelCut>::iterator it=rel_.begin(); it!=rel_.end();) {
+    c = it->c;
+    if (fabs(y[c->getIndex()]) > 1e-6) {
+      it->cntSinceActive = 0;
+    } else {
+      ++(it->cntSinceActive);
+    }
+    if (it->cntSinceActive > maxInactive_ && false==it->neverDisable &&
+        addRow_(c->getFunction(), c->getLb(), c->getUb(), it->neverDel,
+                it->hid)) {
+      ++(stats_.fromRel);
+      p->markDelete(c);
+      del = true;
+      it = rel_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (del) {
+    p->delMarkedCons();
+  }
+}
+
+
+void CsrCutMan::write(std::ostream &out) const
+{
+  out << me_ << "pool has " << lb_.size() << " linear cuts with "
+      << ind_.size() << " nonzeros, " << nlCuts_.size()
+      << " other cuts; " << rel_.size() << " cuts are in the problem."
+      << std::endl;
+}
+
+
+void CsrCutMan::writeStats(std::ostream &out) const
+{
+  out << me_ << "number of checks of pool    = " << stats_.scans << std::endl
+      << me_ << "cuts added to pool          = " << stats_.toPool
+      << std::endl
+      << me_ << "cuts moved pool to problem  = " << stats_.toRel
+      << std::endl
+      << me_ << "cuts moved problem to pool  = " << stats_.fromRel
+      << std::endl
+      << me_ << "cuts deleted from pool      = " << stats_.dropped
+      << std::endl
+      << me_ << "new cuts checked for dups   = " << stats_.checked
+      << std::endl
+      << me_ << "duplicate cuts dropped      = " << stats_.dups
+      << std::endl
+      << me_ << "duplicate cuts merged       = " << stats_.merged
+      << std::endl
+      << me_ << "parallel cuts dropped       = " << stats_.parallel
+      << std::endl
+      << me_ << "duplicate hit rate          = "
+      << (stats_.checked>0 ? (double) (stats_.dups+stats_.merged+
+                                       stats_.parallel)/
+                              stats_.checked : 0.0)
+      << std::endl
+      << me_ << "time in checking pool       = " << stats_.time
+      << std::endl;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,287 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file CsrCutMan.h
+ * \brief Manages addition and deletion of cuts to problem, keeping the
+ * linear cuts of the pool in a sparse matrix.
+ */
+
+
+#ifndef MINOTAURCSRCUTMAN_H
+#define MINOTAURCSRCUTMAN_H
+
+#include <list>
+#include "CutHash.h"
+#include "CutManager.h"
+#include "Types.h"
+
+namespace Minotaur {
+
+class Timer;
+
+struct CsrCutManStats {
+  UInt scans;      ///< Number of times the pool was checked for violations.
+  UInt toPool;     ///< Number of cuts added to the pool.
+  UInt toRel;      ///< Number of cuts moved from the pool to the problem.
+  UInt fromRel;    ///< Number of inactive cuts moved back to the pool.
+  UInt dropped;    ///< Number of cuts deleted from the pool.
+  UInt checked;    ///< Number of new cuts compared with existing cuts.
+  UInt dups;       ///< Number of new cuts dropped as duplicates.
+  UInt merged;     ///< Number of duplicates merged into an existing cut.
+  UInt parallel;   ///< Number of new cuts implied by a nearly parallel cut.
+  double time;     ///< Time spent in checking cuts of the pool.
+};
+
+
+/**
+ * \brief Derived class for managing cuts. Linear cuts of the pool are
+ * stored row-wise in one sparse (CSR) matrix, with their bounds in
+ * contiguous arrays, so that the violations of all of them are found by one
+ * sparse matrix-vector product.
+ *
+ * Violated cuts are added to the problem by separate() or updatePool().
+ * Cuts added by this manager that stay inactive in the problem for
+ * more than a few solves are moved back to the pool by updateRel(). Cuts
+ * that are not linear are kept as they are and checked one at a time.
+ *
+ * Every new linear cut is first looked up in a CutHash. A cut that is an
+ * exact duplicate of an existing cut is dropped; if it is tighter, the
+ * bound of the existing cut is changed instead. If the existing cut is in
+ * the pool and the new one was meant for the problem, the existing cut is
+ * moved to the problem. A cut that is implied by a nearly parallel cut,
+ * within the bounds of the variables when the manager was created, is
+ * dropped in the same way.
+ */
+class CsrCutMan : public CutManager {
+
+public:
+  /**
+   * \brief Default constructor.
+   *
+   * \param [in] env Minotaur Environment pointer.
+   * \param [in] p Problem pointer to which cuts will be added or deleted.
+   */
+  CsrCutMan(EnvPtr env, ProblemPtr p);
+
+  /// Destroy.
+  ~CsrCutMan();
+
+  // Base class method. The cut is copied; c is not deleted or changed.
+  void addCut(CutPtr c);
+
+  // Base class method. The cut is copied; c is not deleted or changed.
+  void addCutToPool(CutPtr c);
+
+  // Base class method.
+  ConstraintPtr addCut(ProblemPtr p, FunctionPtr f, double lb, double ub,
+                       bool direct_to_rel, bool never_del);
+
+  // Base class method.
+  void addCuts(CutVectorIter cbeg, CutVectorIter cend);
+
+  // Base class method.
+  bool findsDuplicates() const;
+
+  // Base class method.
+  UInt getNumCuts() const;
+
+  // Base class method.
+  UInt getNumEnabledCuts() const;
+
+  // Base class method.
+  UInt getNumDisabledCuts() const;
+
+  // Base class method.
+  UInt getNumNewCuts() const;
+
+  /// Return the constraints added to the problem by this manager.
+  std::vector<ConstraintPtr> getPoolCons();
+
+  // Base class method.
+  void postSolveUpdate(ConstSolutionPtr sol, EngineStatus eng_status);
+
+  // Base class method.
+  void separate(ProblemPtr p, ConstSolutionPtr sol, bool *separated,
+                UInt *n_added);
+
+  // Base class method.
+  void updatePool(ProblemPtr p, ConstSolutionPtr sol);
+
+  // Base class method.
+  void updateRel(ConstSolutionPtr sol, ProblemPtr p);
+
+  // Base class method.
+  void write(std::ostream &out) const;
+
+  // Base class method.
+  void writeStats(std::ostream &out) const;
+
+private:
+  /// A cut that was added to the problem by this manager.
+  struct RelCut {
+    ConstraintPtr c;     ///< The constraint in the problem.
+    UInt hid;            ///< Id in hash_, or noHash_.
+    UInt cntSinceActive; ///< Number of solves since its dual was nonzero.
+    bool neverDel;       ///< If true, never delete the cut.
+    bool neverDisable;   ///< If true, never remove the cut from the problem.
+  };
+
+  /// Activities of the rows of the pool at the last point checked.
+  DoubleVector act_;
+
+  /// Age, i.e. the number of checks since the row was last violated.
+  UIntVector age_;
+
+  /// Environment.
+  EnvPtr env_;
+
+  /// Finds duplicate linear cuts.
+  CutHashPtr hash_;
+
+  /// Constraint in the problem of each id of hash_, or NULL.
+  std::vector<ConstraintPtr> hidCon_;
+
+  /// Row in the pool of each id of hash_, or -1.
+  std::vector<int> hidRow_;
+
+  /// Id in hash_ of each row of the pool.
+  UIntVector hid_;
+
+  /// Column indices of the nonzeros of the pool, row after row.
+  UIntVector ind_;
+
+  /// Lower bounds of the rows of the pool.
+  DoubleVector lb_;
+
+  /// For logging.
+  LoggerPtr logger_;
+
+  /// Maximum number of checks a row may stay in the pool without being
+  /// violated.
+  UInt maxPoolAge_;
+
+  /// Maximum number of solves a cut may stay in the problem while
+  /// inactive.
+  UInt maxInactive_;
+
+  /// For logging.
+  const static std::string me_;
+
+  /// If the pool has fewer nonzeros than this, do not use threads.
+  UInt minParNnz_;
+
+  /// Id of a cut that is not in hash_.
+  const static UInt noHash_;
+
+  /// 1 if the row may never be deleted from the pool, 0 otherwise.
+  std::vector<char> neverDel_;
+
+  /// Cuts that are not linear. These are owned by the callers.
+  std::list<CutPtr> nlCuts_;
+
+  /// Problem given to the constructor.
+  ProblemPtr p_;
+
+  /// Cuts added to the problem by this manager.
+  std::list<RelCut> rel_;
+
+  /// Start of each row of the pool in ind_ and val_, and the end of the
+  /// last row.
+  UIntVector start_;
+
+  /// Statistics.
+  CsrCutManStats stats_;
+
+  /// Number of threads used in finding the activities of the rows.
+  UInt threads_;
+
+  /// Timer.
+  Timer *timer_;
+
+  /// Upper bounds of the rows of the pool.
+  DoubleVector ub_;
+
+  /// Coefficients of the nonzeros of the pool, row after row.
+  DoubleVector val_;
+
+  /// Absolute violation above which a cut is added to the problem.
+  double violAbs_;
+
+  /// Relative violation above which a cut is added to the problem.
+  double violRel_;
+
+  /**
+   * \brief Add a row to the pool if f is linear.
+   *
+   * \param [in] f Function of the cut.
+   * \param [in] lb Lower bound of the cut.
+   * \param [in] ub Upper bound of the cut.
+   * \param [in] never_del True if the row must never be deleted.
+   * \param [in] hid Id of the cut in hash_.
+   * \return False if f is not linear, true otherwise.
+   */
+  bool addRow_(FunctionPtr f, double lb, double ub, bool never_del,
+               UInt hid);
+
+  /**
+   * \brief Add the i-th row of the pool to problem p as a new constraint.
+   *
+   * \param [in] p The problem.
+   * \param [in] i Index of the row, used for its bounds.
+   * \param [in] beg Position of the first nonzero of the row in ind_.
+   * \param [in] end Position after the last nonzero of the row in ind_.
+   */
+  ConstraintPtr addToRel_(ProblemPtr p, UInt i, UInt beg, UInt end);
+
+  /// Find activities of all rows of the pool at x.
+  void findActivities_(const double *x);
+
+  /// Store a new linear cut in hash_ and return its id.
+  UInt hashCut_(LinearFunctionPtr lf, double lb, double ub);
+
+  /**
+   * \brief Check if a new linear cut is an exact duplicate of a cut that is
+   * already managed, or is implied by a nearly parallel one. A tighter
+   * duplicate changes the bound of the existing cut. If the existing cut
+   * is a row of the pool and the new cut was meant for the problem, the row
+   * is moved to the problem.
+   *
+   * \param [in] p The problem, used to change the bound of an existing cut
+   * that is in it or to add a row of the pool. May be NULL.
+   * \param [in] to_rel True if the new cut is to be added to p.
+   * \param [out] c If not NULL, the constraint of the existing cut in p, or
+   * NULL if it is in the pool.
+   * \return True if the new cut is not needed.
+   */
+  bool isRedundant_(ProblemPtr p, LinearFunctionPtr lf, double lb,
+                    double ub, bool to_rel, ConstraintPtr *c);
+
+  /// Remove the i-th row from the pool.
+  void removeRow_(UInt i);
+
+  /**
+   * \brief Add violated cuts of the pool to problem p, and remove them and
+   * old rows from the pool.
+   *
+   * \return The number of cuts added to p.
+   */
+  UInt sepPool_(ProblemPtr p, const double *x);
+};
+typedef CsrCutMan* CsrCutManPtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
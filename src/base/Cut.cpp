@@ -20,6 +20,7 @@
 #include "Cut.h"
 #include "Environment.h"
 #include "Function.h"
+#include "LinearFunction.h"
 #include "Logger.h"
 #include "Operations.h"
 #include "Option.h"
@@ -53,6 +54,10 @@ Cut::Cut(UInt n, FunctionPtr f, double lb, double ub,
     n_(n),
     ub_(ub)
 {
+  if (f && f->getLinearFunction()) {
+    // cuts are evaluated many times in the pool.
+    f->getLinearFunction()->flatten();
+  }
   initInfo_(never_delete, never_disable);
 }
 
@@ -65,6 +70,9 @@ Cut::Cut(ProblemPtr p, FunctionPtr f, double lb, double ub,
     n_(p->getNumVars()),
     ub_(ub)
 {
+  if (f && f->getLinearFunction()) {
+    f->getLinearFunction()->flatten();
+  }
   cons_ = p->newConstraint(f,lb,ub);
   initInfo_(never_delete,never_disable);
 }
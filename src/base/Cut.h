@@ -122,6 +122,12 @@ namespace Minotaur {
     /// Constraint associated with the cut
     void setCons(ConstraintPtr c) { cons_ = c; }
 
+    /// Change lb of the inequality. The constraint, if any, is not changed.
+    void setLb(double lb) { lb_ = lb; }
+
+    /// Change ub of the inequality. The constraint, if any, is not changed.
+    void setUb(double ub) { ub_ = ub; }
+
     /// Set name of the cut
     void setName_(std::string name) { name_ = name; }
 
@@ -0,0 +1,349 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file CutHash.cpp
+ * \brief Define class CutHash for finding duplicate and nearly parallel
+ * linear cuts.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "CutHash.h"
+#include "LinearFunction.h"
+#include "Problem.h"
+#include "Variable.h"
+
+using namespace Minotaur;
+
+
+CutHash::CutHash(double par_tol)
+  : gen_(5489u),
+    nCuts_(0),
+    parTol_(par_tol)
+{
+  // two unit vectors with cosine at least 1-t are at most sqrt(2t) apart.
+  // Their products with a Gaussian vector differ by a normal variable with
+  // at most this deviation. Cells four times as wide almost never split
+  // them by more than one cell.
+  width_ = 4.0*sqrt(2.0*std::max(par_tol, 1e-12));
+}
+
+
+CutHash::~CutHash()
+{
+  buckets_.clear();
+  cuts_.clear();
+}
+
+
+double CutHash::cosine_(const Entry_ &e1, const Entry_ &e2) const
+{
+  std::vector<std::pair<UInt, double> >::const_iterator it1, it2;
+  double s = 0.0;
+
+  it1 = e1.row.begin();
+  it2 = e2.row.begin();
+  while (it1!=e1.row.end() && it2!=e2.row.end()) {
+    if (it1->first < it2->first) {
+      ++it1;
+    } else if (it2->first < it1->first) {
+      ++it2;
+    } else {
+      s += it1->second*it2->second;
+      ++it1;
+      ++it2;
+    }
+  }
+  return s;
+}
+
+
+CutHashStatus CutHash::find(LinearFunctionPtr lf, double lb, double ub,
+                            CutHashMatch *match)
+{
+  const double rtol = 1e-9;
+  const double duptol = 1e-10;
+  Entry_ e;
+  long cell[nProj_];
+  std::pair<std::unordered_multimap<size_t, UInt>::const_iterator,
+            std::unordered_multimap<size_t, UInt>::const_iterator> range;
+  CutHashMatch par;
+  bool found_dup = false;
+  bool found_par = false;
+  bool tight;
+  double c;
+
+  if (0==nCuts_ || !normalize_(lf, lb, ub, e)) {
+    return CutHashNew;
+  }
+
+  // search the cell of the cut and all cells adjacent to it. A duplicate is
+  // preferred over a nearly parallel cut.
+  for (int d=0; d<27; ++d) {
+    cell[0] = e.cell[0] + (d%3) - 1;
+    cell[1] = e.cell[1] + ((d/3)%3) - 1;
+    cell[2] = e.cell[2] + (d/9) - 1;
+    range = buckets_.equal_range(key_(cell));
+    for (std::unordered_multimap<size_t, UInt>::const_iterator
+         it=range.first; it!=range.second; ++it) {
+      const Entry_ &s = cuts_[it->second];
+      if (fabs(s.proj[0]-e.proj[0]) > 2.0*width_) {
+        continue; // a collision of keys.
+      }
+      c = cosine_(e, s);
+      if (c < 1.0-parTol_) {
+        continue;
+      }
+      tight = (s.rhs <= e.rhs + rtol*(1.0+fabs(e.rhs)));
+      if (c >= 1.0-duptol) {
+        if (tight) {
+          // the stored cut is at least as tight. The new one is not needed.
+          match->id = it->second;
+          match->tighter = false;
+          match->rhs = e.rhs;
+          match->bnd = s.isUb ? s.rhs*s.norm : -s.rhs*s.norm;
+          match->isUb = s.isUb;
+          return CutHashDuplicate;
+        }
+        if (!found_dup) {
+          found_dup = true;
+          match->id = it->second;
+          match->tighter = true;
+          match->rhs = e.rhs;
+          match->bnd = s.isUb ? e.rhs*s.norm : -e.rhs*s.norm;
+          match->isUb = s.isUb;
+        }
+      } else if (!found_par &&
+                 s.rhs + maxDiff_(e, s) <= e.rhs + rtol*(1.0+fabs(e.rhs))) {
+        // the stored cut implies the new one within the bounds.
+        found_par = true;
+        par.id = it->second;
+        par.tighter = false;
+        par.rhs = e.rhs;
+        par.bnd = s.isUb ? s.rhs*s.norm : -s.rhs*s.norm;
+        par.isUb = s.isUb;
+      }
+    }
+  }
+  if (found_dup) {
+    return CutHashDuplicate;
+  }
+  if (found_par) {
+    *match = par;
+    return CutHashParallel;
+  }
+  return CutHashNew;
+}
+
+
+double CutHash::getHash(UInt id) const
+{
+  return cuts_[id].proj[0];
+}
+
+
+UInt CutHash::getNumCuts() const
+{
+  return nCuts_;
+}
+
+
+UInt CutHash::insert(LinearFunctionPtr lf, double lb, double ub)
+{
+  UInt id;
+
+  if (free_.empty()) {
+    id = cuts_.size();
+    cuts_.push_back(Entry_());
+  } else {
+    id = free_.back();
+    free_.pop_back();
+  }
+
+  Entry_ &e = cuts_[id];
+  e.row.clear();
+  e.used = true;
+  e.indexed = normalize_(lf, lb, ub, e);
+  if (e.indexed) {
+    buckets_.insert(std::make_pair(key_(e.cell), id));
+  }
+  ++nCuts_;
+  return id;
+}
+
+
+size_t CutHash::key_(const long *cell) const
+{
+  return (size_t) (cell[0]*73856093L) ^ (size_t) (cell[1]*19349663L) ^
+         (size_t) (cell[2]*83492791L);
+}
+
+
+double CutHash::maxDiff_(const Entry_ &e1, const Entry_ &e2) const
+{
+  std::vector<std::pair<UInt, double> >::const_iterator it1, it2;
+  double s = 0.0;
+  double d;
+  UInt j;
+
+  it1 = e1.row.begin();
+  it2 = e2.row.begin();
+  while (it1!=e1.row.end() || it2!=e2.row.end()) {
+    if (it2==e2.row.end() ||
+        (it1!=e1.row.end() && it1->first < it2->first)) {
+      j = it1->first;
+      d = it1->second;
+      ++it1;
+    } else if (it1==e1.row.end() || it2->first < it1->first) {
+      j = it2->first;
+      d = -it2->second;
+      ++it2;
+    } else {
+      j = it1->first;
+      d = it1->second - it2->second;
+      ++it1;
+      ++it2;
+    }
+    if (d > 0.0) {
+      if (j >= ub_.size() || ub_[j] >= INFINITY) {
+        return INFINITY;
+      }
+      s += d*ub_[j];
+    } else if (d < 0.0) {
+      if (j >= lb_.size() || lb_[j] <= -INFINITY) {
+        return INFINITY;
+      }
+      s += d*lb_[j];
+    }
+  }
+  return s;
+}
+
+
+bool CutHash::normalize_(LinearFunctionPtr lf, double lb, double ub,
+                         Entry_ &e)
+{
+  const double *r;
+  UInt idx;
+  double sign, nrm = 0.0;
+
+  if (ub < INFINITY && lb <= -INFINITY) {
+    e.isUb = true;
+    sign = 1.0;
+    e.rhs = ub;
+  } else if (lb > -INFINITY && ub >= INFINITY) {
+    e.isUb = false;
+    sign = -1.0;
+    e.rhs = -lb;
+  } else {
+    return false;
+  }
+
+  e.row.clear();
+  e.row.reserve(lf->getNumTerms());
+  for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
+       ++it) {
+    if (it->second != 0.0) {
+      e.row.push_back(std::make_pair(it->first->getIndex(),
+                                     sign*it->second));
+      nrm += it->second*it->second;
+    }
+  }
+  if (e.row.empty()) {
+    return false;
+  }
+  std::sort(e.row.begin(), e.row.end());
+
+  // the random vectors are drawn index by index, so the same index always
+  // gets the same numbers.
+  idx = e.row.back().first;
+  while (rand_[0].size() <= idx) {
+    std::normal_distribution<double> gauss;
+    for (UInt k=0; k<nProj_; ++k) {
+      rand_[k].push_back(gauss(gen_));
+    }
+  }
+
+  nrm = sqrt(nrm);
+  e.norm = nrm;
+  e.rhs /= nrm;
+  for (UInt k=0; k<nProj_; ++k) {
+    e.proj[k] = 0.0;
+  }
+  for (UInt j=0; j<e.row.size(); ++j) {
+    e.row[j].second /= nrm;
+    for (UInt k=0; k<nProj_; ++k) {
+      r = &(rand_[k][0]);
+      e.proj[k] += r[e.row[j].first]*e.row[j].second;
+    }
+  }
+  for (UInt k=0; k<nProj_; ++k) {
+    e.cell[k] = (long) floor(e.proj[k]/width_);
+  }
+  return true;
+}
+
+
+void CutHash::remove(UInt id)
+{
+  Entry_ &e = cuts_[id];
+
+  if (!e.used) {
+    return;
+  }
+  if (e.indexed) {
+    std::pair<std::unordered_multimap<size_t, UInt>::iterator,
+              std::unordered_multimap<size_t, UInt>::iterator> range;
+    range = buckets_.equal_range(key_(e.cell));
+    for (std::unordered_multimap<size_t, UInt>::iterator it=range.first;
+         it!=range.second; ++it) {
+      if (it->second==id) {
+        buckets_.erase(it);
+        break;
+      }
+    }
+  }
+  e.row.clear();
+  e.used = false;
+  e.indexed = false;
+  free_.push_back(id);
+  --nCuts_;
+}
+
+
+void CutHash::setVarBounds(ProblemPtr p)
+{
+  VariablePtr v;
+
+  lb_.resize(p->getNumVars());
+  ub_.resize(p->getNumVars());
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    v = *it;
+    lb_[v->getIndex()] = v->getLb();
+    ub_[v->getIndex()] = v->getUb();
+  }
+}
+
+
+void CutHash::tighten(const CutHashMatch &match)
+{
+  cuts_[match.id].rhs = match.rhs;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,204 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file CutHash.h
+ * \brief Declare class CutHash for finding duplicate and nearly parallel
+ * linear cuts.
+ */
+
+
+#ifndef MINOTAURCUTHASH_H
+#define MINOTAURCUTHASH_H
+
+#include <random>
+#include <unordered_map>
+#include "Types.h"
+
+namespace Minotaur {
+
+class LinearFunction;
+class Problem;
+typedef LinearFunction* LinearFunctionPtr;
+typedef Problem* ProblemPtr;
+
+/// Result of comparing a new cut with the cuts stored in a CutHash.
+typedef enum {
+  CutHashNew,        ///< No stored cut is parallel to the new cut.
+  CutHashDuplicate,  ///< A stored cut has the same normalized coefficients.
+  CutHashParallel    ///< A nearly parallel stored cut implies the new cut.
+} CutHashStatus;
+
+
+/// The stored cut that matched a new cut in CutHash::find().
+struct CutHashMatch {
+  UInt id;       ///< Id of the stored cut.
+  bool tighter;  ///< True if the new cut is tighter than the stored cut.
+  double rhs;    ///< Normalized right hand side of the new cut.
+  double bnd;    ///< Bound that makes the stored cut as tight as the new one.
+  bool isUb;     ///< True if bnd is an upper bound of the stored cut.
+};
+
+
+/**
+ * \brief Find duplicate and nearly parallel linear cuts in expected
+ * constant time.
+ *
+ * A cut \f$l \leq a^Tx \leq u\f$ with one finite bound is written as
+ * \f$\hat{a}^Tx \leq b\f$, where \f$\hat{a}\f$ is \f$a\f$ or \f$-a\f$ scaled
+ * to unit 2-norm. The cut is hashed by the products of \f$\hat{a}\f$ with a
+ * few random Gaussian vectors, rounded to a grid. Two nearly parallel cuts
+ * have nearly equal products and fall in the same or in adjacent cells of
+ * the grid, so only these cells are searched for a new cut. Every candidate
+ * found this way is compared by the cosine of the angle between the two
+ * cuts.
+ *
+ * A nearly parallel stored cut \f$\hat{s}^Tx \leq c\f$ implies the new cut
+ * if \f$c + \max_{l \leq x \leq u} (\hat{a}-\hat{s})^Tx \leq b\f$, where
+ * l and u are the bounds given by setVarBounds().
+ *
+ * Cuts with two finite bounds, or with no nonzero coefficient, are given an
+ * id but are never matched.
+ */
+class CutHash {
+public:
+  /**
+   * \brief Construct an empty hash.
+   *
+   * \param [in] par_tol Two cuts are nearly parallel if the cosine of the
+   * angle between them is at least 1-par_tol.
+   */
+  CutHash(double par_tol);
+
+  /// Destroy.
+  ~CutHash();
+
+  /**
+   * \brief Compare a new cut with the stored cuts.
+   *
+   * \param [in] lf Linear function of the new cut.
+   * \param [in] lb Lower bound of the new cut.
+   * \param [in] ub Upper bound of the new cut.
+   * \param [out] match If the status is not CutHashNew, the stored cut
+   * that matched. A duplicate is preferred over a nearly parallel cut, and
+   * a stored cut that is at least as tight as the new one is preferred;
+   * tighter is then false. If tighter is true, the match is a duplicate and
+   * its bound may be changed to bnd to make it the same as the new cut. A
+   * nearly parallel match implies the new cut within the bounds of the
+   * variables, and tighter is false.
+   * \return The status of the new cut.
+   */
+  CutHashStatus find(LinearFunctionPtr lf, double lb, double ub,
+                     CutHashMatch *match);
+
+  /// Return the first product of the stored cut with a random vector.
+  double getHash(UInt id) const;
+
+  /// Return the number of stored cuts.
+  UInt getNumCuts() const;
+
+  /**
+   * \brief Store a cut.
+   *
+   * \return Id of the cut. Ids of removed cuts are reused.
+   */
+  UInt insert(LinearFunctionPtr lf, double lb, double ub);
+
+  /// Remove a stored cut.
+  void remove(UInt id);
+
+  /**
+   * \brief Copy the bounds of the variables of a problem, by index.
+   *
+   * The bounds decide whether a nearly parallel cut implies a new cut, so
+   * they must hold wherever the cuts are used, e.g. the bounds at the root
+   * of the tree. No nearly parallel cut is matched until they are set.
+   */
+  void setVarBounds(ProblemPtr p);
+
+  /// Change the stored cut of a match returned by find() to the new cut.
+  void tighten(const CutHashMatch &match);
+
+private:
+  /// A stored cut.
+  struct Entry_ {
+    std::vector<std::pair<UInt, double> > row; ///< Normalized and sorted.
+    double rhs;      ///< Normalized right hand side.
+    double norm;     ///< 2-norm of the original coefficients.
+    bool isUb;       ///< True if the cut was a^Tx <= u.
+    double proj[3];  ///< Products with the random vectors.
+    long cell[3];    ///< Cell of the grid.
+    bool indexed;    ///< True if the cut is in buckets_.
+    bool used;       ///< False if the id is free.
+  };
+
+  /// Number of random vectors.
+  static const UInt nProj_ = 3;
+
+  /// Ids of indexed cuts by the hash key of their cells.
+  std::unordered_multimap<size_t, UInt> buckets_;
+
+  /// All cuts, by id.
+  std::vector<Entry_> cuts_;
+
+  /// Ids that may be reused.
+  UIntVector free_;
+
+  /// Generator of the random vectors.
+  std::mt19937 gen_;
+
+  /// Lower bounds of the variables, by index.
+  DoubleVector lb_;
+
+  /// Number of stored cuts.
+  UInt nCuts_;
+
+  /// Tolerance on 1-cosine of parallel cuts.
+  double parTol_;
+
+  /// Random Gaussian vectors, grown when a larger index is seen.
+  DoubleVector rand_[nProj_];
+
+  /// Upper bounds of the variables, by index.
+  DoubleVector ub_;
+
+  /// Width of a cell of the grid.
+  double width_;
+
+  /// Cosine of the angle between two stored or new cuts.
+  double cosine_(const Entry_ &e1, const Entry_ &e2) const;
+
+  /// Hash key of a cell.
+  size_t key_(const long *cell) const;
+
+  /**
+   * Return the maximum of the difference of the normalized coefficients of
+   * e1 and e2 times x over the bounds of the variables, or INFINITY if it
+   * is not bounded.
+   */
+  double maxDiff_(const Entry_ &e1, const Entry_ &e2) const;
+
+  /**
+   * \brief Normalize a cut and find its cell.
+   *
+   * \return False if the cut can not be matched.
+   */
+  bool normalize_(LinearFunctionPtr lf, double lb, double ub, Entry_ &e);
+};
+typedef CutHash* CutHashPtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
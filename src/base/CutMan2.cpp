@@ -39,7 +39,7 @@ typedef std::vector<ConstraintPtr>::const_iterator ConstIter;
 
 CutMan2::CutMan2()
   : env_(EnvPtr()),   // NULL
-    hashVec_(0),
+    hash_(0),
     p_(ProblemPtr()),  // NULL
     absTol_(5e-2),
     MaxInactiveInRel_(10000),
@@ -56,6 +56,10 @@ CutMan2::CutMan2()
   stats_->numPoolToRel = 0;
   stats_->numRelToPool = 0 ;
   stats_->numCuts= 0;
+  stats_->numHashChecks = 0;
+  stats_->numDupCuts = 0;
+  stats_->numMergedCuts = 0;
+  stats_->numParCuts = 0;
 
   ctmngrInfo_.t = ctMngrtime_;
   ctmngrInfo_.RelTr = MaxInactiveInRel_;
@@ -75,12 +79,9 @@ CutMan2::CutMan2(EnvPtr env, ProblemPtr p)
   stats_ = new CutStat();
   timer_ = env_->getNewTimer();
   UInt n = p->getNumVars();
-  hashVec_ = new double[n];
   CtThrsh_ = 6 * (n + p->getNumCons());
-
-  for (UInt i = 0; i < n; i++) {
-    hashVec_[i] = rand()/double (RAND_MAX);
-  }
+  hash_ = (CutHashPtr) new CutHash(1e-4);
+  hash_->setVarBounds(p);
 
   updateTime_ = 0.0;
   checkTime_ = 0.0;
@@ -95,6 +96,10 @@ CutMan2::CutMan2(EnvPtr env, ProblemPtr p)
   stats_->PoolSize = 0;
   stats_->RelSize = 0;
   stats_->numCuts= 0;
+  stats_->numHashChecks = 0;
+  stats_->numDupCuts = 0;
+  stats_->numMergedCuts = 0;
+  stats_->numParCuts = 0;
   ctmngrInfo_.t = ctMngrtime_;
   ctmngrInfo_.PoolTr = PoolSize_;
   ctmngrInfo_.PrntActCnt = PrntCntThrsh_;
@@ -106,9 +111,11 @@ CutMan2::~CutMan2()
     writeStat();
     delete stats_;
   }
-  if (hashVec_) {
-    delete[] hashVec_;
+  if (hash_) {
+    delete hash_;
   }
+  hashCuts_.clear();
+  hashIds_.clear();
   //env_.reset();
   env_ = 0;
   pool_.clear();
@@ -218,7 +225,14 @@ void CutMan2::updatePool(ProblemPtr rel, ConstSolutionPtr sol)
 
 ConstraintPtr CutMan2::addCut(ProblemPtr rel,FunctionPtr fn, double lb, double ub, bool, bool neverDelete)
 {
+  ConstraintPtr c = ConstraintPtr();
+
+  if (isRedundant_(rel, fn, lb, ub, true, &c)) {
+    delete fn;
+    return c;
+  }
   CutPtr cut = (CutPtr) new Cut(rel,fn, lb, ub,neverDelete,false);
+  hashCut_(cut);
   addToRel_(rel,cut,true);
   stats_->numAddedCuts++;
   cut->getInfo()->inRel = true;
@@ -269,6 +283,7 @@ void CutMan2::addToPool_(CutPtr cut)
 */
   if (pool_.size() > PoolSize_ - 1){
     std::list<CutPtr>::iterator it = pool_.begin();
+    unhashCut_(*it);
     it = pool_.erase(it);
   }
 
@@ -354,9 +369,107 @@ void CutMan2::addCuts(CutVectorIter cbeg,CutVectorIter cend)
 
 void CutMan2::addCut(CutPtr c)
 {
+  if (isRedundant_(p_, c->getFunction(), c->getLb(), c->getUb(), false,
+                   0)) {
+    delete c;
+    return;
+  }
+  hashCut_(c);
   addToRel_(c);
 }
 
+
+void CutMan2::hashCut_(CutPtr cut)
+{
+  LinearFunctionPtr lf;
+  FunctionPtr f = cut->getFunction();
+  UInt id;
+
+  if (!hash_ || !f || f->getQuadraticFunction() ||
+      f->getNonlinearFunction() || !f->getLinearFunction()) {
+    return;
+  }
+  lf = f->getLinearFunction();
+  id = hash_->insert(lf, cut->getLb(), cut->getUb());
+  if (hashCuts_.size() <= id) {
+    hashCuts_.resize(id+1, CutPtr());
+  }
+  hashCuts_[id] = cut;
+  hashIds_[cut] = id;
+  cut->getInfo()->hash = hash_->getHash(id);
+}
+
+
+bool CutMan2::isRedundant_(ProblemPtr rel, FunctionPtr f, double lb,
+                           double ub, bool to_rel, ConstraintPtr *c)
+{
+  CutHashMatch match;
+  CutHashStatus status;
+  CutPtr old;
+  bool in_rel;
+
+  if (!hash_ || !f || f->getQuadraticFunction() ||
+      f->getNonlinearFunction() || !f->getLinearFunction()) {
+    return false;
+  }
+
+  ++(stats_->numHashChecks);
+  status = hash_->find(f->getLinearFunction(), lb, ub, &match);
+  if (CutHashNew == status) {
+    return false;
+  }
+
+  old = hashCuts_[match.id];
+  in_rel = old->getInfo()->inRel;
+  if (in_rel && match.tighter) {
+    if (!rel || !old->getConstraint()) {
+      return false;
+    }
+    rel->changeBound(old->getConstraint(), match.isUb ? Upper : Lower,
+                     match.bnd);
+  }
+  if (!in_rel && to_rel && !rel) {
+    return false;
+  }
+
+  if (match.tighter) {
+    if (match.isUb) {
+      old->setUb(match.bnd);
+    } else {
+      old->setLb(match.bnd);
+    }
+    hash_->tighten(match);
+    ++(stats_->numMergedCuts);
+  } else if (CutHashParallel == status) {
+    ++(stats_->numParCuts);
+  } else {
+    ++(stats_->numDupCuts);
+  }
+
+  // the cut was meant for the relaxation: move the copy in the pool there.
+  if (!in_rel && to_rel) {
+    pool_.remove(old);
+    addToRel_(rel, old, false);
+    ++(stats_->numPoolToRel);
+  }
+  if (c) {
+    *c = old->getInfo()->inRel ? old->getConstraint() : ConstraintPtr();
+  }
+  return true;
+}
+
+
+void CutMan2::unhashCut_(CutPtr cut)
+{
+  std::map<CutPtr, UInt>::iterator it = hashIds_.find(cut);
+
+  if (it != hashIds_.end()) {
+    hash_->remove(it->second);
+    hashCuts_[it->second] = CutPtr();
+    hashIds_.erase(it);
+  }
+}
+
 void CutMan2::writeStats(std::ostream &out) const
 {
   out << "nothing to do" << std::endl;
@@ -373,6 +486,11 @@ void CutMan2::writeStat()
     << "CutManager: size of pool................................ = " << pool_.size() << std::endl
     << "CutManager: average size of rel......................... = " << (double)stats_->RelSize/stats_->callNums << std::endl
     << "CutManager: average size of pool........................ = " << (double)stats_->PoolSize/stats_->callNums << std::endl
+    << "CutManager: new cuts checked for duplicates............. = " << stats_->numHashChecks << std::endl
+    << "CutManager: duplicate cuts dropped...................... = " << stats_->numDupCuts << std::endl
+    << "CutManager: duplicate cuts merged....................... = " << stats_->numMergedCuts << std::endl
+    << "CutManager: nearly parallel cuts dropped................ = " << stats_->numParCuts << std::endl
+    << "CutManager: duplicate hit rate.......................... = " << (stats_->numHashChecks>0 ? (double)(stats_->numDupCuts+stats_->numMergedCuts+stats_->numParCuts)/stats_->numHashChecks : 0.0) << std::endl
     << "CutManager: MaxInactiveInRel............................ = " << MaxInactiveInRel_ << std::endl
     << "CutManager: PrntActCnt.................................. = " << PrntCntThrsh_ << std::endl
     << "CutManager: time........................................ = " << ctMngrtime_ << std::endl
@@ -15,6 +15,7 @@
 
 #include <list>
 #include <map>
+#include "CutHash.h"
 #include "CutManager.h"
 #include "Types.h"
 
@@ -41,6 +42,10 @@ namespace Minotaur {
     int PoolSize;
     int RelSize;
     int numCuts;
+    int numHashChecks;  ///< No. of new cuts compared with existing cuts.
+    int numDupCuts;     ///< No. of new cuts dropped as duplicates.
+    int numMergedCuts;  ///< No. of duplicates merged into an existing cut.
+    int numParCuts;     ///< No. of new cuts implied by a nearly parallel cut.
   };
 
   class CutMan2 : public CutManager {
@@ -61,6 +66,9 @@ namespace Minotaur {
     // base class method
     void addCuts(CutVectorIter cbeg, CutVectorIter cend);
 
+    // base class method
+    bool findsDuplicates() const { return (0 != hash_); };
+
     UInt getNumCuts() const { return numCuts_; };
 
     UInt getNumEnabledCuts() const { return rel_.size(); };
@@ -130,8 +138,14 @@ namespace Minotaur {
     /// Environment.
     EnvPtr env_;
 
-    /// Random vector to check for duplicacy.
-    double* hashVec_;
+    /// Finds duplicate cuts.
+    CutHashPtr hash_;
+
+    /// Cuts stored in hash_, by their id.
+    std::vector<CutPtr> hashCuts_;
+
+    /// Id of each cut in hash_.
+    std::map<CutPtr, UInt> hashIds_;
 
     /// For logging.
     LoggerPtr logger_;
@@ -151,6 +165,35 @@ namespace Minotaur {
     /// Adding cut to the cut pool
     void addToPool_(CutPtr cut);
 
+    /// Store a new cut in hash_.
+    void hashCut_(CutPtr cut);
+
+    /**
+     * \brief Check if a new cut is an exact duplicate of a cut that is
+     * already managed, or is implied by a nearly parallel one.
+     *
+     * If the duplicate is tighter than the existing cut, the bound of the
+     * existing cut is changed to that of the new cut. If the existing cut
+     * is in the pool and the new cut was meant for the relaxation, the
+     * existing cut is moved to the relaxation. A nearly parallel cut
+     * makes the new cut redundant only if it implies it within the bounds
+     * of the variables when the manager was created.
+     * \param [in] rel The relaxation, used to change the bound of an
+     * existing cut or to add it. May be NULL.
+     * \param [in] f Function of the new cut.
+     * \param [in] lb Lower bound of the new cut.
+     * \param [in] ub Upper bound of the new cut.
+     * \param [in] to_rel True if the new cut is to be added to rel.
+     * \param [out] c If not NULL, the constraint of the existing cut in rel,
+     * or NULL if it is in the pool.
+     * \return True if the new cut is not needed.
+     */
+    bool isRedundant_(ProblemPtr rel, FunctionPtr f, double lb, double ub,
+                      bool to_rel, ConstraintPtr *c);
+
+    /// Remove a cut from hash_.
+    void unhashCut_(CutPtr cut);
+
     /// Absolute tolerance
     double absTol_;
 
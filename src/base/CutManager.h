@@ -86,6 +86,13 @@ public:
    */
   virtual void addCuts(CutVectorIter cbeg, CutVectorIter cend) = 0;
 
+  /**
+   * \brief Return true if the manager drops a new cut that duplicates a cut
+   * it already has. Such a manager may also drop old cuts from its pool, so
+   * a cut generator should not skip a cut only because it was sent before.
+   */
+  virtual bool findsDuplicates() const { return false; };
+
   /// Get the total number of cuts available to the manager.
   virtual UInt getNumCuts() const = 0;
 
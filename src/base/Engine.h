@@ -55,6 +55,17 @@ namespace Minotaur {
     virtual void changeBound(VariablePtr var, double new_lb, double new_ub) 
       = 0;
 
+    /**
+     * \brief Change both bounds of several variables. By default,
+     * changeBound() is called for each variable.
+     *
+     * \param [in] vars The variables whose bounds are changed.
+     * \param [in] lb The new lower bounds, one for each variable in vars.
+     * \param [in] ub The new upper bounds, one for each variable in vars.
+     */
+    virtual void changeBounds(const VarVector &vars, const DoubleVector &lb,
+                              const DoubleVector &ub);
+
     /**
      * \brief Change the linear function, and the bounds of a constraint.
      * \param [in] c Original constraint that is to be changed.
@@ -15,6 +15,7 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "MinotaurConfig.h"
 #include "Environment.h"
@@ -72,6 +73,11 @@ void Environment::createDefaultOptions_()
       "Display the best solution if one found: <0/1>", true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("bnb_lca_switch", 
+      "Switch between nodes through their lowest common ancestor: <0/1>",
+      true, false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("use_internal_quad", 
       "Should quadratic functions be treated natively: <0/1>",
       true, false);
@@ -199,6 +205,10 @@ void Environment::createDefaultOptions_()
       "If true, synchronize node processing in each iteration across all threads in parallel branch-and-bound: <0/1>", true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("mcbnb_shard_nodes",
+      "If true, keep the active nodes of parallel branch-and-bound in one shard per thread, except in deterministic mode: <0/1>", true, false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("msheur", 
       "Enable multi-start initial heuristic: <0/1>", true, false);
   options_->insert(b_option);
@@ -237,6 +247,11 @@ void Environment::createDefaultOptions_()
       true, true);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("nlp_share_subexpr",
+      "Evaluate subexpressions common to nonlinear functions only once: <0/1>",
+      true, false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("pardivheur",
       "Use parallel diving heuristic for MINLP: <0/1>",
       true, false);
@@ -272,6 +287,11 @@ void Environment::createDefaultOptions_()
       1000000000);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("bnb_spill_nodes", 
+      "Number of active nodes in branch-and-bound above which the warm starts and branches of new nodes are written to a spill file, 0 for no limit: >=0",
+      true, 0);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("separability_intensity_level",
       "Intensity of separability detection: 0-1", true, 0);
   options_->insert(i_option); //MS: disable later after confirming with sir.
@@ -300,6 +320,11 @@ void Environment::createDefaultOptions_()
       "Verbosity of the mseparability detection: 0-6", true, LogInfo);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("cut_pool_threads",
+      "Number of threads used to check cuts of the csr cut manager: >=1",
+      true, 1);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("divheur", 
       "Use diving heuristic for MINLP: <-1/0/1>", 
       true, -1);
@@ -327,6 +352,32 @@ void Environment::createDefaultOptions_()
        "Maximum size of individual element in grouping: >= 2, <= 20", true, 6);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("msheur_samples",
+      "Number of points sampled in each round of the clustering (MLSL) "
+      "multi-start heuristic, 0 for the sequential multi-start heuristic: "
+      ">=0", true, 0);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("msheur_threads",
+      "Number of threads used to solve NLPs in the clustering multi-start "
+      "heuristic: >=1", true, 1);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("obbt_iter_limit",
+      "Limit on simplex iterations in each LP of optimization-based bound "
+      "tightening, 0 for no limit: >=0", true, 0);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("obbt_node_freq",
+      "Optimization-based bound tightening at nodes whose depth is a "
+      "multiple of this value, 0 for none: >=0", true, 0);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("obbt_threads",
+      "Number of threads used to solve LPs in optimization-based bound "
+      "tightening: >=1", true, 1);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("rand_seed",
       "Seed to random number generator: >=0 (0 = time(NULL))", true, 0);
   options_->insert(i_option);
@@ -335,11 +386,26 @@ void Environment::createDefaultOptions_()
       "Limit on number of iterations allowed during strong branching: >0",
       true, 25);
   options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("strbr_threads",
+      "Number of threads used to solve problems in strong branching: >=1",
+      true, 1);
+  options_->insert(i_option);
  
   i_option = (IntOptionPtr) new Option<int>("threads",
       "Number of threads to be used ", true, 1);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("nlp_eval_threads",
+      "Number of threads used to fill Jacobian and Hessian values: >=1",
+      true, 1);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("nlp_cache_size",
+      "Number of results of NLPs with fixed integers saved by QG and OA: >=0",
+      true, 1000);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("msbnb_scheme_id",
       "Initial point generation scheme for MsProcessor: 1-5", true, 5);
   options_->insert(i_option);
@@ -386,11 +452,21 @@ void Environment::createDefaultOptions_()
       true, 1e20);
   options_->insert(d_option);
   
+  d_option = (DoubleOptionPtr) new Option<double>("obbt_time_limit", 
+      "Limit on time in seconds of each round of optimization-based bound "
+      "tightening: >0", true, 1e20);
+  options_->insert(d_option);
+  
   d_option = (DoubleOptionPtr) new Option<double>("heur_time_limit", 
       "Limit on time on each heuristic run in seconds: >0",
       true, 10);
   options_->insert(d_option);
   
+  d_option = (DoubleOptionPtr) new Option<double>("race_ramp_up", 
+      "Time in seconds after which all threads switch to the configuration "
+      "that leads the race in mcrace. No switch if 0: >=0", true, 0.);
+  options_->insert(d_option);
+  
   d_option = (DoubleOptionPtr) new Option<double>("bnb_log_interval", 
       "Display interval in seconds for branch-and-bound status: >0", true, 
       5.);
@@ -469,11 +545,20 @@ void Environment::createDefaultOptions_()
   d_option = 0;
  
   // string options
+  s_option = (StringOptionPtr) new Option<std::string>("bnb_spill_dir", 
+      "Directory in which the spill file of active nodes is created", true,
+      "/tmp");
+  options_->insert(s_option);
+
   s_option = (StringOptionPtr) new Option<std::string>("brancher", 
       "Name of brancher: rel, maxvio, lex, rand, maxfreq, parRel, unambRel",
       true, "rel");
   options_->insert(s_option);
 
+  s_option = (StringOptionPtr) new Option<std::string>("cut_manager",
+      "Cut manager used in branch-and-cut: simple, csr", true, "simple");
+  options_->insert(s_option);
+
   s_option = (StringOptionPtr) new Option<std::string>("config_file", 
       "Name of file that contains parameters or options", true, "");
   options_->insert(s_option);
@@ -514,6 +599,13 @@ void Environment::createDefaultOptions_()
       true, "bqpd");
   options_->insert(s_option);
 
+  s_option = (StringOptionPtr) new Option<std::string>("race_configs", 
+      "Configurations that race against each other in mcrace, separated by "
+      "';'. Each is a list of options, e.g. \"--brancher maxvio\"",
+      true, "--brancher rel;--brancher maxvio;--brancher rel --tree_search "
+      "dfs;--brancher lex");
+  options_->insert(s_option);
+
   s_option = (StringOptionPtr) new Option<std::string>("tb_rule",
       "Tie breaking rule for node selection in branch-and-bound: twoChild, FIFO", true, "");
   options_->insert(s_option);
@@ -860,6 +952,25 @@ void Environment::readOptions(int argc, char **argv)
 }
 
 
+void Environment::readOptions(const std::string &str)
+{
+  std::istringstream istr(str);
+  std::vector<std::string> words;
+  std::vector<char *> argv;
+  std::string word;
+
+  // the first word on a command line is the name of the program.
+  words.push_back("minotaur");
+  while (istr >> word) {
+    words.push_back(word);
+  }
+  for (UInt i=0; i<words.size(); ++i) {
+    argv.push_back(&(words[i][0]));
+  }
+  readOptions((int) argv.size(), &argv[0]);
+}
+
+
 UInt Environment::removeDashes_(std::string &name)
 {
   size_t first_occ;
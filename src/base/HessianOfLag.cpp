@@ -17,20 +17,29 @@
 
 
 #include "MinotaurConfig.h"
+#include "CGraph.h"
 #include "Constraint.h"
 #include "Function.h"
 #include "HessianOfLag.h"
 #include "Objective.h"
 #include "Problem.h"
+#include "QuadraticFunction.h"
+#include "NonlinearFunction.h"
 #include "Variable.h"
 
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace Minotaur;
 
 HessianOfLag::HessianOfLag()
 : etol_(1e-12),
   obj_(FunctionPtr()),
-  p_(0)  // NULL
+  nThreads_(1),
+  p_(0),  // NULL
+  shared_(0)
 {
   stor_.nz = 0;
   stor_.nlVars = 0;
@@ -44,7 +53,9 @@ HessianOfLag::HessianOfLag()
 HessianOfLag::HessianOfLag(Problem *p)
 : etol_(1e-12),
   obj_(FunctionPtr()),
-  p_(p) // NULL
+  nThreads_(1),
+  p_(p), // NULL
+  shared_(0)
 {
   if (p_->getObjective()) {
     obj_ = p_->getObjective()->getFunction();
@@ -100,6 +111,17 @@ void HessianOfLag::fillRowColValues(const double *x, double obj_mult,
   UInt i=0;
   FunctionPtr f;
 
+  if (shared_) {
+    // errors are reported by the functions, which evaluate their own nodes
+    // if the shared graph could not be evaluated.
+    int err = 0;
+    shared_->eval(x, &err);
+  }
+  if (nThreads_>1 && !bStart_.empty()) {
+    fillParValues_(x, obj_mult, con_mult, values, error);
+    return;
+  }
+
   std::fill(values, values+stor_.nz, 0);
   if (p_->getObjective()) {
     f = p_->getObjective()->getFunction();
@@ -120,6 +142,175 @@ void HessianOfLag::fillRowColValues(const double *x, double obj_mult,
 }
 
 
+void HessianOfLag::fillParValues_(const double *x, double obj_mult,
+                                  const double *con_mult, double *values,
+                                  int *error)
+{
+#if USE_OPENMP
+  const int nb = bMult_.size();
+  const int nz = stor_.nz;
+  int err = 0;
+
+#pragma omp parallel num_threads(nThreads_)
+  {
+    double *s = &(scratch_[omp_get_thread_num()][0]);
+    double mult, v;
+    int e;
+    UInt j;
+
+    // evaluate each block into the scratch array of this thread, copy out
+    // what it added and reset the scratch array.
+#pragma omp for schedule(dynamic, 4)
+    for (int b=0; b<nb; ++b) {
+      mult = (bMult_[b]<0) ? obj_mult : con_mult[bMult_[b]];
+      if (fabs(mult) > etol_) {
+        e = 0;
+        if (bQf_[b]) {
+          bQf_[b]->evalHessian(mult, x, &stor_, s, &e);
+        } else {
+          bNlf_[b]->evalHessian(mult, x, &stor_, s, &e);
+        }
+        if (0!=e) {
+#pragma omp critical (hessError)
+          err = e;
+        }
+        for (j=bStart_[b]; j<bStart_[b+1]; ++j) {
+          ev_[j] = s[evOff_[j]];
+          s[evOff_[j]] = 0.0;
+        }
+      } else {
+        for (j=bStart_[b]; j<bStart_[b+1]; ++j) {
+          ev_[j] = 0.0;
+        }
+      }
+    }
+
+    // add the contributions to each nonzero in the order of the blocks, as
+    // in the serial loop.
+#pragma omp for schedule(static)
+    for (int k=0; k<nz; ++k) {
+      v = 0.0;
+      for (j=nzStart_[k]; j<nzStart_[k+1]; ++j) {
+        v += ev_[nzEv_[j]];
+      }
+      values[k] = v;
+    }
+  }
+  *error = err;
+#else
+  assert(!"fillParValues_ needs OpenMP!");
+  *error = 1;
+#endif
+}
+
+
+void HessianOfLag::setShared(CGraphPtr cg)
+{
+  shared_ = cg;
+}
+
+
+void HessianOfLag::setNumThreads(UInt n)
+{
+  nThreads_ = (n>0) ? n : 1;
+  if (p_) {
+    setupPar_();
+  }
+}
+
+
+void HessianOfLag::setupPar_()
+{
+  FunctionPtr f;
+  std::vector<FunctionPtr> funs;
+  IntVector mark;
+  UInt nev;
+
+  bMult_.clear();
+  bNlf_.clear();
+  bQf_.clear();
+  bStart_.clear();
+  ev_.clear();
+  evOff_.clear();
+  nzEv_.clear();
+  nzStart_.clear();
+  scratch_.clear();
+#if USE_OPENMP
+  if (nThreads_<2 || 0==stor_.nz) {
+    return;
+  }
+
+  // blocks are visited in the same order as in the serial loop: objective
+  // first, then constraints, quadratic part before the nonlinear part.
+  funs.push_back(obj_);
+  for (ConstraintConstIterator c_iter=p_->consBegin(); c_iter!=p_->consEnd();
+       ++c_iter) {
+    funs.push_back((*c_iter)->getFunction());
+  }
+  for (UInt k=0; k<funs.size(); ++k) {
+    f = funs[k];
+    if (!f) {
+      continue;
+    }
+    if (f->getQuadraticFunction()) {
+      bStart_.push_back(evOff_.size());
+      bMult_.push_back((int) k - 1);
+      bNlf_.push_back(0);
+      bQf_.push_back(f->getQuadraticFunction());
+      if (false==f->getQuadraticFunction()->getHessOffs(&evOff_)) {
+        setNumThreads(1);
+        return;
+      }
+    }
+    if (f->getNonlinearFunction()) {
+      bStart_.push_back(evOff_.size());
+      bMult_.push_back((int) k - 1);
+      bNlf_.push_back(f->getNonlinearFunction());
+      bQf_.push_back(0);
+      if (false==f->getNonlinearFunction()->getHessOffs(&evOff_)) {
+        setNumThreads(1);
+        return;
+      }
+    }
+  }
+  bStart_.push_back(evOff_.size());
+  nev = evOff_.size();
+
+  // a block must add to a position at most once.
+  mark.resize(stor_.nz, -1);
+  for (UInt b=0; b+1<bStart_.size(); ++b) {
+    for (UInt j=bStart_[b]; j<bStart_[b+1]; ++j) {
+      if (evOff_[j]>=stor_.nz || mark[evOff_[j]]==(int) b) {
+        setNumThreads(1);
+        return;
+      }
+      mark[evOff_[j]] = b;
+    }
+  }
+
+  // for each nonzero, list the values added to it in the order of blocks.
+  nzStart_.assign(stor_.nz+1, 0);
+  for (UInt j=0; j<nev; ++j) {
+    ++nzStart_[evOff_[j]+1];
+  }
+  for (UInt k=0; k<stor_.nz; ++k) {
+    nzStart_[k+1] += nzStart_[k];
+  }
+  nzEv_.resize(nev);
+  for (UInt j=0; j<nev; ++j) {
+    nzEv_[nzStart_[evOff_[j]]++] = j;
+  }
+  for (UInt k=stor_.nz; k>0; --k) {
+    nzStart_[k] = nzStart_[k-1];
+  }
+  nzStart_[0] = 0;
+
+  ev_.resize(nev, 0.0);
+  scratch_.resize(nThreads_, DoubleVector(stor_.nz, 0.0));
+#endif
+}
+
+
 void HessianOfLag::setupRowCol()
 {
   UInt nz;
@@ -198,7 +389,7 @@ void HessianOfLag::setupRowCol()
   }
   delete [] stor_.colQs;
   stor_.colQs = 0;
-
+  setupPar_();
 }
 
 
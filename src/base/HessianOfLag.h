@@ -17,6 +17,8 @@
 #include "Types.h"
 
 namespace Minotaur {
+  class CGraph;
+  typedef CGraph* CGraphPtr;
 
   struct LTHessStor {
     UInt nz;
@@ -93,11 +95,45 @@ namespace Minotaur {
       /// Ugly hack to solve maximization problem. TODO: delete it.
       virtual void negateObj() {};
 
+      /**
+       * \brief Set the number of threads used by fillRowColValues().
+       *
+       * Each thread evaluates the Hessians of different functions into its
+       * own scratch array. The contributions to each nonzero are then added
+       * in the same order as with one thread, so the values do not depend on
+       * the number of threads. If some function can not report the
+       * positions it writes to, only one thread is used.
+       */
+      void setNumThreads(UInt n);
+
+      /**
+       * \brief Set the graph that has the subexpressions shared by the
+       * objective and constraints. fillRowColValues() evaluates it once at x
+       * before the functions copy their values from it.
+       */
+      void setShared(CGraphPtr cg);
+
       virtual void setupRowCol();
 
       virtual void write(std::ostream &out) const;
 
     private:
+      /// Start of the values of each block in ev_. Has one extra entry.
+      UIntVector bStart_;
+
+      /**
+       * Index of the multiplier of each block in con_mult, or -1 if the
+       * block is in the objective. A block is the quadratic or the
+       * nonlinear part of the objective or of a constraint.
+       */
+      IntVector bMult_;
+
+      /// Nonlinear part of each block, or NULL.
+      std::vector<NonlinearFunctionPtr> bNlf_;
+
+      /// Quadratic part of each block, or NULL.
+      std::vector<QuadraticFunctionPtr> bQf_;
+
       /** 
        * If a lagrange multiplier is less than etol_, then it is considered
        * zero.
@@ -119,9 +155,39 @@ namespace Minotaur {
        * The hessian value for x_4x_5 goes in position 3 and so on.
        */
 
+      /// Values added by the blocks in the last call, block after block.
+      DoubleVector ev_;
+
+      /// Position in the Hessian values of each entry of ev_.
+      UIntVector evOff_;
+
+      /// Number of threads used to fill the values.
+      UInt nThreads_;
+
+      /// Entries of ev_ added to each nonzero, in the order of the blocks.
+      UIntVector nzEv_;
+
+      /// Start of the entries of each nonzero in nzEv_.
+      UIntVector nzStart_;
+
       Problem *p_;
+
+      /// Graph of shared subexpressions, or NULL. Not owned.
+      CGraphPtr shared_;
+
+      /// One array of size stor_.nz for each thread. Kept at zero.
+      std::vector<DoubleVector> scratch_;
+
       LTHessStor stor_;
 
+      /// Fill the values using nThreads_ threads.
+      void fillParValues_(const double *x, double obj_mult,
+                          const double *con_mult, double *values,
+                          int *error);
+
+      /// Set up the blocks and offsets used by fillParValues_().
+      void setupPar_();
+
   };
 
   typedef HessianOfLag* HessianOfLagPtr;
@@ -7,6 +7,7 @@
 #include <iostream>
 
 #include "MinotaurConfig.h"
+#include "CGraph.h"
 #include "Constraint.h"
 #include "Function.h"
 #include "Jacobian.h"
@@ -17,21 +18,28 @@ using namespace Minotaur;
 
 Jacobian::Jacobian()
   : cons_(0),
+    nThreads_(1),
+    shared_(0),
     nz_(0)
 {
 }
 
 
 Jacobian::Jacobian(const std::vector<ConstraintPtr> & cons, const UInt)
+  : nThreads_(1),
+    shared_(0)
 {
   ConstraintConstIterator c_iter;
 
   nz_ = 0;
   cons_ = &cons;
+  nzStart_.reserve(cons_->size()+1);
   for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter) {
+    nzStart_.push_back(nz_);
     nz_ += (*c_iter)->getFunction()->getNumVars();
     (*c_iter)->getFunction()->prepJac();
   }
+  nzStart_.push_back(nz_);
 }
 
 
@@ -77,6 +85,31 @@ void Jacobian::fillRowColValues(const double *x, double *values, int *error)
 
   *error = 0;
   std::fill(values, values+nz_, 0.0);
+  if (shared_) {
+    // errors are reported by the constraints, which evaluate their own
+    // nodes if the shared graph could not be evaluated.
+    int err = 0;
+    shared_->eval(x, &err);
+  }
+#if USE_OPENMP
+  if (nThreads_>1 && cons_ && nzStart_.size()==cons_->size()+1) {
+    // each constraint fills its own slice of values, so the result is the
+    // same as in the serial loop below.
+    const int ncons = cons_->size();
+    int err = 0;
+#pragma omp parallel for num_threads(nThreads_) schedule(dynamic, 16)
+    for (int i=0; i<ncons; ++i) {
+      int e = 0;
+      (*cons_)[i]->getFunction()->fillJac(x, values+nzStart_[i], &e);
+      if (0!=e) {
+#pragma omp critical (jacError)
+        err = e;
+      }
+    }
+    *error = err;
+    return;
+  }
+#endif
   for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter) {
     f = (*c_iter)->getFunction();
     f->fillJac(x, values+nz_cnt, error);
@@ -89,6 +122,18 @@ void Jacobian::fillRowColValues(const double *x, double *values, int *error)
 }
 
 
+void Jacobian::setShared(CGraphPtr cg)
+{
+  shared_ = cg;
+}
+
+
+void Jacobian::setNumThreads(UInt n)
+{
+  nThreads_ = (n>0) ? n : 1;
+}
+
+
 void Jacobian::write(std::ostream &out) const
 {
   out << "nz_ = " << nz_ << std::endl;
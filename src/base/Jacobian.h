@@ -16,6 +16,8 @@
 #include "Types.h"
 
 namespace Minotaur {
+  class CGraph;
+  typedef CGraph* CGraphPtr;
 
 
   /**
@@ -96,6 +98,20 @@ namespace Minotaur {
       virtual void fillColRowValues(const double *, double *, int *)
       { assert(!"implement me!");}
          
+      /**
+       * \brief Set the graph that has the subexpressions shared by the
+       * constraints. fillRowColValues() evaluates it once at x before the
+       * constraints copy their values from it.
+       */
+      void setShared(CGraphPtr cg);
+
+      /**
+       * \brief Set the number of threads used by fillRowColValues(). Each
+       * thread fills the rows of a different set of constraints. The values
+       * do not depend on the number of threads.
+       */
+      void setNumThreads(UInt n);
+
       void write(std::ostream &out) const;
 
     private:
@@ -105,9 +121,21 @@ namespace Minotaur {
        */
       const std::vector<ConstraintPtr> * cons_;
 
+      /// Number of threads used to fill the values.
+      UInt nThreads_;
+
+      /// Graph of shared subexpressions, or NULL. Not owned.
+      CGraphPtr shared_;
+
       /// Number of nonzeros
       UInt nz_;
 
+      /**
+       * Position of the first nonzero of each constraint in the values
+       * array. Has one extra entry, equal to nz_, at the end.
+       */
+      UIntVector nzStart_;
+
   };
   typedef Jacobian* JacobianPtr;
 }
@@ -31,7 +31,8 @@ typedef std::vector<ConstraintPtr>::const_iterator CCIter;
 KnapCovHandler::KnapCovHandler()
   : env_(EnvPtr()),
     minlp_(ProblemPtr()),
-    stats_(0)
+    stats_(0),
+    cutIndex_(0)
 {
   // This is an abstract class, find a way to make this work such as Logger(log1).
   //logger_ = (LoggerPtr) new Logger();
@@ -42,7 +43,8 @@ KnapCovHandler::KnapCovHandler()
 KnapCovHandler::KnapCovHandler(EnvPtr env, ProblemPtr minlp)
   : env_(env),
     minlp_(minlp),
-    stats_(0)
+    stats_(0),
+    cutIndex_(0)
 {
   intTol_ = env_->getOptions()->findDouble("int_tol")->getValue();
   // Initialize logger.
@@ -56,7 +58,7 @@ KnapCovHandler::KnapCovHandler(EnvPtr env, ProblemPtr minlp)
   stats_->singlectwo = 0;
   stats_->time  = 0.0;
   stats_->cutdel = 0;
-  
+  cutIndex_ = new CoverCutIndex();
 }
 
 KnapCovHandler::~KnapCovHandler()
@@ -65,6 +67,9 @@ KnapCovHandler::~KnapCovHandler()
     //writeStats(logger_->MsgStream(LogInfo));
     delete stats_;
   }
+  if (cutIndex_) {
+    delete cutIndex_;
+  }
   //env_.reset();
   //minlp_.reset();
   
@@ -116,8 +121,13 @@ void KnapCovHandler::separate(ConstSolutionPtr sol, NodePtr,
   if (isintfeas ==  false) {
     // We do another check in CoverCutGneerator for integrality, may be we
     // should eliminate it and use the one above.
-    // Generate cover cuts from current relaxation.
-    CoverCutGeneratorPtr cover = (CoverCutGeneratorPtr) new CoverCutGenerator(rel,sol, env_);
+    // Generate cover cuts from current relaxation. Cuts sent to the cut
+    // manager in earlier calls are not generated again. A manager that
+    // finds duplicates itself may drop cuts from its pool, and then our
+    // index would keep them from being generated again.
+    CoverCutIndexPtr sent = cmanager->findsDuplicates() ? 0 : cutIndex_;
+    CoverCutGeneratorPtr cover = (CoverCutGeneratorPtr)
+      new CoverCutGenerator(rel, sol, env_, sent);
     // Add cuts to the relaxation by using cut manager.
     CutVector violatedcuts = cover->getViolatedCutList();
     CutIterator itc;
@@ -142,6 +152,7 @@ void KnapCovHandler::separate(ConstSolutionPtr sol, NodePtr,
     stats_->simple += covstats->simple;
     stats_->gns += covstats->gns;
     stats_->singlectwo += covstats->singlectwo;    
+    delete cover;
   }
 
   
@@ -153,6 +153,12 @@ private:
   /// Tolerance for checking integrality.
   double intTol_;
 
+  /**
+   * Cover cuts sent to the cut manager, kept across calls to separate().
+   * Not used if the cut manager finds duplicates itself.
+   */
+  CoverCutIndexPtr cutIndex_;
+
   /// For log:
   static const std::string me_;
 };
@@ -1082,7 +1082,6 @@ double LGCIGenerator::lift(CoverSetPtr obj,
   std::vector<CoverSetPtr>::iterator end   = origgubs->end();
   UInt index = 0;
   double * bgub;
-  double * copybgub = 0;
   if (liftup == false) {
     for (it=begin ; it!=end; ++it) {
       // Iterators for variables of GUB.
@@ -1103,8 +1102,9 @@ double LGCIGenerator::lift(CoverSetPtr obj,
     } // end of for.
     bgub = initialbgub;
   } else {
-    copybgub = new double[gubcons->size()];
-    std::memcpy(copybgub, initialbgub, sizeof(double)*(gubcons->size()));
+    // Copy of GUB rhs, kept between calls.
+    bgubCopy_.assign(initialbgub, initialbgub+gubcons->size());
+    double * copybgub = bgubCopy_.data();
     // Uplifting case.
     for (it=begin ; it!=end; ++it) {
       // Iterators for variables of GUB.
@@ -1153,7 +1153,6 @@ double LGCIGenerator::lift(CoverSetPtr obj,
   if (liftup == true) {
     // If uplifting.
     alpha = rhs - gamma;
-    delete [] copybgub;
     return alpha;
   } else {
     // If downlifting.
@@ -1706,44 +1705,10 @@ CutPtr LGCIGenerator::generateCut(const ConstCoverSetPtr inequality,
   return cut;
 }
 
-/**
- * TODO: Create a new index for variables in the knapsack only.
- * Do not consider all variables for coefficients.
- */
 bool LGCIGenerator::checkExists(CoverSetPtr inequality, double rhs)
 {
-  // Iterators for variables in cut.
-  CoverSetConstIterator it;
-  CoverSetConstIterator begin = inequality->begin();
-  CoverSetConstIterator end   = inequality->end();
-  // Number of variables in the problem.
-  // Later change this to number of variables in the linear function.
-  UInt numvars = p_->getNumVars();
-  // Vector to include coefficients.
-  std::vector<double> coeffs(numvars,0);
-  // Index of the variable in the problem.
-  UInt index = 0;
-  // Current variable considered.
-  VariablePtr var;
-  // Coefficient divided by rhs of cover inequality.
-  double dividedcoeff;
-  // Add coefficients to coefficient vector one by one.
-  for (it=begin; it!=end; ++it) {
-    var           = it->first;
-    index         = var->getIndex();
-    dividedcoeff  = it->second / rhs;
-    coeffs[index] = dividedcoeff;
-  }
-  
-  // Check if the cut already exists.
-  std::map< std::vector<double>, UInt>::iterator found  = cutmap_.find(coeffs);
-  std::map< std::vector<double>, UInt>::iterator endmap = cutmap_.end();
-  if (found == endmap) {
-    cutmap_.insert(std::pair< std::vector<double>, UInt > (coeffs,stats_->totalcuts));
-    return false; 
-  } else {    
-    return true;
-  }
+  // Check if the cut already exists, add it otherwise.
+  return (false == cutIndex_.insert(inequality, rhs));
 }
 
 double LGCIGenerator::violation(CutPtr cut)
@@ -21,6 +21,7 @@ using std::ofstream;
 using std::string;
 
 
+#include "CoverCutIndex.h"
 #include "KnapsackList.h"
 #include "Problem.h"
 #include "Solution.h"
@@ -325,10 +326,12 @@ private:
   UInt numCons_; 
   // Statistics for LGCI generator.
   LGCIGenStatsPtr stats_;
-  // Hash map that is used to check if a cut is already created or not.
-  std::map< std::vector<double>, UInt> cutmap_;
+  // Index that is used to check if a cut is already created or not.
+  CoverCutIndex cutIndex_;
   // Integer tolerance.
   double intTol_;
+  // Copy of rhs of GUB constraints used by lift() for uplifting.
+  DoubleVector bgubCopy_;
 
   // Output file
   ofstream output_;
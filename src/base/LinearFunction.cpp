@@ -5,6 +5,7 @@
 // 
 
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -18,7 +19,8 @@ using namespace Minotaur;
 
 
 LinearFunction::LinearFunction()
-  : hasChanged_(true),
+  : flatOk_(false),
+    hasChanged_(true),
     tol_(1e-9)
 {
   terms_.clear();
@@ -26,7 +28,8 @@ LinearFunction::LinearFunction()
 
 
 LinearFunction::LinearFunction(const double tol)
-  : hasChanged_(true),
+  : flatOk_(false),
+    hasChanged_(true),
     tol_(tol)
 {
   terms_.clear();
@@ -35,7 +38,8 @@ LinearFunction::LinearFunction(const double tol)
 
 LinearFunction::LinearFunction(double *a, VariableConstIterator vbeg, 
     VariableConstIterator vend, double tol)
-  : hasChanged_(true),
+  : flatOk_(false),
+    hasChanged_(true),
     tol_(tol)
 {
   VariablePtr v;
@@ -61,6 +65,7 @@ void LinearFunction::add(LinearFunctionPtr lf)
       incTerm(it->first, it->second);
     }
     hasChanged_ = true;
+    flatOk_ = false;
   }
 }
 
@@ -72,6 +77,7 @@ void LinearFunction::add(ConstLinearFunctionPtr lf)
       incTerm(it->first, it->second);
     }
     hasChanged_ = true;
+    flatOk_ = false;
   }
 }
 
@@ -82,6 +88,7 @@ void LinearFunction::minus(LinearFunctionPtr lf){
           incTerm(it->first, -1*it->second);
     }
     hasChanged_ = true;
+    flatOk_ = false;
     
     }
 
@@ -91,6 +98,7 @@ void LinearFunction::addTerm(ConstVariablePtr var, const double a)
   if (fabs(a) > tol_) {
     terms_.insert(std::make_pair(var, a));
     hasChanged_ = true;
+    flatOk_ = false;
   }
 }
 
@@ -138,19 +146,30 @@ void LinearFunction::incTerm(ConstVariablePtr var, const double a)
       terms_.erase(var);
     } 
     hasChanged_ = true;
+    flatOk_ = false;
   }
 }
 
 
 double LinearFunction::eval(const std::vector<double> &x) const
 {
-   return(InnerProduct(x, terms_));
+  if (flatOk_) {
+    return eval(x.empty() ? 0 : &x[0]);
+  }
+  return(InnerProduct(x, terms_));
 }
 
 
 double LinearFunction::eval(const double *x) const
 {
   double value = 0;
+  if (flatOk_) {
+    const UInt n = fVals_.size();
+    for (UInt i=0; i<n; ++i) {
+      value += x[fVars_[i]->getIndex()] * fVals_[i];
+    }
+    return value;
+  }
   for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
     value += x[it->first->getIndex()] * it->second;
   }
@@ -160,12 +179,53 @@ double LinearFunction::eval(const double *x) const
 
 void LinearFunction::evalGradient(double *grad_f) const
 {
+  if (flatOk_) {
+    const UInt n = fVals_.size();
+    for (UInt i=0; i<n; ++i) {
+      grad_f[fVars_[i]->getIndex()] += fVals_[i];
+    }
+    return;
+  }
   for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
     grad_f[it->first->getIndex()] += it->second;
   }
 }
 
 
+void LinearFunction::flatten()
+{
+  std::vector<std::pair<UInt, UInt> > order;
+  std::vector<ConstVariablePtr> vars;
+  DoubleVector vals;
+  UInt k;
+
+  if (flatOk_) {
+    return;
+  }
+  order.reserve(terms_.size());
+  vars.reserve(terms_.size());
+  vals.reserve(terms_.size());
+  k = 0;
+  for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end();
+       ++it, ++k) {
+    order.push_back(std::make_pair(it->first->getIndex(), k));
+    vars.push_back(it->first);
+    vals.push_back(it->second);
+  }
+
+  // terms_ is ordered by id. Keep the terms in order of index so that x is
+  // read from front to back.
+  std::sort(order.begin(), order.end());
+  fVars_.resize(order.size());
+  fVals_.resize(order.size());
+  for (k=0; k<order.size(); ++k) {
+    fVars_[k] = vars[order[k].second];
+    fVals_[k] = vals[order[k].second];
+  }
+  flatOk_ = true;
+}
+
+
 void LinearFunction::fillJac(double *values, int *) 
 {
   double *v = values;
@@ -180,15 +240,19 @@ void LinearFunction::computeBounds(double *l, double *u)
   double lb = 0.0;
   double ub = 0.0;
   double a;
+  ConstVariablePtr v;
+  const UInt n = terms_.size();
 
-  for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
-    a = it->second;
+  flatten();
+  for (UInt i=0; i<n; ++i) {
+    a = fVals_[i];
+    v = fVars_[i];
     if (a>0) {
-      lb += a*it->first->getLb();
-      ub += a*it->first->getUb();
+      lb += a*v->getLb();
+      ub += a*v->getUb();
     } else {
-      lb += a*it->first->getUb();
-      ub += a*it->first->getLb();
+      lb += a*v->getUb();
+      ub += a*v->getLb();
     }
   }
   *l = lb;
@@ -225,12 +289,14 @@ void LinearFunction::multiply(double d)
   if (fabs(d) < 1e-7) {
     terms_.clear();
     hasChanged_ = true;
+    flatOk_ = false;
   } else {
     for (VariableGroupIterator it = terms_.begin(); it != terms_.end(); ++it) {
       it->second *= d;
     }
   }
   hasChanged_ = true;
+  flatOk_ = false;
 }
 
 
@@ -273,6 +339,7 @@ void LinearFunction::removeVar(VariablePtr v, double )
 {
   terms_.erase(v);
   hasChanged_ = true;
+  flatOk_ = false;
 }
 
 void LinearFunction::clearAll()
@@ -280,6 +347,7 @@ void LinearFunction::clearAll()
   terms_.clear();
   off_.clear();
   hasChanged_ = true;
+  flatOk_ = false;
 }
 
 
@@ -305,6 +373,7 @@ void LinearFunction::prepJac(VarSetConstIter vbeg, VarSetConstIter vend)
     }
     hasChanged_ = false;
   }
+  flatten();
 }
 
 
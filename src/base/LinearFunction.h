@@ -107,6 +107,17 @@ namespace Minotaur {
 
     void fillJac(double *values, int *error);
 
+    /**
+     * \brief Copy the terms into arrays sorted by the index of the
+     * variable.
+     *
+     * eval(), evalGradient() and computeBounds() read these arrays instead
+     * of the map of terms until the function is changed. Called by
+     * prepJac() and computeBounds(). The arrays keep pointers to the
+     * variables, so they stay valid if the problem renumbers its variables.
+     */
+    void flatten();
+
     double getFixVarOffset(VariablePtr v, double val);
 
     /// Get the number of terms in this function.
@@ -189,6 +200,15 @@ namespace Minotaur {
     QuadraticFunctionPtr copyMult(ConstLinearFunctionPtr l1);
 
   private:
+    /// Coefficients of the terms, in the same order as fVars_.
+    DoubleVector fVals_;
+
+    /// Variables of the terms, sorted by index when flatten() was called.
+    std::vector<ConstVariablePtr> fVars_;
+
+    /// True if fVars_ and fVals_ have the same terms as terms_.
+    bool flatOk_;
+
     /**
      * True if terms in linear function are modified since previous call to
      * prepJac.
@@ -200,7 +220,7 @@ namespace Minotaur {
 
     /**
      * terms_ is a map with variables as keys and their coefficients as
-     * values.
+     * values. Functions are built and changed through this map.
      */
     VariableGroup terms_;
 
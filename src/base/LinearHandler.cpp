@@ -12,9 +12,11 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <unordered_map>
 
 #include "MinotaurConfig.h"
 #include "Branch.h"
@@ -57,7 +59,11 @@ LinearHandler::LinearHandler()
     eTol_(1e-8),
     infty_(1e20),
     pStats_(0),
-    pOpts_(0)
+    pOpts_(0),
+    pNCons_(0),
+    pProb_(0),
+    pValid_(false),
+    pVer_(0)
 {
   linVars_.clear();
 }
@@ -70,7 +76,11 @@ LinearHandler::LinearHandler(EnvPtr env, ProblemPtr problem)
     eTol_(1e-8),
     infty_(1e20),
     pStats_(0),
-    pOpts_(0)
+    pOpts_(0),
+    pNCons_(0),
+    pProb_(0),
+    pValid_(false),
+    pVer_(0)
 {
   logger_ = env->getLogger();
   pStats_ = new LinPresolveStats();
@@ -93,6 +103,7 @@ LinearHandler::LinearHandler(EnvPtr env, ProblemPtr problem)
   pStats_->time = 0.;
   pStats_->timeN = 0.;
   pStats_->nMods = 0;
+  pStats_->rProp = 0;
 
 }
 
@@ -102,6 +113,7 @@ LinearHandler::~LinearHandler()
   delete pStats_;
   delete pOpts_;
   linVars_.clear();
+  propClear_();
 }
 
 
@@ -240,7 +252,7 @@ SolveStatus LinearHandler::presolve(PreModQ *pre_mods, bool *changed0)
   // For each constraint, we do:
   // 1. checkBounds_
   // 2. varBndsFromCons_
-  // 3. dupRows_
+  // 3. dupRows_ and dupCols_
   // 4. coeffImp_
   // For each variable, we do:
   // 1. checkBounds_
@@ -252,9 +264,9 @@ SolveStatus LinearHandler::presolve(PreModQ *pre_mods, bool *changed0)
   // We maintain two flags to avoid repeated unnecessary checks: 
   // 1. For each constraint if c->getBFlag() is true, then check for new
   // bounds on variables of that constraint
-  // 2. if chkDupRows_ is true then check for duplicate rows. This flag is not
-  // constraint specific. Even if one constraint is changed, all constraints
-  // are checked for duplicacy.
+  // 2. if chkDupRows_ is true then check for duplicate rows and columns. This
+  // flag is not constraint specific. Even if one constraint is changed, all
+  // constraints are checked for duplicacy.
 
   chkDupRows_ = true;
   for (ConstraintConstIterator c_iter = problem_->consBegin();
@@ -297,9 +309,14 @@ SolveStatus LinearHandler::presolve(PreModQ *pre_mods, bool *changed0)
       chkSing_(&changed);
       purgeVars_(pre_mods);
     }
-    if (true == chkDupRows_ && true == pOpts_->purgeCons) {
-      dupRows_(&changed);
-      problem_->delMarkedCons();
+    if (true == chkDupRows_) {
+      if (true == pOpts_->dualFix) {
+        dupCols_(&changed);
+      }
+      if (true == pOpts_->purgeCons) {
+        dupRows_(&changed);
+        problem_->delMarkedCons();
+      }
       chkDupRows_ = false;
     }
     if (true == pOpts_->coeffImp) coeffImp_(&changed);
@@ -486,49 +503,37 @@ SolveStatus LinearHandler::varBndsFromCons_(ProblemPtr p, bool apply_to_prob,
                                             bool *changed, ModQ *mods,
                                             UInt *nintmods)
 {
-  ConstraintPtr c_ptr;
   bool t_changed;
   SolveStatus status = Started;
+  UInt r, npops = 0, maxpops;
 
 #if SPEW
   logger_->msgStream(LogDebug2) << me_ << "bounds from constraints." 
                                << std::endl; 
 #endif
 
-  for (ConstraintConstIterator c_iter=p->consBegin(); c_iter!=p->consEnd();
-       ++c_iter) {
-    c_ptr = *c_iter;
-    if (c_ptr->getBFlag() &&  c_ptr->getFunctionType() == Linear &&
-        c_ptr->getQuadraticFunction() == 0 && c_ptr->getNonlinearFunction() == 0
-        && DeletedCons!=c_ptr->getState()) {
-      t_changed = true;
-      c_ptr->setBFlag(false);
-      while (true == t_changed) {
-        status = linBndTighten_(p, apply_to_prob, c_ptr, &t_changed, mods,
-                                nintmods);
-        if (SolvedInfeasible == status) {
-          return SolvedInfeasible;
-        }
-        if (true == t_changed) {
-          *changed = true;
-          if (false==apply_to_prob) {
-            t_changed = false;
-          }
-        }
-      }
-    } else if (c_ptr->getFunctionType() == Constant
-               && DeletedCons!=c_ptr->getState()
-               && apply_to_prob 
-               && pOpts_->purgeCons) {
-#if SPEW
-      logger_->msgStream(LogDebug) << me_ << "constraint " << c_ptr->getName() 
-                                   << " is redundant\n";
-#endif
-      //assert(!"check activity!");
-      p->markDelete(c_ptr);
-      ++(pStats_->conDel);
+  // A row is visited again whenever the bound of one of its variables
+  // changes, until no bound changes. Bounds that converge slowly could keep
+  // the queue busy for long, so the number of visits is limited. Rows that
+  // are left in the queue stay there for the next call.
+  propSync_(p, apply_to_prob);
+  maxpops = (apply_to_prob ? 20 : 2)*pRows_.size() + 100;
+  while (!pQueue_.empty() && npops < maxpops) {
+    r = pQueue_.front();
+    pQueue_.pop_front();
+    ++npops;
+    pRows_[r].queued = false;
+    pRows_[r].c->setBFlag(false);
+    status = linBndTighten_(p, apply_to_prob, r, &t_changed, mods,
+                            nintmods);
+    if (SolvedInfeasible == status) {
+      break;
+    }
+    if (true == t_changed) {
+      *changed = true;
     }
   }
+  pStats_->rProp += npops;
   return status;
 }
 
@@ -644,6 +649,7 @@ void LinearHandler::coeffImp_(bool *changed)
             // constraint is redundant when x0=1
             assert(a0 < 0);
             lf->incTerm(v, ub-uu-a0);
+            pValid_ = false;
             c->setBFlag(true);
             *changed = true;
             chkDupRows_ = true;
@@ -653,6 +659,7 @@ void LinearHandler::coeffImp_(bool *changed)
             // constraint is redundant when x0=1
             assert(a0 > 0);
             lf->incTerm(v, lb-ll-a0);
+            pValid_ = false;
             c->setBFlag(true);
             *changed = true;
             chkDupRows_ = true;
@@ -672,6 +679,7 @@ void LinearHandler::coeffImp_(bool *changed)
             // constraint is redundant when x0=0
             assert(a0 > 0);
             lf->incTerm(v, uu-a0-ub);
+            pValid_ = false;
             problem_->changeBound(c, Upper, uu-a0);
             c->setBFlag(true);
             *changed = true;
@@ -682,6 +690,7 @@ void LinearHandler::coeffImp_(bool *changed)
             // constraint is redundant when x0=0
             assert(a0 < 0);
             lf->incTerm(v, ll-a0-lb);
+            pValid_ = false;
             problem_->changeBound(c, Lower, ll-a0);
             c->setBFlag(true);
             *changed = true;
@@ -871,16 +880,139 @@ void LinearHandler::dualFix_(bool *changed)
 }
 
 
+void LinearHandler::dupCols_(bool *changed)
+{
+  const double width = 1e-8;
+  const UInt m = problem_->getNumCons();
+  LinearFunctionPtr olf = problem_->getObjective()->getLinearFunction();
+  DoubleVector r;
+  DoubleVector cost;
+  VarVector vars;
+  std::vector<DupVec_> dv;
+  std::vector<std::pair<UInt, double> > col;
+  std::vector<std::vector<std::pair<UInt, double> > > cols;
+  std::unordered_multimap<size_t, UInt> buckets;
+  std::pair<std::unordered_multimap<size_t, UInt>::iterator,
+            std::unordered_multimap<size_t, UInt>::iterator> range;
+  ConstraintPtr c;
+  VariablePtr v;
+  DupVec_ d;
+  double w, mult;
+  bool fixed, same;
+  UInt i;
+
+#if SPEW
+  logger_->msgStream(LogDebug) << me_ << "searching for duplicate "
+    << "columns" << std::endl; 
+#endif
+
+  r.reserve(m);
+  for (i=0; i<m; ++i) {
+    r.push_back((double) rand()/(RAND_MAX)*10.0);
+  }
+
+  findLinVars_();
+  for (VarQueueConstIter vit=linVars_.begin(); vit!=linVars_.end(); ++vit) {
+    v = *vit;
+    if (v->getUb() - v->getLb() < eTol_) {
+      continue;
+    }
+    col.clear();
+    for (ConstrSet::iterator cit=v->consBegin(); cit!=v->consEnd(); ++cit) {
+      c = *cit;
+      if (DeletedCons==c->getState() || problem_->isMarkedDel(c)) {
+        continue;
+      }
+      w = c->getLinearFunction()->getWeight(v);
+      if (w != 0.0) {
+        col.push_back(std::make_pair(c->getIndex(), w));
+      }
+    }
+    if (col.empty()) {
+      continue; // left to dualFix_.
+    }
+    std::sort(col.begin(), col.end());
+    d.first = col[0].first;
+    d.nnz = col.size();
+    d.lead = col[0].second;
+    d.proj = 0.0;
+    for (i=0; i<col.size(); ++i) {
+      d.proj += r[col[i].first]*col[i].second;
+    }
+    d.proj /= d.lead;
+    d.cell = (long) floor(d.proj/width);
+    w = olf ? olf->getWeight(v) : 0.0;
+
+    fixed = false;
+    for (long k=d.cell-1; k<=d.cell+1 && !fixed; ++k) {
+      range = buckets.equal_range(dupKey_(d, k));
+      for (std::unordered_multimap<size_t, UInt>::iterator
+           it=range.first; it!=range.second && !fixed; ) {
+        const DupVec_ &e = dv[it->second];
+        const std::vector<std::pair<UInt, double> > &ecol = cols[it->second];
+        if (e.first!=d.first || e.nnz!=d.nnz || 
+            fabs(e.proj-d.proj)>width) {
+          ++it;
+          continue;
+        }
+        // verify that col is mult times ecol.
+        mult = d.lead/e.lead;
+        same = true;
+        for (i=0; i<col.size(); ++i) {
+          if (col[i].first!=ecol[i].first ||
+              fabs(col[i].second/ecol[i].second-mult)>1e-12) {
+            same = false;
+            break;
+          }
+        }
+        if (!same) {
+          ++it;
+          continue;
+        }
+        fixed = fixDupCol_(vars[it->second], v, mult, cost[it->second], w,
+                           changed);
+        if (!fixed && fixDupCol_(v, vars[it->second], 1.0/mult, w,
+                                 cost[it->second], changed)) {
+          // the stored variable is fixed; v takes its place.
+          it = buckets.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    if (!fixed) {
+      buckets.insert(std::make_pair(dupKey_(d, d.cell), (UInt) dv.size()));
+      dv.push_back(d);
+      cols.push_back(col);
+      vars.push_back(v);
+      cost.push_back(w);
+    }
+  }
+}
+
+
+size_t LinearHandler::dupKey_(const DupVec_ &d, long cell) const
+{
+  return (size_t) (cell*73856093L) ^ (size_t) (d.first*19349663L) ^
+         (size_t) (d.nnz*83492791L);
+}
+
+
 void LinearHandler::dupRows_(bool *changed)
 {
+  const double width = 1e-8;
   const UInt n = problem_->getNumVars();
-  const UInt m = problem_->getNumCons();
-  UInt i,j;
-  int err = 0;
-  DoubleVector r1, r2;
-  DoubleVector h1;
-  DoubleVector h2;
-  ConstraintPtr c1, c2;
+  UInt i;
+  DoubleVector r;
+  std::vector<DupVec_> dv;
+  std::vector<ConstraintPtr> rows;
+  std::unordered_multimap<size_t, UInt> buckets;
+  std::pair<std::unordered_multimap<size_t, UInt>::const_iterator,
+            std::unordered_multimap<size_t, UInt>::const_iterator> range;
+  ConstraintPtr c;
+  LinearFunctionPtr lf;
+  VariableGroupConstIterator git;
+  DupVec_ d;
   bool is_deleted;
 
 #if SPEW
@@ -888,68 +1020,114 @@ void LinearHandler::dupRows_(bool *changed)
     << "constraints" << std::endl; 
 #endif
 
-  r1.reserve(n);
-  r2.reserve(n);
-  h1.reserve(m);
-  h2.reserve(m);
-
+  r.reserve(n);
   for (i=0; i<n; ++i) {
-    r1.push_back((double) rand()/(RAND_MAX)*10.0);
-    r2.push_back((double) rand()/(RAND_MAX)*10.0);
+    r.push_back((double) rand()/(RAND_MAX)*10.0);
   }
 
-  i=0;
+  // each row is scaled so that its first coefficient is one. Rows that are
+  // multiples of each other then have the same projection on r.
   for (ConstraintConstIterator it=problem_->consBegin();
-       it!=problem_->consEnd(); ++it, ++i) {
-    c1 = *it;
-    if (c1->getFunctionType()==Linear) {
-      h1[i] = c1->getActivity(&(r1[0]), &err);
-      h2[i] = c1->getActivity(&(r2[0]), &err);
-    } else {
-      h1[i] = h2[i] = 1e30;
+       it!=problem_->consEnd(); ++it) {
+    c = *it;
+    if (c->getFunctionType()!=Linear || problem_->isMarkedDel(c)) {
+      continue;
     }
-  }
-
-  for (i=0; i<m; ++i) {
-    if (h1[i]<1e29) {
-      for (j=i+1; j<m; ++j) {
-        if (fabs(h1[j]-h1[i])<1e-10 ||
-            fabs(h1[j]+h1[i])<1e-10) {
-          c1 = problem_->getConstraint(i);
-          c2 = problem_->getConstraint(j);
-          is_deleted = treatDupRows_(c1, c2, 1.0, changed);
-          //c1->write(std::cout);
-          //c2->write(std::cout);
-          //std::cout << h1[i] << " xxx " << h1[j] << "\n";
-          if (is_deleted) {
-            h1[j] = h2[j] = 1e30;
-          }
-        } else if (h1[j] < 1e29 && fabs(h1[i]/h1[j]-h2[i]/h2[j])<1e-10) {
-          c1 = problem_->getConstraint(i);
-          c2 = problem_->getConstraint(j);
-          is_deleted = treatDupRows_(c1, c2, h1[i]/h1[j], changed);
-          //c1->write(std::cout);
-          //c2->write(std::cout);
-          //std::cout << h1[i] << " *** " << h1[j] << "\n";
-          if (is_deleted) {
-            h1[j] = h2[j] = 1e30;
-          }
+    lf = c->getLinearFunction();
+    if (!lf || 0==lf->getNumTerms() || 0.0==lf->termsBegin()->second) {
+      continue;
+    }
+    git = lf->termsBegin();
+    d.first = git->first->getIndex();
+    d.nnz = lf->getNumTerms();
+    d.lead = git->second;
+    d.proj = 0.0;
+    for (; git!=lf->termsEnd(); ++git) {
+      d.proj += r[git->first->getIndex()]*git->second;
+    }
+    d.proj /= d.lead;
+    d.cell = (long) floor(d.proj/width);
+
+    is_deleted = false;
+    for (long k=d.cell-1; k<=d.cell+1 && !is_deleted; ++k) {
+      range = buckets.equal_range(dupKey_(d, k));
+      for (std::unordered_multimap<size_t, UInt>::const_iterator
+           it2=range.first; it2!=range.second && !is_deleted; ++it2) {
+        const DupVec_ &e = dv[it2->second];
+        if (e.first==d.first && e.nnz==d.nnz &&
+            fabs(e.proj-d.proj)<=width) {
+          is_deleted = treatDupRows_(rows[it2->second], c, e.lead/d.lead,
+                                     changed);
         }
       }
     }
+    if (!is_deleted) {
+      buckets.insert(std::make_pair(dupKey_(d, d.cell), (UInt) dv.size()));
+      dv.push_back(d);
+      rows.push_back(c);
+    }
   }
 }
 
 
+bool LinearHandler::fixDupCol_(VariablePtr v1, VariablePtr v2, double mult,
+                               double c1, double c2, bool *changed)
+{
+  // If v2 is moved from a bound b to x2, v1 can be moved by mult*(x2-b) to
+  // keep all constraints the same. This costs (c1*mult-c2)*(x2-b) and needs
+  // room on one side of v1.
+  VarBoundModPtr mod = 0;
+  double b;
+
+  if (v1->getType()!=Continuous &&
+      (v2->getType()==Continuous || fabs(fabs(mult)-1.0)>1e-12)) {
+    return false;
+  }
+  if (v2->getLb() > -infty_ && c2 >= c1*mult &&
+      ((mult>0 && v1->getUb() >= infty_) ||
+       (mult<0 && v1->getLb() <= -infty_))) {
+    b = v2->getLb();
+    if (v1->getType()!=Continuous && fabs(b-floor(b+0.5)) > intTol_) {
+      return false;
+    }
+    mod = (VarBoundModPtr) new VarBoundMod(v2, Upper, b);
+  } else if (v2->getUb() < infty_ && c2 <= c1*mult &&
+             ((mult>0 && v1->getLb() <= -infty_) ||
+              (mult<0 && v1->getUb() >= infty_))) {
+    b = v2->getUb();
+    if (v1->getType()!=Continuous && fabs(b-floor(b+0.5)) > intTol_) {
+      return false;
+    }
+    mod = (VarBoundModPtr) new VarBoundMod(v2, Lower, b);
+  } else {
+    return false;
+  }
+
+#if SPEW
+  logger_->msgStream(LogDebug) << me_ << "fixed variable " << v2->getName()
+                               << " to " << b << " as its column is "
+                               << mult << " times that of " << v1->getName()
+                               << std::endl;
+#endif
+  changeBFlag_(v2);
+  mod->applyToProblem(problem_);
+  delete mod;
+  ++(pStats_->vBnd);
+  *changed = true;
+  return true;
+}
+
+
 SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob, 
-                                          ConstraintPtr c_ptr, bool *changed,
-                                          ModQ *mods, UInt *nintmods)
+                                          UInt r, bool *changed, ModQ *mods,
+                                          UInt *nintmods)
 {
+  ConstraintPtr c_ptr = pRows_[r].c;
   LinearFunctionPtr lf = c_ptr->getLinearFunction();
   double lb = c_ptr->getLb();
   double ub = c_ptr->getUb();
   double ll, uu;
-  double sing_ll = -INFINITY, sing_uu = INFINITY;
+  double sing_ll, sing_uu;
 
   *changed = false;
 
@@ -958,10 +1136,7 @@ SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob,
   }
 
   assert(lf);
-  getLfBnds_(lf, &ll, &uu);
-  if (ll < -infty_ || uu > infty_) {
-    getSingLfBnds_(lf, &sing_ll, &sing_uu);
-  }
+  propRowBnds_(r, &ll, &uu, &sing_ll, &sing_uu);
 
   if (apply_to_prob && ll >= lb - eTol_ && uu <= ub + eTol_) {
 #if SPEW
@@ -1017,10 +1192,8 @@ SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob,
   }
 
   if (true == *changed) {
-    getLfBnds_(lf, &ll, &uu);
-    if (ll < -infty_ || uu > infty_) {
-      getSingLfBnds_(lf, &sing_ll, &sing_uu);
-    }
+    // the cached activities were updated with each change.
+    propRowBnds_(r, &ll, &uu, &sing_ll, &sing_uu);
   }
 
   // c_ptr->write(std::cout);
@@ -1037,6 +1210,225 @@ SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob,
 }
 
 
+void LinearHandler::propAddTerm_(PropRow_ &row, double a, double lb,
+                                 double ub, int sign)
+{
+  double lo = (a>0) ? lb : ub;
+  double hi = (a>0) ? ub : lb;
+
+  if (lo <= -infty_ || lo >= infty_) {
+    row.minInf += sign;
+  } else {
+    row.minFin += sign*a*lo;
+    if (sign<0 && fabs(a*lo) > 1e6) {
+      row.exact = false;
+    }
+  }
+  if (hi <= -infty_ || hi >= infty_) {
+    row.maxInf += sign;
+  } else {
+    row.maxFin += sign*a*hi;
+    if (sign<0 && fabs(a*hi) > 1e6) {
+      row.exact = false;
+    }
+  }
+}
+
+
+void LinearHandler::propAddRow_(ProblemPtr p, ConstraintPtr c,
+                                bool apply_to_prob, bool queue)
+{
+  LinearFunctionPtr lf;
+  VariablePtr v;
+  PropRow_ row;
+  UInt j;
+
+  if (DeletedCons==c->getState()) {
+    return;
+  }
+  if (c->getFunctionType() == Linear && c->getQuadraticFunction() == 0 &&
+      c->getNonlinearFunction() == 0) {
+    lf = c->getLinearFunction();
+    row.c = c;
+    row.lb = c->getLb();
+    row.ub = c->getUb();
+    row.minFin = row.maxFin = 0.0;
+    row.minInf = row.maxInf = 0;
+    row.exact = true;
+    row.queued = false;
+    for (VariableGroupConstIterator vit=lf->termsBegin();
+         vit!=lf->termsEnd(); ++vit) {
+      v = p->getVariable(vit->first->getIndex());
+      j = v->getIndex();
+      pRowVar_.push_back(v);
+      pRowVal_.push_back(vit->second);
+      propAddTerm_(row, vit->second, pLb_[j], pUb_[j], 1);
+      pCols_[j].push_back(std::make_pair((UInt) pRows_.size(),
+                                         vit->second));
+    }
+    pRowStart_.push_back(pRowVar_.size());
+    pRows_.push_back(row);
+    if (queue || c->getBFlag()) {
+      propQueue_(pRows_.size()-1);
+    }
+  } else if (c->getFunctionType() == Constant && apply_to_prob &&
+             pOpts_->purgeCons) {
+#if SPEW
+    logger_->msgStream(LogDebug) << me_ << "constraint " << c->getName() 
+                                 << " is redundant\n";
+#endif
+    p->markDelete(c);
+    ++(pStats_->conDel);
+  }
+}
+
+
+void LinearHandler::propClear_()
+{
+  pCols_.clear();
+  pLb_.clear();
+  pNCons_ = 0;
+  pProb_ = 0;
+  pQueue_.clear();
+  pRows_.clear();
+  pRowStart_.clear();
+  pRowVal_.clear();
+  pRowVar_.clear();
+  pUb_.clear();
+  pValid_ = false;
+}
+
+
+void LinearHandler::propInit_(ProblemPtr p, bool apply_to_prob,
+                              bool queue_all)
+{
+  const UInt n = p->getNumVars();
+
+  propClear_();
+  pProb_ = p;
+  pVer_ = p->getStructVer();
+  pValid_ = true;
+  pCols_.resize(n);
+  pLb_.resize(n);
+  pUb_.resize(n);
+  for (UInt j=0; j<n; ++j) {
+    pLb_[j] = p->getVariable(j)->getLb();
+    pUb_[j] = p->getVariable(j)->getUb();
+  }
+  pRowStart_.push_back(0);
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd(); ++it) {
+    propAddRow_(p, *it, apply_to_prob, queue_all);
+  }
+  pNCons_ = p->getNumCons();
+}
+
+
+void LinearHandler::propQueue_(UInt r)
+{
+  if (false==pRows_[r].queued) {
+    pRows_[r].queued = true;
+    pQueue_.push_back(r);
+  }
+  pRows_[r].c->setBFlag(true);
+}
+
+
+void LinearHandler::propRowBnds_(UInt r, double *ll, double *uu,
+                                 double *sing_ll, double *sing_uu)
+{
+  PropRow_ &row = pRows_[r];
+
+  if (false==row.exact) {
+    row.minFin = row.maxFin = 0.0;
+    row.minInf = row.maxInf = 0;
+    row.exact = true;
+    for (UInt k=pRowStart_[r]; k<pRowStart_[r+1]; ++k) {
+      propAddTerm_(row, pRowVal_[k], pRowVar_[k]->getLb(),
+                   pRowVar_[k]->getUb(), 1);
+    }
+  }
+  *ll = (row.minInf>0) ? -INFINITY : row.minFin;
+  *uu = (row.maxInf>0) ? INFINITY : row.maxFin;
+  *sing_ll = (row.minInf>1) ? -INFINITY : row.minFin;
+  *sing_uu = (row.maxInf>1) ? INFINITY : row.maxFin;
+}
+
+
+void LinearHandler::propSync_(ProblemPtr p, bool apply_to_prob)
+{
+  const UInt n = p->getNumVars();
+  const UInt n0 = pLb_.size();
+  VariablePtr v;
+  double lb, ub;
+
+  if (p!=pProb_ || false==pValid_ || p->getStructVer()!=pVer_ || n<n0 ||
+      p->getNumCons()<pNCons_) {
+    // in presolve, all rows to be checked are flagged. At a node, bounds
+    // may have changed anywhere since the last call.
+    propInit_(p, apply_to_prob, !apply_to_prob);
+    return;
+  }
+
+  // variables whose bounds changed since the last call.
+  for (UInt j=0; j<n0; ++j) {
+    v = p->getVariable(j);
+    lb = v->getLb();
+    ub = v->getUb();
+    if (lb!=pLb_[j] || ub!=pUb_[j]) {
+      varBndChanged_(v, pLb_[j], pUb_[j]);
+    }
+  }
+
+  // new variables and constraints.
+  pCols_.resize(n);
+  pLb_.resize(n);
+  pUb_.resize(n);
+  for (UInt j=n0; j<n; ++j) {
+    pLb_[j] = p->getVariable(j)->getLb();
+    pUb_[j] = p->getVariable(j)->getUb();
+  }
+  for (UInt i=pNCons_; i<p->getNumCons(); ++i) {
+    propAddRow_(p, p->getConstraint(i), apply_to_prob, true);
+  }
+  pNCons_ = p->getNumCons();
+
+  // rows whose bounds changed, or that were flagged.
+  for (UInt r=0; r<pRows_.size(); ++r) {
+    PropRow_ &row = pRows_[r];
+    if (DeletedCons==row.c->getState()) {
+      continue;
+    } else if (row.c->getLb()!=row.lb || row.c->getUb()!=row.ub) {
+      row.lb = row.c->getLb();
+      row.ub = row.c->getUb();
+      propQueue_(r);
+    } else if (row.c->getBFlag() && false==row.queued) {
+      propQueue_(r);
+    }
+  }
+}
+
+
+void LinearHandler::varBndChanged_(VariablePtr v, double old_lb,
+                                   double old_ub)
+{
+  const UInt j = v->getIndex();
+  UInt r;
+
+  if (j<pCols_.size()) {
+    for (UInt k=0; k<pCols_[j].size(); ++k) {
+      r = pCols_[j][k].first;
+      propAddTerm_(pRows_[r], pCols_[j][k].second, old_lb, old_ub, -1);
+      propAddTerm_(pRows_[r], pCols_[j][k].second, v->getLb(), v->getUb(),
+                   1);
+      propQueue_(r);
+    }
+    pLb_[j] = v->getLb();
+    pUb_[j] = v->getUb();
+  }
+  changeBFlag_(v);
+}
+
+
 void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob, 
                                           LinearFunctionPtr lf, double lb,
                                           double uu, bool is_sing,
@@ -1046,6 +1438,7 @@ void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob,
   ConstVariablePtr cvar;
   VariablePtr var;
   double coef, vlb, vub, nlb, nub;
+  double old_lb, old_ub;
   VarBoundModPtr mod;
 
   for (VariableGroupConstIterator it=lf->termsBegin(); it != lf->termsEnd(); 
@@ -1065,9 +1458,11 @@ void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob,
         if (nlb > var->getUb()-eTol_) {
           nlb = var->getUb();
         }
-        changeBFlag_(var);
+        old_lb = var->getLb();
+        old_ub = var->getUb();
         mod = (VarBoundModPtr) new VarBoundMod(var, Lower, nlb);
         mod->applyToProblem(p);
+        varBndChanged_(var, old_lb, old_ub);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 1: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1100,9 +1495,11 @@ void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob,
           nub = var->getLb();
         }
 
-        changeBFlag_(var);
+        old_lb = var->getLb();
+        old_ub = var->getUb();
         mod = (VarBoundModPtr) new VarBoundMod(var, Upper, nub);
         mod->applyToProblem(p);
+        varBndChanged_(var, old_lb, old_ub);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 2: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1137,6 +1534,7 @@ void LinearHandler::updateLfBoundsFromUb_(ProblemPtr p, bool apply_to_prob,
   ConstVariablePtr cvar;
   VariablePtr var;
   double coef, vlb, vub, nlb, nub;
+  double old_lb, old_ub;
   VarBoundModPtr mod;
 
   for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd(); 
@@ -1156,9 +1554,11 @@ void LinearHandler::updateLfBoundsFromUb_(ProblemPtr p, bool apply_to_prob,
         if (nub < var->getLb()+eTol_) {
           nub = var->getLb();
         }
-        changeBFlag_(var);
+        old_lb = var->getLb();
+        old_ub = var->getUb();
         mod = (VarBoundModPtr) new VarBoundMod(var, Upper, nub);
         mod->applyToProblem(p);
+        varBndChanged_(var, old_lb, old_ub);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 3: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1190,9 +1590,11 @@ void LinearHandler::updateLfBoundsFromUb_(ProblemPtr p, bool apply_to_prob,
         if (nlb > var->getUb()-eTol_) {
           nlb = var->getUb();
         }
-        changeBFlag_(var);
+        old_lb = var->getLb();
+        old_ub = var->getUb();
         mod = (VarBoundModPtr) new VarBoundMod(var, Lower, nlb);
         mod->applyToProblem(p);
+        varBndChanged_(var, old_lb, old_ub);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 4: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1604,16 +2006,9 @@ void LinearHandler::simplePresolve(ProblemPtr p, SolutionPoolPtr spool,
   UInt iters = 1;
   UInt nintmods;
   Timer *timer = 0;
-  ConstraintPtr c_ptr;
   timer = env_->getNewTimer();
   timer->start();
 
-  for (ConstraintConstIterator c_iter = p->consBegin(); c_iter != p->consEnd();
-       ++c_iter) {
-    c_ptr = *c_iter;
-    c_ptr->setBFlag(true);
-  }
-
   while (true == changed && iters <= max_iters &&
          (iters <= min_iters || nintmods > 0) &&
          status != SolvedInfeasible) {
@@ -1742,6 +2137,7 @@ void LinearHandler::writePreStats(std::ostream &out) const
     << me_ << "Times coefficients improved    = "<< pStats_->cImp   << std::endl
     << me_ << "Times binary variable relaxed  = "<< pStats_->bImpl  << std::endl
     << me_ << "Changes in nodes               = "<< pStats_->nMods  << std::endl
+    << me_ << "Rows visited in propagation    = "<< pStats_->rProp  << std::endl
     ;
 }
 
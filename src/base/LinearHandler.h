@@ -14,6 +14,7 @@
 #ifndef MINOTAURLINEARHANDLER_H
 #define MINOTAURLINEARHANDLER_H
 
+#include <deque>
 #include "Handler.h"
 
 namespace Minotaur {
@@ -33,6 +34,7 @@ struct LinPresolveStats
   int cImp;    ///> Number of times coefficient in a constraint was improved.
   int bImpl;   ///> No. of times a binary var. was changed to implied binary.
   int nMods;   ///> Number of changes made in all nodes.
+  int rProp;   ///> Number of rows visited in propagating bounds.
 };
 
 /// Options for presolve.
@@ -188,6 +190,75 @@ protected:
    */
   VarQueue linVars_;
 
+  /**
+   * A row or a column in the search for duplicates. Parallel vectors have
+   * the same first index, the same number of nonzeros and nearly the same
+   * proj, so only vectors in the same or adjacent cells of proj are
+   * compared.
+   */
+  struct DupVec_ {
+    UInt first;  /// Index of the first nonzero.
+    UInt nnz;    /// Number of nonzeros.
+    double lead; /// Value of the first nonzero.
+    double proj; /// Product with a random vector, divided by lead.
+    long cell;   /// Cell of proj.
+  };
+
+  /// A linear constraint in the propagation of bounds.
+  struct PropRow_ {
+    ConstraintPtr c; ///< The constraint.
+    double lb;       ///< Lower bound of c when it was last checked.
+    double ub;       ///< Upper bound of c when it was last checked.
+    double minFin;   ///< Sum of the finite terms of the minimum activity.
+    double maxFin;   ///< Sum of the finite terms of the maximum activity.
+    int minInf;      ///< Number of infinite terms of the minimum activity.
+    int maxInf;      ///< Number of infinite terms of the maximum activity.
+    bool exact;      ///< False if a large term was removed from the sums.
+    bool queued;     ///< True if the row is in pQueue_.
+  };
+
+  /**
+   * Nonzeros of the column of each variable, as pairs of the row in pRows_
+   * and the coefficient.
+   */
+  std::vector<std::vector<std::pair<UInt, double> > > pCols_;
+
+  /// Lower bounds of the variables used in the activities of the rows.
+  DoubleVector pLb_;
+
+  /// Number of constraints of pProb_ that were seen.
+  UInt pNCons_;
+
+  /// Problem whose rows are stored for propagation, or NULL.
+  ProblemPtr pProb_;
+
+  /// Rows whose bounds may tighten the bounds of their variables.
+  std::deque<UInt> pQueue_;
+
+  /// Linear constraints whose bounds are propagated.
+  std::vector<PropRow_> pRows_;
+
+  /// Start of each row in pRowVar_ and pRowVal_.
+  UIntVector pRowStart_;
+
+  /// Coefficients of the nonzeros of the rows.
+  DoubleVector pRowVal_;
+
+  /// Variables of the nonzeros of the rows.
+  VarVector pRowVar_;
+
+  /// Upper bounds of the variables used in the activities of the rows.
+  DoubleVector pUb_;
+
+  /**
+   * False if a linear function of pProb_ was changed in place, so that the
+   * rows must be built again.
+   */
+  bool pValid_;
+
+  /// Value of getStructVer() of pProb_ when the rows were built.
+  UInt pVer_;
+
 
   /// For log.
   static const std::string me_;
@@ -213,8 +284,38 @@ protected:
   void delFixedVars_(bool *changed);
 
   void dualFix_(bool *changed);
+
+  /**
+   * \brief Find pairs of variables whose columns are parallel and fix one
+   * of them to a bound if the other can take up its contribution at no
+   * larger cost.
+   *
+   * Only variables that appear linearly everywhere are considered.
+   * \param[out] changed Set to true if a variable is fixed.
+   */
+  void dupCols_(bool *changed);
+
+  /// Bucket key of a vector of the search for duplicates in a cell.
+  size_t dupKey_(const DupVec_ &d, long cell) const;
+
+  /**
+   * \brief Find pairs of parallel linear constraints and replace them by
+   * one constraint with the tighter bounds. Candidates are found by hashing
+   * and verified by treatDupRows_.
+   */
   void dupRows_(bool *changed);
 
+  /**
+   * \brief Fix v2 to a bound if its column is mult times the column of
+   * v1 and v1 can take up the change at no larger cost.
+   *
+   * \param[in] c1 Objective coefficient of v1.
+   * \param[in] c2 Objective coefficient of v2.
+   * \return True if v2 is fixed.
+   */
+  bool fixDupCol_(VariablePtr v1, VariablePtr v2, double mult, double c1,
+                  double c2, bool *changed);
+
   /// check if lb <= ub for all variables and constraints.
   SolveStatus checkBounds_(ProblemPtr p);
 
@@ -229,8 +330,64 @@ protected:
   void getLfBnds_(LinearFunctionPtr lf, double *lo, double *up);
   void getSingLfBnds_(LinearFunctionPtr lf, double *lo, double *up);
 
-  SolveStatus linBndTighten_(ProblemPtr p, bool apply_to_prob, 
-                      ConstraintPtr c_ptr, bool *changed, ModQ *mods, UInt *nintmods);
+  /**
+   * \brief Tighten bounds of variables using the bounds of one row of the
+   * propagation.
+   *
+   * \param[in] r The row in pRows_. Its activities are read from the
+   * cached sums.
+   * \param[out] changed True if the bound of a variable changed.
+   */
+  SolveStatus linBndTighten_(ProblemPtr p, bool apply_to_prob, UInt r,
+                             bool *changed, ModQ *mods, UInt *nintmods);
+
+  /// Add (sign 1) or remove (sign -1) a term to the activities of a row.
+  void propAddTerm_(PropRow_ &row, double a, double lb, double ub,
+                    int sign);
+
+  /**
+   * \brief Add constraint c of p as a new row if it is linear, and queue the
+   * row if queue is true. Constant constraints are deleted if apply_to_prob
+   * is true.
+   */
+  void propAddRow_(ProblemPtr p, ConstraintPtr c, bool apply_to_prob,
+                   bool queue);
+
+  /// Free the data of the propagation.
+  void propClear_();
+
+  /**
+   * \brief Build the rows and columns of the linear constraints of p. Queue
+   * all rows if queue_all is true, and only the rows whose BFlag is true
+   * otherwise.
+   */
+  void propInit_(ProblemPtr p, bool apply_to_prob, bool queue_all);
+
+  /// Add row r to the queue and set the BFlag of its constraint.
+  void propQueue_(UInt r);
+
+  /// Find the bounds of a row from its cached activities.
+  void propRowBnds_(UInt r, double *ll, double *uu, double *sing_ll,
+                    double *sing_uu);
+
+  /**
+   * \brief Bring the rows of the propagation up to date with p.
+   *
+   * The rows are built again only if p is not the problem they were built
+   * for, or if a constraint or variable of p was deleted or changed since.
+   * Otherwise new constraints are added as new rows, the activities of the
+   * rows of variables whose bounds changed are updated, and only these rows,
+   * the rows whose bounds changed and the rows whose BFlag is true are
+   * queued.
+   */
+  void propSync_(ProblemPtr p, bool apply_to_prob);
+
+  /**
+   * \brief Update the activities of the rows of v after its bounds change
+   * from old_lb and old_ub, and queue these rows. Also set the BFlag of the
+   * constraints of v.
+   */
+  void varBndChanged_(VariablePtr v, double old_lb, double old_ub);
 
   void purgeVars_(PreModQ *pre_mods);
 
@@ -899,8 +899,8 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
     } else if (br_status==ModifiedByBrancher) {
       for (ModificationConstIterator miter=mods.begin(); miter!=mods.end();
            ++miter) {
-        node->addPMod(*miter);
         (*miter)->applyToProblem(relaxation_);
+        node->addPMod(*miter);
       }
       should_resolve = true;
     } 
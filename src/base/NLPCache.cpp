@@ -0,0 +1,164 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file NLPCache.cpp
+ * \brief Define class NLPCache for saving the results of NLPs solved with
+ * integer variables fixed.
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include "MinotaurConfig.h"
+#include "Environment.h"
+#include "NLPCache.h"
+#include "Option.h"
+#include "Problem.h"
+#include "Variable.h"
+
+using namespace Minotaur;
+
+const std::string NLPCache::me_ = "NLPCache: ";
+
+NLPCache::NLPCache(EnvPtr env)
+  : hits_(0),
+    misses_(0)
+{
+  int n = env->getOptions()->findInt("nlp_cache_size")->getValue();
+  maxSize_ = (n>0) ? n : 0;
+}
+
+
+NLPCache::~NLPCache()
+{
+  entries_.clear();
+  keys_.clear();
+}
+
+
+bool NLPCache::find(ProblemPtr p, const double *x, EngineStatus *status,
+                    double *obj, DoubleVector &sol)
+{
+  DoubleVector key;
+  bool found = false;
+
+  if (0==maxSize_) {
+    return false;
+  }
+  getKey_(p, x, key);
+#pragma omp critical (nlpCache)
+  {
+    std::unordered_map<DoubleVector, Entry_, KeyHash_>::const_iterator it;
+    it = entries_.find(key);
+    if (it!=entries_.end()) {
+      *status = it->second.status;
+      *obj = it->second.obj;
+      sol = it->second.x;
+      found = true;
+      ++hits_;
+    } else {
+      ++misses_;
+    }
+  }
+  return found;
+}
+
+
+void NLPCache::getKey_(ProblemPtr p, const double *x, DoubleVector &key)
+  const
+{
+  VariablePtr v;
+
+  key.clear();
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    v = *it;
+    if (v->getType()==Binary || v->getType()==Integer) {
+      key.push_back(floor(x[v->getIndex()] + 0.5));
+    }
+  }
+}
+
+
+UInt NLPCache::getSize() const
+{
+  return entries_.size();
+}
+
+
+void NLPCache::insert(ProblemPtr p, const double *x, EngineStatus status,
+                      double obj, const double *sol)
+{
+  DoubleVector key;
+  Entry_ e;
+
+  if (0==maxSize_ || false==keeps(status)) {
+    return;
+  }
+  getKey_(p, x, key);
+  e.status = status;
+  e.obj = obj;
+  e.x.assign(sol, sol+p->getNumVars());
+#pragma omp critical (nlpCache)
+  {
+    if (entries_.insert(std::make_pair(key, e)).second) {
+      keys_.push_back(key);
+      if (keys_.size() > maxSize_) {
+        entries_.erase(keys_.front());
+        keys_.pop_front();
+      }
+    }
+  }
+}
+
+
+bool NLPCache::keeps(EngineStatus status)
+{
+  switch (status) {
+  case (ProvenOptimal):
+  case (ProvenLocalOptimal):
+  case (ProvenInfeasible):
+  case (ProvenLocalInfeasible):
+  case (ProvenObjectiveCutOff):
+    return true;
+  default:
+    return false;
+  }
+}
+
+
+size_t NLPCache::KeyHash_::operator()(const DoubleVector &key) const
+{
+  size_t h = key.size();
+  long long b;
+
+  for (DoubleVector::const_iterator it=key.begin(); it!=key.end(); ++it) {
+    b = (long long) *it;
+    h ^= (size_t) b + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+
+void NLPCache::writeStats(std::ostream &out) const
+{
+  out << me_ << "number of results saved       = " << entries_.size()
+      << std::endl
+      << me_ << "number of lookups found       = " << hits_ << std::endl
+      << me_ << "number of lookups not found   = " << misses_ << std::endl;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,137 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file NLPCache.h
+ * \brief Declare class NLPCache for saving the results of NLPs solved with
+ * integer variables fixed.
+ */
+
+
+#ifndef MINOTAURNLPCACHE_H
+#define MINOTAURNLPCACHE_H
+
+#include <deque>
+#include <unordered_map>
+#include "Types.h"
+
+namespace Minotaur {
+
+/**
+ * \brief Save the outcome of NLPs in which the integer variables are fixed,
+ * so that an NLP is not solved again when the same integer assignment is
+ * seen at another node.
+ *
+ * An outcome is the status of the engine, the objective value and the
+ * primal solution. The cuts that a handler derives from these are
+ * regenerated from the saved solution. Results are keyed on the rounded
+ * values of the binary and integer variables of the problem, in the order
+ * of their indices, so copies of a problem made for different threads may
+ * share one cache. All public methods are safe to call from several
+ * threads.
+ *
+ * When the cache is full, the oldest result is dropped. A cache of size
+ * zero saves nothing.
+ */
+class NLPCache {
+public:
+  /**
+   * \brief Construct an empty cache.
+   *
+   * \param [in] env Environment. The number of results kept is read from
+   * option "nlp_cache_size".
+   */
+  NLPCache(EnvPtr env);
+
+  /// Destroy.
+  ~NLPCache();
+
+  /**
+   * \brief Find the outcome of the NLP in which the integer variables of p
+   * are fixed to the rounded values in x.
+   *
+   * \param [in] p The problem whose integer variables are fixed.
+   * \param [in] x Point from which the values of the integer variables are
+   * rounded.
+   * \param [out] status Status of the engine.
+   * \param [out] obj Objective value of the saved solution.
+   * \param [out] sol Saved primal solution, one value for each variable.
+   * \return True if the outcome is found, false otherwise.
+   */
+  bool find(ProblemPtr p, const double *x, EngineStatus *status,
+            double *obj, DoubleVector &sol);
+
+  /// Return the number of saved results.
+  UInt getSize() const;
+
+  /**
+   * \brief Save the outcome of the NLP in which the integer variables of p
+   * are fixed to the rounded values in x. Nothing is saved if keeps(status)
+   * is false.
+   *
+   * \param [in] sol Primal solution of the NLP, one value for each variable
+   * of p.
+   */
+  void insert(ProblemPtr p, const double *x, EngineStatus status,
+              double obj, const double *sol);
+
+  /**
+   * \brief Return true if results with this status are saved. These are
+   * the statuses after which the engine has a solution.
+   */
+  static bool keeps(EngineStatus status);
+
+  /// Write statistics.
+  void writeStats(std::ostream &out) const;
+
+private:
+  /// A saved outcome.
+  struct Entry_ {
+    EngineStatus status; /// Status of the engine.
+    double obj;          /// Objective value.
+    DoubleVector x;      /// Primal solution.
+  };
+
+  /// Hash of the values of the integer variables.
+  struct KeyHash_ {
+    size_t operator()(const DoubleVector &key) const;
+  };
+
+  /// Saved outcomes.
+  std::unordered_map<DoubleVector, Entry_, KeyHash_> entries_;
+
+  /// Number of calls to find() that found a saved outcome.
+  UInt hits_;
+
+  /// Keys in the order in which they were saved, oldest first.
+  std::deque<DoubleVector> keys_;
+
+  /// Number of calls to find() that did not find a saved outcome.
+  UInt misses_;
+
+  /// Maximum number of saved outcomes.
+  UInt maxSize_;
+
+  /// For logging.
+  static const std::string me_;
+
+  /// Fill key with the rounded values of the integer variables of p in x.
+  void getKey_(ProblemPtr p, const double *x, DoubleVector &key) const;
+};
+typedef NLPCache* NLPCachePtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
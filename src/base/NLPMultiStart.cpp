@@ -11,17 +11,23 @@
  */
 
 #include <cmath> // for INFINITY
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
+#include "Constraint.h"
 #include "Engine.h"
 #include "Variable.h"
 #include "Environment.h"
 #include "NLPMultiStart.h"
 #include "Logger.h"
 #include "Node.h"
+#include "Objective.h"
 #include "Operations.h"
 #include "Option.h"
 #include "SolutionPool.h"
+#include "Solution.h"
 #include "Timer.h"
 #include <iomanip>
 #include <algorithm>
@@ -35,6 +41,8 @@ const std::string NLPMultiStart::me_ = "NLP Multi-Start Heuristic: ";
 NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
 : e_(e),
   env_(env),
+  mlslSamples_(0),
+  mlslThreads_(1),
   p_(p)
 {
   VariablePtr variable;
@@ -47,6 +55,10 @@ NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
   distBound_ = (distBound_ >= INFINITY) ? 10.0*sqrt(n) : sqrt(distBound_);
   logger_ = env->getLogger();
   random_                  = new double[n];  
+  mlslSamples_ = std::max(0, env->getOptions()->findInt("msheur_samples")
+                          ->getValue());
+  mlslThreads_ = std::max(1, env->getOptions()->findInt("msheur_threads")
+                          ->getValue());
 
   // statistics
   stats_.numNLPs           = 0;
@@ -56,12 +68,17 @@ NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
   stats_.time              = 0;
   stats_.iterations        = 0;
   stats_.bestObjValue      = INFINITY;
+  stats_.numSamples        = 0;
+  stats_.numMinima         = 0;
 
 }
 
 
 NLPMultiStart::~NLPMultiStart(){
   delete [] random_;
+  for (UInt i=0; i<eCopies_.size(); ++i) {
+    delete eCopies_[i];
+  }
 }
 
 
@@ -111,6 +128,32 @@ void NLPMultiStart::constructInitial_(double* a, const double* b, double rho,
 }
 
 
+double NLPMultiStart::merit_(const double *x)
+{
+  const double penalty = 1e3; // weight of violation of constraints.
+  ObjectivePtr o = p_->getObjective();
+  ConstraintPtr c;
+  double merit = 0.0;
+  double act;
+  int err = 0;
+
+  if (o) {
+    merit = o->eval(x, &err);
+  }
+  for (ConstraintConstIterator it=p_->consBegin(); it!=p_->consEnd() &&
+       0==err; ++it) {
+    c = *it;
+    act = c->getActivity(x, &err);
+    merit += penalty*(std::max(0.0, act-c->getUb()) +
+                      std::max(0.0, c->getLb()-act));
+  }
+  if (0!=err || std::isnan(merit)) {
+    return INFINITY;
+  }
+  return merit;
+}
+
+
 void NLPMultiStart::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
 {
   ConstSolutionPtr sol; 
@@ -122,8 +165,17 @@ void NLPMultiStart::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
   double rho                     = rho_initial;
   Timer *timer                   = env_->getNewTimer();
   UInt n                         = p_->getNumVars();
-  double* prev_feasible          = new double[n];
-  double* initial_point          = new double[n];
+  double* prev_feasible;
+  double* initial_point;
+
+  if (mlslSamples_>0) {
+    delete timer;
+    solveMLSL_(s_pool);
+    return;
+  }
+
+  prev_feasible = new double[n];
+  initial_point = new double[n];
 
   // start at a random point.
   for (UInt i=0; i<n; ++i){
@@ -199,6 +251,239 @@ void NLPMultiStart::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
 }
 
 
+void NLPMultiStart::solveMLSL_(SolutionPoolPtr s_pool)
+{
+  UInt heur_bound                = 10; // no. of rounds of sampling
+  UInt unchanged_obj_count_limit =  3;
+  double obj_tol                 = 1e-6;
+  double reduce                  = 0.1;  // fraction of points kept by merit
+  double sigma                   = 4.0;  // of the critical distance
+  double half_width              = 10.0; // of the box of an unbounded var
+  double min_tol                 = 1e-4; // distance between distinct minima
+  double time_limit              = env_->getOptions()->
+    findDouble("heur_time_limit")->getValue();
+  Timer *timer                   = env_->getNewTimer();
+  UInt n                         = p_->getNumVars();
+  DoubleVector lo(n), wd(n);
+  std::vector<DoubleVector> pts;    // sampled points, scaled to [0,1]^n.
+  std::vector<DoubleVector> minima; // local minima, scaled to [0,1]^n.
+  DoubleVector merits;
+  UIntVector started;               // 1 if an NLP was started from a point.
+  UIntVector order, starts;
+  std::vector<EnginePtr> engines;
+  std::vector<ProblemPtr> probs;
+  DoubleVector x(n);
+  VariablePtr v;
+  ProblemPtr q;
+  EnginePtr e;
+  bool stop = false;
+  bool improved;
+  UInt nt;
+
+  // points are sampled from the bounds of the variables. Unbounded
+  // variables get a box of width 2*half_width.
+  for (UInt j=0; j<n; ++j) {
+    double l, u;
+    v = p_->getVariable(j);
+    l = v->getLb();
+    u = v->getUb();
+    if (l <= -INFINITY && u >= INFINITY) {
+      l = -half_width;
+      u = half_width;
+    } else if (l <= -INFINITY) {
+      l = u - 2.0*half_width;
+    } else if (u >= INFINITY) {
+      u = l + 2.0*half_width;
+    }
+    lo[j] = l;
+    wd[j] = u-l;
+  }
+
+  // copies of e_ are made once and used again in later calls.
+  while (eCopies_.size()+1 < mlslThreads_) {
+    e = e_->emptyCopy();
+    if (!e) {
+      logger_->msgStream(LogInfo) << me_ << "engine " << e_->getName()
+        << " can not be copied. Solving NLPs in " << eCopies_.size()+1
+        << " threads." << std::endl;
+      mlslThreads_ = eCopies_.size()+1;
+      break;
+    }
+    eCopies_.push_back(e);
+  }
+  nt = mlslThreads_;
+
+  // each thread has its own engine and copy of the problem, since the
+  // starting point is saved in the problem.
+  engines.push_back(e_);
+  probs.push_back(p_);
+  for (UInt i=1; i<nt; ++i) {
+    q = p_->clone(env_);
+    if (p_->hasNativeDer()) {
+      q->setNativeDer();
+    }
+    engines.push_back(eCopies_[i-1]);
+    probs.push_back(q);
+  }
+  for (UInt i=0; i<nt; ++i) {
+    engines[i]->clear();
+    engines[i]->load(probs[i]);
+  }
+
+  srand(1);
+  timer->start();
+  for (UInt k=1, unchanged_obj_count=0; k <= heur_bound &&
+       unchanged_obj_count < unchanged_obj_count_limit && false==stop; ++k) {
+    UInt kn, nred;
+    double r;
+
+    // sample new points and score them.
+    for (UInt s=0; s<mlslSamples_; ++s) {
+      DoubleVector y(n);
+      for (UInt j=0; j<n; ++j) {
+        y[j] = rand()/double(RAND_MAX);
+        x[j] = lo[j] + wd[j]*y[j];
+      }
+      pts.push_back(y);
+      merits.push_back(merit_(x.data()));
+      started.push_back(0);
+    }
+    stats_.numSamples += mlslSamples_;
+    ++(stats_.iterations);
+
+    // the reduced sample is the fraction of all points with the best merit.
+    kn = pts.size();
+    order.resize(kn);
+    for (UInt i=0; i<kn; ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&merits](UInt a, UInt b)
+                     { return merits[a] < merits[b]; });
+    nred = std::max((UInt) 1, (UInt) ceil(reduce*kn));
+
+    // critical distance of Rinnooy Kan and Timmer for kn points in the
+    // unit cube.
+    r = exp((lgamma(1.0+n/2.0) + log(sigma*log((double) kn)/kn))/n)
+      / sqrt(M_PI);
+
+    // start from a point of the reduced sample if no better point and no
+    // local minimum is within the critical distance.
+    starts.clear();
+    for (UInt a=0; a<nred; ++a) {
+      UInt i = order[a];
+      bool near = false;
+      if (1==started[i] || merits[i] >= INFINITY) {
+        continue;
+      }
+      for (UInt b=0; b<a && false==near; ++b) {
+        near = getDistance(pts[order[b]].data(), pts[i].data(), n) <= r;
+      }
+      for (UInt b=0; b<minima.size() && false==near; ++b) {
+        near = getDistance(minima[b].data(), pts[i].data(), n) <= r;
+      }
+      if (false==near) {
+        starts.push_back(i);
+        started[i] = 1;
+      }
+    }
+#if SPEW
+    logger_->msgStream(LogDebug) << me_ << "round " << k << ": "
+      << kn << " points, critical distance " << r << ", "
+      << starts.size() << " NLPs." << std::endl;
+#endif
+
+    // NLPs are solved best merit first, so that good solutions are found
+    // early.
+    improved = false;
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nt) schedule(dynamic, 1)
+#endif
+    for (int t=0; t<(int) starts.size(); ++t) {
+#if USE_OPENMP
+      UInt i = omp_get_thread_num();
+#else
+      UInt i = 0;
+#endif
+      ConstSolutionPtr sol;
+      EngineStatus status;
+      DoubleVector x0(n);
+      const double *y;
+      bool skip;
+
+#pragma omp critical (nlpMultiStart)
+      {
+        skip = stop;
+        if (false==skip && timer->query() > time_limit) {
+          stop = true;
+          skip = true;
+        }
+      }
+      if (skip) {
+        continue;
+      }
+
+      for (UInt j=0; j<n; ++j) {
+        x0[j] = lo[j] + wd[j]*pts[starts[t]][j];
+      }
+      probs[i]->setInitialPoint(x0.data());
+      status = engines[i]->solve();
+      sol = engines[i]->getSolution();
+
+#pragma omp critical (nlpMultiStart)
+      {
+        ++(stats_.numNLPs);
+        if (ProvenOptimal==status || ProvenLocalOptimal==status) {
+          DoubleVector ym(n);
+          bool near = false;
+
+          y = sol->getPrimal();
+          if (sol->getObjValue() < stats_.bestObjValue - obj_tol) {
+            stats_.bestObjValue = sol->getObjValue();
+            s_pool->addSolution(y, sol->getObjValue());
+            improved = true;
+            ++(stats_.numImprove);
+#if SPEW
+            logger_->msgStream(LogDebug) << me_ << "Better solution "
+              << stats_.bestObjValue << std::endl;
+#endif
+          }
+          for (UInt j=0; j<n; ++j) {
+            ym[j] = (wd[j]>0.0) ? (y[j]-lo[j])/wd[j] : 0.0;
+          }
+          for (UInt b=0; b<minima.size() && false==near; ++b) {
+            near = getDistance(minima[b].data(), ym.data(), n) <= min_tol;
+          }
+          if (false==near) {
+            minima.push_back(ym);
+            ++(stats_.numMinima);
+          }
+        } else if (ProvenInfeasible==status || ProvenLocalInfeasible==status
+                   || ProvenObjectiveCutOff==status ||
+                   ProvenFailedCQInfeas==status || FailedInfeas==status) {
+          ++(stats_.numInfeas);
+        } else {
+          ++(stats_.numBadstatus);
+        }
+      }
+    }
+
+    if (improved) {
+      unchanged_obj_count = 0;
+    } else {
+      ++unchanged_obj_count;
+    }
+    stats_.time = timer->query();
+  }
+
+  for (UInt i=1; i<nt; ++i) {
+    engines[i]->clear();
+    delete probs[i];
+  }
+  delete timer;
+}
+
+
 void NLPMultiStart::writeStats(std::ostream &out) const
 {
   out << me_ << " number of nlps solved                 = " 
@@ -208,13 +493,19 @@ void NLPMultiStart::writeStats(std::ostream &out) const
     << me_ << " number of Improvements in objective   = " 
     << stats_.numImprove << std::endl
     << me_ << " number of Bad status(unbounded etc)   = " 
-    << stats_.numNLPs << std::endl
+    << stats_.numBadstatus << std::endl
     << me_ << " total time taken                      = " 
     << stats_.time << std::endl
     << me_ << " number of iterations                  = " 
     << stats_.iterations << std::endl
     << me_ << " Best Objective Value                  = " 
     << stats_.bestObjValue << std::endl;
+  if (mlslSamples_>0) {
+    out << me_ << " number of points sampled              = " 
+      << stats_.numSamples << std::endl
+      << me_ << " number of local minima found          = " 
+      << stats_.numMinima << std::endl;
+  }
 }
 
 // Local Variables: 
@@ -27,13 +27,15 @@ namespace Minotaur {
 
   /// Statistic for Multistart heuristic
   struct MSHeurStats {
-    UInt numNLPs;
-    UInt numInfeas;
-    UInt numImprove;
-    UInt numBadstatus;
-    double time;
-    UInt iterations;
-    double bestObjValue;
+    UInt numNLPs;        ///< Number of NLPs solved.
+    UInt numInfeas;      ///< Number of NLPs found infeasible.
+    UInt numImprove;     ///< Number of times the best objective improved.
+    UInt numBadstatus;   ///< Number of NLPs with an unbounded or bad status.
+    double time;         ///< Time taken by the heuristic.
+    UInt iterations;     ///< Number of rounds (of sampling in MLSL).
+    double bestObjValue; ///< Best objective value found.
+    UInt numSamples;     ///< Number of points sampled by MLSL.
+    UInt numMinima;      ///< Number of distinct local minima found by MLSL.
   };
 
 
@@ -43,6 +45,17 @@ namespace Minotaur {
    * A Heuristic used to find solutions for continuous NLPs by solving the
    * NLP using NLP engine. The engine is called multiple times from different
    * strategically constructed starting points.
+   *
+   * If option msheur_samples is positive, the starting points are chosen by
+   * multi-level single linkage (MLSL) instead. In each round, points are
+   * sampled uniformly from the bounds of the variables and scored by a
+   * merit function, the objective plus a penalty on the violation of the
+   * constraints. Among the best scored points, an NLP is started only from
+   * points that have no better point and no known local minimum within a
+   * critical distance, which shrinks as more points are sampled. These
+   * NLPs are solved in parallel by copies of the engine, best scored
+   * first, and each better solution is added to the pool as soon as it is
+   * found.
    */
   class NLPMultiStart : public Heuristic {
     
@@ -54,6 +67,9 @@ namespace Minotaur {
       /// Destroy.
       ~NLPMultiStart(); 
 
+      /// Return the statistics of the heuristic.
+      const MSHeurStats* getStats() const {return &stats_;};
+
       /// Use this heuristic.
       void solve(NodePtr node, RelaxationPtr rel, SolutionPoolPtr s_pool);
 
@@ -71,6 +87,9 @@ namespace Minotaur {
 
       /// Engine being used to solve problem.
       EnginePtr e_;
+
+      /// Copies of e_ used by the other threads of MLSL.
+      std::vector<EnginePtr> eCopies_;
    
       /// Environment
       EnvPtr env_;
@@ -78,6 +97,12 @@ namespace Minotaur {
       /// Logger.
       LoggerPtr logger_;
      
+      /// Number of points sampled in each round of MLSL, 0 for no MLSL.
+      UInt mlslSamples_;
+
+      /// Number of threads used to solve NLPs in MLSL.
+      UInt mlslThreads_;
+
       /// Problem that is being solved.
       ProblemPtr p_;
 
@@ -100,7 +125,17 @@ namespace Minotaur {
        * \param]in] vars Number of variables
        */
       void constructInitial_(double* a, const double* b, double rho, UInt vars);
-      
+
+      /**
+       * \brief Return the merit of a point for MLSL: the objective value
+       * plus a penalty on the violation of constraints. INFINITY if the
+       * functions can not be evaluated at the point.
+       */
+      double merit_(const double *x);
+
+      /// Run the multistart heuristic with MLSL starting points.
+      void solveMLSL_(SolutionPoolPtr s_pool);
+
   };
 
   typedef NLPMultiStart* NLPMSPtr;
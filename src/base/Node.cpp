@@ -22,6 +22,8 @@
 #include "Modification.h"
 #include "Node.h"
 #include "Relaxation.h"
+#include "SpillFile.h"
+#include "VarBoundMod.h"
 #include "WarmStart.h"
 
 using namespace Minotaur;
@@ -35,6 +37,10 @@ Node::Node()
     pMods_(0), 
     rMods_(0), 
     parent_(NodePtr()),
+    pcFromParent_(false),
+    modsSpilled_(false),
+    spilled_(false),
+    spillAt_(0),
     status_(NodeNotProcessed),
     vioVal_(0),
     tbScore_(0),
@@ -51,6 +57,10 @@ Node::Node(NodePtr parentNode, BranchPtr branch)
     pMods_(0), 
     rMods_(0), 
     parent_(parentNode),
+    pcFromParent_(false),
+    modsSpilled_(false),
+    spilled_(false),
+    spillAt_(0),
     status_(NodeNotProcessed),
     vioVal_(0),
     tbScore_(0),
@@ -79,6 +89,8 @@ Node::~Node()
 
   pMods_.clear();
   rMods_.clear();
+  bnds_.clear();
+  pcChanges_.clear();
   cutPool_.clear();
   children_.clear();
 }
@@ -90,10 +102,47 @@ void Node::addChild(NodePtr childNode)
 }
 
 
+void Node::addPMod(ModificationPtr m)
+{
+  if (false==packBnd_(m, false)) {
+    pMods_.push_back(m);
+  }
+}
+
+
+void Node::addRMod(ModificationPtr m)
+{
+  if (false==packBnd_(m, true)) {
+    rMods_.push_back(m);
+  }
+}
+
+
+void Node::applyBnd_(const BndChange &b, ProblemPtr p) const
+{
+  p->changeBoundByInd(b.vind, (BoundType) b.lu, b.newVal);
+}
+
+
+UInt Node::applyBnds_(UInt j, UInt pos, bool in_rel, ProblemPtr p) const
+{
+  for (; j<bnds_.size(); ++j) {
+    if (bnds_[j].inRel==in_rel) {
+      if (bnds_[j].pos>pos) {
+        break;
+      }
+      applyBnd_(bnds_[j], p);
+    }
+  }
+  return j;
+}
+
+
 void Node::applyPMods(ProblemPtr p)
 {
   ModificationConstIterator mod_iter;
   ModificationPtr mod;
+  UInt j;
   // first apply the mods that created this node from its parent
   if (branch_) {
     for (mod_iter=branch_->pModsBegin(); mod_iter!=branch_->pModsEnd(); 
@@ -102,11 +151,14 @@ void Node::applyPMods(ProblemPtr p)
       mod->applyToProblem(p);
     }
   }
-  // now apply any other mods that were added while processing it.
-  for (mod_iter=pMods_.begin(); mod_iter!=pMods_.end(); ++mod_iter) {
-    mod = *mod_iter;
-    mod->applyToProblem(p);
+  // now apply any other mods that were added while processing it, in the
+  // order they were added.
+  j = 0;
+  for (UInt i=0; i<pMods_.size(); ++i) {
+    j = applyBnds_(j, i, false, p);
+    pMods_[i]->applyToProblem(p);
   }
+  applyBnds_(j, pMods_.size(), false, p);
 }
 
 
@@ -114,6 +166,7 @@ void Node::applyRMods(RelaxationPtr rel)
 {
   ModificationConstIterator mod_iter;
   ModificationPtr mod;
+  UInt j;
   // first apply the mods that created this node from its parent
   if (branch_) {
     for (mod_iter=branch_->rModsBegin(); mod_iter!=branch_->rModsEnd(); 
@@ -122,11 +175,14 @@ void Node::applyRMods(RelaxationPtr rel)
       mod->applyToProblem(rel);
     }
   }
-  // now apply any other mods that were added while processing it.
-  for (mod_iter=rMods_.begin(); mod_iter!=rMods_.end(); ++mod_iter) {
-    mod = *mod_iter;
-    mod->applyToProblem(rel);
+  // now apply any other mods that were added while processing it, in the
+  // order they were added.
+  j = 0;
+  for (UInt i=0; i<rMods_.size(); ++i) {
+    j = applyBnds_(j, i, true, rel);
+    rMods_[i]->applyToProblem(rel);
   }
+  applyBnds_(j, rMods_.size(), true, rel);
 }
 
 
@@ -182,6 +238,7 @@ void Node::applyRModsTrans(RelaxationPtr rel)
   ModificationPtr mod;
   ModificationPtr pmod1, mod2;
   ProblemPtr p=0;   //not used, just passed
+  UInt j;
 
   // first apply the mods that created this node from its parent
   if (branch_) {
@@ -200,9 +257,13 @@ void Node::applyRModsTrans(RelaxationPtr rel)
       delete pmod1; pmod1 = 0;
     }
   }
-  // now apply any other mods that were added while processing it.
-  for (mod_iter=rMods_.begin(); mod_iter!=rMods_.end(); ++mod_iter) {
-    mod = *mod_iter;
+  // now apply any other mods that were added while processing it. Packed
+  // bound changes are stored by the index of the variable and need no
+  // translation.
+  j = 0;
+  for (UInt i=0; i<rMods_.size(); ++i) {
+    j = applyBnds_(j, i, true, rel);
+    mod = rMods_[i];
     pmod1 = mod->fromRel(rel, p);
     if (pmod1) {
       mod2 = pmod1->toRel(p, rel);
@@ -213,6 +274,7 @@ void Node::applyRModsTrans(RelaxationPtr rel)
     }
     delete pmod1; pmod1 = 0;
   }
+  applyBnds_(j, rMods_.size(), true, rel);
 }
 
 
@@ -223,6 +285,131 @@ void Node::applyMods(RelaxationPtr rel, ProblemPtr p)
 }
 
 
+void Node::dropSpill(SpillFilePtr f)
+{
+  if (modsSpilled_) {
+    f->release(spillAt_);
+    modsSpilled_ = false;
+  }
+  spilled_ = false;
+}
+
+
+UIntVector Node::getBrCands() const
+{
+  DoubleVector v;
+  getPCost_(PCBrCand, v);
+  return UIntVector(v.begin(), v.end());
+}
+
+
+UIntVector Node::getLastStrongBranched() const
+{
+  DoubleVector v;
+  getPCost_(PCLastStr, v);
+  return UIntVector(v.begin(), v.end());
+}
+
+
+DoubleVector Node::getPCDown() const
+{
+  DoubleVector v;
+  getPCost_(PCDown, v);
+  return v;
+}
+
+
+void Node::getPCost_(PCostField f, DoubleVector &v) const
+{
+  std::vector<ConstNodePtr> chain;
+  ConstNodePtr node = this;
+
+  chain.push_back(node);
+  while (node->pcFromParent_ && node->parent_) {
+    node = node->parent_;
+    chain.push_back(node);
+  }
+
+  // replay the updates starting from the oldest ancestor.
+  v.clear();
+  for (std::vector<ConstNodePtr>::reverse_iterator it=chain.rbegin();
+       it!=chain.rend(); ++it) {
+    node = *it;
+    for (std::vector<PCostChange>::const_iterator cit=node->pcChanges_.begin();
+         cit!=node->pcChanges_.end(); ++cit) {
+      if (cit->field!=f) {
+        continue;
+      }
+      if (PCBrCand==f || cit->pos>=v.size()) {
+        v.push_back(cit->value);
+      } else {
+        v[cit->pos] = cit->value;
+      }
+    }
+  }
+}
+
+
+DoubleVector Node::getPCUp() const
+{
+  DoubleVector v;
+  getPCost_(PCUp, v);
+  return v;
+}
+
+
+UIntVector Node::getTimesDown() const
+{
+  DoubleVector v;
+  getPCost_(PCTimesDown, v);
+  return UIntVector(v.begin(), v.end());
+}
+
+
+UIntVector Node::getTimesUp() const
+{
+  DoubleVector v;
+  getPCost_(PCTimesUp, v);
+  return UIntVector(v.begin(), v.end());
+}
+
+
+bool Node::packBnd_(ModificationPtr m, bool in_rel)
+{
+  VarBoundModPtr bmod = dynamic_cast<VarBoundModPtr>(m);
+  VarBoundMod2Ptr bmod2;
+  BndChange b;
+
+  b.inRel = in_rel;
+  b.pos = (in_rel) ? rMods_.size() : pMods_.size();
+  if (bmod) {
+    b.vind = bmod->getVar()->getIndex();
+    b.lu = bmod->getLU();
+    b.newVal = bmod->getNewVal();
+    b.oldVal = bmod->getOldVal();
+    bnds_.push_back(b);
+    delete bmod;
+    return true;
+  }
+
+  bmod2 = dynamic_cast<VarBoundMod2Ptr>(m);
+  if (bmod2) {
+    b.vind = bmod2->getVar()->getIndex();
+    b.lu = Lower;
+    b.newVal = bmod2->getNewLb();
+    b.oldVal = bmod2->getOldLb();
+    bnds_.push_back(b);
+    b.lu = Upper;
+    b.newVal = bmod2->getNewUb();
+    b.oldVal = bmod2->getOldUb();
+    bnds_.push_back(b);
+    delete bmod2;
+    return true;
+  }
+  return false;
+}
+
+
 void Node::removeChild(NodePtrIterator childNodeIter)
 {
   children_.erase(childNodeIter);
@@ -272,6 +459,13 @@ void Node::setLb(double value)
 }
 
 
+void Node::setPCostsFromParent()
+{
+  pcChanges_.clear();
+  pcFromParent_ = true;
+}
+
+
 void Node::setWarmStart (WarmStartPtr ws) 
 { 
   if (ws) {
@@ -284,22 +478,49 @@ void Node::setWarmStart (WarmStartPtr ws)
 }
 
 
+void Node::spill(SpillFilePtr f)
+{
+  if (branch_ && false==modsSpilled_) {
+    modsSpilled_ = branch_->spillMods(f, &spillAt_);
+  }
+  spilled_ = true;
+}
+
+
+void Node::undoBnd_(const BndChange &b, ProblemPtr p) const
+{
+  p->changeBoundByInd(b.vind, (BoundType) b.lu, b.oldVal);
+}
+
+
+UInt Node::undoBnds_(UInt j, UInt pos, bool in_rel, ProblemPtr p) const
+{
+  for (; j>0; --j) {
+    if (bnds_[j-1].inRel==in_rel) {
+      if (bnds_[j-1].pos<pos) {
+        break;
+      }
+      undoBnd_(bnds_[j-1], p);
+    }
+  }
+  return j;
+}
+
+
 void Node::undoPMods(ProblemPtr p)
 {
   ModificationRConstIterator mod_iter;
   ModificationPtr mod;
 
-  // explicitely request the const_reverse_iterator for rend():
-  // for bug in STL C++ standard
-  // http://stackoverflow.com/questions/2135094/gcc-reverse-iterator-comparison-operators-missing
-  ModificationRConstIterator rend = pMods_.rend();  
+  UInt j = bnds_.size();
 
-
-  // first undo the mods that were added while processing the node.
-  for (mod_iter=pMods_.rbegin(); mod_iter!= rend; ++mod_iter) {
-    mod = *mod_iter;
-    mod->undoToProblem(p);
+  // first undo the mods that were added while processing the node, in the
+  // reverse order.
+  for (UInt i=pMods_.size(); i>0; --i) {
+    j = undoBnds_(j, i, false, p);
+    pMods_[i-1]->undoToProblem(p);
   } 
+  undoBnds_(j, 0, false, p);
 
   // now undo the mods that were used to create this node from its parent.
   if (branch_) {
@@ -317,17 +538,15 @@ void Node::undoRMods(RelaxationPtr rel)
   ModificationRConstIterator mod_iter;
   ModificationPtr mod;
 
-  // explicitely request the const_reverse_iterator for rend():
-  // for bug in STL C++ standard
-  // http://stackoverflow.com/questions/2135094/gcc-reverse-iterator-comparison-operators-missing
-  ModificationRConstIterator rend = rMods_.rend();  
-
+  UInt j = bnds_.size();
 
-  // first undo the mods that were added while processing the node.
-  for (mod_iter=rMods_.rbegin(); mod_iter!= rend; ++mod_iter) {
-    mod = *mod_iter;
-    mod->undoToProblem(rel);
+  // first undo the mods that were added while processing the node, in the
+  // reverse order.
+  for (UInt i=rMods_.size(); i>0; --i) {
+    j = undoBnds_(j, i, true, rel);
+    rMods_[i-1]->undoToProblem(rel);
   } 
+  undoBnds_(j, 0, true, rel);
 
   // now undo the mods that were used to create this node from its parent.
   if (branch_) {
@@ -346,15 +565,14 @@ void Node::undoRModsTrans(RelaxationPtr rel)
   ModificationPtr mod;
   ProblemPtr p=0;
 
-  // explicitely request the const_reverse_iterator for rend():
-  // for bug in STL C++ standard
-  // http://stackoverflow.com/questions/2135094/gcc-reverse-iterator-comparison-operators-missing
-  ModificationRConstIterator rend = rMods_.rend();
   ModificationPtr pmod1, mod2;
+  UInt j = bnds_.size();
 
-  // first undo the mods that were added while processing the node.
-  for (mod_iter=rMods_.rbegin(); mod_iter!= rend; ++mod_iter) {
-    mod = *mod_iter;
+  // first undo the mods that were added while processing the node, in the
+  // reverse order.
+  for (UInt i=rMods_.size(); i>0; --i) {
+    j = undoBnds_(j, i, true, rel);
+    mod = rMods_[i-1];
     //converting modifications applicable for one relaxation to another
     pmod1 = mod->fromRel(rel, p);
     if (pmod1) {
@@ -366,6 +584,7 @@ void Node::undoRModsTrans(RelaxationPtr rel)
     }
     delete pmod1; pmod1 = 0;
   }
+  undoBnds_(j, 0, true, rel);
 
   // now undo the mods that were used to create this node from its parent.
   if (branch_) {
@@ -386,6 +605,23 @@ void Node::undoRModsTrans(RelaxationPtr rel)
 }
 
 
+void Node::unspill(SpillFilePtr f)
+{
+  if (modsSpilled_) {
+    branch_->unspillMods(f, spillAt_);
+    modsSpilled_ = false;
+  }
+  if (ws_) {
+    // the warm start may be shared with a node read back by another thread.
+#if USE_OPENMP
+#pragma omp critical (warmStartSpill)
+#endif
+    ws_->unspill();
+  }
+  spilled_ = false;
+}
+
+
 void Node::undoMods(RelaxationPtr rel, ProblemPtr p)
 {
   undoPMods(p);
@@ -394,52 +630,43 @@ void Node::undoMods(RelaxationPtr rel, ProblemPtr p)
 
 
 void Node::updateBrCands(UInt index) {
-  brCands_.push_back(index);
+  updatePCost_(PCBrCand, 0, index);
 }
 
 
 void Node::updateLastStrBranched(UInt index, double value) {
-  if (index >= lastStrBranched_.size()) {
-    lastStrBranched_.push_back(value);
-  } else {
-    lastStrBranched_[index] = value;
-  }
+  updatePCost_(PCLastStr, index, value);
 }
 
 
 void Node::updatePCDown(UInt index, double value) {
-  if (index >= pseudoDown_.size()) {
-    pseudoDown_.push_back(value);
-  } else {
-    pseudoDown_[index] = value;
-  }
+  updatePCost_(PCDown, index, value);
+}
+
+
+void Node::updatePCost_(PCostField f, UInt pos, double value)
+{
+  PCostChange c;
+
+  c.pos = pos;
+  c.field = f;
+  c.value = value;
+  pcChanges_.push_back(c);
 }
 
 
 void Node::updatePCUp(UInt index, double value) {
-  if (index >= pseudoUp_.size()) {
-    pseudoUp_.push_back(value);
-  } else {
-    pseudoUp_[index] = value;
-  }
+  updatePCost_(PCUp, index, value);
 }
 
 
 void Node::updateTimesDown(UInt index, double value) {
-  if (index >= timesDown_.size()) {
-    timesDown_.push_back(value);
-  } else {
-    timesDown_[index] = value;
-  }
+  updatePCost_(PCTimesDown, index, value);
 }
 
 
 void Node::updateTimesUp(UInt index, double value) {
-  if (index >= timesUp_.size()) {
-    timesUp_.push_back(value);
-  } else {
-    timesUp_[index] = value;
-  }
+  updatePCost_(PCTimesUp, index, value);
 }
 
 
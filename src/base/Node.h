@@ -20,9 +20,11 @@ namespace Minotaur {
 
   class Node;
   class Relaxation;
+  class SpillFile;
   class WarmStart;
   typedef const Node* ConstNodePtr;
   typedef Relaxation* RelaxationPtr;
+  typedef SpillFile* SpillFilePtr;
   typedef WarmStart* WarmStartPtr;
   
    /**
@@ -76,17 +78,19 @@ namespace Minotaur {
      * At each node one can make several modifications to the problem.
      * Each such modification must be stored. This includes all the
      * modifications that were used to create this node from its parent
-     * (while branching).
+     * (while branching). A change of bounds of a variable is stored in a
+     * packed form and m is deleted, so m must not be used after this call.
      */
-    void addPMod(ModificationPtr m) { pMods_.push_back(m); }
+    void addPMod(ModificationPtr m);
 
     /**
      * At each node one can make several modifications to the relaxation.
      * Each such modification must be stored. This includes all the
      * modifications that were used to create this node from its parent
-     * (while branching).
+     * (while branching). A change of bounds of a variable is stored in a
+     * packed form and m is deleted, so m must not be used after this call.
      */
-    void addRMod(ModificationPtr m) { rMods_.push_back(m); }
+    void addRMod(ModificationPtr m);
 
     /**
      * Apply the cuts generated at the ancestors of this node at this node to
@@ -141,7 +145,7 @@ namespace Minotaur {
     UInt getId() const { return id_; }
 
     /// Return the vector of last strong branching information of candidates.
-    UIntVector getLastStrongBranched() {return lastStrBranched_;}
+    UIntVector getLastStrongBranched() const;
 
     /// Return the lower bound of the relaxation obtained at this node.
     double getLb() const { return lb_; }
@@ -156,20 +160,19 @@ namespace Minotaur {
      * Return the vector of pseudocosts of down-branchings upto this node in
      * the parental chain (direct ancestors only).
      */
-    //DoubleVector getPCDown() const { return pseudoDown_; }
-    DoubleVector getPCDown() { return pseudoDown_; }
+    DoubleVector getPCDown() const;
 
     /**
      * Return the vector of indices of the variables branched till this node.
      * in the parental chain (direct ancestors only).
      */
-    UIntVector getBrCands() const { return brCands_; }
+    UIntVector getBrCands() const;
 
     /**
      * Return the vector of pseudocosts of up-branchings upto this node in
      * the parental chain (direct ancestors only).
      */
-    DoubleVector getPCUp() const { return pseudoUp_; }
+    DoubleVector getPCUp() const;
 
     /// Get the status of this node.
     NodeStatus getStatus() const { return status_; }
@@ -185,17 +188,31 @@ namespace Minotaur {
      * Return the vector of number of down-branchings of a variable upto this
      * in the parental chain (direct ancestors only).
      */
-    UIntVector getTimesDown() const { return timesDown_; }
+    UIntVector getTimesDown() const;
 
     /**
      * Return the vector of number of up-branchings of a variable upto this
      * node in the parental chain (direct ancestors only).
      */
-    UIntVector getTimesUp() const { return timesUp_; }
+    UIntVector getTimesUp() const;
 
     /// Get the warm start information.
     WarmStartPtr getWarmStart() { return ws_; }
 
+    /**
+     * \brief Return true if spill() was called and unspill() or
+     * dropSpill() have not been called since.
+     */
+    bool isSpilled() const { return spilled_; }
+
+    /**
+     * \brief Release the information written by spill() without reading it
+     * back. Called before the node is deleted.
+     *
+     * \param[in] f The spill file passed to spill().
+     */
+    void dropSpill(SpillFilePtr f);
+
     /// \todo Dont know what this is meant for.
     void makeChildOf(const Node* parent);
 
@@ -232,9 +249,6 @@ namespace Minotaur {
     /// Remove warm start information associated with this node.
     void removeWarmStart();
 
-    /// Set the branching candidate information for this node.
-    void setBrCands(UIntVector brCands) { brCands_ = brCands; }
-
     /// Set the depth of the node in the tree.
     void setDepth(UInt depth);
 
@@ -244,17 +258,18 @@ namespace Minotaur {
      */
     void setId(UInt id);
 
-    /// Set the vector of last strong branched information of candidates.
-    void setLastStrongBranched(UIntVector lstStrnBrnchd) {lastStrBranched_ = lstStrnBrnchd;}
-
     /// Set a lower bound for the relaxation at this node.
     void setLb(double value);
 
-    /// Set the down pseudocosts for this node.
-    void setPCDown(DoubleVector pcDown) { pseudoDown_ = pcDown; }
-
-    /// Set the up pseudocosts for this node.
-    void setPCUp(DoubleVector pcUp) { pseudoUp_ = pcUp; }
+    /**
+     * \brief Start the branching candidates, pseudocosts and counts of this
+     * node from those of its parent.
+     *
+     * The statistics are not copied. The node only stores the entries that
+     * are updated at this node, and the getters add these to the statistics
+     * of the parent. Any updates made at this node earlier are discarded.
+     */
+    void setPCostsFromParent();
 
     /// Set the status of this node.
     void setStatus(NodeStatus status) { status_ = status; }
@@ -262,21 +277,33 @@ namespace Minotaur {
     /// Get the tie-breaking score.
     void setTbScore(double d) { tbScore_ = d; }
 
-    /// Set the times down for this node.
-    void setTimesDown(UIntVector timesDown) { timesDown_ = timesDown; }
-
-    /// Set the times up for this node.
-    void setTimesUp(UIntVector timesUp) { timesUp_ = timesUp; }
-
     /// Set warm start information
     void setWarmStart (WarmStartPtr ws);
 
+    /**
+     * \brief Move the modifications of the branch of this active node to a
+     * spill file.
+     *
+     * The warm start is not moved here since it may be shared with other
+     * nodes. The tree manager moves it when it creates the nodes.
+     * \param[in] f The spill file.
+     */
+    void spill(SpillFilePtr f);
+
     /**
      * Undo the modifications including the branching that were made 
      * at this node to the problem.
      */
     void undoPMods(ProblemPtr p);
 
+    /**
+     * \brief Read back the modifications and the warm start moved to a spill
+     * file. It must be called before the node is processed.
+     *
+     * \param[in] f The spill file passed to spill().
+     */
+    void unspill(SpillFilePtr f);
+
     /**
      * Undo the modifications including the branching that were made
      * at this node to the problem.
@@ -330,6 +357,57 @@ namespace Minotaur {
     void write(std::ostream &o) const;
 
   private:   
+    /// A change in a bound of a variable, packed for storing at the node.
+    struct BndChange {
+      /// Index of the variable.
+      UInt vind;
+
+      /// Number of other modifications of the same kind made before it.
+      UInt pos;
+
+      /// Lower or upper bound.
+      unsigned char lu;
+
+      /// True if the relaxation is changed, false if the problem.
+      bool inRel;
+
+      /// The new value of the bound.
+      double newVal;
+
+      /// The value of the bound before the change.
+      double oldVal;
+    };
+
+    /// The statistics of branching candidates stored at a node.
+    typedef enum {
+      PCBrCand,
+      PCDown,
+      PCUp,
+      PCTimesDown,
+      PCTimesUp,
+      PCLastStr
+    } PCostField;
+
+    /// An update of one statistic of one branching candidate.
+    struct PCostChange {
+      /// Position of the candidate in the vector of the statistic.
+      UInt pos;
+
+      /// The statistic updated.
+      PCostField field;
+
+      /// The new value.
+      double value;
+    };
+
+    /**
+     * Changes in the bounds of variables that were made at this node, in the
+     * order they were made. Each is applied after the first pos
+     * modifications in pMods_ or rMods_, so that the order in which all
+     * modifications were made is kept.
+     */
+    std::vector<BndChange> bnds_;
+
     /**
      * The branching constraints that were used to create this node from its
      * parent.
@@ -345,9 +423,6 @@ namespace Minotaur {
     /// Id of this node.
     UInt id_;
 
-    /// When did we last strong-branch on a candidate.
-    UIntVector lastStrBranched_;
-
     /**
      * Lower bound on the relaxation at this node (not to original
      * relaxation).
@@ -370,16 +445,26 @@ namespace Minotaur {
     NodePtr parent_;
 
     /**
-     * Vector of indices of variables branched on till this node in the
-     * parental chain (direct ancestors only).
+     * Updates of the branching candidates, pseudocosts, counts and last
+     * strong branching of candidates made at this node, in the order they
+     * were made.
+     */
+    std::vector<PCostChange> pcChanges_;
+
+    /**
+     * True if the statistics in pcChanges_ are updates of those of the
+     * parent, false if they start from empty vectors.
      */
-    UIntVector brCands_;
+    bool pcFromParent_;
 
-    /// Vector of pseudocosts for rounding down ().
-    DoubleVector pseudoDown_;
+    /// True if the modifications of branch_ are in a spill file.
+    bool modsSpilled_;
 
-    /// Vector of pseudocosts for rounding up.
-    DoubleVector pseudoUp_;
+    /// True if spill() was called, and the node was not read back yet.
+    bool spilled_;
+
+    /// Position of the modifications of branch_ in the spill file.
+    size_t spillAt_;
 
     /// The status of this node.
     NodeStatus status_;   
@@ -393,20 +478,42 @@ namespace Minotaur {
     /// List of cuts generated at this node.
     CutList cutPool_;
 
+    /// The warm start information saved for this node
+    WarmStartPtr ws_;
+
+    /// Apply a packed bound change to a problem or relaxation.
+    void applyBnd_(const BndChange &b, ProblemPtr p) const;
+
     /**
-     * \brief Number of times we have branched down and noted the effect on
-     * objective improvement.
+     * Apply the packed bound changes of the problem (in_rel false) or the
+     * relaxation (in_rel true), starting at position j in bnds_, that were
+     * made before the modification at position pos. Return the position of the
+     * first change not applied.
      */
-    UIntVector timesDown_;
+    UInt applyBnds_(UInt j, UInt pos, bool in_rel, ProblemPtr p) const;
 
     /**
-     * \brief Number of times we have branched up and noted the effect on objective
-     * improvement.
+     * Pack a modification if it changes bounds of a variable. Return true
+     * if it was packed.
      */
-    UIntVector timesUp_;
+    bool packBnd_(ModificationPtr m, bool in_rel);
 
-    /// The warm start information saved for this node
-    WarmStartPtr ws_;
+    /// Return the statistic f up to this node in the parental chain.
+    void getPCost_(PCostField f, DoubleVector &v) const;
+
+    /// Record the update of statistic f of the candidate at position pos.
+    void updatePCost_(PCostField f, UInt pos, double value);
+
+    /// Undo a packed bound change in a problem or relaxation.
+    void undoBnd_(const BndChange &b, ProblemPtr p) const;
+
+    /**
+     * Undo, in the reverse order, the packed bound changes before position j
+     * in bnds_ that were made after the first pos modifications of the
+     * problem (in_rel false) or the relaxation (in_rel true). Return the
+     * position after the last change not undone.
+     */
+    UInt undoBnds_(UInt j, UInt pos, bool in_rel, ProblemPtr p) const;
 
     /// Not allowed to copy a node.
     Node(const Node &node); 
@@ -0,0 +1,121 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2017 The MINOTAUR Team.
+// 
+
+/**
+ * \file NodeBoundIndex.cpp
+ * \brief Define class NodeBoundIndex for finding the smallest lower bound of
+ * active nodes.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "MinotaurConfig.h"
+#include "Node.h"
+#include "NodeBoundIndex.h"
+
+using namespace Minotaur;
+
+
+NodeBoundIndex::NodeBoundIndex()
+  : live_(0)
+{
+}
+
+
+NodeBoundIndex::~NodeBoundIndex()
+{
+  heap_.clear();
+  gen_.clear();
+}
+
+
+void NodeBoundIndex::add(NodePtr n)
+{
+  Entry_ e;
+
+  e.lb = n->getLb();
+  e.id = n->getId();
+  if (e.id>=gen_.size()) {
+    gen_.resize(e.id+1, 0);
+  }
+  e.gen = gen_[e.id];
+  heap_.push_back(e);
+  std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry_>());
+  ++live_;
+}
+
+
+void NodeBoundIndex::clear()
+{
+  heap_.clear();
+  gen_.clear();
+  live_ = 0;
+}
+
+
+void NodeBoundIndex::dropRemoved_()
+{
+  if (heap_.size() > 2*live_+64) {
+    // too many stale entries. Rebuild the heap from the live ones.
+    UInt j = 0;
+    for (UInt i=0; i<heap_.size(); ++i) {
+      if (false==isStale_(heap_[i])) {
+        heap_[j] = heap_[i];
+        ++j;
+      }
+    }
+    heap_.resize(j);
+    std::make_heap(heap_.begin(), heap_.end(), std::greater<Entry_>());
+    return;
+  }
+
+  while (false==heap_.empty() && isStale_(heap_.front())) {
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry_>());
+    heap_.pop_back();
+  }
+}
+
+
+double NodeBoundIndex::getBestLB() const
+{
+  if (heap_.empty()) {
+    return INFINITY;
+  }
+  return heap_.front().lb;
+}
+
+
+bool NodeBoundIndex::isStale_(const Entry_ &e) const
+{
+  return e.gen<gen_[e.id];
+}
+
+
+void NodeBoundIndex::remove(NodePtr n)
+{
+  UInt id = n->getId();
+
+  if (id>=gen_.size()) {
+    gen_.resize(id+1, 0);
+  }
+  ++gen_[id];
+  --live_;
+  dropRemoved_();
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
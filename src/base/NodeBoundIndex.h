@@ -0,0 +1,98 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2017 The MINOTAUR Team.
+// 
+
+/**
+ * \file NodeBoundIndex.h
+ * \brief Declare class NodeBoundIndex for finding the smallest lower bound of
+ * active nodes.
+ */
+
+
+#ifndef MINOTAURNODEBOUNDINDEX_H
+#define MINOTAURNODEBOUNDINDEX_H
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  /**
+   * \brief Keep the lower bounds of active nodes in a min-heap.
+   *
+   * Stores that do not order the nodes by their lower bound (NodeStack,
+   * NodeHeap by depth) use it so that the best bound of the tree can be
+   * found in constant time rather than by scanning all active nodes. A node
+   * is added with the lower bound it has at that time. A removed node is
+   * only marked, and its entry is dropped when it reaches the top of the
+   * heap. To update the bound of a node, remove it and add it again.
+   */
+  class NodeBoundIndex {
+
+  public:
+    /// Default constructor.
+    NodeBoundIndex();
+
+    /// Destroy.
+    ~NodeBoundIndex();
+
+    /// Add an active node.
+    void add(NodePtr n);
+
+    /// Remove all nodes.
+    void clear();
+
+    /// Return the smallest lower bound of all nodes. INFINITY if empty.
+    double getBestLB() const;
+
+    /**
+     * \brief Remove a node added earlier.
+     *
+     * Nodes are identified by their id, which must not change while the
+     * node is in the index.
+     */
+    void remove(NodePtr n);
+
+  private:
+    /// An entry of the heap.
+    struct Entry_ {
+      double lb;  ///< Lower bound of the node when it was added.
+      UInt id;    ///< Id of the node.
+      UInt gen;   ///< Value of gen_[id] when the node was added.
+      bool operator>(const Entry_ &e) const { return lb > e.lb; };
+    };
+
+    /**
+     * Entry i is the number of times the node with id i was removed. An
+     * entry of the heap is stale if its gen is smaller, so that an entry
+     * left from before a node was removed is not used after the node is
+     * added again.
+     */
+    UIntVector gen_;
+
+    /// Min-heap of the entries of the nodes added.
+    std::vector<Entry_> heap_;
+
+    /// Number of nodes added but not removed.
+    UInt live_;
+
+    /// Drop the stale entries from the top of the heap.
+    void dropRemoved_();
+
+    /// Return true if entry e is stale.
+    bool isStale_(const Entry_ &e) const;
+  };
+}
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -59,6 +59,9 @@ NodeHeap::~NodeHeap()
 void NodeHeap::pop()
 {
   // std::cout << "popping out node " << nodes_.front()->getId() << std::endl;
+  if (type_ != Value) {
+    lbs_.remove(nodes_.front());
+  }
   switch(type_) {
   case (Value):
     pop_heap(nodes_.begin(), nodes_.end(), valueGreaterThan);
@@ -80,9 +83,7 @@ double NodeHeap::getBestLB() const
       if (type_ == Value) {
          retval = nodes_.front()->getLb();
       } else {
-        std::vector<NodePtr>::const_iterator it = min_element(nodes_.begin(), 
-             nodes_.end(), valueGreaterThan);
-         retval = (*it)->getLb();
+         retval = lbs_.getBestLB();
       }
    }
    return retval;
@@ -120,6 +121,9 @@ void NodeHeap::push(NodePtr n)
 {
   // std::cout << "inserting node " << n->getId() << std::endl;
   nodes_.push_back(n);
+  if (type_ != Value) {
+    lbs_.add(n);
+  }
   switch(type_) {
   case (Value):
     push_heap(nodes_.begin(), nodes_.end(), valueGreaterThan);
@@ -138,6 +142,13 @@ void NodeHeap::setType(Type type)
   if (type == type_) return;
   //XXX Could probably do this fancier
 
+  type_ = type;
+  lbs_.clear();
+  if (type_ != Value) {
+    for (NodePtrIterator it=nodes_.begin(); it!=nodes_.end(); ++it) {
+      lbs_.add(*it);
+    }
+  }
   switch(type_) {
   case (Value):
     make_heap(nodes_.begin(), nodes_.end(), valueGreaterThan);
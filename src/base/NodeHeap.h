@@ -17,6 +17,7 @@
 
 #include "Types.h"
 #include "ActiveNodeStore.h"
+#include "NodeBoundIndex.h"
 
 namespace Minotaur {
 
@@ -54,7 +55,8 @@ namespace Minotaur {
         /**
          * Find the minimum lower bound of all the active nodes in the heap.
          * If the heap is ordered by best bound, then the root has the
-         * minimum value.
+         * minimum value. Otherwise, it is read from a NodeBoundIndex. Either
+         * way it takes constant time.
          */
         virtual double getBestLB() const;
 
@@ -89,6 +91,9 @@ namespace Minotaur {
         NodePtrIterator nodesEnd();
 
       private:
+        /// Lower bounds of the active nodes. Not used if type_ is Value.
+        NodeBoundIndex lbs_;
+
         /// Vector of active nodes.
         NodePtrVector nodes_;
 
@@ -20,6 +20,7 @@
 #include "NodeIncRelaxer.h"
 #include "Option.h"
 #include "Relaxation.h"
+#include "TreeManager.h"
 
 
 using namespace Minotaur;
@@ -29,8 +30,10 @@ NodeIncRelaxer::NodeIncRelaxer (EnvPtr env, HandlerVector handlers)
   : engine_(EnginePtr()),  // NULL
     env_(env),
     handlers_(handlers),
+    lcaSwitch_(false),
     modProb_(true),
-    rel_(RelaxationPtr()) // NULL
+    rel_(RelaxationPtr()), // NULL
+    tm_(0)
 {
 }
 
@@ -49,6 +52,7 @@ NodeIncRelaxer::~NodeIncRelaxer ()
 RelaxationPtr NodeIncRelaxer::createRootRelaxation(NodePtr, bool &prune)
 {
   prune = false;
+  path_.clear();
   rel_ = (RelaxationPtr) new Relaxation(env_);
   for (HandlerIterator h = handlers_.begin(); h != handlers_.end() && !prune; 
       ++h) {
@@ -98,40 +102,44 @@ RelaxationPtr NodeIncRelaxer::createNodeRelaxation(NodePtr node, bool dived,
   WarmStartPtr ws;
   prune = false;
 
-  if (!dived) {
-    // traceback to root and put in all modifications that need to go into the
-    // relaxation and the engine.
-    std::stack<NodePtr> predecessors;
-    t_node = node->getParent();
+  if (lcaSwitch_) {
+    switchPath_(node, dived);
+  } else {
+    if (!dived) {
+      // traceback to root and put in all modifications that need to go into
+      // the relaxation and the engine.
+      std::stack<NodePtr> predecessors;
+      t_node = node->getParent();
 
-    while (t_node) {
-      predecessors.push(t_node);
-      t_node = t_node->getParent();
-    }
+      while (t_node) {
+        predecessors.push(t_node);
+        t_node = t_node->getParent();
+      }
 
-    // starting from the top, put in modifications made at each node to the
-    // engine
-    if (modProb_) {
-      while (!predecessors.empty()) {
-        t_node = predecessors.top();
-        t_node->applyMods(rel_, p_);
-        predecessors.pop();
+      // starting from the top, put in modifications made at each node to the
+      // engine
+      if (modProb_) {
+        while (!predecessors.empty()) {
+          t_node = predecessors.top();
+          t_node->applyMods(rel_, p_);
+          predecessors.pop();
+        }
+      } else {
+        while (!predecessors.empty()) {
+          t_node = predecessors.top();
+          t_node->applyRMods(rel_);
+          predecessors.pop();
+        }
       }
+    } 
+
+    // put in the modifications that were used to create this node from
+    // its parent.
+    if (modProb_) {
+      node->applyMods(rel_, p_);
     } else {
-      while (!predecessors.empty()) {
-        t_node = predecessors.top();
-        t_node->applyRMods(rel_);
-        predecessors.pop();
-      }
+      node->applyRMods(rel_);
     }
-  } 
-
-  // put in the modifications that were used to create this node from
-  // its parent.
-  if (modProb_) {
-    node->applyMods(rel_, p_);
-  } else {
-    node->applyRMods(rel_);
   }
 
   for (HandlerIterator h = handlers_.begin(); h != handlers_.end() && !prune; 
@@ -159,6 +167,15 @@ void NodeIncRelaxer::reset(NodePtr node, bool diving)
 {
   NodePtr t_node = node;
 
+  if (!diving && lcaSwitch_ && !path_.empty()) {
+    // modifications are undone in createNodeRelaxation(), once we know
+    // which of them are not needed by the next node. If there is no next
+    // node, undo them now.
+    if (!node) {
+      clearPath_();
+    }
+    return;
+  }
   if (!diving) {
     if (modProb_) {
       while (t_node) {
@@ -175,6 +192,84 @@ void NodeIncRelaxer::reset(NodePtr node, bool diving)
 }
 
 
+void NodeIncRelaxer::clearPath_()
+{
+  NodePtr t_node = path_.back();
+
+  rel_->beginBoundBatch();
+  while (false==path_.empty()) {
+    if (modProb_) {
+      path_.back()->undoMods(rel_, p_);
+    } else {
+      path_.back()->undoRMods(rel_);
+    }
+    path_.pop_back();
+  }
+  rel_->endBoundBatch();
+  tm_->releaseNode(t_node);
+}
+
+
+void NodeIncRelaxer::switchPath_(NodePtr node, bool dived)
+{
+  NodePtrVector branch;
+  NodePtr t_node = 0;
+  UInt keep;
+
+  if (dived && path_.empty()) {
+    // we dived from the root. Its modifications were applied while
+    // processing it.
+    for (t_node=node->getParent(); t_node; t_node=t_node->getParent()) {
+      path_.insert(path_.begin(), t_node);
+    }
+  }
+  if (false==path_.empty()) {
+    t_node = path_.back();
+  }
+
+  // climb up from node until we reach a node whose modifications are
+  // applied. path_[i] is at depth i.
+  branch.push_back(node);
+  node = node->getParent();
+  while (node && (node->getDepth()>=path_.size() ||
+                  path_[node->getDepth()]!=node)) {
+    branch.push_back(node);
+    node = node->getParent();
+  }
+  keep = (node) ? node->getDepth()+1 : 0;
+
+  // the engine only needs the bounds at the new node, not each change
+  // along the way.
+  rel_->beginBoundBatch();
+  while (path_.size()>keep) {
+    if (modProb_) {
+      path_.back()->undoMods(rel_, p_);
+    } else {
+      path_.back()->undoRMods(rel_);
+    }
+    path_.pop_back();
+  }
+  for (NodePtrVector::reverse_iterator it=branch.rbegin();
+       it!=branch.rend(); ++it) {
+    if (modProb_) {
+      (*it)->applyMods(rel_, p_);
+    } else {
+      (*it)->applyRMods(rel_);
+    }
+    assert((*it)->getDepth()==path_.size());
+    path_.push_back(*it);
+  }
+  rel_->endBoundBatch();
+
+  // keep the new node until its modifications are undone. The previous one
+  // is not needed anymore.
+  tm_->holdNode(path_.back());
+  if (t_node) {
+    tm_->releaseNode(t_node);
+  }
+}
+
+
 RelaxationPtr NodeIncRelaxer::getRelaxation()
 {
   return rel_;
@@ -184,6 +279,7 @@ RelaxationPtr NodeIncRelaxer::getRelaxation()
 void NodeIncRelaxer::setRelaxation(RelaxationPtr rel)
 {
   rel_ = rel;
+  path_.clear();
 }
 
 
@@ -193,6 +289,15 @@ void NodeIncRelaxer::setProblem(ProblemPtr p)
 }
 
 
+void NodeIncRelaxer::setTreeManager(TreeManagerPtr tm)
+{
+  tm_ = tm;
+  lcaSwitch_ = (tm_ &&
+                env_->getOptions()->findBool("bnb_lca_switch")->getValue());
+  path_.clear();
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
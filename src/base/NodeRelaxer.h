@@ -68,7 +68,9 @@ public:
   /**
    * After processing the node, some node relaxers may like to make
    * changes. This function is the place to do it. diving is true if the
-   * next node to be processed is a child node of the current node.
+   * next node to be processed is a child node of the current node. Call
+   * it with node NULL and diving false when no node is processed next, to
+   * undo the modifications that are still applied to the relaxation.
    */
   virtual void reset(NodePtr node, bool diving) = 0;
 
@@ -38,20 +38,9 @@ bool NodeStack::isEmpty() const
 }
 
 
-// This function is expensive and must be avoided for large trees.
 double NodeStack::getBestLB() const
 {
-  NodeStackConstIter iter;
-  double node_lb;
-  double best_lb = INFINITY;
-
-  for (iter = nodes_.begin(); iter != nodes_.end(); ++iter) {
-    node_lb = (*iter)->getLb();
-    if (node_lb < best_lb) {
-      best_lb = node_lb;
-    }
-  }
-  return best_lb;
+  return lbs_.getBestLB();
 }
 
 
@@ -64,12 +53,14 @@ UInt NodeStack::getDeepestLevel() const
 
 void NodeStack::pop() 
 {
+  lbs_.remove(nodes_.front());
   nodes_.pop_front();
 }
 
 
 void NodeStack::push(NodePtr n) 
 {
+  lbs_.add(n);
   nodes_.push_front(n);
 }
 
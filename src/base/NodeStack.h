@@ -16,6 +16,7 @@
 #define MINOTAURNODESTACK_H
 
 #include "ActiveNodeStore.h"
+#include "NodeBoundIndex.h"
 
 namespace Minotaur {
 
@@ -45,8 +46,8 @@ namespace Minotaur {
 
       /**
        * \brief Find the minimum lower bound of all the active nodes in the
-       * stack.  This function is expensive and must be avoided for large
-       * trees.
+       * stack. The bounds are kept in a NodeBoundIndex, so it takes constant
+       * time.
        */
       virtual double getBestLB() const;
 
@@ -75,6 +76,9 @@ namespace Minotaur {
       NodeStackIter nodesEnd();
 
     private:
+      /// Lower bounds of the active nodes.
+      NodeBoundIndex lbs_;
+
       /// stack of active nodes.
       NodePtrStack nodes_;
   };
@@ -45,6 +45,40 @@ void NonlinearFunction::computeBounds(double *lb, double *ub, int *error)
 }
 
 
+void NonlinearFunction::evalBatch(UInt k, UInt n, const double *x,
+                                  double *f, int *error)
+{
+  int err;
+  for (UInt p=0; p<k; ++p) {
+    err = 0;
+    f[p] = eval(x+p*n, &err);
+    if (0!=err) {
+      *error = err;
+    }
+  }
+}
+
+
+void NonlinearFunction::evalGradientBatch(UInt k, UInt n, const double *x,
+                                          double *grad_f, int *error)
+{
+  int err;
+  for (UInt p=0; p<k; ++p) {
+    err = 0;
+    evalGradient(x+p*n, grad_f+p*n, &err);
+    if (0!=err) {
+      *error = err;
+    }
+  }
+}
+
+
+bool NonlinearFunction::getHessOffs(UIntVector *) const
+{
+  return false;
+}
+
+
 std::string NonlinearFunction::getNlString(int *)
 {
   return "";
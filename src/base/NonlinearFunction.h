@@ -99,6 +99,42 @@ namespace Minotaur {
     virtual void evalGradient(const double *x, double *grad_f, int *error) 
       = 0;
 
+    /**
+     * \brief Evaluate the function at several points.
+     *
+     * The default implementation calls eval() once for each point. Derived
+     * classes may evaluate all points in one pass.
+     *
+     * \param [in] k The number of points.
+     * \param [in] n The length of each point. Point p starts at x+p*n. n
+     * must exceed the highest index of the variables used in the function.
+     * \param [in] x Array of size k*n containing the points one after the
+     * other.
+     * \param [out] f Array of size k. f[p] is set to the value at point p.
+     * \param [out] error It should be set a positive value if there is
+     * error encountered while evaluating any point. Leave undisturbed
+     * otherwise.
+     */
+    virtual void evalBatch(UInt k, UInt n, const double *x, double *f,
+                           int *error);
+
+    /**
+     * \brief Evaluate and add gradient at several points.
+     *
+     * \param [in] k The number of points.
+     * \param [in] n The length of each point, as in evalBatch().
+     * \param [in] x Array of size k*n containing the points one after the
+     * other.
+     * \param [out] grad_f Dense array of size k*n. The values
+     * grad_f[p*n] to grad_f[p*n+n-1] are incremented with the gradient at
+     * point p.
+     * \param [out] error It should be set a positive value if there is
+     * error encountered while evaluating any point. Leave undisturbed
+     * otherwise.
+     */
+    virtual void evalGradientBatch(UInt k, UInt n, const double *x,
+                                   double *grad_f, int *error);
+
     /**
      * \brief Evaluate and add hessian at a given point.
      *
@@ -145,6 +181,18 @@ namespace Minotaur {
      */
     virtual void  finalHessStor(const LTHessStor *stor) = 0;
 
+    /**
+     * \brief Get the positions in the Hessian values array to which
+     * evalHessian() adds.
+     *
+     * Valid only after finalHessStor() has been called.
+     * \param [out] offs The positions are appended to offs, one for each
+     * value added by evalHessian().
+     * \return True if the positions could be reported, false otherwise. The
+     * default implementation returns false.
+     */
+    virtual bool getHessOffs(UIntVector *offs) const;
+
     /**
      * \brief Return a string in AMPL's .nl format (postfix notation) of this
      * nonlinear function.
@@ -60,9 +60,11 @@ OAHandler::OAHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe,
   nlCons_(0),
   nlpe_(nlpe),
   milpe_(milpe),
+  nlpCache_(0),
   nlpStatus_(EngineUnknownStatus),
   objVar_(VariablePtr()),
   oNl_(false),
+  ownCache_(true),
   rel_(RelaxationPtr()),
   relobj_(0.0)
 {
@@ -73,6 +75,7 @@ OAHandler::OAHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe,
   objATol_ = env_->getOptions()->findDouble("solAbs_tol")->getValue();
   objRTol_ = env_->getOptions()->findDouble("solRel_tol")->getValue();
   logger_ = env->getLogger();
+  nlpCache_ = (NLPCachePtr) new NLPCache(env_);
 
   stats_ = new OAStats();
   stats_->cuts = 0;
@@ -80,6 +83,7 @@ OAHandler::OAHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe,
   stats_->nlpF = 0;
   stats_->nlpI = 0;
   stats_->nlpIL = 0;
+  stats_->nlpC = 0;
   stats_->milpS = 0;
   stats_->milpIL = 0;
 }
@@ -94,6 +98,9 @@ OAHandler::~OAHandler()
   if (timer_) {
     delete timer_;
   }
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
   env_ = 0;
   rel_ = 0;
   minlp_ = 0;
@@ -167,37 +174,42 @@ void OAHandler::cutIntSol_(ConstSolutionPtr sol, CutManager *cutMan,
                            SeparationStatus *status)
 {
   const double *lpx = sol->getPrimal();
+  const double *nlpx = 0;
+  double nlpval = INFINITY;
   //relobj_ = (sol) ? sol->getObjValue() : -INFINITY;
 
-  fixInts_(lpx);           // Fix integer variables
-  solveNLP_();
-  unfixInts_();            // Unfix integer variables
+  if (nlpCache_->find(minlp_, lpx, &nlpStatus_, &nlpval, nlpX_)) {
+    ++(stats_->nlpC);
+    nlpx = &(nlpX_[0]);
+  } else {
+    fixInts_(lpx);           // Fix integer variables
+    solveNLP_();
+    unfixInts_();            // Unfix integer variables
+    if (NLPCache::keeps(nlpStatus_)) {
+      nlpval = nlpe_->getSolutionValue();
+      nlpx = nlpe_->getSolution()->getPrimal();
+      nlpCache_->insert(minlp_, lpx, nlpStatus_, nlpval, nlpx);
+    }
+  }
 
   switch(nlpStatus_) {
   case (ProvenOptimal):
   case (ProvenLocalOptimal):
-    {
-      ++(stats_->nlpF);
-      double nlpval = nlpe_->getSolutionValue();
-      updateUb_(s_pool, nlpval, sol_found);
-      if ((relobj_ >= nlpval-objATol_) ||
-          (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
-          *status = SepaPrune;
-      } else {
-        const double * nlpx = nlpe_->getSolution()->getPrimal();
-        cutToObj_(nlpx, lpx, cutMan, status);
-        cutToCons_(nlpx, lpx, cutMan, status);
-      }
+    ++(stats_->nlpF);
+    updateUb_(s_pool, nlpval, nlpx, sol_found);
+    if ((relobj_ >= nlpval-objATol_) ||
+        (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
+      *status = SepaPrune;
+    } else {
+      cutToObj_(nlpx, lpx, cutMan, status);
+      cutToCons_(nlpx, lpx, cutMan, status);
     }
     break;
   case (ProvenInfeasible):
   case (ProvenLocalInfeasible):
   case (ProvenObjectiveCutOff):
-    {
-      ++(stats_->nlpI);
-      const double * nlpx = nlpe_->getSolution()->getPrimal();
-      cutToCons_(nlpx, lpx, cutMan, status);
-    }
+    ++(stats_->nlpI);
+    cutToCons_(nlpx, lpx, cutMan, status);
     break;
   case (EngineIterationLimit):
     ++(stats_->nlpIL);
@@ -696,6 +708,16 @@ void OAHandler::separate(ConstSolutionPtr sol, NodePtr, RelaxationPtr,
 }
 
 
+void OAHandler::setNLPCache(NLPCachePtr cache)
+{
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
+  nlpCache_ = cache;
+  ownCache_ = false;
+}
+
+
 void OAHandler::solveNLP_()
 {
   nlpStatus_ = nlpe_->solve();
@@ -718,14 +740,13 @@ void OAHandler::unfixInts_()
 
 
 void OAHandler::updateUb_(SolutionPoolPtr s_pool, double nlpval, 
-                          bool *sol_found)
+                          const double *x, bool *sol_found)
 {
   //MS: solution is added to the pool only if better than incumbent
   double bestval = s_pool->getBestSolutionValue();
 
   if ((bestval - objATol_ > nlpval) ||
         (bestval != 0 && (bestval - fabs(bestval)*objRTol_ > nlpval))) {
-    const double *x = nlpe_->getSolution()->getPrimal();
 #pragma omp critical (solPool)
     s_pool->addSolution(x, nlpval);
     *sol_found = true;
@@ -744,6 +765,8 @@ void OAHandler::writeStats(std::ostream &out) const
     << stats_->nlpF << std::endl
     << me_ << "number of nlps hit engine iterations limit     = " 
     << stats_->nlpIL << std::endl
+    << me_ << "number of nlps found in cache                  = " 
+    << stats_->nlpC << std::endl
     << me_ << "number of milps solved                         = " 
     << stats_->milpS << std::endl
     << me_ << "number of milps hit engine iterations limit    = " 
@@ -21,6 +21,7 @@
 #include "Engine.h"
 #include "Problem.h"
 #include "Function.h"
+#include "NLPCache.h"
 #include "Timer.h"
 
 namespace Minotaur {
@@ -31,6 +32,7 @@ struct OAStats {
   size_t nlpF;      /// Number of nlps feasible.
   size_t nlpI;      /// Number of nlps infeasible.
   size_t nlpIL;     /// Number of nlps hits engine iterations limit.
+  size_t nlpC;      /// Number of nlps whose results were found in cache.
   size_t milpS;      /// Number of milps solved.
   size_t milpIL;     /// Number of milps hits engine iterations limit.
 }; 
@@ -79,8 +81,14 @@ private:
   /// MILP Engine used to solve the MILP relaxations.
   MILPEnginePtr milpe_;
 
+  /// Results of NLPs solved earlier, may be shared with other handlers.
+  NLPCachePtr nlpCache_;
+
   /// Modifications done to NLP before solving it.
   std::stack<Modification *> nlpMods_;
+
+  /// Solution of an NLP found in nlpCache_.
+  DoubleVector nlpX_;
   
   /// Status of the NLP/QP engine.
   EngineStatus nlpStatus_;
@@ -95,6 +103,9 @@ private:
   /// Nonlinearity status of objective function. 1 if nonlinear 0 otherwise.
   bool oNl_;
 
+  /// True if nlpCache_ was created by this handler.
+  bool ownCache_;
+
   /// Pointer to relaxation of the problem.
   RelaxationPtr rel_;
  
@@ -201,6 +212,14 @@ public:
   // Show statistics.
   void writeStats(std::ostream &out) const;
 
+  /**
+   * \brief Use a cache of NLP results that is shared with other handlers,
+   * e.g. the handlers of other threads, instead of a private one.
+   *
+   * \param [in] cache The cache. It is not deleted by this handler.
+   */
+  void setNLPCache(NLPCachePtr cache);
+
   /// Set the nonlinear constraints
   void setNonlinCons(std::vector<ConstraintPtr> nlCons) {nlCons_ = nlCons;}
 
@@ -297,10 +316,11 @@ private:
   void unfixInts_();
 
   /**
-   * Update the upper bound. XXX: Needs proper integration with
-   * Minotaur's Handler design. 
+   * Update the upper bound with the NLP solution x of value nlp_val. XXX:
+   * Needs proper integration with Minotaur's Handler design. 
    */
-  void updateUb_(SolutionPoolPtr s_pool, double nlp_val, bool *sol_found);
+  void updateUb_(SolutionPoolPtr s_pool, double nlp_val, const double *x,
+                 bool *sol_found);
 
   };
 
@@ -319,8 +319,8 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
       } else if (br_status==ModifiedByBrancher) {
         for (ModificationConstIterator miter=mods.begin(); miter!=mods.end();
              ++miter) {
-          node->addRMod(*miter);
           (*miter)->applyToProblem(relaxation_);
+          node->addRMod(*miter);
         }
         mods.clear();
         should_prune = presolveNode_(node, s_pool);
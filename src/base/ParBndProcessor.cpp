@@ -234,8 +234,8 @@ void ParBndProcessor::process(NodePtr node, RelaxationPtr rel,
     } else if (br_status==ModifiedByBrancher) {
       for (ModificationConstIterator miter=mods.begin(); miter!=mods.end();
            ++miter) {
-        node->addRMod(*miter);
         (*miter)->applyToProblem(relaxation_);
+        node->addRMod(*miter);
       }
       should_resolve = true;
     } 
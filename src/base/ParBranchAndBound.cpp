@@ -55,6 +55,8 @@ ParBranchAndBound::ParBranchAndBound()
     nodeRlxr_(0),
     options_(0),
     problem_(0),
+    racePool_(0),
+    raceStop_(0),
     solPool_(0),
     stats_(0),
     status_(NotStarted),
@@ -69,6 +71,8 @@ ParBranchAndBound::ParBranchAndBound(EnvPtr env, ProblemPtr p)
     nodePrcssr_(0),
     nodeRlxr_(0),
     problem_(p),
+    racePool_(0),
+    raceStop_(0),
     solPool_(0),
     stats_(0),
     status_(NotStarted)
@@ -354,6 +358,22 @@ readSerialOutput(const char* myFile)
 }
 
 
+void ParBranchAndBound::resetRelaxers_(ParNodeIncRelaxerPtr parNodeRlxr[],
+                                       NodePtr current_node[],
+                                       bool dived_prev[], UInt numThreads)
+{
+  // undo the modifications that are still applied to the relaxation of
+  // each thread. If a thread stopped right after a dive, those of the
+  // parent of its current node are.
+  for (UInt i=0; i<numThreads; ++i) {
+    if (current_node[i] && dived_prev[i]) {
+      parNodeRlxr[i]->reset(current_node[i]->getParent(), false);
+    }
+    parNodeRlxr[i]->reset(NodePtr(), false);
+  }
+}
+
+
 void ParBranchAndBound::setLogLevel(LogLevel level) 
 {
   logger_->setMaxLevel(level);
@@ -372,12 +392,46 @@ void ParBranchAndBound::setNodeRelaxer(NodeRelaxerPtr nr)
 }
 
 
+void ParBranchAndBound::setRace(SolutionPoolPtr pool, bool *stop)
+{
+  racePool_ = pool;
+  raceStop_ = stop;
+}
+
+
 void ParBranchAndBound::shouldCreateRoot(bool b)
 {
   options_->createRoot = b;
 }
 
 
+bool ParBranchAndBound::race_()
+{
+  bool stop;
+  double ub;
+
+#pragma omp critical (racePool)
+  {
+#pragma omp critical (solPool)
+    {
+      ub = solPool_->getBestSolutionValue();
+      if (ub < racePool_->getBestSolutionValue()) {
+        racePool_->addSolution(solPool_->getBestSolution());
+      } else if (racePool_->getBestSolutionValue() < ub) {
+        ub = racePool_->getBestSolutionValue();
+        solPool_->addSolution(racePool_->getBestSolution());
+      }
+    }
+  }
+  if (ub < tm_->getUb()) {
+    tm_->setUb(ub);
+  }
+#pragma omp atomic read
+  stop = *raceStop_;
+  return stop;
+}
+
+
 bool ParBranchAndBound::shouldPrune_(NodePtr node)
 {
   bool should_prune = false;
@@ -438,7 +492,10 @@ bool ParBranchAndBound::shouldStopPar_(double WallTimeStart, double treeLb)
 {
   bool stop_bnb = false;
 
-  if (tm_->getPerGapPar(treeLb) <= 0.0) {
+  if (racePool_ && race_()) {
+    stop_bnb = true;
+    status_ = Interrupted;
+  } else if (tm_->getPerGapPar(treeLb) <= 0.0) {
     stop_bnb = true;
     status_ = SolvedOptimal;
   } else if ( tm_->getPerGapPar(treeLb) <= options_->perGapLimit) {
@@ -557,9 +614,14 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     should_prune[i] = false;
     initialized[i] = false;
     nodeCountTh[i] = 1;
+    parNodeRlxr[i]->setTreeManager(tm_);
     nodesProcTh[i] = 0;
   }
 
+  if (options_->shardNodes) {
+    tm_->setShards(numThreads);
+  }
+
   // initialize timer
   timer_->start();
 
@@ -647,28 +709,19 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
  
     while (nodeCountTh[i] > 0 && shouldRun) {
       if (current_node[i]) {
-#pragma omp critical (treeManager)
-        {
-          if (tm_->shouldPrune_(current_node[i])) {
-            parNodeRlxr[i]->reset(current_node[i], false);
+        if (tm_->shouldPrune_(current_node[i])) {
+          parNodeRlxr[i]->reset(current_node[i], false);
 #if SPEW
-            logger_->msgStream(LogInfo) << me_ << "prune node "
-              << current_node[i]->getId() << " thread "
-              << omp_get_thread_num() << std::endl;
+          logger_->msgStream(LogInfo) << me_ << "prune node "
+            << current_node[i]->getId() << " thread "
+            << omp_get_thread_num() << std::endl;
 #endif
-            tm_->pruneNode(current_node[i]);
+          tm_->pruneNode(current_node[i]);
 #pragma omp critical (current_node)
-            current_node[i] = NodePtr();
-          }
+          current_node[i] = NodePtr();
         }
       } else {
-#pragma omp critical (treeManager)
-        {
-          current_node[i] = tm_->getCandidate();
-          if (current_node[i]) {
-            tm_->removeActiveNode(current_node[i]);
-          }
-        }
+        current_node[i] = tm_->popCandidate();
         if (current_node[i]) {
           nodesProcTh[i]++;
 #if SPEW
@@ -725,10 +778,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
           << omp_get_thread_num() << std::endl;
 #endif
         if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-          {
-            tm_->setUb(solPool_->getBestSolutionValue());
-          }
+          tm_->setUb(solPool_->getBestSolutionValue());
         }
         should_prune[i] = shouldPrune_(current_node[i]);
 
@@ -740,27 +790,18 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
             << omp_get_thread_num() << std::endl;
 #endif
           parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-          {
-            tm_->pruneNode(current_node[i]);
-          }
+          tm_->pruneNode(current_node[i]);
 #pragma omp critical (current_node)
           current_node[i] = NodePtr();
-#pragma omp critical (treeManager)
-          {
-            new_node[i] = tm_->getCandidate();
-            if (new_node[i]) {
-              //getting and removing node must be in the same critical
-              //block otherwise some other thread might take the same node
-              tm_->removeActiveNode(new_node[i]);
-              nodesProcTh[i]++;
+          new_node[i] = tm_->popCandidate();
+          if (new_node[i]) {
+            nodesProcTh[i]++;
 #if SPEW
 #pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node "
-                << new_node[i]->getId() << " (prune) thread "
-                << omp_get_thread_num() << std::endl;
+            logger_->msgStream(LogDebug) << me_ << "get node "
+              << new_node[i]->getId() << " (prune) thread "
+              << omp_get_thread_num() << std::endl;
 #endif
-            }
           }
           dived_prev[i] = false;
         } else {
@@ -779,49 +820,39 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
           if (!branches[i]) {
             logger_->msgStream(LogDebug) << " NO BRANCHES \n";
           }
-#pragma omp critical (treeManager)
-          {
 #pragma omp critical (current_node)
-            new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
+          new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
 #pragma omp critical (logger)
-            logger_->msgStream(LogDebug) << me_ << "get node "
-              << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
-              << std::endl;
+          logger_->msgStream(LogDebug) << me_ << "get node "
+            << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
+            << std::endl;
 #endif
-          }
           assert((should_dive[i] && new_node[i])
                  || (!should_dive[i] && !new_node[i]));
           if (should_dive[i]) {
             dived_prev[i] = true;
           } else {
             parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->getCandidate(); // Can be NULL. The
-              // branches that were created could have large lb and tm
-              // might have eliminated them.
-              if (new_node[i]) {
-                tm_->removeActiveNode(new_node[i]);
+            new_node[i] = tm_->popCandidate(); // Can be NULL. The
+            // branches that were created could have large lb and tm
+            // might have eliminated them.
+            if (new_node[i]) {
 #if SPEW
 #pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get/remove node "
-                  << new_node[i]->getId() << " thread "
-                  << omp_get_thread_num() << std::endl;
+              logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                << new_node[i]->getId() << " thread "
+                << omp_get_thread_num() << std::endl;
 #endif
-              }
-              dived_prev[i] = false;
             }
+            dived_prev[i] = false;
           }
         }
 #pragma omp critical (current_node)
         current_node[i] = new_node[i];
       } // if (current_node[i]) ends
       //update lower bound
-#pragma omp critical (treeManager)
-      {
-        treeLbTh[i] = tm_->updateLb();
-      }
+      treeLbTh[i] = tm_->updateLb();
       minNodeLbTh[i] = INFINITY;
       for (UInt j=0; j < numThreads; ++j) {
 #pragma omp critical (current_node)
@@ -855,10 +886,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         showParStatus_(nodeCountTh[i], treeLbTh[i], wallTimeStart, i);
       }
       if (shouldStopPar_(wallTimeStart, treeLbTh[i])) {
-#pragma omp critical (treeManager)
-        {
-          tm_->updateLb();
-        }
+        tm_->updateLb();
       }
 
       // update stopping conditions
@@ -904,6 +932,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     << me_ << "nodes created   = " << tm_->getSize() << std::endl;
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
 
+  resetRelaxers_(parNodeRlxr, current_node, dived_prev, numThreads);
   stats_->timeUsed = timer_->query();
   timer_->stop();
 
@@ -971,6 +1000,11 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
     initialized[i] = false;
     shouldRunTh[i] = true;
     nodeCountTh[i] = 1;
+    parNodeRlxr[i]->setTreeManager(tm_);
+  }
+
+  if (options_->shardNodes) {
+    tm_->setShards(numThreads);
   }
 
   // initialize timer
@@ -1079,27 +1113,18 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             //<< me_ << "depth = " << current_node[0]->getDepth() << std::endl
             //<< me_ << "did we dive = " << dived_prev[0] << std::endl;
 //#endif
-#pragma omp critical (treeManager)
-          {
-            if (tm_->shouldPrune_(current_node[i])) {
-              parNodeRlxr[i]->reset(current_node[i], false);
+          if (tm_->shouldPrune_(current_node[i])) {
+            parNodeRlxr[i]->reset(current_node[i], false);
 #if SPEW
-              logger_->msgStream(LogInfo) << me_ << "prune node "
-                << current_node[i]->getId() << " thread "
-                << omp_get_thread_num() << std::endl;
+            logger_->msgStream(LogInfo) << me_ << "prune node "
+              << current_node[i]->getId() << " thread "
+              << omp_get_thread_num() << std::endl;
 #endif
-              tm_->pruneNode(current_node[i]);
-              current_node[i] = NodePtr();
-            }
+            tm_->pruneNode(current_node[i]);
+            current_node[i] = NodePtr();
           }
         } else {
-#pragma omp critical (treeManager)
-          {
-            current_node[i] = tm_->getCandidate();
-            if(current_node[i]) {
-              tm_->removeActiveNode(current_node[i]);
-            }
-          }
+          current_node[i] = tm_->popCandidate();
           dived_prev[i] = false;
         }
         if (current_node[i]) {
@@ -1147,10 +1172,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             << omp_get_thread_num()<< std::endl;
 #endif
           if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-            {
-              tm_->setUb(solPool_->getBestSolutionValue());
-            }
+            tm_->setUb(solPool_->getBestSolutionValue());
           }
           should_prune[i] = shouldPrune_(current_node[i]);
 
@@ -1162,25 +1184,16 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
               << omp_get_thread_num() << std::endl;
 #endif
             parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-            {
-              tm_->pruneNode(current_node[i]);
-            }
+            tm_->pruneNode(current_node[i]);
             current_node[i] = NodePtr();
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->getCandidate();
-              if (new_node[i]) {
+            new_node[i] = tm_->popCandidate();
+            if (new_node[i]) {
 #if SPEW
 #pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get node "
-                  << new_node[i]->getId() << " (prune) thread "
-                  << omp_get_thread_num() << std::endl;
+              logger_->msgStream(LogDebug) << me_ << "get node "
+                << new_node[i]->getId() << " (prune) thread "
+                << omp_get_thread_num() << std::endl;
 #endif
-                //getting and removing node must be in the same critical
-                //block otherwise some other thread might take the same node
-                tm_->removeActiveNode(new_node[i]);
-              }
             }
             dived_prev[i] = false;
 
@@ -1200,38 +1213,31 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             if (!branches[i]) {
               logger_->msgStream(LogDebug) << " NO BRANCHES \n";
             }
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
+            new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
 #pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node "
-                << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
-                << std::endl;
+            logger_->msgStream(LogDebug) << me_ << "get node "
+              << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
+              << std::endl;
 #endif
-            }
             assert((should_dive[i] && new_node[i])
                    || (!should_dive[i] && !new_node[i]));
             if (should_dive[i]) {
               dived_prev[i] = true;
             } else {
               parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-              {
-                new_node[i] = tm_->getCandidate(); // Can be NULL. The
-                // branches that were created could have large lb and tm
-                // might have eliminated them.
-                if (new_node[i]) {
-                  tm_->removeActiveNode(new_node[i]);
+              new_node[i] = tm_->popCandidate(); // Can be NULL. The
+              // branches that were created could have large lb and tm
+              // might have eliminated them.
+              if (new_node[i]) {
 #if SPEW
 #pragma omp critical (logger)
-                  logger_->msgStream(LogDebug) << me_ << "get/remove node "
-                    << new_node[i]->getId() << " thread "
-                    << omp_get_thread_num() << std::endl;
+                logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                  << new_node[i]->getId() << " thread "
+                  << omp_get_thread_num() << std::endl;
 #endif
-                }
-                dived_prev[i] = false;
               }
+              dived_prev[i] = false;
             }
           }
           current_node[i] = new_node[i];
@@ -1242,10 +1248,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
       for (UInt i = 0; i < numThreads; ++i) {
         //stopping condition at each thread
         nodeCountTh[i] = 0;
-#pragma omp critical (treeManager)
-        {
-          treeLbTh[i] = tm_->updateLb();
-        }
+        treeLbTh[i] = tm_->updateLb();
         minNodeLbTh[i] = INFINITY;
 
         for (UInt j=0; j < numThreads; ++j) {
@@ -1267,10 +1270,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           showParStatus_(nodeCountTh[i], treeLbTh[i], wallTimeStart, i);
         }
         if (shouldStopPar_(wallTimeStart, treeLbTh[i])) {
-#pragma omp critical (treeManager)
-          {
-            tm_->updateLb();
-          }
+          tm_->updateLb();
           shouldRunTh[i] = false;
         }
       } //parallel for2 end
@@ -1334,6 +1334,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   //}
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
 
+  resetRelaxers_(parNodeRlxr, current_node, dived_prev, numThreads);
   stats_->timeUsed = timer_->query();
   timer_->stop();
 
@@ -1378,35 +1379,36 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
   bool *should_prune = new bool[numThreads];
   bool *initialized = new bool[numThreads];
   NodePtr *current_node = new NodePtr[numThreads]();
-  NodePtr *new_node = new NodePtr[numThreads];
-  Branches *branches = new Branches[numThreads];
+  NodePtr new_node;
+  Branches branches;
   WarmStartPtr *ws = new WarmStartPtr[numThreads]();
   RelaxationPtr *rel = new RelaxationPtr[numThreads];
+  SolutionPoolPtr *thPool = new SolutionPoolPtr[numThreads];
+  double *busy = new double[numThreads];
+  std::vector<UIntVector> timesUp(numThreads), timesDown(numThreads);
+  std::vector<DoubleVector> pseudoUp(numThreads), pseudoDown(numThreads);
   UInt nodeCount;
+  UInt epochProc;
+  UInt numVars;
   double treeLb, nodeLb, minNodeLb;
-  double *treeLbTh = new double[numThreads];
-  double *nodeLbTh = new double[numThreads];
-  double *minNodeLbTh = new double[numThreads];
-  bool *shouldRunTh = new bool[numThreads];
-  UInt *nodeCountTh = new UInt[numThreads];
-  UInt iterCount = 1;
-  //bool ubUpdated = false;
+  double tStart, tSolve, tMerge;
+  bool isParRel = false;
+  bool shouldRun = true;
 
   omp_set_num_threads(numThreads);
-//#pragma omp parallel for
   for(UInt i = 0; i < numThreads; ++i) {
     should_dive[i] = false;
     dived_prev[i] = false;
     should_prune[i] = false;
     initialized[i] = false;
-    shouldRunTh[i] = true;
-    nodeCountTh[i] = 1;
+    parNodeRlxr[i]->setTreeManager(tm_);
   }
 
   // initialize timer
   timer_->start();
 
-  logger_->msgStream(LogInfo) << me_ << "starting branch-and-bound ";
+  logger_->msgStream(LogInfo) << me_ << "starting deterministic "
+    << "branch-and-bound ";
   if(numThreads > 1) {
   logger_->msgStream(LogInfo) << "using " << numThreads << " out of "
     << omp_get_num_procs() << " processors";
@@ -1458,6 +1460,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
   } else if (shouldStopPar_(wallTimeStart, tm_->getLb())) {
     tm_->updateLb();
     nodeCount = 1;
+    shouldRun = false;
   } else {
 #if SPEW
     logger_->msgStream(LogDebug) << std::setprecision(8)
@@ -1467,68 +1470,98 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
     nodeCount = 1;
   }
 
-  // solve root outside the loop. save the useful information.
-  bool shouldRun = true;
   initialized[0] = true; //pseudoCosts for thread0 initialized while doing root
+  numVars = rel[0]->getNumVars();
+  if (nodePrcssr[0]->getBrancher()->getName() == "ParReliabilityBrancher") {
+    isParRel = true;
+  }
 
-  // memory leak check: remove later
-  if (numThreads > 1) {
-    for (UInt i=1; i < numThreads; i++) {
-      if (current_node[i]) {
-        assert(!"Memory leak (fake node) with a non-master thread\n");
-      }
-    }
+  // each thread checks its solutions against its own pool during an epoch,
+  // so that a solution found by another thread in the same epoch can not
+  // change the result.
+  for (UInt i=0; i < numThreads; i++) {
+    thPool[i] = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
   }
 
+  // Nodes are processed in epochs. In each epoch, every thread processes at
+  // most one node. The nodes are assigned, and the children, solutions and
+  // pseudocosts are merged, by the master in the order of thread ids. Thus
+  // the tree is the same in every run with the same number of threads.
   while ((nodeCount > 0 || tm_->anyActiveNodesLeft()) && shouldRun) {
-#if SPEW
-    logger_->msgStream(LogDebug1) << me_ << "processing node "
-      << current_node[0]->getId() << std::endl
-      << me_ << "depth = " << current_node[0]->getDepth() << std::endl
-      << me_ << "did we dive = " << dived_prev[0] << std::endl;
-#endif
+    tStart = getWallTime();
+    epochProc = stats_->nodesProc;
 
-//#pragma omp parallel
-    //{}
     // NODE ASSIGNMENT
-#pragma omp for
-    for(UInt i = 0; i < numThreads; ++i) {
-      if (current_node[i]) {
+    for (UInt i = 0; i < numThreads; ++i) {
+      if (current_node[i] && tm_->shouldPrune_(current_node[i])) {
+        // the incumbent found in the last epoch may prune a diving node.
+        parNodeRlxr[i]->reset(current_node[i], false);
+        tm_->pruneNode(current_node[i]);
+        current_node[i] = NodePtr();
+      }
+      if (!current_node[i]) {
+        current_node[i] = tm_->getCandidate();
+        if (current_node[i]) {
+          tm_->removeActiveNode(current_node[i]);
+        }
+        dived_prev[i] = false;
+      }
+      if (current_node[i] && solPool_->getBestSolutionValue() <
+          thPool[i]->getBestSolutionValue()) {
+        thPool[i]->addSolution(solPool_->getBestSolution());
+      }
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug1) << me_ << "process node "
-            << current_node[0]->getId() << std::endl
-            << me_ << "depth = " << current_node[0]->getDepth() << std::endl
-            << me_ << "did we dive = " << dived_prev[0] << std::endl;
+      if (current_node[i]) {
+        logger_->msgStream(LogDebug1) << me_ << "assign node "
+          << current_node[i]->getId() << " score "
+          << (int)current_node[i]->getTbScore() << " lb "
+          << current_node[i]->getLb() << " thread " << i << std::endl;
+      }
 #endif
-      } else {
-#pragma omp critical (treeManager)
-        {
-          current_node[i] = tm_->getCandidate();
+    }
+    tSolve = getWallTime();
+    stats_->mergeTime += tSolve-tStart;
+
+#pragma omp parallel
+    {
+      // PSEUDOCOST SNAPSHOT. Thread i sees the pseudocosts that the other
+      // threads had at the end of the last epoch.
+      if (isParRel) {
+#pragma omp for
+        for (UInt i = 0; i < numThreads; ++i) {
+          ParReliabilityBrancherPtr parRelBr;
           if (current_node[i]) {
-#if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogDebug1) << "assign node " << current_node[i]->getId() << " score "
-              << (int)current_node[i]->getTbScore() << " lb "
-              << current_node[i]->getLb() << " thread " << omp_get_thread_num() << "\n";
-#endif
-            tm_->removeActiveNode(current_node[i]);
+            timesUp[i].assign(numVars, 0);
+            timesDown[i].assign(numVars, 0);
+            pseudoUp[i].assign(numVars, 0.0);
+            pseudoDown[i].assign(numVars, 0.0);
+            for (UInt j = 0; j < numThreads; ++j) {
+              if (i!=j) {
+                parRelBr = dynamic_cast <ParReliabilityBrancher*>
+                  (nodePrcssr[j]->getBrancher());
+                const UIntVector &tUp = parRelBr->getTimesUp();
+                const UIntVector &tDown = parRelBr->getTimesDown();
+                const DoubleVector &pUp = parRelBr->getPCUp();
+                const DoubleVector &pDown = parRelBr->getPCDown();
+                for (UInt l=0; l < tDown.size(); ++l) {
+                  timesUp[i][l] += tUp[l];
+                  timesDown[i][l] += tDown[l];
+                  pseudoUp[i][l] += tUp[l]*pUp[l];
+                  pseudoDown[i][l] += tDown[l]*pDown[l];
+                }
+              }
+            }
           }
         }
-        dived_prev[i] = false;
       }
-    } //for end
 
-    // PARALLEL REGION STARTS
-#pragma omp parallel
-    {
       // NODE SOLVING
 #pragma omp for
       for (UInt i = 0; i < numThreads; ++i) {
-        UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown, lastStrBranched;
-        DoubleVector tmpPseudoUp, tmpPseudoDown, pseudoUp, pseudoDown;
-
+        double t;
+        busy[i] = 0.0;
         if (current_node[i]) {
+          t = getWallTime();
           should_dive[i] = false;
           rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                         dived_prev[i],
@@ -1540,179 +1573,133 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
             << (int)current_node[i]->getTbScore() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
-          nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
-                                   initialized[i], timesUp, timesDown,
-                                   pseudoUp, pseudoDown, stats_->nodesProc);
-#pragma omp critical (stats)
-          ++stats_->nodesProc;
-        } //if current_node[i]
-      } //for ends
+          nodePrcssr[i]->process(current_node[i], rel[i], thPool[i],
+                                 initialized[i], timesUp[i], timesDown[i],
+                                 pseudoUp[i], pseudoDown[i], epochProc);
+          busy[i] = getWallTime()-t;
+        }
+      }
+    } //parallel region ends
+    tMerge = getWallTime();
+    for (UInt i = 0; i < numThreads; ++i) {
+      stats_->idleTime += tMerge-tSolve-busy[i];
+    }
 
-      // UPPER BOUND UPDATE
-#pragma omp single
-      {
-        for (UInt i = 0; i < numThreads; ++i) {
-          if (current_node[i]) {
-            //double oldUb = tm_->getUb();
-            if (nodePrcssr[i]->foundNewSolution()) {
+    // UPPER BOUND UPDATE
+    for (UInt i = 0; i < numThreads; ++i) {
+      if (current_node[i]) {
+        ++stats_->nodesProc;
+        if (nodePrcssr[i]->foundNewSolution()) {
 #if SPEW
-              logger_->msgStream(LogInfo) << me_ << "found sol at "
-                << current_node[i]->getId() << " score "
-                << (int)current_node[i]->getTbScore() << " thread "
-                << omp_get_thread_num() << std::endl;
+          logger_->msgStream(LogInfo) << me_ << "found sol at "
+            << current_node[i]->getId() << " score "
+            << (int)current_node[i]->getTbScore() << " thread "
+            << i << std::endl;
 #endif
-              tm_->setUb(solPool_->getBestSolutionValue());
-              //ubUpdated = (oldUb > tm_->getUb()) ? 1 : 0;
-            }
-            should_prune[i] = shouldPrune_(current_node[i]);
-          } //if current_node[i]
-        } //for ends
+          solPool_->addSolution(thPool[i]->getBestSolution());
+        }
       }
-      // BRANCHING SYNCHRONIZATION
-#pragma omp for
-      for (UInt i = 0; i < numThreads; ++i) {
-        if (current_node[i]) {
-          //if (!should_prune[i]) {
-            //should_prune[i] = nodePrcssr[i]->shouldPrune_(current_node[i], current_node[i]->getLb(), solPool_);
-          //}
-          if (should_prune[i]) {
-#if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node "
-              << current_node[i]->getId() << " score "
-              << (int)current_node[i]->getTbScore() << " thread "
-              << omp_get_thread_num() << std::endl;
-#endif
-            parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-            {
-              tm_->pruneNode(current_node[i]);
-              new_node[i] = NodePtr();
-            }
-            dived_prev[i] = false;
-          } else {
-            initialized[i] = true;
-#if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "branch at node "
-              << current_node[i]->getId() << " score "
-              << (int)current_node[i]->getTbScore() << " thread "
-              << omp_get_thread_num() << std::endl;
+    }
+    if (solPool_->getBestSolutionValue() < tm_->getUb()) {
+      tm_->setUb(solPool_->getBestSolutionValue());
+    }
 
-#endif
-            branches[i] = nodePrcssr[i]->getBranches();
-            //if (ubUpdated) {
-//#pragma omp critical (logger)
-              //std::cout << "ub updated\n";
-              //BrCandPtr br_can = (*branches[i]->begin())->getBrCand();
-              //const double* xsol = nodePrcssr[i]->getSolution()->getPrimal();
-              //DoubleVector x;
-              //x.resize(rel[i]->getNumVars());
-              //std::copy(xsol, xsol+rel[i]->getNumVars(), x.begin());
-              //branches[i] = br_can->getHandler()->getBranches(br_can, x, rel[i], solPool_);
-              //for (BranchConstIterator br_iter=branches[i]->begin();
-                  //br_iter!=branches[i]->end(); ++br_iter) {
-                //(*br_iter)->setBrCand(br_can);
-              //}
-            //}
-            ws[i] = nodePrcssr[i]->getWarmStart();
-            should_dive[i] = tm_->shouldDive();
-            assert(branches[i]);
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
-#if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogInfo) << me_ << "get node "
-                << new_node[i]->getId() << " score "
-                << (int)new_node[i]->getTbScore() << " (branch) thread "
-                << omp_get_thread_num() << std::endl;
-#endif
-            }
-            assert((should_dive[i] && new_node[i])
-                   || (!should_dive[i] && !new_node[i]));
-            if (should_dive[i]) {
-              dived_prev[i] = true;
-            } else {
-              parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-              {
-                new_node[i] = tm_->getCandidate(); // Can be NULL. The
-                // branches that were created could have large lb and tm
-                // might have eliminated them.
-                if (new_node[i]) {
-                  tm_->removeActiveNode(new_node[i]);
+    // BRANCHING
+    for (UInt i = 0; i < numThreads; ++i) {
+      if (!current_node[i]) {
+        continue;
+      }
+      should_prune[i] = shouldPrune_(current_node[i]);
+      if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogInfo) << me_ << "get node "
-                << new_node[i]->getId() << " score "
-                << (int)new_node[i]->getTbScore() << " (prune) thread "
-                << omp_get_thread_num() << std::endl;
+        logger_->msgStream(LogInfo) << me_ << "prune node "
+          << current_node[i]->getId() << " score "
+          << (int)current_node[i]->getTbScore() << " thread "
+          << i << std::endl;
 #endif
-                }
-              }
-              dived_prev[i] = false;
-            }
-          }
-          current_node[i] = new_node[i];
-        } // if (current_node[i]) ends
-      } //parallel for end
-#pragma omp single
-      {
-        //iterCount++;
-        nodeCount = 0;
-        treeLb = tm_->updateLb();
-        minNodeLb = INFINITY;
-        for (UInt j = 0; j < numThreads; ++j) {
-          if (current_node[j]) {
-            nodeCount++;
-            nodeLb = current_node[j]->getLb();
-            if (nodeLb < minNodeLb) {
-              minNodeLb = nodeLb;
-            }
-          }
-        }
-        if (minNodeLb < treeLb) {
-          treeLb = minNodeLb;
+        parNodeRlxr[i]->reset(current_node[i], false);
+        tm_->pruneNode(current_node[i]);
+        new_node = NodePtr();
+        dived_prev[i] = false;
+      } else {
+        initialized[i] = true;
+        branches = nodePrcssr[i]->getBranches();
+        ws[i] = nodePrcssr[i]->getWarmStart();
+        should_dive[i] = tm_->shouldDive();
+        assert(branches);
+        new_node = tm_->branch(branches, current_node[i], ws[i]);
+        assert((should_dive[i] && new_node)
+               || (!should_dive[i] && !new_node));
+        if (should_dive[i]) {
+          dived_prev[i] = true;
+        } else {
+          // a new node is assigned in the next epoch.
+          parNodeRlxr[i]->reset(current_node[i], false);
+          dived_prev[i] = false;
         }
-        showParStatus_(nodeCount, treeLb, wallTimeStart, 0);
+      }
+      current_node[i] = new_node;
+    }
 
-        // update stopping conditions
-        if (nodeCount == 0 && !(tm_->anyActiveNodesLeft())) {
-          tm_->updateLb();
-          if (tm_->getUb() <= -INFINITY) {
-            status_ = SolvedUnbounded;
-          } else if (tm_->getUb() < INFINITY) {
-            status_ = SolvedOptimal; // TODO: get the right status
-          } else {
-            status_ = SolvedInfeasible; // TODO: get the right status
-          }
+    ++stats_->epochs;
+    nodeCount = 0;
+    treeLb = tm_->updateLb();
+    minNodeLb = INFINITY;
+    for (UInt j = 0; j < numThreads; ++j) {
+      if (current_node[j]) {
+        nodeCount++;
+        nodeLb = current_node[j]->getLb();
+        if (nodeLb < minNodeLb) {
+          minNodeLb = nodeLb;
+        }
+      }
+    }
+    if (minNodeLb < treeLb) {
+      treeLb = minNodeLb;
+    }
+    showParStatus_(nodeCount, treeLb, wallTimeStart, 0);
+
+    // update stopping conditions
+    if (nodeCount == 0 && !(tm_->anyActiveNodesLeft())) {
+      tm_->updateLb();
+      if (tm_->getUb() <= -INFINITY) {
+        status_ = SolvedUnbounded;
+      } else if (tm_->getUb() < INFINITY) {
+        status_ = SolvedOptimal; // TODO: get the right status
+      } else {
+        status_ = SolvedInfeasible; // TODO: get the right status
+      }
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "all nodes have "
-            << "been processed" << std::endl;
+      logger_->msgStream(LogDebug) << me_ << "all nodes have "
+        << "been processed" << std::endl;
 #endif
-        } else if (shouldStopPar_(wallTimeStart, treeLb)) {
-          tm_->updateLb();
-          shouldRun = false;
-        } else {
+    } else if (shouldStopPar_(wallTimeStart, treeLb)) {
+      tm_->updateLb();
+      shouldRun = false;
+    } else {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << std::setprecision(8)
-            << me_ << "lb = " << tm_->updateLb() << std::endl
-            << me_ << "ub = " << tm_->getUb() << std::endl;
+      logger_->msgStream(LogDebug) << std::setprecision(8)
+        << me_ << "lb = " << tm_->updateLb() << std::endl
+        << me_ << "ub = " << tm_->getUb() << std::endl;
 #endif
-          iterCount++;
-        }
-      } //omp master/single ended
-    }   //parallel region ends
+    }
+    stats_->mergeTime += getWallTime()-tMerge;
   }     //while ends
+
+  // the time that threads of the opportunistic mode would have spent on
+  // other nodes.
+  stats_->syncOverhead = stats_->mergeTime + stats_->idleTime/numThreads;
   logger_->msgStream(LogInfo) << me_ << "stopping branch-and-bound"
     << std::endl
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
     << me_ << "nodes created   = " << tm_->getSize() << std::endl
-    << me_ << "iterations = " << iterCount << std::endl;
+    << me_ << "epochs          = " << stats_->epochs << std::endl
+    << me_ << "sync overhead   = " << std::fixed << std::setprecision(2)
+    << stats_->syncOverhead << " s ("
+    << 100*stats_->syncOverhead/std::max(getWallTime()-wallTimeStart, 1e-9)
+    << "% of wall time)" << std::endl;
 
+  resetRelaxers_(parNodeRlxr, current_node, dived_prev, numThreads);
   stats_->timeUsed = timer_->query();
   timer_->stop();
 
@@ -1724,26 +1711,16 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
     if (current_node[i]) {
       delete current_node[i]; current_node[i] = 0;
     }
-    if (new_node[i]) {
-      new_node[i] = 0;
-    }
     if (ws[i]) {
       ws[i] = 0;
     }
-    if (branches[i]) {
-      branches[i] = 0;
-    }
+    delete thPool[i];
   }
   delete[] current_node;
-  delete[] new_node;
-  delete[] nodeCountTh;
-  delete[] treeLbTh;
-  delete[] nodeLbTh;
-  delete[] minNodeLbTh;
-  delete[] shouldRunTh;
+  delete[] thPool;
+  delete[] busy;
   delete[] ws;
   delete[] rel;
-  delete[] branches;
 }
 
 
@@ -1753,6 +1730,12 @@ void ParBranchAndBound::writeStats(std::ostream &out)
     << stats_->timeUsed << std::endl
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
     << me_ << "nodes created   = " << tm_->getSize() << std::endl;
+  if (stats_->epochs>0) {
+    out << me_ << "epochs          = " << stats_->epochs << std::endl
+      << me_ << "idle time       = " << stats_->idleTime << std::endl
+      << me_ << "merge time      = " << stats_->mergeTime << std::endl
+      << me_ << "sync overhead   = " << stats_->syncOverhead << std::endl;
+  }
   nodePrcssr_->writeStats(out);
   nodePrcssr_->getBrancher()->writeStats(out);
   for (HeurVector::iterator it=preHeurs_.begin(); it!=preHeurs_.end(); ++it) {
@@ -1767,6 +1750,12 @@ void ParBranchAndBound::writeParStats(std::ostream &out, ParPCBProcessorPtr node
     << stats_->timeUsed << std::endl
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
     << me_ << "nodes created   = " << tm_->getSize() << std::endl;
+  if (stats_->epochs>0) {
+    out << me_ << "epochs          = " << stats_->epochs << std::endl
+      << me_ << "idle time       = " << stats_->idleTime << std::endl
+      << me_ << "merge time      = " << stats_->mergeTime << std::endl
+      << me_ << "sync overhead   = " << stats_->syncOverhead << std::endl;
+  }
   //Amend code below when mcbnb statistics are finalized: to be done!!!
   nodePrcssr[0]->writeStats(out);
   nodePrcssr[0]->getBrancher()->writeStats(out);
@@ -1786,7 +1775,11 @@ double ParBranchAndBound::totalTime()
 // --------------------------------------------------------------------------
 
   ParBabStats::ParBabStats()
-:nodesProc(0),
+:epochs(0),
+  idleTime(0),
+  mergeTime(0),
+  nodesProc(0),
+  syncOverhead(0),
   timeUsed(0),
   updateTime(0)
 {
@@ -1799,6 +1792,7 @@ double ParBranchAndBound::totalTime()
 : createRoot(true),
   nodeLimit(0),
   perGapLimit(0.),
+  shardNodes(false),
   solLimit(0),
   timeLimit(0.)
 
@@ -1813,6 +1807,7 @@ ParBabOptions::ParBabOptions(EnvPtr env)
   logInterval = options->findDouble("bnb_log_interval")->getValue();
   nodeLimit   = options->findInt("bnb_node_limit")->getValue();
   perGapLimit = options->findDouble("obj_gap_percent")->getValue();
+  shardNodes  = options->findBool("mcbnb_shard_nodes")->getValue();
   solLimit    = options->findInt("bnb_sol_limit")->getValue();
   timeLimit   = options->findDouble("bnb_time_limit")->getValue();
   createRoot  = true;
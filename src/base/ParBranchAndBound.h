@@ -150,6 +150,21 @@ namespace Minotaur {
      */
     void setNodeRelaxer(NodeRelaxerPtr nr);
 
+    /**
+     * \brief Race against other branch-and-bound runs that solve the same
+     * problem in other threads.
+     *
+     * The best solution found by any run is copied to the pool, and the
+     * best solution in the pool is used as the incumbent of this run. The
+     * run stops with status Interrupted when the flag is set.
+     *
+     * \param [in] pool The pool shared by all runs. Its size limit must be
+     * one.
+     * \param [in] stop The flag that is set when one of the runs has solved
+     * the problem.
+     */
+    void setRace(SolutionPoolPtr pool, bool *stop);
+
     /**
      * \brief Switch to turn on/off root-node creation.
      *
@@ -191,6 +206,12 @@ namespace Minotaur {
     /**
      * \brief Branch-and-bound solver with reproducibility of results.
      *
+     * Nodes are processed in epochs, one node per thread in each epoch. The
+     * children, incumbents and pseudocosts found in an epoch are merged in
+     * the order of thread ids before the next epoch starts. The tree is thus
+     * the same in every run with the same number of threads (unless the time
+     * limit is hit). The time lost in waiting is saved in ParBabStats.
+     *
      * \param [in] parNodeRelaxer is the array of node relaxers.
      * \param [in] parPCBProcessor is the array of node processors.
      * \param [in] nThreads is the number of threads being used.
@@ -266,6 +287,12 @@ namespace Minotaur {
     /// The Problem that is solved using branch-and-bound.
     ProblemPtr problem_;
 
+    /// The pool shared with other runs when racing. NULL otherwise.
+    SolutionPoolPtr racePool_;
+
+    /// The flag that stops all runs when racing. NULL otherwise.
+    bool *raceStop_;
+
     /// The TreeManager used to manage the search tree.
     SolutionPoolPtr solPool_;
 
@@ -313,6 +340,26 @@ namespace Minotaur {
                          NodePtr &node);
 
 
+    /**
+     * \brief Exchange the incumbent with the runs that race against this
+     * one. Return true if one of them has solved the problem.
+     */
+    bool race_();
+
+    /**
+     * \brief Undo the modifications that are still applied to the
+     * relaxations when the search stops.
+     *
+     * \param [in] parNodeRlxr used to create relaxations of nodes.
+     * \param [in] current_node the node of each thread, or NULL.
+     * \param [in] dived_prev true for a thread whose node is a child of the
+     * node it processed last.
+     * \param [in] numThreads number of threads.
+     */
+    void resetRelaxers_(ParNodeIncRelaxerPtr parNodeRlxr[],
+                        NodePtr current_node[], bool dived_prev[],
+                        UInt numThreads);
+
     /// Return True if a node can be pruned.
     bool shouldPrune_(NodePtr node);
 
@@ -361,9 +408,30 @@ namespace Minotaur {
     /// Constructor. All data is initialized to zero.
     ParBabStats();
 
+    /// Number of epochs in the deterministic mode.
+    UInt epochs;
+
+    /**
+     * \brief Time that threads spent waiting for the slowest thread at the
+     * end of an epoch, summed over all threads.
+     */
+    double idleTime;
+
+    /**
+     * \brief Time spent by the master in assigning nodes and merging the
+     * results of an epoch, while other threads wait.
+     */
+    double mergeTime;
+
     /// Number of nodes processed.
     UInt nodesProc;
 
+    /**
+     * \brief Wall clock time lost by the deterministic mode as compared to
+     * the opportunistic mode, in which threads do not wait for each other.
+     */
+    double syncOverhead;
+
     /// Total time used in branch-and-bound.
     double timeUsed;
 
@@ -399,6 +467,12 @@ namespace Minotaur {
      */
      double perGapLimit;
 
+    /**
+     * \brief Should each thread keep the active nodes in its own shard
+     * (except in the deterministic mode)?
+     */
+    bool shardNodes;
+
     /// Limit on number of nodes processed.
     UInt solLimit;
 
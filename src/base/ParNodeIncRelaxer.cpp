@@ -19,6 +19,7 @@
 #include "Node.h"
 #include "ParNodeIncRelaxer.h"
 #include "Option.h"
+#include "ParTreeManager.h"
 #include "Relaxation.h"
 
 using namespace Minotaur;
@@ -28,8 +29,10 @@ ParNodeIncRelaxer::ParNodeIncRelaxer (EnvPtr env, HandlerVector handlers)
   : engine_(EnginePtr()),  // NULL
     env_(env),
     handlers_(handlers),
+    lcaSwitch_(false),
     modProb_(true),
-    rel_(RelaxationPtr()) // NULL
+    rel_(RelaxationPtr()), // NULL
+    tm_(0)
 {
 }
 
@@ -48,6 +51,7 @@ ParNodeIncRelaxer::~ParNodeIncRelaxer ()
 RelaxationPtr ParNodeIncRelaxer::createRootRelaxation(NodePtr, bool &prune)
 {
   prune = false;
+  path_.clear();
   rel_ = (RelaxationPtr) new Relaxation(env_);
   for (HandlerIterator h = handlers_.begin(); h != handlers_.end() && !prune; 
       ++h) {
@@ -97,43 +101,48 @@ RelaxationPtr ParNodeIncRelaxer::createNodeRelaxation(NodePtr node, bool dived,
   WarmStartPtr ws;
   prune = false;
 
-  if (!dived) {
-    // traceback to root and put in all modifications that need to go into the
-    // relaxation and the engine.
-    std::stack<NodePtr> predecessors;
-    t_node = node->getParent();
-
-    while (t_node) {
-      predecessors.push(t_node);
-      t_node = t_node->getParent();
-    }
+  if (lcaSwitch_) {
+    switchPath_(node, dived);
+  } else {
+    if (!dived) {
+      // traceback to root and put in all modifications that need to go into
+      // the relaxation and the engine.
+      std::stack<NodePtr> predecessors;
+      t_node = node->getParent();
 
-    // starting from the top, put in modifications made at each node to the
-    // engine
-    if (modProb_) {
-      while (!predecessors.empty()) {
-        t_node = predecessors.top();
-        t_node->applyMods(rel_, p_);
-        predecessors.pop();
+      while (t_node) {
+        predecessors.push(t_node);
+        t_node = t_node->getParent();
       }
-    } else {
-      while (!predecessors.empty()) {
-        t_node = predecessors.top();
-        t_node->applyRModsTrans(rel_);
-        if (env_->getOptions()->findBool("storeCutsAtNode")->getValue() == true) {
-          t_node->applyCutsByIndex(rel_);
+
+      // starting from the top, put in modifications made at each node to the
+      // engine
+      if (modProb_) {
+        while (!predecessors.empty()) {
+          t_node = predecessors.top();
+          t_node->applyMods(rel_, p_);
+          predecessors.pop();
+        }
+      } else {
+        while (!predecessors.empty()) {
+          t_node = predecessors.top();
+          t_node->applyRModsTrans(rel_);
+          if (env_->getOptions()->findBool("storeCutsAtNode")->getValue()
+              == true) {
+            t_node->applyCutsByIndex(rel_);
+          }
+          predecessors.pop();
         }
-        predecessors.pop();
       }
     }
-  }
 
-  // put in the modifications that were used to create this node from
-  // its parent.
-  if (modProb_) {
-    node->applyMods(rel_, p_);
-  } else {
-    node->applyRModsTrans(rel_);
+    // put in the modifications that were used to create this node from
+    // its parent.
+    if (modProb_) {
+      node->applyMods(rel_, p_);
+    } else {
+      node->applyRModsTrans(rel_);
+    }
   }
 
   for (HandlerIterator h = handlers_.begin(); h != handlers_.end() && !prune; 
@@ -162,6 +171,15 @@ void ParNodeIncRelaxer::reset(NodePtr node, bool diving)
 {
   NodePtr t_node = node;
 
+  if (!diving && lcaSwitch_ && !path_.empty()) {
+    // modifications are undone in createNodeRelaxation(), once we know
+    // which of them are not needed by the next node. If there is no next
+    // node, undo them now.
+    if (!node) {
+      clearPath_();
+    }
+    return;
+  }
   if (!diving) {
     if (modProb_) {
       while (t_node) {
@@ -178,6 +196,89 @@ void ParNodeIncRelaxer::reset(NodePtr node, bool diving)
 }
 
 
+void ParNodeIncRelaxer::clearPath_()
+{
+  NodePtr t_node = path_.back();
+
+  rel_->beginBoundBatch();
+  while (false==path_.empty()) {
+    if (modProb_) {
+      path_.back()->undoMods(rel_, p_);
+    } else {
+      path_.back()->undoRModsTrans(rel_);
+    }
+    path_.pop_back();
+  }
+  rel_->endBoundBatch();
+  tm_->releaseNode(t_node);
+}
+
+
+void ParNodeIncRelaxer::switchPath_(NodePtr node, bool dived)
+{
+  NodePtrVector branch;
+  NodePtr t_node = 0;
+  UInt keep;
+  bool store_cuts =
+    env_->getOptions()->findBool("storeCutsAtNode")->getValue();
+
+  if (dived && path_.empty()) {
+    // we dived from the root. Its modifications were applied while
+    // processing it.
+    for (t_node=node->getParent(); t_node; t_node=t_node->getParent()) {
+      path_.insert(path_.begin(), t_node);
+    }
+  }
+  if (false==path_.empty()) {
+    t_node = path_.back();
+  }
+
+  // climb up from node until we reach a node whose modifications are
+  // applied. path_[i] is at depth i.
+  branch.push_back(node);
+  node = node->getParent();
+  while (node && (node->getDepth()>=path_.size() ||
+                  path_[node->getDepth()]!=node)) {
+    branch.push_back(node);
+    node = node->getParent();
+  }
+  keep = (node) ? node->getDepth()+1 : 0;
+
+  // the engine only needs the bounds at the new node, not each change
+  // along the way.
+  rel_->beginBoundBatch();
+  while (path_.size()>keep) {
+    if (modProb_) {
+      path_.back()->undoMods(rel_, p_);
+    } else {
+      path_.back()->undoRModsTrans(rel_);
+    }
+    path_.pop_back();
+  }
+  for (NodePtrVector::reverse_iterator it=branch.rbegin();
+       it!=branch.rend(); ++it) {
+    if (modProb_) {
+      (*it)->applyMods(rel_, p_);
+    } else {
+      (*it)->applyRModsTrans(rel_);
+      if (store_cuts && *it!=branch.front()) {
+        (*it)->applyCutsByIndex(rel_);
+      }
+    }
+    assert((*it)->getDepth()==path_.size());
+    path_.push_back(*it);
+  }
+  rel_->endBoundBatch();
+
+  // keep the new node until its modifications are undone. The previous one
+  // is not needed anymore.
+  tm_->holdNode(path_.back());
+  if (t_node) {
+    tm_->releaseNode(t_node);
+  }
+}
+
+
 RelaxationPtr ParNodeIncRelaxer::getRelaxation()
 {
   return rel_;
@@ -187,6 +288,7 @@ RelaxationPtr ParNodeIncRelaxer::getRelaxation()
 void ParNodeIncRelaxer::setRelaxation(RelaxationPtr rel)
 {
   rel_ = rel;
+  path_.clear();
 }
 
 
@@ -196,6 +298,15 @@ void ParNodeIncRelaxer::setProblem(ProblemPtr p)
 }
 
 
+void ParNodeIncRelaxer::setTreeManager(ParTreeManagerPtr tm)
+{
+  tm_ = tm;
+  lcaSwitch_ = (tm_ &&
+                env_->getOptions()->findBool("bnb_lca_switch")->getValue());
+  path_.clear();
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
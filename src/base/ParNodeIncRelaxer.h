@@ -21,6 +21,9 @@
 
 namespace Minotaur {
 
+class ParTreeManager;
+typedef ParTreeManager* ParTreeManagerPtr;
+
 /**
  * The root relaxation is stored as rel_. In each node, we apply all
  * modifications stored in each ancestor of the node. When we are done
@@ -72,6 +75,21 @@ public:
 
   /// Set the problem pointer
   void setProblem(ProblemPtr p);
+
+  /**
+   * \brief Set the tree manager that holds the nodes of the branch-and-bound
+   * tree. Needed when option bnb_lca_switch is set.
+   *
+   * In that mode, reset() does not undo the modifications of the processed
+   * node and its ancestors. The next createNodeRelaxation() undoes only those
+   * below the lowest common ancestor of the two nodes and applies the
+   * modifications of the new node and its ancestors below it. The last node
+   * whose modifications are applied is held in the tree manager, so that it
+   * is not freed before its modifications are undone.
+   *
+   * \param[in] tm The tree manager.
+   */
+  void setTreeManager(ParTreeManagerPtr tm);
 private:
   /// Pointer engine used to solve the relaxation.
   EnginePtr engine_;
@@ -82,6 +100,12 @@ private:
   /// Vector of handlers that will make the relaxation.
   HandlerVector handlers_;
 
+  /**
+   * True if we switch between nodes through their lowest common ancestor.
+   * See setTreeManager().
+   */
+  bool lcaSwitch_;
+
   /**
    * True if Problem is modified in each node, false if only relaxation is
    * modified.
@@ -91,11 +115,26 @@ private:
   /// The problem being solved by branch-and-bound.
   ProblemPtr p_;
 
+  /**
+   * Nodes whose modifications are applied to rel_, root first. Used only
+   * when lcaSwitch_ is true.
+   */
+  NodePtrVector path_;
+
   /**
    * \brief We only keep one relaxation. It is modified at each node and then
    * reset.
    */
   RelaxationPtr rel_;
+
+  /// The tree manager that holds the last node in path_.
+  ParTreeManagerPtr tm_;
+
+  /// Undo the modifications of all nodes in path_ and release the last one.
+  void clearPath_();
+
+  /// Undo and apply modifications to go from the last node in path_ to node.
+  void switchPath_(NodePtr node, bool dived);
 };
 
 typedef ParNodeIncRelaxer* ParNodeIncRelaxerPtr;
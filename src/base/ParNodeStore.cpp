@@ -0,0 +1,295 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2017 The MINOTAUR Team.
+// 
+
+/**
+ * \file ParNodeStore.cpp
+ * \brief Define class ParNodeStore for storing the active nodes of parallel
+ * branch-and-bound in several shards.
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include "MinotaurConfig.h"
+#include "Node.h"
+#include "NodeHeap.h"
+#include "NodeStack.h"
+#include "ParNodeStore.h"
+
+using namespace Minotaur;
+
+
+ParNodeStore::ParNodeStore(TreeSearchOrder order, UInt n)
+  : byDepth_(DepthFirst==order),
+    n_((n>0) ? n : 1),
+    size_(0),
+    topShard_(0)
+{
+  keys_.resize(n_, INFINITY);
+  lbs_.resize(n_, INFINITY);
+  next_.resize(n_, 1);
+  for (UInt s=0; s<n_; ++s) {
+    if (byDepth_) {
+      shards_.push_back((NodeStackPtr) new NodeStack());
+    } else {
+      shards_.push_back((NodeHeapPtr) new NodeHeap(NodeHeap::Value));
+    }
+  }
+#if USE_OPENMP
+  locks_.resize(n_);
+  for (UInt s=0; s<n_; ++s) {
+    omp_init_lock(&locks_[s]);
+  }
+#endif
+}
+
+
+ParNodeStore::~ParNodeStore()
+{
+  for (UInt s=0; s<n_; ++s) {
+    delete shards_[s];
+#if USE_OPENMP
+    omp_destroy_lock(&locks_[s]);
+#endif
+  }
+  shards_.clear();
+}
+
+
+UInt ParNodeStore::bestShard_() const
+{
+  UInt best = 0;
+  double bkey = readKey_(0);
+  double key;
+
+  for (UInt s=1; s<n_; ++s) {
+    key = readKey_(s);
+    if (key<bkey) {
+      bkey = key;
+      best = s;
+    }
+  }
+  return best;
+}
+
+
+double ParNodeStore::getBestLB() const
+{
+  double lb = INFINITY;
+  double slb;
+
+  for (UInt s=0; s<n_; ++s) {
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+    slb = lbs_[s];
+    lb = std::min(lb, slb);
+  }
+  return lb;
+}
+
+
+UInt ParNodeStore::getDeepestLevel() const
+{
+  UInt d = 0;
+
+  for (UInt s=0; s<n_; ++s) {
+    lock_(s);
+    d = std::max(d, shards_[s]->getDeepestLevel());
+    unlock_(s);
+  }
+  return d;
+}
+
+
+UInt ParNodeStore::getSize() const
+{
+  UInt size;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  size = size_;
+  return size;
+}
+
+
+bool ParNodeStore::isEmpty() const
+{
+  return (0==getSize());
+}
+
+
+double ParNodeStore::key_(NodePtr node) const
+{
+  if (byDepth_) {
+    return -((double) node->getDepth());
+  }
+  return node->getLb();
+}
+
+
+void ParNodeStore::lock_(UInt s) const
+{
+#if USE_OPENMP
+  omp_set_lock(&locks_[s]);
+#else
+  (void) s;
+#endif
+}
+
+
+void ParNodeStore::pop()
+{
+  popFrom_(topShard_);
+}
+
+
+NodePtr ParNodeStore::popFrom_(UInt s)
+{
+  NodePtr node = 0;
+
+  lock_(s);
+  if (false==shards_[s]->isEmpty()) {
+    node = shards_[s]->top();
+    shards_[s]->pop();
+    updateKey_(s);
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+    --size_;
+  }
+  unlock_(s);
+  return node;
+}
+
+
+NodePtr ParNodeStore::popTop()
+{
+  UInt s = shard_();
+  UInt other;
+  NodePtr node = 0;
+
+  if (n_>1) {
+    // only the thread that owns shard s changes next_[s].
+    other = (s+next_[s])%n_;
+    next_[s] = next_[s]%(n_-1)+1;
+    if (readKey_(other)<readKey_(s)) {
+      s = other;
+    }
+  }
+  if (readKey_(s)<INFINITY) {
+    node = popFrom_(s);
+  }
+
+  // steal the best node from any shard. The keys may change while we look,
+  // so give up after a few attempts.
+  for (UInt i=0; i<n_ && !node && false==isEmpty(); ++i) {
+    node = popFrom_(bestShard_());
+  }
+  return node;
+}
+
+
+void ParNodeStore::push(NodePtr n)
+{
+  UInt s = shard_();
+
+  lock_(s);
+  shards_[s]->push(n);
+  updateKey_(s);
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+  ++size_;
+  unlock_(s);
+}
+
+
+double ParNodeStore::readKey_(UInt s) const
+{
+  double key;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  key = keys_[s];
+  return key;
+}
+
+
+UInt ParNodeStore::shard_() const
+{
+#if USE_OPENMP
+  return omp_get_thread_num()%n_;
+#else
+  return 0;
+#endif
+}
+
+
+NodePtr ParNodeStore::top() const
+{
+  NodePtr node = 0;
+
+  topShard_ = bestShard_();
+  lock_(topShard_);
+  if (false==shards_[topShard_]->isEmpty()) {
+    node = shards_[topShard_]->top();
+  }
+  unlock_(topShard_);
+  return node;
+}
+
+
+void ParNodeStore::unlock_(UInt s) const
+{
+#if USE_OPENMP
+  omp_unset_lock(&locks_[s]);
+#else
+  (void) s;
+#endif
+}
+
+
+void ParNodeStore::updateKey_(UInt s)
+{
+  double key = INFINITY;
+  double lb = INFINITY;
+  if (false==shards_[s]->isEmpty()) {
+    key = key_(shards_[s]->top());
+    lb = shards_[s]->getBestLB();
+  }
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+  keys_[s] = key;
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+  lbs_[s] = lb;
+}
+
+
+void ParNodeStore::write(std::ostream &out) const
+{
+  for (UInt s=0; s<n_; ++s) {
+    lock_(s);
+    out << "shard " << s << std::endl;
+    shards_[s]->write(out);
+    unlock_(s);
+  }
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,163 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2017 The MINOTAUR Team.
+// 
+
+/**
+ * \file ParNodeStore.h
+ * \brief Declare class ParNodeStore for storing the active nodes of parallel
+ * branch-and-bound in several shards.
+ */
+
+
+#ifndef MINOTAURPARNODESTORE_H
+#define MINOTAURPARNODESTORE_H
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "Types.h"
+#include "ActiveNodeStore.h"
+
+namespace Minotaur {
+
+  /**
+   * \brief Active nodes shared by all the threads of parallel
+   * branch-and-bound.
+   *
+   * The nodes are spread over several shards. Each shard is a NodeHeap (or a
+   * NodeStack for depth first search) with its own lock, so that threads
+   * working on different shards do not wait for each other. A thread pushes
+   * new nodes into its own shard. When it needs a node, it takes the better
+   * of the best node in its own shard and the best node in one other shard,
+   * visiting the other shards in turn. If both are empty, it steals the best
+   * node from any shard. The node returned is therefore not always the best
+   * active node, but it is close to it.
+   *
+   * popTop(), push(), getBestLB() and getSize() may be called by several
+   * threads at once. top() and pop() are meant for use by a single thread,
+   * e.g. while processing the root or deleting the tree.
+   */
+  class ParNodeStore : public ActiveNodeStore {
+
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param[in] order The search order. Shards are stacks for depth first
+     * search and heaps ordered by lower bounds otherwise.
+     * \param[in] n Number of shards. Usually one per thread.
+     */
+    ParNodeStore(TreeSearchOrder order, UInt n);
+
+    /// Destroy. The nodes are not deleted.
+    ~ParNodeStore();
+
+    /**
+     * \brief Find the minimum lower bound of all the active nodes.
+     *
+     * The best bound of each shard is kept up to date when nodes are added
+     * or removed, so no shard is locked. A node is never moved from one
+     * shard to another, so the value is not missing any node that was in a
+     * shard all along.
+     */
+    double getBestLB() const;
+
+    // Base class method.
+    UInt getDeepestLevel() const;
+
+    // Base class method.
+    UInt getSize() const;
+
+    // Base class method.
+    bool isEmpty() const;
+
+    /// Remove the node returned by the last call to top().
+    void pop();
+
+    /**
+     * \brief Remove a node close to the best one and return it.
+     *
+     * \return The node removed. NULL if no node could be found.
+     */
+    NodePtr popTop();
+
+    /// Add a node to the shard of the calling thread.
+    void push(NodePtr n);
+
+    /// Return the best node of all shards.
+    NodePtr top() const;
+
+    // Base class method.
+    void write(std::ostream &out) const;
+
+  private:
+    /// True if the nodes are ordered by depth, false if by lower bound.
+    bool byDepth_;
+
+    /// For each shard, the key of its best node, INFINITY if empty.
+    DoubleVector keys_;
+
+    /// For each shard, the lower bound of its best node, INFINITY if empty.
+    DoubleVector lbs_;
+
+#if USE_OPENMP
+    /// Lock of each shard.
+    mutable std::vector<omp_lock_t> locks_;
+#endif
+
+    /// Number of shards.
+    UInt n_;
+
+    /// For each shard, the offset of the shard to visit next in popTop().
+    UIntVector next_;
+
+    /// Active nodes in each shard.
+    std::vector<ActiveNodeStorePtr> shards_;
+
+    /// Total number of active nodes.
+    UInt size_;
+
+    /// The shard where the node returned by the last top() is.
+    mutable UInt topShard_;
+
+    /// Return the shard whose best node has the smallest key.
+    UInt bestShard_() const;
+
+    /// Return the key by which the given node is ordered across shards.
+    double key_(NodePtr node) const;
+
+    /// Lock shard s.
+    void lock_(UInt s) const;
+
+    /// Remove the best node of shard s and return it. NULL if s is empty.
+    NodePtr popFrom_(UInt s);
+
+    /// Read the key of shard s.
+    double readKey_(UInt s) const;
+
+    /// Return the shard of the calling thread.
+    UInt shard_() const;
+
+    /// Unlock shard s.
+    void unlock_(UInt s) const;
+
+    /// Update the key and the best bound of shard s. It must be locked.
+    void updateKey_(UInt s);
+  };
+  typedef ParNodeStore* ParNodeStorePtr;
+}
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -238,6 +238,22 @@ NodePtr ParQGBranchAndBound::processRoot_(bool *should_prune, bool *should_dive,
   return current_node;
 }
 
+void ParQGBranchAndBound::resetRelaxers_(ParNodeIncRelaxerPtr parNodeRlxr[],
+                                         NodePtr current_node[],
+                                         bool dived_prev[], UInt numThreads)
+{
+  // undo the modifications that are still applied to the relaxation of
+  // each thread. If a thread stopped right after a dive, those of the
+  // parent of its current node are.
+  for (UInt i=0; i<numThreads; ++i) {
+    if (current_node[i] && dived_prev[i]) {
+      parNodeRlxr[i]->reset(current_node[i]->getParent(), false);
+    }
+    parNodeRlxr[i]->reset(NodePtr(), false);
+  }
+}
+
+
 void ParQGBranchAndBound::setLogLevel(LogLevel level) 
 {
   logger_->setMaxLevel(level);
@@ -452,9 +468,14 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     should_prune[i] = false;
     initialized[i] = false;
     nodeCountTh[i] = 1;
+    parNodeRlxr[i]->setTreeManager(tm_);
     nodesProcTh[i] = 0;
   }
 
+  if (options_->shardNodes) {
+    tm_->setShards(numThreads);
+  }
+
   // initialize timer
   timer_->start();
 
@@ -553,28 +574,19 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     //while (nodeCountThread > 0 && shouldRun)
     while (nodeCountTh[i] > 0 && shouldRun) {
       if (current_node[i]) {
-#pragma omp critical (treeManager)
-        {
-          if (tm_->shouldPrune_(current_node[i])) {
-            parNodeRlxr[i]->reset(current_node[i], false);
+        if (tm_->shouldPrune_(current_node[i])) {
+          parNodeRlxr[i]->reset(current_node[i], false);
 #if SPEW
-            logger_->msgStream(LogInfo) << me_ << "prune node "
-              << current_node[i]->getId() << " thread "
-              << omp_get_thread_num() << std::endl;
+          logger_->msgStream(LogInfo) << me_ << "prune node "
+            << current_node[i]->getId() << " thread "
+            << omp_get_thread_num() << std::endl;
 #endif
-            tm_->pruneNode(current_node[i]);
+          tm_->pruneNode(current_node[i]);
 #pragma omp critical (current_node)
-            current_node[i] = NodePtr();
-          }
+          current_node[i] = NodePtr();
         }
       } else {
-#pragma omp critical (treeManager)
-        {
-          current_node[i] = tm_->getCandidate();
-          if (current_node[i]) {
-            tm_->removeActiveNode(current_node[i]);
-          }
-        }
+        current_node[i] = tm_->popCandidate();
         if (current_node[i]) {
           nodesProcTh[i]++;
 #if SPEW
@@ -653,10 +665,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
           << omp_get_thread_num() << std::endl;
 #endif
         if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-          {
-            tm_->setUb(solPool_->getBestSolutionValue());
-          }
+          tm_->setUb(solPool_->getBestSolutionValue());
         }
         should_prune[i] = shouldPrune_(current_node[i]);
 
@@ -668,27 +677,18 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
             << omp_get_thread_num() << std::endl;
 #endif
           parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-          {
-            tm_->pruneNode(current_node[i]);
-          }
+          tm_->pruneNode(current_node[i]);
 #pragma omp critical (current_node)
           current_node[i] = NodePtr();
-#pragma omp critical (treeManager)
-          {
-            new_node[i] = tm_->getCandidate();
-            if (new_node[i]) {
-              //getting and removing node must be in the same critical
-              //block otherwise some other thread might take the same node
-              tm_->removeActiveNode(new_node[i]);
-              nodesProcTh[i]++;
+          new_node[i] = tm_->popCandidate();
+          if (new_node[i]) {
+            nodesProcTh[i]++;
 #if SPEW
 #pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node "
-                << new_node[i]->getId() << " (prune) thread "
-                << omp_get_thread_num() << std::endl;
+            logger_->msgStream(LogDebug) << me_ << "get node "
+              << new_node[i]->getId() << " (prune) thread "
+              << omp_get_thread_num() << std::endl;
 #endif
-            }
           }
           dived_prev[i] = false;
         } else {
@@ -707,39 +707,32 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
           if (!branches[i]) {
             logger_->msgStream(LogDebug) << " NO BRANCHES \n";
           }
-#pragma omp critical (treeManager)
-          {
 #pragma omp critical (current_node)
-            new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
+          new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
 #pragma omp critical (logger)
-            logger_->msgStream(LogDebug) << me_ << "get node "
-              << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
-              << std::endl;
+          logger_->msgStream(LogDebug) << me_ << "get node "
+            << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
+            << std::endl;
 #endif
-          }
           assert((should_dive[i] && new_node[i])
                  || (!should_dive[i] && !new_node[i]));
           if (should_dive[i]) {
             dived_prev[i] = true;
           } else {
             parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->getCandidate(); // Can be NULL. The
-              // branches that were created could have large lb and tm
-              // might have eliminated them.
-              if (new_node[i]) {
-                tm_->removeActiveNode(new_node[i]);
+            new_node[i] = tm_->popCandidate(); // Can be NULL. The
+            // branches that were created could have large lb and tm
+            // might have eliminated them.
+            if (new_node[i]) {
 #if SPEW
 #pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get/remove node "
-                  << new_node[i]->getId() << " thread "
-                  << omp_get_thread_num() << std::endl;
+              logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                << new_node[i]->getId() << " thread "
+                << omp_get_thread_num() << std::endl;
 #endif
-              }
-              dived_prev[i] = false;
             }
+            dived_prev[i] = false;
           }
         }
 #pragma omp critical (current_node)
@@ -747,10 +740,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
       } // if (current_node[i]) ends
 
       //update lower bound
-#pragma omp critical (treeManager)
-      {
-        treeLbTh[i] = tm_->updateLb();
-      }
+      treeLbTh[i] = tm_->updateLb();
       minNodeLbTh[i] = INFINITY;
       for (UInt j=0; j < numThreads; ++j) {
 #pragma omp critical (current_node)
@@ -784,10 +774,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         showParStatus_(nodeCountTh[i], treeLbTh[i], wallTimeStart, i);
       }
       if (shouldStopPar_(wallTimeStart, treeLbTh[i])) {
-#pragma omp critical (treeManager)
-        {
-          tm_->updateLb();
-        }
+        tm_->updateLb();
       }
       // update stopping conditions
       if (nodeCountTh[i] == 0) {
@@ -832,6 +819,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     << me_ << "nodes created   = " << tm_->getSize() << std::endl;
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
 
+  resetRelaxers_(parNodeRlxr, current_node, dived_prev, numThreads);
   stats_->timeUsed = timer_->query();
   timer_->stop();
 
@@ -906,6 +894,11 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
     initialized[i] = false;
     shouldRunTh[i] = true;
     nodeCountTh[i] = 1;
+    parNodeRlxr[i]->setTreeManager(tm_);
+  }
+
+  if (options_->shardNodes) {
+    tm_->setShards(numThreads);
   }
 
   // initialize timer
@@ -1012,27 +1005,18 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           lastStrBranched.resize(numVars,0);
         }
         if (current_node[i]) {
-#pragma omp critical (treeManager)
-          {
-            if (tm_->shouldPrune_(current_node[i])) {
-              parNodeRlxr[i]->reset(current_node[i], false);
+          if (tm_->shouldPrune_(current_node[i])) {
+            parNodeRlxr[i]->reset(current_node[i], false);
 #if SPEW
-              logger_->msgStream(LogInfo) << me_ << "prune node "
-                << current_node[i]->getId() << " thread "
-                << omp_get_thread_num() << std::endl;
+            logger_->msgStream(LogInfo) << me_ << "prune node "
+              << current_node[i]->getId() << " thread "
+              << omp_get_thread_num() << std::endl;
 #endif
-              tm_->pruneNode(current_node[i]);
-              current_node[i] = NodePtr();
-            }
+            tm_->pruneNode(current_node[i]);
+            current_node[i] = NodePtr();
           }
         } else {
-#pragma omp critical (treeManager)
-          {
-            current_node[i] = tm_->getCandidate();
-            if(current_node[i]) {
-              tm_->removeActiveNode(current_node[i]);
-            }
-          }
+          current_node[i] = tm_->popCandidate();
           dived_prev[i] = false;
         }
         if (current_node[i]) {
@@ -1101,10 +1085,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             << omp_get_thread_num()<< std::endl;
 #endif
           if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-            {
-              tm_->setUb(solPool_->getBestSolutionValue());
-            }
+            tm_->setUb(solPool_->getBestSolutionValue());
           }
           should_prune[i] = shouldPrune_(current_node[i]);
 
@@ -1116,25 +1097,16 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
               << omp_get_thread_num() << std::endl;
 #endif
             parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-            {
-              tm_->pruneNode(current_node[i]);
-            }
+            tm_->pruneNode(current_node[i]);
             current_node[i] = NodePtr();
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->getCandidate();
-              if (new_node[i]) {
+            new_node[i] = tm_->popCandidate();
+            if (new_node[i]) {
 #if SPEW
 #pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get node (prune) "
-                  << new_node[i]->getId() << " thread "
-                  << omp_get_thread_num() << std::endl;
+              logger_->msgStream(LogDebug) << me_ << "get node (prune) "
+                << new_node[i]->getId() << " thread "
+                << omp_get_thread_num() << std::endl;
 #endif
-                //getting and removing node must be in the same critical
-                //block otherwise some other thread might take the same node
-                tm_->removeActiveNode(new_node[i]);
-              }
             }
             dived_prev[i] = false;
           } else {
@@ -1153,38 +1125,31 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             if (!branches[i]) {
               logger_->msgStream(LogDebug) << " NO BRANCHES \n";
             }
-#pragma omp critical (treeManager)
-            {
-              new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
+            new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
 #pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node (branch) "
-                << new_node[i]->getId() << " thread " << omp_get_thread_num()
-                << std::endl;
+            logger_->msgStream(LogDebug) << me_ << "get node (branch) "
+              << new_node[i]->getId() << " thread " << omp_get_thread_num()
+              << std::endl;
 #endif
-            }
             assert((should_dive[i] && new_node[i])
                    || (!should_dive[i] && !new_node[i]));
             if (should_dive[i]) {
               dived_prev[i] = true;
             } else {
               parNodeRlxr[i]->reset(current_node[i], false);
-#pragma omp critical (treeManager)
-              {
-                new_node[i] = tm_->getCandidate(); // Can be NULL. The
-                // branches that were created could have large lb and tm
-                // might have eliminated them.
-                if (new_node[i]) {
-                  tm_->removeActiveNode(new_node[i]);
+              new_node[i] = tm_->popCandidate(); // Can be NULL. The
+              // branches that were created could have large lb and tm
+              // might have eliminated them.
+              if (new_node[i]) {
 #if SPEW
 #pragma omp critical (logger)
-                  logger_->msgStream(LogDebug) << me_ << "get/remove node "
-                    << new_node[i]->getId() << " thread "
-                    << omp_get_thread_num() << std::endl;
+                logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                  << new_node[i]->getId() << " thread "
+                  << omp_get_thread_num() << std::endl;
 #endif
-                }
-                dived_prev[i] = false;
               }
+              dived_prev[i] = false;
             }
           }
           current_node[i] = new_node[i];
@@ -1195,10 +1160,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
       for(UInt i = 0; i < numThreads; ++i) {
         //stopping condition at each thread
         nodeCountTh[i] = 0;
-#pragma omp critical (treeManager)
-        {
-          treeLbTh[i] = tm_->updateLb();
-        }
+        treeLbTh[i] = tm_->updateLb();
         minNodeLbTh[i] = INFINITY;
 
         for (UInt j=0; j < numThreads; ++j) {
@@ -1220,10 +1182,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           showParStatus_(nodeCountTh[i], treeLbTh[i], wallTimeStart, i);
         }
         if (shouldStopPar_(wallTimeStart, treeLbTh[i])) {
-#pragma omp critical (treeManager)
-          {
-            tm_->updateLb();
-          }
+          tm_->updateLb();
           shouldRunTh[i] = false;
         }
       } //parallel for2 end
@@ -1288,6 +1247,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   //}
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
 
+  resetRelaxers_(parNodeRlxr, current_node, dived_prev, numThreads);
   stats_->timeUsed = timer_->query();
   timer_->stop();
 
@@ -1349,6 +1309,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
     initialized[i] = false;
     shouldRunTh[i] = true;
     nodeCountTh[i] = 1;
+    parNodeRlxr[i]->setTreeManager(tm_);
   }
 
   // initialize timer
@@ -1678,6 +1639,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
     << me_ << "iterations = " << iterCount << std::endl;
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
 
+  resetRelaxers_(parNodeRlxr, current_node, dived_prev, numThreads);
   stats_->timeUsed = timer_->query();
   timer_->stop();
 
@@ -1751,6 +1713,7 @@ double ParQGBranchAndBound::totalTime()
 : createRoot(true),
   nodeLimit(0),
   perGapLimit(0.),
+  shardNodes(false),
   solLimit(0),
   timeLimit(0.)
 
@@ -1765,6 +1728,7 @@ ParQGBabOptions::ParQGBabOptions(EnvPtr env)
   logInterval = options->findDouble("bnb_log_interval")->getValue();
   nodeLimit   = options->findInt("bnb_node_limit")->getValue();
   perGapLimit = options->findDouble("obj_gap_percent")->getValue();
+  shardNodes  = options->findBool("mcbnb_shard_nodes")->getValue();
   solLimit    = options->findInt("bnb_sol_limit")->getValue();
   timeLimit   = options->findDouble("bnb_time_limit")->getValue();
   createRoot  = true;
@@ -289,6 +289,20 @@ namespace Minotaur {
                          ParPCBProcessorPtr nodePrcssr, WarmStartPtr ws,
                          NodePtr &node);
 
+    /**
+     * \brief Undo the modifications that are still applied to the
+     * relaxations when the search stops.
+     *
+     * \param [in] parNodeRlxr used to create relaxations of nodes.
+     * \param [in] current_node the node of each thread, or NULL.
+     * \param [in] dived_prev true for a thread whose node is a child of the
+     * node it processed last.
+     * \param [in] numThreads number of threads.
+     */
+    void resetRelaxers_(ParNodeIncRelaxerPtr parNodeRlxr[],
+                        NodePtr current_node[], bool dived_prev[],
+                        UInt numThreads);
+
     /// Return True if a node can be pruned.
     bool shouldPrune_(NodePtr node);
 
@@ -378,6 +392,12 @@ namespace Minotaur {
      */
      double perGapLimit;
 
+    /**
+     * \brief Should each thread keep the active nodes in its own shard
+     * (except in the deterministic mode)?
+     */
+    bool shardNodes;
+
     /// Limit on number of nodes processed.
     UInt solLimit;
 
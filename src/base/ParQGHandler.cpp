@@ -56,9 +56,11 @@ ParQGHandler::ParQGHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   minlp_(minlp),
   nlCons_(0),
   nlpe_(nlpe),
+  nlpCache_(0),
   nlpStatus_(EngineUnknownStatus),
   objVar_(VariablePtr()),
   oNl_(false),
+  ownCache_(true),
   rel_(RelaxationPtr()),
   relobj_(0.0),
   node_(0)
@@ -70,12 +72,14 @@ ParQGHandler::ParQGHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   objRTol_ = env_->getOptions()->findDouble("solRel_tol")->getValue();
   storeCutsAtNode_ = env_->getOptions()->findBool("storeCutsAtNode")->getValue();
   logger_ = env->getLogger();
+  nlpCache_ = (NLPCachePtr) new NLPCache(env_);
 
   stats_ = new ParQGStats();
   stats_->nlpS = 0;
   stats_->nlpF = 0;
   stats_->nlpI = 0;
   stats_->nlpIL = 0;
+  stats_->nlpC = 0;
   stats_->cuts = 0;
 }
 
@@ -85,6 +89,9 @@ ParQGHandler::~ParQGHandler()
   if (stats_) {
     delete stats_;
   }
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
 
   env_ = 0;
   rel_ = 0;
@@ -160,40 +167,46 @@ void ParQGHandler::cutIntSol_(ConstSolutionPtr sol, CutManager *cutMan,
                            SeparationStatus *status)
 {
   const double *lpx = sol->getPrimal();
+  const double *nlpx = 0;
+  double nlpval = INFINITY;
   relobj_ = (sol) ? sol->getObjValue() : -INFINITY;
 
-  fixInts_(lpx);           // Fix integer variables
-  solveNLP_();
-  unfixInts_();            // Unfix integer variables
+  // the cache may be shared by the handlers of all threads.
+  if (nlpCache_->find(minlp_, lpx, &nlpStatus_, &nlpval, nlpX_)) {
+    ++(stats_->nlpC);
+    nlpx = &(nlpX_[0]);
+  } else {
+    fixInts_(lpx);           // Fix integer variables
+    solveNLP_();
+    unfixInts_();            // Unfix integer variables
+    if (NLPCache::keeps(nlpStatus_)) {
+      nlpval = nlpe_->getSolutionValue();
+      nlpx = nlpe_->getSolution()->getPrimal();
+      nlpCache_->insert(minlp_, lpx, nlpStatus_, nlpval, nlpx);
+    }
+  }
   
   switch(nlpStatus_) {
   case (ProvenOptimal):
   case (ProvenLocalOptimal):
-    {
-      ++(stats_->nlpF);
-      double nlpval = nlpe_->getSolutionValue();
+    ++(stats_->nlpF);
 #pragma omp critical (solPool)
-      {
-       updateUb_(s_pool, nlpval, sol_found);
-      }
-      if ((relobj_ >= nlpval-objATol_) ||
-          (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
-          *status = SepaPrune;
-      } else {
-        const double * nlpx = nlpe_->getSolution()->getPrimal();
-        cutToObj_(nlpx, lpx, cutMan, status);
-        cutToCons_(nlpx, lpx, cutMan, status);
-      }
+    {
+      updateUb_(s_pool, nlpval, nlpx, sol_found);
+    }
+    if ((relobj_ >= nlpval-objATol_) ||
+        (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
+      *status = SepaPrune;
+    } else {
+      cutToObj_(nlpx, lpx, cutMan, status);
+      cutToCons_(nlpx, lpx, cutMan, status);
     }
     break;
   case (ProvenInfeasible):
   case (ProvenLocalInfeasible):
   case (ProvenObjectiveCutOff):
-    {
-      ++(stats_->nlpI);
-      const double * nlpx = nlpe_->getSolution()->getPrimal();
-      cutToCons_(nlpx, lpx, cutMan, status);
-    }
+    ++(stats_->nlpI);
+    cutToCons_(nlpx, lpx, cutMan, status);
     break;
   case (EngineIterationLimit):
     ++(stats_->nlpIL);
@@ -341,6 +354,16 @@ bool ParQGHandler::isFeasible(ConstSolutionPtr sol, RelaxationPtr, bool &,
 }
 
 
+void ParQGHandler::setNLPCache(NLPCachePtr cache)
+{
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
+  nlpCache_ = cache;
+  ownCache_ = false;
+}
+
+
 void ParQGHandler::setObjVar()
 {
   ObjectivePtr o = minlp_->getObjective();
@@ -759,13 +782,12 @@ void ParQGHandler::unfixInts_()
 
 
 void ParQGHandler::updateUb_(SolutionPoolPtr s_pool, double nlpval,
-                          bool *sol_found)
+                             const double *x, bool *sol_found)
 {
   double bestval = s_pool->getBestSolutionValue();
 
   if ((bestval - objATol_ > nlpval) ||
         (bestval != 0 && (bestval - fabs(bestval)*objRTol_ > nlpval))) {
-    const double *x = nlpe_->getSolution()->getPrimal();
     s_pool->addSolution(x, nlpval);
     *sol_found = true;
   }
@@ -784,6 +806,8 @@ void ParQGHandler::writeStats(std::ostream &out) const
     << stats_->nlpF << std::endl
     << me_ << "number of nlps hit engine iterations limit  = " 
     << stats_->nlpIL << std::endl
+    << me_ << "number of nlps found in cache               = " 
+    << stats_->nlpC << std::endl
     << me_ << "number of cuts added                        = " 
     << stats_->cuts << std::endl;
   return;
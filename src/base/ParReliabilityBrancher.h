@@ -20,8 +20,10 @@
 namespace Minotaur {
 
 class Engine;
+class StrBrPool;
 class Timer;
 typedef Engine* EnginePtr;
+typedef StrBrPool* StrBrPoolPtr;
 
 struct ParRelBrStats {
   UInt bndChange;  /// Number of times variable bounds were changed.
@@ -361,6 +363,12 @@ private:
   /// Modifications that can be applied to the problem.
   ModVector mods_;
 
+  /**
+   * \brief Engines that solve the problems of strong branching in parallel.
+   * NULL if option strbr_threads is less than two.
+   */
+  StrBrPoolPtr pool_;
+
   /// Vector of pseudocosts for rounding down.
   DoubleVector pseudoDown_;
 
@@ -21,8 +21,11 @@
 #include "NodeStack.h"
 #include "Operations.h"
 #include "Option.h"
+#include "ParNodeStore.h"
+#include "SpillFile.h"
 #include "Timer.h"
 #include "ParTreeManager.h"
+#include "WarmStart.h"
 
 using namespace Minotaur;
 
@@ -32,8 +35,12 @@ ParTreeManager::ParTreeManager(EnvPtr env)
   cutOff_(INFINITY),
   doVbc_(false),
   etol_(1e-6),
+  maxMemNodes_(0),
+  numSpilled_(0),
+  sharded_(false),
   size_(0),
-  timer_(0)
+  timer_(0),
+  spill_(0)
 {
   std::string s = env->getOptions()->findString("tree_search")->getValue();
   if ("dfs"==s) {
@@ -61,6 +68,15 @@ ParTreeManager::ParTreeManager(EnvPtr env)
   aNode_ = NodePtr();
   cutOff_ = env->getOptions()->findDouble("obj_cut_off")->getValue();
   tbRule_ = env->getOptions()->findString("tb_rule")->getValue();
+
+  // the newest nodes are processed first in depth first search, so there
+  // are no cold nodes to move to the spill file.
+  maxMemNodes_ = env->getOptions()->findInt("bnb_spill_nodes")->getValue();
+  if (maxMemNodes_>0 && DepthFirst!=searchType_) {
+    s = env->getOptions()->findString("bnb_spill_dir")->getValue();
+    spill_ = (SpillFilePtr) new SpillFile(s);
+  }
+
   s = env->getOptions()->findString("vbc_file")->getValue();
   if (s!="") {
     vbcFile_.open(s.c_str());
@@ -84,6 +100,9 @@ ParTreeManager::~ParTreeManager()
 {
   clearAll();
   delete activeNodes_;
+  if (spill_) {
+    delete spill_;
+  }
   if (doVbc_) {
     vbcFile_.close();
     delete timer_;
@@ -103,38 +122,56 @@ NodePtr ParTreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
   NodePtr new_cand = NodePtr(); // NULL
   NodePtr child;
   bool is_first = false;
+  bool spill = false;
   if (searchType_ == DepthFirst || searchType_ == BestThenDive) {
     is_first = true;
   }
-  for (BranchConstIterator br_iter=branches->begin(); br_iter!=branches->end();
-      ++br_iter) {
-    branch_p = *br_iter;
-    child = (NodePtr) new Node(node, branch_p);
-    child->setLb(node->getLb());
-    child->setTbScore(node->getTbScore());
-    child->setDepth(node->getDepth()+1);
-    node->addChild(child);
-    if (is_first) {
-      child->setWarmStart(ws);
-      insertCandidate_(child, true);
-      is_first = false;
-      new_cand = child;
-    } else {
-      // We make a copy of the pointer to warm-start, not the full copy of the
-      // warm-start.
-      child->setWarmStart(ws);
-      insertCandidate_(child);
+  if (spill_ && shouldSpill_(node)) {
+    spill = true;
+    // the first child is processed right away while diving, and it needs
+    // the warm start. No other thread can see ws before the children are
+    // inserted.
+    if (ws && false==is_first) {
+      ws->spill(spill_);
     }
   }
-  if (doVbc_) {
-    vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1 << " "
-             << VbcSolved << std::endl;
-    if (new_cand) {
-      vbcFile_ << toClockTime(timer_->query()) << " P "
-               << new_cand->getId()+1 << " " << VbcSolving << std::endl;
+#pragma omp critical (treeNodes)
+  {
+    for (BranchConstIterator br_iter=branches->begin();
+         br_iter!=branches->end(); ++br_iter) {
+      branch_p = *br_iter;
+      child = (NodePtr) new Node(node, branch_p);
+      child->setLb(node->getLb());
+      child->setTbScore(node->getTbScore());
+      child->setDepth(node->getDepth()+1);
+      node->addChild(child);
+      if (is_first) {
+        child->setWarmStart(ws);
+        insertCandidate_(child, true);
+        is_first = false;
+        new_cand = child;
+      } else {
+        // We make a copy of the pointer to warm-start, not the full copy of
+        // the warm-start.
+        child->setWarmStart(ws);
+        if (spill) {
+          child->spill(spill_);
+#pragma omp atomic
+          ++numSpilled_;
+        }
+        insertCandidate_(child);
+      }
+    }
+    if (doVbc_) {
+      vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1
+               << " " << VbcSolved << std::endl;
+      if (new_cand) {
+        vbcFile_ << toClockTime(timer_->query()) << " P "
+                 << new_cand->getId()+1 << " " << VbcSolving << std::endl;
+      }
     }
+    aNode_ = new_cand; // can be NULL
   }
-  aNode_ = new_cand; // can be NULL
   return new_cand;
 }
 
@@ -144,14 +181,18 @@ void ParTreeManager::clearAll()
   NodePtr n;
   NodePtrIterator node_i;
 
+  while (false==held_.empty()) {
+    releaseNode(held_.back());
+  }
+
   if (aNode_) {
     //removeNodeAndUp_(aNode_);
     aNode_ = 0;
   }
   while (false==activeNodes_->isEmpty()) {
     n = activeNodes_->top();
-    removeNodeAndUp_(n);
     activeNodes_->pop();
+    removeNodeAndUp_(n);
   }
 }
 
@@ -179,6 +220,7 @@ NodePtr ParTreeManager::getCandidate()
         vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1
                  << " " << VbcSolving << std::endl;
       }
+      unspill_(node);
       break;
     }
   } 
@@ -189,7 +231,10 @@ NodePtr ParTreeManager::getCandidate()
 
 double ParTreeManager::getCutOff()
 {
-  return cutOff_;
+  double cutoff;
+#pragma omp critical (treeBounds)
+  cutoff = cutOff_;
+  return cutoff;
 }
 
 
@@ -199,13 +244,18 @@ double ParTreeManager::getPerGap()
   // so that if one has a ub, she can say that the solution can not be more
   // than gap% away from the current ub.
   double gap = 0.0;
-  if (bestUpperBound_ >= INFINITY) {
+  double lb, ub;
+#pragma omp critical (treeBounds)
+  {
+    lb = bestLowerBound_;
+    ub = bestUpperBound_;
+  }
+  if (ub >= INFINITY) {
     gap = INFINITY;
-  } else if ((bestUpperBound_ > etol_) && (fabs(bestLowerBound_) < etol_)) {
+  } else if ((ub > etol_) && (fabs(lb) < etol_)) {
     gap = 100.0;
   } else {
-    gap = (bestUpperBound_ - bestLowerBound_)/(fabs(bestUpperBound_)+etol_) 
-      * 100.0;
+    gap = (ub - lb)/(fabs(ub)+etol_) * 100.0;
     if (gap<0.0) {
       gap = 0.0;
     }
@@ -220,13 +270,13 @@ double ParTreeManager::getPerGapPar(double treeLb)
   // than gap% away from the current ub.
   //assert(bestLowerBound_ >= treeLb - etol_);
   double gap = 0.0;
-  if (bestUpperBound_ >= INFINITY) {
+  double ub = getUb();
+  if (ub >= INFINITY) {
     gap = INFINITY;
   } else if (fabs(treeLb) < etol_) {
     gap = 100.0;
   } else {
-    gap = (bestUpperBound_ - treeLb)/(fabs(bestUpperBound_)+etol_) 
-      * 100.0;
+    gap = (ub - treeLb)/(fabs(ub)+etol_) * 100.0;
     if (gap<0.0) {
       gap = 0.0;
     }
@@ -237,7 +287,10 @@ double ParTreeManager::getPerGapPar(double treeLb)
 
 double ParTreeManager::getLb()
 {
-  return bestLowerBound_;
+  double lb;
+#pragma omp critical (treeBounds)
+  lb = bestLowerBound_;
+  return lb;
 }
 
 
@@ -249,7 +302,10 @@ UInt ParTreeManager::getSize() const
 
 double ParTreeManager::getUb()
 {
-  return bestUpperBound_;
+  double ub;
+#pragma omp critical (treeBounds)
+  ub = bestUpperBound_;
+  return ub;
 }
 
 
@@ -287,7 +343,7 @@ void ParTreeManager::insertCandidate_(NodePtr node, bool pop_now)
   // is processed right after creating it; we don't
   // want to keep it in activeNodes (e.g. while diving)
   if (!pop_now) {
-    activeNodes_->push(node);
+    pushStore_(node);
   } 
   if (doVbc_) {
     vbcFile_ << toClockTime(timer_->query()) << " N "
@@ -297,6 +353,16 @@ void ParTreeManager::insertCandidate_(NodePtr node, bool pop_now)
 }
 
 
+void ParTreeManager::holdNode(NodePtr node)
+{
+#pragma omp critical (treeNodes)
+  {
+    held_.push_back(node);
+    heldRemoved_.push_back(false);
+  }
+}
+
+
 void ParTreeManager::insertRoot(NodePtr node)
 {
   assert(size_==0);
@@ -304,7 +370,7 @@ void ParTreeManager::insertRoot(NodePtr node)
 
   node->setId(0);
   node->setDepth(0);
-  activeNodes_->push(node);
+  pushStore_(node);
   ++size_;
   if (doVbc_) {
     // father node color
@@ -314,13 +380,78 @@ void ParTreeManager::insertRoot(NodePtr node)
 }
 
 
+NodePtr ParTreeManager::popCandidate()
+{
+  NodePtr node;
+
+  while ((node = popStore_())) {
+    if (shouldPrune_(node)) {
+      pruneNode(node);
+    } else {
+      if (doVbc_) {
+#pragma omp critical (treeNodes)
+        vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1
+                 << " " << VbcSolving << std::endl;
+      }
+      unspill_(node);
+      break;
+    }
+  }
+  return node; // can be NULL
+}
+
+
+NodePtr ParTreeManager::popStore_()
+{
+  NodePtr node;
+
+  if (sharded_) {
+    return activeNodes_->popTop();
+  }
+#pragma omp critical (activeNodes)
+  node = activeNodes_->popTop();
+  return node;
+}
+
+
 void ParTreeManager::pruneNode(NodePtr node)
 {
   // XXX: if required do something before deleting the node.
+#pragma omp critical (treeNodes)
   removeNodeAndUp_(node);
 }
 
 
+void ParTreeManager::pushStore_(NodePtr node)
+{
+  if (sharded_) {
+    activeNodes_->push(node);
+  } else {
+#pragma omp critical (activeNodes)
+    activeNodes_->push(node);
+  }
+}
+
+
+void ParTreeManager::releaseNode(NodePtr node)
+{
+  bool removed;
+
+#pragma omp critical (treeNodes)
+  for (UInt i=0; i<held_.size(); ++i) {
+    if (held_[i]==node) {
+      removed = heldRemoved_[i];
+      held_.erase(held_.begin()+i);
+      heldRemoved_.erase(heldRemoved_.begin()+i);
+      if (removed) {
+        removeNodeAndUp_(node);
+      }
+      break;
+    }
+  }
+}
+
+
 void ParTreeManager::removeActiveNode(NodePtr node)
 {
   if (doVbc_) {
@@ -338,6 +469,18 @@ void ParTreeManager::removeActiveNode(NodePtr node)
 }
 
 
+bool ParTreeManager::markHeld_(NodePtr node)
+{
+  for (UInt i=0; i<held_.size(); ++i) {
+    if (held_[i]==node) {
+      heldRemoved_[i] = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+
 void ParTreeManager::removeNode_(NodePtr node)
 {
   NodePtr cNode, parent;
@@ -375,6 +518,11 @@ void ParTreeManager::removeNode_(NodePtr node)
       assert (!"Current node is not in its parent's list of children!");
     }
   }
+  if (node->isSpilled()) {
+    node->dropSpill(spill_);
+#pragma omp atomic
+    --numSpilled_;
+  }
   delete node;
 }
 
@@ -383,11 +531,16 @@ void ParTreeManager::removeNodeAndUp_(NodePtr node)
 {
   NodePtr parent = node->getParent();
 
+  // a held node is removed when it is released.
+  if (markHeld_(node)) {
+    return;
+  }
+
   // remove the given node
   removeNode_(node);
 
   // remove the ancestors of the given node, if they have no children left
-  while (parent && parent->getNumChildren()==0) {
+  while (parent && parent->getNumChildren()==0 && !markHeld_(parent)) {
     node = parent;
     parent = node->getParent();
     removeNode_(node);
@@ -397,15 +550,30 @@ void ParTreeManager::removeNodeAndUp_(NodePtr node)
 
 void ParTreeManager::setCutOff(double value)
 {
+#pragma omp critical (treeBounds)
   cutOff_ = value;
 }
 
 
+void ParTreeManager::setShards(UInt n)
+{
+  assert(size_==0);
+  if (n>1) {
+    delete activeNodes_;
+    activeNodes_ = (ParNodeStorePtr) new ParNodeStore(searchType_, n);
+    sharded_ = true;
+  }
+}
+
+
 void ParTreeManager::setUb(double value)
 {
-  bestUpperBound_ = value;
-  if (value < cutOff_) {
-    cutOff_ = value;
+#pragma omp critical (treeBounds)
+  {
+    bestUpperBound_ = value;
+    if (value < cutOff_) {
+      cutOff_ = value;
+    }
   }
 }
 
@@ -422,8 +590,13 @@ bool ParTreeManager::shouldDive()
 bool ParTreeManager::shouldPrune_(NodePtr node)
 {
   double lb = node->getLb();
-  if (lb > cutOff_ - etol_ || 
-      fabs(bestUpperBound_-lb)/(fabs(bestUpperBound_)+etol_)*100 < etol_) {
+  double cutoff, ub;
+#pragma omp critical (treeBounds)
+  {
+    cutoff = cutOff_;
+    ub = bestUpperBound_;
+  }
+  if (lb > cutoff - etol_ || fabs(ub-lb)/(fabs(ub)+etol_)*100 < etol_) {
     node->setStatus(NodeHitUb);
     return true;
   }
@@ -431,12 +604,47 @@ bool ParTreeManager::shouldPrune_(NodePtr node)
 }
 
 
+bool ParTreeManager::shouldSpill_(NodePtr node)
+{
+  UInt spilled;
+  double best_lb;
+
+#pragma omp atomic read
+  spilled = numSpilled_;
+#pragma omp critical (treeBounds)
+  best_lb = bestLowerBound_;
+  // nodes with the best bound are likely to be processed soon.
+  return (activeNodes_->getSize()-spilled >= maxMemNodes_ &&
+          node->getLb() > best_lb+etol_);
+}
+
+
+void ParTreeManager::unspill_(NodePtr node)
+{
+  if (node->isSpilled()) {
+    node->unspill(spill_);
+#pragma omp atomic
+    --numSpilled_;
+  }
+}
+
+
 double ParTreeManager::updateLb()
 {
-  // this could be an expensive operation. Try to avoid it.
-  bestLowerBound_ = activeNodes_->getBestLB();
+  double lb;
+
+  // this could be an expensive operation. Try to avoid it. The sharded
+  // store keeps the best bound of each shard and needs no lock.
+  if (sharded_) {
+    lb = activeNodes_->getBestLB();
+  } else {
+#pragma omp critical (activeNodes)
+    lb = activeNodes_->getBestLB();
+  }
+#pragma omp critical (treeBounds)
+  bestLowerBound_ = lb;
 
-  return bestLowerBound_;
+  return lb;
 }
 
 
@@ -21,8 +21,10 @@
 namespace Minotaur {
   
   class ActiveNodeStore;
+  class SpillFile;
   class WarmStart;
   typedef ActiveNodeStore* ActiveNodeStorePtr;
+  typedef SpillFile* SpillFilePtr;
   typedef WarmStart* WarmStartPtr;
 
   // 1=like_red, 2=blue, 4=red, 5=yellow, 6=black, 7=pink, 8=cyan, 9=green
@@ -39,7 +41,15 @@ namespace Minotaur {
   } VbcColors;
 
 
-  /// Base class for managing the branch-and-bound tree. 
+  /**
+   * \brief Manage the branch-and-bound tree shared by all threads.
+   *
+   * Except getCandidate() and removeActiveNode(), which must be called
+   * together inside one critical section, the public functions may be
+   * called by several threads at once. Changes to the tree are serialized
+   * internally. The active nodes are kept either in one store with a lock,
+   * or in a ParNodeStore with one shard per thread; see setShards().
+   */
   class ParTreeManager {
 
   public:
@@ -123,6 +133,17 @@ namespace Minotaur {
      */
     NodePtr getCandidate();
 
+    /**
+     * \brief Keep a node in memory, even if it is pruned, until
+     * releaseNode() is called.
+     *
+     * A node relaxer may keep the modifications of a node applied after the
+     * node is processed, and undo them only when the next node is known. It
+     * needs the node and its ancestors until then.
+     * \param[in] node The node that must not be freed.
+     */
+    void holdNode(NodePtr node);
+
     /**
      * \brief Insert the root node into the tree.
      *
@@ -130,6 +151,16 @@ namespace Minotaur {
      */
     void insertRoot(NodePtr node);
 
+    /**
+     * \brief Remove a good candidate from the active nodes and return it.
+     *
+     * Nodes that can be pruned because of their bound are pruned on the way.
+     * Unlike getCandidate(), it may be called by several threads at once and
+     * the candidate need not be removed by removeActiveNode().
+     * \return The candidate, or NULL if no active node was found.
+     */
+    NodePtr popCandidate();
+
     /**
      * \brief Prune a given node from the tree
      *
@@ -137,6 +168,14 @@ namespace Minotaur {
      */
     void pruneNode(NodePtr node);
 
+    /**
+     * \brief Stop holding a node. The node is freed now if it was pruned
+     * while it was held.
+     *
+     * \param[in] node A node passed to holdNode() earlier.
+     */
+    void releaseNode(NodePtr node);
+
     /**
      * \brief Remove a given active node from storage.
      *
@@ -153,6 +192,17 @@ namespace Minotaur {
      */
     void setCutOff(double value);
 
+    /**
+     * \brief Store the active nodes in n shards, one for each thread.
+     *
+     * Threads then add and remove active nodes mostly in their own shard,
+     * and take nodes from other shards only when theirs is empty or worse.
+     * It must be called before the root is inserted.
+     * \param[in] n The number of shards. Nothing is changed if it is less
+     * than two.
+     */
+    void setShards(UInt n);
+
     /** 
      * \brief Set the best known objective function value.
      *
@@ -203,9 +253,27 @@ namespace Minotaur {
     /// Tolerance for pruning nodes on the basis of bounds.
     const double etol_;
 
+    /**
+     * Number of active nodes above which new nodes are moved to spill_. 0
+     * if nodes are never moved.
+     */
+    UInt maxMemNodes_;
+
+    /// Number of active nodes that are in spill_ now.
+    UInt numSpilled_;
+
+    /// Nodes passed to holdNode() that have not been released yet.
+    NodePtrVector held_;
+
+    /// Entry i is true if held_[i] was pruned while it was held.
+    BoolVector heldRemoved_;
+
     /// The search order: depth first, best first or something else.
     TreeSearchOrder searchType_;
 
+    /// True if activeNodes_ is a ParNodeStore that does its own locking.
+    bool sharded_;
+
     /**
      * \brief Number of nodes that have been created so far, including the
      * ones that were deleted.
@@ -221,9 +289,29 @@ namespace Minotaur {
     /// File name to store tree information for vbc.
     std::ofstream vbcFile_;
 
+    /**
+     * File to which the warm starts and branches of active nodes are moved
+     * when there are too many active nodes. NULL if they are always kept in
+     * memory.
+     */
+    SpillFilePtr spill_;
+
     /// Check if the node can be pruned because of its bound.
     bool shouldPrune_(NodePtr node);
 
+    /**
+     * \brief Check if the children of a node should be moved to the spill
+     * file when they are created.
+     *
+     * \param[in] node The node that is branched upon.
+     * \return True if there are too many active nodes in memory and the
+     * children are not among the best active nodes.
+     */
+    bool shouldSpill_(NodePtr node);
+
+    /// Read back a node from the spill file if it was moved there.
+    void unspill_(NodePtr node);
+
     /**
      * \brief Insert a candidate (that is not root) into the tree.
      *
@@ -232,6 +320,21 @@ namespace Minotaur {
      */
     void insertCandidate_(NodePtr node, bool pop_now = false);
 
+    /**
+     * \brief Check if a node is held. If so, mark it as pruned so that it
+     * is removed when it is released.
+     *
+     * \param[in] node The node that is about to be removed.
+     * \return True if the node is held and must not be removed now.
+     */
+    bool markHeld_(NodePtr node);
+
+    /// Remove the best node from activeNodes_ and return it.
+    NodePtr popStore_();
+
+    /// Add a node to activeNodes_.
+    void pushStore_(NodePtr node);
+
     /**
      * \brief Remove a node from the tree. Ancestors are removed if their
      * single child is removed.
@@ -11,6 +11,7 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -407,6 +408,27 @@ double PolynomialFunction::eval(const double *x, int *error)
 }
 
 
+void PolynomialFunction::evalBatch(UInt k, UInt n, const double *x,
+                                   double *f, int *error)
+{
+  if (cg_) {
+    cg_->evalBatch(k, n, x, f, error);
+  } else {
+    int err = 0;
+    std::fill(f, f+k, cb_);
+    for (MonomialConstIter it=terms_.begin(); it!=terms_.end(); ++it) {
+      for (UInt p=0; p<k; ++p) {
+        f[p] += (*it)->eval(x+p*n, &err);
+        if (0!=err) {
+          *error = err;
+          return;
+        }
+      }
+    }
+  }
+}
+
+
 void PolynomialFunction::evalGradient(const double *x, double *grad_f, 
                                       int *error)
 {
@@ -418,6 +440,22 @@ void PolynomialFunction::evalGradient(const double *x, double *grad_f,
 }
 
 
+void PolynomialFunction::evalGradientBatch(UInt k, UInt n, const double *x,
+                                           double *grad_f, int *error)
+{
+  int err = 0;
+  for (MonomialConstIter it=terms_.begin(); it!=terms_.end(); ++it) {
+    for (UInt p=0; p<k; ++p) {
+      (*it)->evalGradient(x+p*n, grad_f+p*n, &err);
+      if (0!=err) {
+        *error = err;
+        return;
+      }
+    }
+  }
+}
+
+
 void PolynomialFunction::evalHessian(const double mult, const double *x, 
                                      const LTHessStor *stor, double *values, 
                                      int *error) 
@@ -460,6 +498,15 @@ void PolynomialFunction::finalHessStor(const LTHessStor *stor)
 }
 
 
+bool PolynomialFunction::getHessOffs(UIntVector *offs) const
+{
+  if (cg_) {
+    return cg_->getHessOffs(offs);
+  }
+  return false;
+}
+
+
 FunctionType PolynomialFunction::getType() const
 {
   return Polynomial;
@@ -185,9 +185,16 @@ namespace Minotaur {
     // base class function.
     double eval(const double *x, int *error);
 
+    // base class function.
+    void evalBatch(UInt k, UInt n, const double *x, double *f, int *error);
+
     // base class function.
     void evalGradient(const double *x, double *grad_f, int *error);
 
+    // base class function.
+    void evalGradientBatch(UInt k, UInt n, const double *x, double *grad_f,
+                           int *error);
+
     // base class function.
     void evalHessian(const double mult, const double *x, 
                      const LTHessStor *stor, double *values, 
@@ -202,6 +209,9 @@ namespace Minotaur {
     // base class function.
     void  finalHessStor(const LTHessStor *stor);
 
+    // base class function.
+    bool getHessOffs(UIntVector *offs) const;
+
     // base class function.
     void getVars(VariableSet *);
 
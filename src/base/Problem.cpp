@@ -17,6 +17,7 @@
 #include <sstream>
 
 #include "MinotaurConfig.h"
+#include "CGraph.h"
 #include "Constraint.h"
 #include "Engine.h"
 #include "Environment.h"
@@ -27,6 +28,7 @@
 #include "Logger.h"
 #include "NonlinearFunction.h"
 #include "Objective.h"
+#include "Option.h"
 #include "Problem.h"
 #include "ProblemSize.h"
 #include "QuadraticFunction.h"
@@ -38,8 +40,10 @@ using namespace Minotaur;
 const std::string Problem::me_ = "Problem: ";
 
 Problem::Problem(EnvPtr env) 
-: cons_(0), 
+: bndBatch_(false),
+  cons_(0), 
   consModed_(false),
+  derThreads_(1),
   engine_(0),
   hessian_(0),
   jacobian_(0),
@@ -47,15 +51,23 @@ Problem::Problem(EnvPtr env)
   nextCId_(0),
   nextSId_(0),
   nextVId_(0),
+  nlShared_(0),
   numDCons_(0),
   numDVars_(0),
   obj_(0), 
+  shareNl_(false),
   size_(0),
+  structVer_(0),
   vars_(0), 
   varsModed_(false)
 
 {
+  int nt = env->getOptions()->findInt("nlp_eval_threads")->getValue();
   logger_ = env->getLogger();
+  if (nt>1) {
+    derThreads_ = nt;
+  }
+  shareNl_ = env->getOptions()->findBool("nlp_share_subexpr")->getValue();
 }
 
 
@@ -94,6 +106,9 @@ Problem::~Problem()
   if (jacobian_) {
     delete jacobian_;
   }
+  if (nlShared_) {
+    delete nlShared_;
+  }
   if (size_) {
     delete size_;
   }
@@ -141,6 +156,28 @@ void Problem::addToCons(ConstraintPtr cons, double c)
 }
 
 
+void Problem::batchBound_(VariablePtr var)
+{
+  UInt i = var->getIndex();
+
+  if (bndBatchSeen_.size()<=i) {
+    bndBatchSeen_.resize(vars_.size(), false);
+  }
+  if (false==bndBatchSeen_[i]) {
+    bndBatchSeen_[i] = true;
+    bndBatchVars_.push_back(var);
+    bndBatchLb_.push_back(var->getLb());
+    bndBatchUb_.push_back(var->getUb());
+  }
+}
+
+
+void Problem::beginBoundBatch()
+{
+  bndBatch_ = true;
+}
+
+
 void Problem::calculateSize(bool shouldRedo)
 {
   if (!size_) {
@@ -173,12 +210,15 @@ void Problem::changeBoundByInd(UInt ind, BoundType lu, double new_val)
   assert(ind < vars_.size() || 
       !"Problem::changeBound: index of variable exceeds no. of variables.");
 
+  if (bndBatch_) {
+    batchBound_(vars_[ind]);
+  }
   if (lu == Lower) {
     vars_[ind]->setLb_(new_val);
   } else {
     vars_[ind]->setUb_(new_val);
   }
-  if (engine_) {
+  if (engine_ && !bndBatch_) {
     engine_->changeBound(vars_[ind], lu, new_val);
   }
 }
@@ -190,9 +230,12 @@ void Problem::changeBoundByInd(UInt ind, double new_lb, double new_ub)
   assert(ind < vars_.size() || 
       !"Problem::changeBound: index of variable exceeds no. of variables.");
 
+  if (bndBatch_) {
+    batchBound_(vars_[ind]);
+  }
   vars_[ind]->setLb_(new_lb);
   vars_[ind]->setUb_(new_ub);
-  if (engine_) {
+  if (engine_ && !bndBatch_) {
     engine_->changeBound(vars_[ind], new_lb, new_ub);
   }
 }
@@ -204,12 +247,15 @@ void Problem::changeBound(VariablePtr var, BoundType lu, double new_val)
   assert(var == vars_[var->getIndex()] || 
       !"Problem: Bound of variable not in a problem can't be changed.");
 
+  if (bndBatch_) {
+    batchBound_(var);
+  }
   if (lu == Lower) {
     var->setLb_(new_val);
   } else {
     var->setUb_(new_val);
   }
-  if (engine_) {
+  if (engine_ && !bndBatch_) {
     engine_->changeBound(var, lu, new_val);
   }
 }
@@ -221,9 +267,12 @@ void Problem::changeBound(VariablePtr var, double new_lb, double new_ub)
   assert(var == vars_[var->getIndex()] || 
       !"Problem: Bound of variable that is not in problem can't be changed.");
 
+  if (bndBatch_) {
+    batchBound_(var);
+  }
   var->setLb_(new_lb);
   var->setUb_(new_ub);
-  if (engine_) {
+  if (engine_ && !bndBatch_) {
     engine_->changeBound(var, new_lb, new_ub);
   }
 }
@@ -289,6 +338,7 @@ void Problem::changeConstraint(ConstraintPtr con, NonlinearFunctionPtr nlf)
     (*vit)->inConstraint_(con);
   }
   consModed_ = true;
+  ++structVer_;
 }
 
 
@@ -323,6 +373,7 @@ void Problem::changeConstraint(ConstraintPtr con, LinearFunctionPtr lf,
     (*vit)->inConstraint_(con);
   }
   consModed_ = true;
+  ++structVer_;
 }
 
 
@@ -1033,6 +1084,7 @@ void Problem::delMarkedCons()
 
     cons_ = copycons;
     consModed_ = true;
+    ++structVer_;
     numDCons_ = 0;
   }
 }
@@ -1071,11 +1123,38 @@ void Problem::delMarkedVars(bool keep)
     vars_ = copyvars;
 
     varsModed_ = true;
+    ++structVer_;
     numDVars_ = 0;
   }
 }
 
 
+void Problem::endBoundBatch()
+{
+  VarVector vars;
+  DoubleVector lb, ub;
+  VariablePtr v;
+
+  bndBatch_ = false;
+  for (UInt i=0; i<bndBatchVars_.size(); ++i) {
+    v = bndBatchVars_[i];
+    bndBatchSeen_[v->getIndex()] = false;
+    // bounds that were changed and then restored need not be sent.
+    if (v->getLb()!=bndBatchLb_[i] || v->getUb()!=bndBatchUb_[i]) {
+      vars.push_back(v);
+      lb.push_back(v->getLb());
+      ub.push_back(v->getUb());
+    }
+  }
+  bndBatchVars_.clear();
+  bndBatchLb_.clear();
+  bndBatchUb_.clear();
+  if (engine_ && !vars.empty()) {
+    engine_->changeBounds(vars, lb, ub);
+  }
+}
+
+
 ProblemType Problem::findType()
 {
   calculateSize();
@@ -1655,6 +1734,7 @@ void Problem::reverseSense(ConstraintPtr cons)
 {
   cons->reverseSense_();
   consModed_ = true;
+  ++structVer_;
 }
 
 
@@ -1736,8 +1816,48 @@ void Problem::setNativeDer()
   if (hessian_) {
     delete hessian_; hessian_ = 0;
   }
+  if (nlShared_) {
+    delete nlShared_; nlShared_ = 0;
+  }
   jacobian_ = (JacobianPtr) new Jacobian(cons_, vars_.size());
   hessian_ = (HessianOfLagPtr) new HessianOfLag(this);
+  if (derThreads_>1) {
+    jacobian_->setNumThreads(derThreads_);
+    hessian_->setNumThreads(derThreads_);
+  }
+  if (shareNl_) {
+    setNlShared_();
+  }
+}
+
+
+void Problem::setNlShared_()
+{
+  std::vector<CGraphPtr> cgs;
+  CGraphPtr cg;
+  FunctionPtr f;
+
+  for (ConstraintConstIterator it=cons_.begin(); it!=cons_.end(); ++it) {
+    f = (*it)->getFunction();
+    cg = (f) ? dynamic_cast <CGraph*> (f->getNonlinearFunction()) : 0;
+    if (cg) {
+      cgs.push_back(cg);
+    }
+  }
+  f = (obj_) ? obj_->getFunction() : 0;
+  cg = (f) ? dynamic_cast <CGraph*> (f->getNonlinearFunction()) : 0;
+  if (cg) {
+    cgs.push_back(cg);
+  }
+
+  // nothing can be shared with fewer than two functions.
+  if (cgs.size()<2) {
+    return;
+  }
+  nlShared_ = (CGraphPtr) new CGraph();
+  nlShared_->share(cgs);
+  jacobian_->setShared(nlShared_);
+  hessian_->setShared(nlShared_);
 }
 
 
@@ -1803,6 +1923,7 @@ void Problem::subst(VariablePtr out, VariablePtr in, double rat)
 
   obj_->subst_(out, in, rat);
   consModed_ = varsModed_ = true;
+  ++structVer_;
 }
 
 
@@ -20,6 +20,7 @@
 
 namespace Minotaur {
 
+  class CGraph;
   class Engine;
   class Function;
   class HessianOfLag;
@@ -30,6 +31,7 @@ namespace Minotaur {
   class QuadraticFunction;
   class SOS;
   class SparseMatrix;
+  typedef CGraph* CGraphPtr;
   typedef Jacobian* JacobianPtr;
   typedef HessianOfLag* HessianOfLagPtr;
   typedef LinearFunction* LinearFunctionPtr;
@@ -74,6 +76,15 @@ namespace Minotaur {
     /// Add a constant term to the objective.
     virtual void addToObj(double cb);
 
+    /**
+     * \brief Start collecting changes in bounds of variables.
+     *
+     * Until endBoundBatch() is called, the bounds of variables are changed
+     * in the problem but not in the engine. Useful when many bounds are
+     * changed and changed back, e.g. when switching between nodes.
+     */
+    virtual void beginBoundBatch();
+
     /// Fill up the statistics about the size of the problem into size_.
     virtual void calculateSize(bool shouldRedo=false);
 
@@ -180,6 +191,12 @@ namespace Minotaur {
      */
     virtual void delMarkedVars(bool keep=false);
 
+    /**
+     * \brief Stop collecting changes in bounds of variables, and send the
+     * net changes since beginBoundBatch() to the engine in one call.
+     */
+    virtual void endBoundBatch();
+
     /**
      * \brief Return what type of problem it is. May result in re-calculation of
      * the problem size.
@@ -245,6 +262,14 @@ namespace Minotaur {
     /// Calculate and return a measure of the size of the problem.
     double getSizeEstimate();
 
+    /**
+     * \brief Return a number that changes whenever a constraint or a
+     * variable is deleted, a function of a constraint is changed, or a
+     * variable is substituted. Adding constraints or variables and changing
+     * bounds do not change it.
+     */
+    virtual UInt getStructVer() const { return structVer_; }
+
     /// Return a pointer to the variable with a given index
     virtual VariablePtr getVariable(UInt index) const;
 
@@ -573,6 +598,21 @@ namespace Minotaur {
     virtual void writeSize(std::ostream &out) const;
 
   protected:
+    /// True if changes in bounds of variables are being collected.
+    bool bndBatch_;
+
+    /// Lower bounds of bndBatchVars_ when they were first changed.
+    DoubleVector bndBatchLb_;
+
+    /// Entry i is true if the variable with index i is in bndBatchVars_.
+    BoolVector bndBatchSeen_;
+
+    /// Upper bounds of bndBatchVars_ when they were first changed.
+    DoubleVector bndBatchUb_;
+
+    /// Variables whose bounds were changed since beginBoundBatch().
+    VarVector bndBatchVars_;
+
     /// Vector of constraints.
     ConstraintVector cons_;
 
@@ -587,6 +627,9 @@ namespace Minotaur {
      */
     bool consModed_;
 
+    /// Number of threads used to fill the native Jacobian and Hessian.
+    UInt derThreads_;
+
     /// Engine that must be updated if problem is loaded to it, could be null 
     Engine* engine_;
 
@@ -614,6 +657,12 @@ namespace Minotaur {
     /// ID of the next variable.
     UInt nextVId_;
 
+    /**
+     * Graph with the subexpressions common to the nonlinear functions of
+     * objective and constraints. NULL if not used.
+     */
+    CGraphPtr nlShared_;
+
     /// Number of constraints marked for deletion
     UInt numDCons_;
 
@@ -623,6 +672,9 @@ namespace Minotaur {
     /// Objective, could be NULL.
     ObjectivePtr obj_;
 
+    /// If true, setNativeDer() sets up nlShared_.
+    bool shareNl_;
+
     /// Size statistics for this Problem.
     ProblemSizePtr size_;
 
@@ -632,6 +684,9 @@ namespace Minotaur {
     /// SOS2 constraints.
     SOSVector sos2_;
 
+    /// Changed whenever existing constraints or variables are changed.
+    UInt structVer_;
+
     /// Vector of variables.
     VarVector vars_;
 
@@ -644,6 +699,9 @@ namespace Minotaur {
     /// True if variables delete, added or their bounds changed.
     bool varsModed_;
 
+    /// Remember the bounds of var before its first change in a batch.
+    void batchBound_(VariablePtr var);
+
     /// Count the types of constraints and fill the values in size_.
     virtual void countConsTypes_();
 
@@ -664,6 +722,13 @@ namespace Minotaur {
 
     void setIndex_(VariablePtr v, UInt i);
 
+    /**
+     * \brief Set up nlShared_ from the CGraph functions of objective and
+     * constraints, and let the Jacobian and the Hessian evaluate it once
+     * at each point.
+     */
+    void setNlShared_();
+
   };
 }
 #endif
@@ -50,9 +50,11 @@ QGAdvHandler::QGAdvHandler()
   minlp_(ProblemPtr()),
   nlCons_(0),
   nlpe_(EnginePtr()),
+  nlpCache_(0),
   nlpStatus_(EngineUnknownStatus),
   objVar_(VariablePtr()),
   oNl_(false),
+  ownCache_(true),
   rel_(RelaxationPtr()),
   relobj_(0.0),
   stats_(0),
@@ -73,9 +75,11 @@ QGAdvHandler::QGAdvHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   minlp_(minlp),
   nlCons_(0),
   nlpe_(nlpe),
+  nlpCache_(0),
   nlpStatus_(EngineUnknownStatus),
   objVar_(VariablePtr()),
   oNl_(false),
+  ownCache_(true),
   rel_(RelaxationPtr()),
   relobj_(0.0),
   prStatus_(0),
@@ -87,12 +91,14 @@ QGAdvHandler::QGAdvHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   npATol_ = env_->getOptions()->findDouble("solAbs_tol")->getValue();
   npRTol_ = env_->getOptions()->findDouble("solRel_tol")->getValue();
   logger_ = env->getLogger();
+  nlpCache_ = (NLPCachePtr) new NLPCache(env_);
 
   stats_ = new QGStats();
   stats_->nlpS = 0;
   stats_->nlpF = 0;
   stats_->nlpI = 0;
   stats_->nlpIL = 0;
+  stats_->nlpC = 0;
   stats_->cuts = 0;
 }
  
@@ -103,9 +109,11 @@ QGAdvHandler::QGAdvHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe,
   minlp_(minlp),
   nlCons_(0),
   nlpe_(nlpe),
+  nlpCache_(0),
   nlpStatus_(EngineUnknownStatus),
   objVar_(VariablePtr()),
   oNl_(false),
+  ownCache_(true),
   rel_(RelaxationPtr()),
   relobj_(0.0),
   prStatus_(0),
@@ -115,11 +123,13 @@ QGAdvHandler::QGAdvHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe,
   solAbsTol_ = env_->getOptions()->findDouble("solAbs_tol")->getValue();
   solRelTol_ = env_->getOptions()->findDouble("solRel_tol")->getValue();
   logger_ = env->getLogger();
+  nlpCache_ = (NLPCachePtr) new NLPCache(env_);
   stats_ = new QGStats();
   stats_->nlpS = 0;
   stats_->nlpF = 0;
   stats_->nlpI = 0;
   stats_->nlpIL = 0;
+  stats_->nlpC = 0;
   stats_->cuts = 0;
 }
 
@@ -129,6 +139,9 @@ QGAdvHandler::~QGAdvHandler()
   if (stats_) {
     delete stats_;
   }
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
   nlCons_.clear();
 }
 
@@ -203,24 +216,33 @@ void QGAdvHandler::cutIntSol_(ConstSolutionPtr sol, CutManager *cutMan,
 {
   SeparationStatus pcStatus;
   double nlpval = INFINITY;
-  const double *lpx = sol->getPrimal(), *nlpx;
+  const double *lpx = sol->getPrimal(), *nlpx = 0;
   relobj_ = (sol) ? sol->getObjValue() : -INFINITY;
 
-  fixInts_(lpx);           // Fix integer variables
-  solveNLP_();
-  unfixInts_();            // Unfix integer variables
+  if (nlpCache_->find(minlp_, lpx, &nlpStatus_, &nlpval, nlpX_)) {
+    ++(stats_->nlpC);
+    nlpx = &(nlpX_[0]);
+  } else {
+    fixInts_(lpx);           // Fix integer variables
+    solveNLP_();
+    unfixInts_();            // Unfix integer variables
+    if (NLPCache::keeps(nlpStatus_)) {
+      nlpval = nlpe_->getSolutionValue();
+      nlpx = nlpe_->getSolution()->getPrimal();
+      nlpCache_->insert(minlp_, lpx, nlpStatus_, nlpval, nlpx);
+    }
+  }
   
   switch(nlpStatus_) {
   case (ProvenOptimal):
   case (ProvenLocalOptimal):
     ++(stats_->nlpF);
-    updateUb_(s_pool, &nlpval, sol_found);
+    updateUb_(s_pool, nlpval, nlpx, sol_found);
     if ((relobj_ >= nlpval-npATol_) ||
         (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*npRTol_))) {
         *status = SepaPrune;
         break;
     } else {
-      nlpx = nlpe_->getSolution()->getPrimal();
       oaCutToCons_(nlpx, lpx, cutMan, status);
       oaCutToObj_(nlpx, lpx, cutMan, status);
       if (prStatus_) {
@@ -232,7 +254,6 @@ void QGAdvHandler::cutIntSol_(ConstSolutionPtr sol, CutManager *cutMan,
   case (ProvenLocalInfeasible):
   case (ProvenObjectiveCutOff):
     ++(stats_->nlpI);
-    nlpx = nlpe_->getSolution()->getPrimal();
     oaCutToCons_(nlpx, lpx, cutMan, status);
     if (prStatus_) {
       pcPtr_->atIntPt(rel_, nlpx, lpx, &pcStatus, cutMan);
@@ -755,6 +776,16 @@ void QGAdvHandler::separate(ConstSolutionPtr sol, NodePtr , RelaxationPtr rel,
 }
 
 
+void QGAdvHandler::setNLPCache(NLPCachePtr cache)
+{
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
+  nlpCache_ = cache;
+  ownCache_ = false;
+}
+
+
 void QGAdvHandler::solveNLP_()
 {
   nlpStatus_ = nlpe_->solve();
@@ -776,22 +807,19 @@ void QGAdvHandler::unfixInts_()
 }
 
 
-void QGAdvHandler::updateUb_(SolutionPoolPtr s_pool, double *nlpval,
-                          bool *sol_found)
+void QGAdvHandler::updateUb_(SolutionPoolPtr s_pool, double nlpval,
+                             const double *x, bool *sol_found)
 {
-  double val = nlpe_->getSolutionValue();
   double bestval = s_pool->getBestSolutionValue();
 
-  if (val <= bestval) {
-    const double *x = nlpe_->getSolution()->getPrimal();
-    s_pool->addSolution(x, val);
+  if (nlpval <= bestval) {
+    s_pool->addSolution(x, nlpval);
     *sol_found = true;
 #if SPEW
     logger_->msgStream(LogDebug) << me_ << "new solution found, value = "
-      << val << std::endl;
+      << nlpval << std::endl;
 #endif
   }
-  *nlpval = val;
   return;
 }
 
@@ -807,6 +835,8 @@ void QGAdvHandler::writeStats(std::ostream &out) const
     << stats_->nlpF << std::endl
     << me_ << "number of nlps hit engine iterations limit     = " 
     << stats_->nlpF << std::endl
+    << me_ << "number of nlps found in cache                  = " 
+    << stats_->nlpC << std::endl
     << me_ << "number of cuts added                           = " 
     << stats_->cuts << std::endl;
   return;
@@ -51,9 +51,11 @@ QGHandler::QGHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   minlp_(minlp),
   nlCons_(0),
   nlpe_(nlpe),
+  nlpCache_(0),
   nlpStatus_(EngineUnknownStatus),
   objVar_(VariablePtr()),
   oNl_(false),
+  ownCache_(true),
   rel_(RelaxationPtr()),
   relobj_(0.0)
 {
@@ -63,6 +65,7 @@ QGHandler::QGHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   objATol_ = env_->getOptions()->findDouble("solAbs_tol")->getValue();
   objRTol_ = env_->getOptions()->findDouble("solRel_tol")->getValue();
   logger_ = env->getLogger();
+  nlpCache_ = (NLPCachePtr) new NLPCache(env_);
 
   stats_ = new QGStats();
   stats_->cuts = 0;
@@ -70,6 +73,7 @@ QGHandler::QGHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   stats_->nlpF = 0;
   stats_->nlpI = 0;
   stats_->nlpIL = 0;
+  stats_->nlpC = 0;
 }
 
 
@@ -78,6 +82,9 @@ QGHandler::~QGHandler()
   if (stats_) {
     delete stats_;
   }
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
 
   env_ = 0;
   rel_ = 0;
@@ -148,37 +155,42 @@ void QGHandler::cutIntSol_(ConstSolutionPtr sol, CutManager *cutMan,
                            SeparationStatus *status)
 {
   const double *lpx = sol->getPrimal();
+  const double *nlpx = 0;
+  double nlpval = INFINITY;
   relobj_ = (sol) ? sol->getObjValue() : -INFINITY;
 
-  fixInts_(lpx);           // Fix integer variables
-  solveNLP_();
-  unfixInts_();            // Unfix integer variables
+  if (nlpCache_->find(minlp_, lpx, &nlpStatus_, &nlpval, nlpX_)) {
+    ++(stats_->nlpC);
+    nlpx = &(nlpX_[0]);
+  } else {
+    fixInts_(lpx);           // Fix integer variables
+    solveNLP_();
+    unfixInts_();            // Unfix integer variables
+    if (NLPCache::keeps(nlpStatus_)) {
+      nlpval = nlpe_->getSolutionValue();
+      nlpx = nlpe_->getSolution()->getPrimal();
+      nlpCache_->insert(minlp_, lpx, nlpStatus_, nlpval, nlpx);
+    }
+  }
   
   switch(nlpStatus_) {
   case (ProvenOptimal):
   case (ProvenLocalOptimal):
-    {
-      ++(stats_->nlpF);
-      double nlpval = nlpe_->getSolutionValue();
-      updateUb_(s_pool, nlpval, sol_found);
-      if ((relobj_ >= nlpval-objATol_) ||
-          (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
-          *status = SepaPrune;
-      } else {
-        const double * nlpx = nlpe_->getSolution()->getPrimal();
-        cutToObj_(nlpx, lpx, cutMan, status);
-        cutToCons_(nlpx, lpx, cutMan, status);
-      }
+    ++(stats_->nlpF);
+    updateUb_(s_pool, nlpval, nlpx, sol_found);
+    if ((relobj_ >= nlpval-objATol_) ||
+        (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
+      *status = SepaPrune;
+    } else {
+      cutToObj_(nlpx, lpx, cutMan, status);
+      cutToCons_(nlpx, lpx, cutMan, status);
     }
     break;
   case (ProvenInfeasible):
   case (ProvenLocalInfeasible): 
   case (ProvenObjectiveCutOff):
-    {
-      ++(stats_->nlpI);
-      const double * nlpx = nlpe_->getSolution()->getPrimal();
-      cutToCons_(nlpx, lpx, cutMan, status);
-    }
+    ++(stats_->nlpI);
+    cutToCons_(nlpx, lpx, cutMan, status);
     break;
   case (EngineIterationLimit):
     ++(stats_->nlpIL);
@@ -643,6 +655,16 @@ void QGHandler::separate(ConstSolutionPtr sol, NodePtr, RelaxationPtr rel,
 }
 
 
+void QGHandler::setNLPCache(NLPCachePtr cache)
+{
+  if (ownCache_ && nlpCache_) {
+    delete nlpCache_;
+  }
+  nlpCache_ = cache;
+  ownCache_ = false;
+}
+
+
 void QGHandler::solveNLP_()
 {
   nlpStatus_ = nlpe_->solve();
@@ -666,13 +688,12 @@ void QGHandler::unfixInts_()
 
 
 void QGHandler::updateUb_(SolutionPoolPtr s_pool, double nlpval,
-                          bool *sol_found)
+                          const double *x, bool *sol_found)
 {
   double bestval = s_pool->getBestSolutionValue();
 
   if ((bestval - objATol_ > nlpval) ||
         (bestval != 0 && (bestval - fabs(bestval)*objRTol_ > nlpval))) {
-    const double *x = nlpe_->getSolution()->getPrimal();
     s_pool->addSolution(x, nlpval);
     *sol_found = true;
   }
@@ -691,6 +712,8 @@ void QGHandler::writeStats(std::ostream &out) const
     << stats_->nlpF << std::endl
     << me_ << "number of nlps hit engine iterations limit  = " 
     << stats_->nlpIL << std::endl
+    << me_ << "number of nlps found in cache               = " 
+    << stats_->nlpC << std::endl
     << me_ << "number of cuts added                        = " 
     << stats_->cuts << std::endl;
   return;
@@ -21,6 +21,7 @@
 #include "Engine.h"
 #include "Problem.h"
 #include "Function.h"
+#include "NLPCache.h"
 #include "Solution.h"
 
 namespace Minotaur {
@@ -30,6 +31,7 @@ struct QGStats {
   size_t nlpF;      /// Number of nlps feasible.
   size_t nlpI;      /// Number of nlps infeasible.
   size_t nlpIL;     /// Number of nlps hits engine iterations limit.
+  size_t nlpC;      /// Number of nlps whose results were found in cache.
   size_t cuts;      /// Number of cuts added to the LP.
 }; 
 
@@ -66,9 +68,15 @@ private:
   /// NLP/QP Engine used to solve the NLP/QP relaxations.
   EnginePtr nlpe_;
 
+  /// Results of NLPs solved earlier, may be shared with other handlers.
+  NLPCachePtr nlpCache_;
+
   /// Modifications done to NLP before solving it.
   std::stack<Modification *> nlpMods_;
 
+  /// Solution of an NLP found in nlpCache_.
+  DoubleVector nlpX_;
+
   /// Status of the NLP/QP engine.
   EngineStatus nlpStatus_;
 
@@ -82,6 +90,9 @@ private:
   /// Nonlinearity status of objective function. 1 if nonlinear 0 otherwise.
   bool oNl_;
 
+  /// True if nlpCache_ was created by this handler.
+  bool ownCache_;
+
   /// Pointer to relaxation of the problem.
   RelaxationPtr rel_;
 
@@ -173,6 +184,14 @@ public:
                 CutManager *cutman, SolutionPoolPtr s_pool, ModVector &p_mods,
                 ModVector &r_mods, bool *sol_found, SeparationStatus *status);
  
+  /**
+   * \brief Use a cache of NLP results that is shared with other handlers
+   * instead of a private one.
+   *
+   * \param [in] cache The cache. It is not deleted by this handler.
+   */
+  void setNLPCache(NLPCachePtr cache);
+
   /// Show statistics.
   void writeStats(std::ostream &out) const;
 
@@ -259,10 +278,11 @@ private:
   void unfixInts_();
 
   /**
-   * Update the upper bound. XXX: Needs proper integration with
-   * Minotaur's Handler design. 
+   * Update the upper bound with the NLP solution x of value nlpval. XXX:
+   * Needs proper integration with Minotaur's Handler design. 
    */
-  void updateUb_(SolutionPoolPtr s_pool, double nlpval, bool *sol_found);
+  void updateUb_(SolutionPoolPtr s_pool, double nlpval, const double *x,
+                 bool *sol_found);
 
   };
 
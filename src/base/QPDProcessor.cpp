@@ -397,8 +397,8 @@ bool QPDProcessor::presolveNode_(NodePtr node, SolutionPoolPtr s_pool)
     is_inf = (*h)->presolveNode(qp_, node, s_pool, n_mods, t_mods);
     for (ModificationConstIterator m_iter=t_mods.begin(); m_iter!=t_mods.end(); 
         ++m_iter) {
-      node->addRMod(*m_iter);
       (*m_iter)->applyToProblem(qp_);
+      node->addRMod(*m_iter);
     }
     n_mods.clear();
     t_mods.clear();
@@ -18,6 +18,9 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
 #include "Branch.h"
@@ -70,6 +73,12 @@ QuadHandler::QuadHandler(EnvPtr env, ProblemPtr problem)
   timer_ = env->getTimer();
   defaultLb_ = 1e12;
   defaultUb_ = -1e12;
+  obbtFreq_ = std::max(0, env->getOptions()->findInt("obbt_node_freq")
+                       ->getValue());
+  obbtIterLim_ = env->getOptions()->findInt("obbt_iter_limit")->getValue();
+  obbtThreads_ = std::max(1, env->getOptions()->findInt("obbt_threads")
+                          ->getValue());
+  obbtTimeLim_ = env->getOptions()->findDouble("obbt_time_limit")->getValue();
 }
 
 QuadHandler::QuadHandler(EnvPtr env, ProblemPtr problem, EnginePtr lpe)
@@ -87,6 +96,12 @@ QuadHandler::QuadHandler(EnvPtr env, ProblemPtr problem, EnginePtr lpe)
   timer_ = env->getTimer();
   defaultLb_ = 1e12;
   defaultUb_ = -1e12;
+  obbtFreq_ = std::max(0, env->getOptions()->findInt("obbt_node_freq")
+                       ->getValue());
+  obbtIterLim_ = env->getOptions()->findInt("obbt_iter_limit")->getValue();
+  obbtThreads_ = std::max(1, env->getOptions()->findInt("obbt_threads")
+                          ->getValue());
+  obbtTimeLim_ = env->getOptions()->findDouble("obbt_time_limit")->getValue();
 }
 
 QuadHandler::~QuadHandler()
@@ -101,6 +116,14 @@ QuadHandler::~QuadHandler()
   }
   x0x1Funs_.clear();
   bStats_.qvars.clear();
+  for (UInt i=0; i<lpeCopies_.size(); ++i) {
+    delete lpeCopies_[i];
+  }
+  lpeCopies_.clear();
+  if (lpe_) {
+    delete lpe_;
+    lpe_ = 0;
+  }
 }
 
 
@@ -777,6 +800,151 @@ bool QuadHandler::isFeasible(ConstSolutionPtr sol, RelaxationPtr , bool &,
 }
 
 
+bool QuadHandler::obbt_(ProblemPtr lp, const UIntVector &vars,
+                        DoubleVector &lb, DoubleVector &ub)
+{
+  std::vector<ProblemPtr> lps;
+  std::vector<EnginePtr> engines;
+  UIntVector done; // 1 if the LP of a task need not be solved.
+  int ntasks = 2*vars.size();
+  double stime = timer_->query();
+  bool is_inf = false;
+  bool stop = false;
+  EnginePtr e;
+  UInt nt;
+
+  lb.resize(vars.size());
+  ub.resize(vars.size());
+  for (UInt k=0; k<vars.size(); ++k) {
+    lb[k] = lp->getVariable(vars[k])->getLb();
+    ub[k] = lp->getVariable(vars[k])->getUb();
+  }
+  if (!lpe_ || vars.empty()) {
+    return false;
+  }
+
+  // copies of lpe_ are made once and used again in later rounds.
+  while (lpeCopies_.size()+1 < obbtThreads_) {
+    e = lpe_->emptyCopy();
+    if (!e) {
+      logger_->msgStream(LogInfo) << me_ << "engine " << lpe_->getName()
+        << " can not be copied. Solving LPs of OBBT in "
+        << lpeCopies_.size()+1 << " threads." << std::endl;
+      obbtThreads_ = lpeCopies_.size()+1;
+      break;
+    }
+    lpeCopies_.push_back(e);
+  }
+  nt = std::min(obbtThreads_, (UInt) ntasks);
+
+  // each thread has its own engine and copy of the LP. The engine keeps the
+  // basis of the last LP it solved and starts the next one from it.
+  engines.push_back(lpe_);
+  lps.push_back(lp);
+  for (UInt i=1; i<nt; ++i) {
+    engines.push_back(lpeCopies_[i-1]);
+    lps.push_back(lp->clone(env_));
+  }
+  for (UInt i=0; i<nt; ++i) {
+    engines[i]->load(lps[i]);
+    if (obbtIterLim_>0) {
+      engines[i]->setIterationLimit(obbtIterLim_);
+    }
+  }
+
+  // task 2k minimizes vars[k] and task 2k+1 maximizes it.
+  done.resize(ntasks, 0);
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nt) schedule(dynamic, 1)
+#endif
+  for (int t=0; t<ntasks; ++t) {
+#if USE_OPENMP
+    UInt i = omp_get_thread_num();
+#else
+    UInt i = 0;
+#endif
+    UInt k = t/2;
+    LinearFunctionPtr lf;
+    FunctionPtr f;
+    EngineStatus status;
+    VariablePtr v;
+    const double *x;
+    double val;
+    bool skip;
+
+#pragma omp critical (quadObbt)
+    {
+      skip = stop || 1==done[t];
+      if (false==skip && timer_->query()-stime > obbtTimeLim_) {
+        stop = true;
+        skip = true;
+      }
+      done[t] = 1;
+    }
+    if (skip) {
+      continue;
+    }
+
+    lf = (LinearFunctionPtr) new LinearFunction();
+    lf->addTerm(lps[i]->getVariable(vars[k]), (0==t%2) ? 1.0 : -1.0);
+    f = (FunctionPtr) new Function(lf);
+    lps[i]->changeObj(f, 0.0);
+    delete f;
+    status = engines[i]->solve();
+
+#pragma omp critical (quadObbt)
+    {
+      ++bStats_.nLP;
+      switch (status) {
+      case (ProvenOptimal):
+        val = engines[i]->getSolutionValue();
+        if (0==t%2) {
+          lb[k] = std::max(lb[k], val);
+        } else {
+          ub[k] = std::min(ub[k], -val);
+        }
+        // the LP of a variable can not improve its bound in lp if this
+        // solution is already at that bound.
+        x = engines[i]->getSolution()->getPrimal();
+        for (UInt j=0; j<vars.size(); ++j) {
+          v = lps[i]->getVariable(vars[j]);
+          if (0==done[2*j] && x[vars[j]] <= v->getLb()+bTol_) {
+            done[2*j] = 1;
+            ++bStats_.nLPSkip;
+          }
+          if (0==done[2*j+1] && x[vars[j]] >= v->getUb()-bTol_) {
+            done[2*j+1] = 1;
+            ++bStats_.nLPSkip;
+          }
+        }
+        break;
+      case (ProvenInfeasible):
+      case (ProvenObjectiveCutOff):
+        is_inf = true;
+        stop = true;
+        break;
+      default:
+        // the objective value of an LP that is not solved to optimality is
+        // not a valid bound.
+        break;
+      }
+    }
+  }
+
+  for (UInt i=0; i<nt; ++i) {
+    if (obbtIterLim_>0) {
+      engines[i]->resetIterationLimit();
+    }
+    engines[i]->clear();
+    if (i>0) {
+      delete lps[i];
+    }
+  }
+  bStats_.obbtTime += timer_->query()-stime;
+  return is_inf;
+}
+
+
 SolveStatus QuadHandler::presolve(PreModQ *, bool *changed)
 {
 
@@ -894,14 +1062,21 @@ SolveStatus QuadHandler::presolve(PreModQ *, bool *changed)
 }
 
 
-bool QuadHandler::presolveNode(RelaxationPtr rel, NodePtr, SolutionPoolPtr,
-                               ModVector &p_mods, ModVector &r_mods)
+bool QuadHandler::presolveNode(RelaxationPtr rel, NodePtr node,
+                               SolutionPoolPtr, ModVector &p_mods,
+                               ModVector &r_mods)
 {
   bool lchanged = true;
   bool changed = true;
   bool is_inf = false;
   double stime = timer_->query();
 
+  if (lpe_ && obbtFreq_>0 && 0==node->getDepth()%obbtFreq_) {
+    if (tightenNodeLP_(rel, p_mods, r_mods)) {
+      return true;
+    }
+  }
+
   // visit each quadratic constraint and see if bounds can be improved.
   while (true==changed) {
     ++pStats_.iters;
@@ -1165,6 +1340,9 @@ void QuadHandler::resetStats_()
   bStats_.nqubl = 0;
   bStats_.vBndl = 0;
   bStats_.nLP = 0;
+  bStats_.nLPSkip = 0;
+  bStats_.nObbt = 0;
+  bStats_.obbtTime = 0.0;
   bStats_.dlb = 0;
   bStats_.dub = 0;
 }
@@ -1408,35 +1586,6 @@ bool QuadHandler::calcVarBnd_(VariablePtr v, double a, double b, double ly,
  return false; 
 }
 
-double QuadHandler::getBndByLP_(bool &is_inf) {
-  double b;
-  EngineStatus lpStatus;
-  lpStatus = lpe_->solve();
-  ++bStats_.nLP;
-  is_inf = false;
-
-  switch(lpStatus) {
-    case (ProvenOptimal):
-    case (EngineIterationLimit):
-    case (ProvenUnbounded):
-      b = lpe_->getSolution()->getObjValue();
-      break;
-    case (ProvenInfeasible):
-    case (ProvenObjectiveCutOff):
-      b = INFINITY;
-      is_inf = true;
-      break;
-    case (EngineError):
-    case (EngineUnknownStatus):
-    default:
-      logger_->msgStream(LogError) << me_ << "LP engine status at root= "
-        << lpStatus << std::endl;
-      assert(!"In QuadHandler: stopped at root. Check error log.");
-      break;
-  }
-  return b;
-}
-
 bool QuadHandler::tightenLP_(bool *changed) {
   ConstraintPtr c;
   QuadraticFunctionPtr qf;
@@ -1446,11 +1595,14 @@ bool QuadHandler::tightenLP_(bool *changed) {
   VariablePtr v;
   std::map<VariablePtr, VariablePtr> pv_lpv;
   ProblemPtr lp;
+  UIntVector lpvars;
+  DoubleVector lbs, ubs;
   double lb, ub, clb, cub;
   bool is_inf;
   bool c1;
+  UInt i;
 
-  if (p_->getSize()->consWithLin == 0) {
+  if (!lpe_ || p_->getSize()->consWithLin == 0) {
     return false;
   }
 
@@ -1517,76 +1669,91 @@ bool QuadHandler::tightenLP_(bool *changed) {
   }
 
   if (lp->getNumCons() == 0) {
-      qvars.clear();
-      pv_lpv.clear();
-      delete lpe_;
-      delete lp;
-      if (flp) {
-        delete flp;
-      }
-      return false;
+    qvars.clear();
+    pv_lpv.clear();
+    delete lp;
+    return false;
   }
 
   flp = (FunctionPtr) new Function();
   lp->newObjective(flp, 0.0, Minimize);
-  //lp->setEngine(lpe_);
-  lpe_->load(lp);
 
   for (VariableSet::iterator vit = qvars.begin(); vit != qvars.end(); ++vit) {
-    lflp = (LinearFunctionPtr) new LinearFunction();
-    lflp->addTerm(pv_lpv[*vit], 1.0);
-    flp = (FunctionPtr) new Function(lflp);
-    lp->changeObj(flp, 0.0);
-    lb = getBndByLP_(is_inf);
-    if (is_inf) {
-      qvars.clear();
-      pv_lpv.clear();
-      delete lpe_;
-      delete lp;
-      if (flp) {
-        delete flp;
+    lpvars.push_back(pv_lpv[*vit]->getIndex());
+  }
+  is_inf = obbt_(lp, lpvars, lbs, ubs);
+  if (false==is_inf) {
+    i = 0;
+    for (VariableSet::iterator vit = qvars.begin(); vit != qvars.end();
+         ++vit, ++i) {
+      c1 = false;
+      if (updatePBounds_(*vit, lbs[i], ubs[i], &c1) < 0) {
+        is_inf = true;
+        break;
       }
-      return true;
-    }
-    (*flp) *= -1.0;
-    lp->changeObj(flp, 0.0);
-    ub = -getBndByLP_(is_inf);
-    if (is_inf) {
-      qvars.clear();
-      pv_lpv.clear();
-      delete lpe_;
-      delete lp;
-      if (flp) {
-        delete flp;
+      if (c1 == true) {
+        ++bStats_.vBndl;
+        *changed = true;
       }
-      return true;
     }
+  }
+  qvars.clear();
+  pv_lpv.clear();
+  delete lp;
+  return is_inf;
+}
+
+
+bool QuadHandler::tightenNodeLP_(RelaxationPtr rel, ModVector &p_mods,
+                                 ModVector &r_mods)
+{
+  VarSet xvars;
+  UIntVector lpvars;
+  DoubleVector lbs, ubs;
+  ProblemPtr lp;
+  bool is_inf;
+  bool c1;
+  UInt i;
+
+  for (LinSqrMapIter it=x2Funs_.begin(); it != x2Funs_.end(); ++it) {
+    xvars.insert(it->first);
+  }
+  for (LinBilSetIter it=x0x1Funs_.begin(); it != x0x1Funs_.end(); ++it) {
+    xvars.insert((*it)->getX0());
+    xvars.insert((*it)->getX1());
+  }
+  if (xvars.empty()) {
+    return false;
+  }
+  for (VarSet::iterator vit = xvars.begin(); vit != xvars.end(); ++vit) {
+    lpvars.push_back(rel->getRelaxationVar(*vit)->getIndex());
+  }
+
+  // the relaxation is loaded in the engine of branch-and-bound. Solve LPs on
+  // a copy.
+  lp = rel->clone(env_);
+  is_inf = obbt_(lp, lpvars, lbs, ubs);
+  delete lp;
+  ++bStats_.nObbt;
+  if (true==is_inf) {
+    return true;
+  }
+
+  i = 0;
+  for (VarSet::iterator vit = xvars.begin(); vit != xvars.end(); ++vit, ++i) {
     c1 = false;
-    if (updatePBounds_(*vit, lb, ub, &c1) < 0) {
-      qvars.clear();
-      pv_lpv.clear();
-      delete lpe_;
-      delete lp;
-      if (flp) {
-        delete flp;
-      }
+    if (updatePBounds_(*vit, lbs[i], ubs[i], rel, modRel_, &c1, p_mods,
+                       r_mods) < 0) {
       return true;
     }
     if (c1 == true) {
       ++bStats_.vBndl;
-      *changed = true;
     }
   }
-  qvars.clear();
-  pv_lpv.clear();
-  delete lpe_;
-  delete lp;
-  if (flp) {
-    delete flp;
-  }
   return false;
 }
 
+
 bool QuadHandler::tightenQuad_(bool *changed) {
   ConstraintPtr c;
   double implLb, implUb;
@@ -2095,6 +2262,10 @@ void QuadHandler::writeStats(std::ostream &out) const
     << me_ << "Time taken in node presolves   = "<< pStats_.timeN  << std::endl
     << me_ << "Times variables tightened      = "<< pStats_.vBnd   << std::endl
     << me_ << "Changes in nodes               = "<< pStats_.nMods  << std::endl
+    << me_ << "Nodes with LP bound tightening = "<< bStats_.nObbt  << std::endl
+    << me_ << "LPs solved in bound tightening = "<< bStats_.nLP    << std::endl
+    << me_ << "LPs skipped in LP tightening   = "<< bStats_.nLPSkip<< std::endl
+    << me_ << "Time taken in LP tightening    = "<< bStats_.obbtTime << std::endl
     ;
 
   out << me_ << "Statistics for separation by QuadHandler:"        << std::endl
@@ -2132,7 +2303,11 @@ void QuadHandler::writeBTStats_(std::ostream &out, bool flag) {
     "Number of times bound tightened by lp tightening                      = "
     << bStats_.vBndl << std::endl << me_ <<
     "Number of LPs solved                                                  = "
-    << bStats_.nLP << std::endl;
+    << bStats_.nLP << std::endl << me_ <<
+    "Number of LPs skipped because a solution was at the bound             = "
+    << bStats_.nLPSkip << std::endl << me_ <<
+    "Time taken in solving LPs                                             = "
+    << bStats_.obbtTime << std::endl;
   } else {
     out << me_ << "Statistics for Bound Tightening:" << std::endl
         << me_ << "Number of variables for which default lb was added = "
@@ -103,6 +103,14 @@ public:
   void relaxNodeInc(NodePtr node, RelaxationPtr rel, bool *is_inf);
 
 
+  /**
+   * \brief Set the LP engine used for optimization-based bound tightening
+   * at the nodes. The handler deletes the engine when it is destroyed.
+   * \param[in] lpe The LP engine. It is copied for other threads if
+   * option obbt_threads is larger than one.
+   */
+  void setLPEngine(EnginePtr lpe);
+
   // base class method. Adds linearlization cuts when available.
   void separate(ConstSolutionPtr sol, NodePtr node, RelaxationPtr rel, 
                 CutManager *cutman, SolutionPoolPtr s_pool, ModVector &p_mods,
@@ -155,6 +163,10 @@ private:
     int vBndl;         ///> Number of times bounds tightened by
                        ///> lp tightening
     int nLP;           ///> Number of LP solved
+    int nLPSkip;       ///> Number of LPs not solved because an earlier LP
+                       ///> solution was already at the bound
+    int nObbt;         ///> Number of nodes at which OBBT was done
+    double obbtTime;   ///> Time spent in solving LPs for OBBT
     int dlb;           ///> Number of variables for which default lb was added
     int dub;           ///> Number of variables for which default ub was added
   };
@@ -183,6 +195,9 @@ private:
 
   /// LP engine
   EnginePtr lpe_;
+
+  /// Copies of lpe_ used by the other threads in OBBT.
+  std::vector<EnginePtr> lpeCopies_;
       
   /// For printing messages.
   static const std::string me_;
@@ -190,6 +205,18 @@ private:
   /// Transformed problem (not the relaxation).
   ProblemPtr p_;
 
+  /// Do OBBT at nodes whose depth is a multiple of this. 0 for never.
+  UInt obbtFreq_;
+
+  /// Limit on the simplex iterations in each LP of OBBT. 0 for no limit.
+  int obbtIterLim_;
+
+  /// Number of threads used to solve LPs in OBBT.
+  UInt obbtThreads_;
+
+  /// Limit on the time in seconds of each round of OBBT.
+  double obbtTimeLim_;
+
   /// Statistics about presolve
   PresolveStats pStats_;
 
@@ -292,14 +319,6 @@ private:
    */
   void findLinPt_(double xval, double yval, double &xl, double &yl);
 
-  /**
-   * \brief Solve the lp and get the bounds of the variable.
-   * Called by tightenLP_.
-   * \param[in] e The engine where lp is loaded
-   * \param[out] is_inf True if the lp is infeasible.
-   */
-  double getBndByLP_(bool &is_inf);
-
   /**
    * \brief Get one of the four linear functions and right hand sides for the
    * linear relaxation of a bilinear constraint y = x0x1.
@@ -368,6 +387,24 @@ private:
   /// Return true if xval is one of the bounds of variable x
   bool isAtBnds_(ConstVariablePtr x, double xval);
 
+  /**
+   * \brief Minimize and maximize variables over an LP. The LPs are spread
+   * over lpe_ and its copies, one thread for each engine. Each engine starts
+   * from the basis of the last LP it solved. An LP is not solved if the
+   * solution of an earlier LP is already at the bound that it would find.
+   * No more LPs are started after obbtTimeLim_ seconds.
+   * \param[in] lp The LP. Its objective is changed. lp is not loaded in any
+   * engine when this function returns.
+   * \param[in] vars Indices of the variables of lp that are to be minimized
+   * and maximized.
+   * \param[out] lb The lower bounds found for the variables in vars. It is
+   * the bound in lp if the LP is not solved.
+   * \param[out] ub The upper bounds found for the variables in vars.
+   * \return True if the LP is found to be infeasible, false otherwise.
+   */
+  bool obbt_(ProblemPtr lp, const UIntVector &vars, DoubleVector &lb,
+             DoubleVector &ub);
+
   /**
    * \brief Strengthen bounds of variables in a bilinear constraint y=x0x1
    * \param[in] lx0x1 The bilinear term
@@ -446,6 +483,17 @@ private:
    */
   bool tightenLP_(bool *changed);
 
+  /**
+   * \brief Bound tightening at a node by minimizing and maximizing the x
+   * variables of all square and bilinear terms over the relaxation.
+   * \param[in] rel The relaxation at the node.
+   * \param[in] p_mods A vector to save the modifications to the problem 
+   * \param[in] r_mods A vector to save the modifications to the relaxation 
+   * \return True if the node is found to be infeasible, false otherwise.
+   */
+  bool tightenNodeLP_(RelaxationPtr rel, ModVector &p_mods,
+                      ModVector &r_mods);
+
   /**
    * \brief Bound tightening of the problem by considering linear and quadratic
    * terms simultaneously. Returns true if the problem is found to be
@@ -31,9 +31,22 @@
 
 using namespace Minotaur;
 
+const double QuadraticFunction::denseTol_ = 0.3;
+const UInt QuadraticFunction::maxDense_ = 1024;
+
+#ifdef F77_FUNC
+extern "C"
+{
+  void F77_FUNC(dsymv, DSYMV)(char *uplo, int *n, double *alpha, double *a,
+                              int *lda, const double *x, int *incx,
+                              double *beta, double *y, int *incy);
+}
+#endif
+
 
 QuadraticFunction::QuadraticFunction() 
   : etol_(1e-8),
+    flatOk_(false),
     hCoeffs_(0),
     hFirst_(0),
     hOff_(0),
@@ -48,6 +61,7 @@ QuadraticFunction::QuadraticFunction()
 QuadraticFunction::QuadraticFunction(UInt nz, double *vals, UInt *irow,
                                      UInt *jcol, VariableConstIterator vbeg)
 : etol_(1e-8),
+  flatOk_(false),
   hCoeffs_(0),
   hFirst_(0),
   hOff_(0),
@@ -72,6 +86,7 @@ QuadraticFunction::QuadraticFunction(UInt nz, double *vals, UInt *irow,
 QuadraticFunction::QuadraticFunction(double* vals, VariableConstIterator vbeg,
                                     VariableConstIterator vend)
 : etol_(1e-8),
+  flatOk_(false),
   hCoeffs_(0),
   hFirst_(0),
   hOff_(0),
@@ -134,6 +149,9 @@ QuadraticFunctionPtr QuadraticFunction::cloneWithVars(VariableConstIterator vbeg
 
 double QuadraticFunction::eval(const std::vector<double> &x) const
 {
+   if (flatOk_) {
+     return eval(x.empty() ? 0 : &x[0]);
+   }
    double sum = 0.0;
    for(VariablePairGroupConstIterator it = begin(); it != end(); ++it) {
       sum += it->second * x[it->first.first->getIndex()] * 
@@ -146,6 +164,22 @@ double QuadraticFunction::eval(const std::vector<double> &x) const
 double QuadraticFunction::eval(const double *x) const
 {
    double sum = 0.0;
+   if (flatOk_) {
+     const UInt nv = fVars_.size();
+     double sbuf[64];
+     DoubleVector hbuf;
+     double *xl = sbuf;
+
+     if (2*nv > 64) {
+       hbuf.resize(2*nv);
+       xl = &hbuf[0];
+     }
+     multFlat_(x, xl, xl+nv);
+     for (UInt i=0; i<nv; ++i) {
+       sum += xl[i]*xl[nv+i];
+     }
+     return 0.5*sum;
+   }
    for(VariablePairGroupConstIterator it = begin(); it != end(); ++it) {
       sum += it->second * x[it->first.first->getIndex()] * 
         x[it->first.second->getIndex()];
@@ -153,6 +187,45 @@ double QuadraticFunction::eval(const double *x) const
    return sum;
 }
 
+void QuadraticFunction::evalBatch(UInt k, UInt n, const double *x,
+                                  double *f) const
+{
+  const UInt nt = terms_.size();
+  UIntVector ind1(nt), ind2(nt);
+  DoubleVector coef(nt);
+  UInt t = 0;
+  double sum;
+
+  if (flatOk_) {
+    const UInt nv = fVars_.size();
+    DoubleVector buf(2*nv+1);
+    for (UInt p=0; p<k; ++p, x+=n) {
+      multFlat_(x, &buf[0], &buf[nv]);
+      sum = 0.0;
+      for (t=0; t<nv; ++t) {
+        sum += buf[t]*buf[nv+t];
+      }
+      f[p] = 0.5*sum;
+    }
+    return;
+  }
+
+  // copy the terms into flat arrays once, then sweep them for each point.
+  for (VariablePairGroupConstIterator it = begin(); it != end(); ++it, ++t) {
+    ind1[t] = it->first.first->getIndex();
+    ind2[t] = it->first.second->getIndex();
+    coef[t] = it->second;
+  }
+  for (UInt p=0; p<k; ++p, x+=n) {
+    sum = 0.0;
+    for (t=0; t<nt; ++t) {
+      sum += coef[t] * x[ind1[t]] * x[ind2[t]];
+    }
+    f[p] = sum;
+  }
+}
+
+
 void QuadraticFunction::computeBounds(double *l, double *u){
   double a;
   double b;
@@ -299,7 +372,21 @@ void QuadraticFunction::bndsquadterms_2(double *l, double *u, VariablePtr v, Var
 void QuadraticFunction::evalGradient(const double *x, double *grad_f)
 {
   assert (grad_f);
-  if (x) {
+  if (x && flatOk_) {
+    const UInt nv = fVars_.size();
+    double sbuf[64];
+    DoubleVector hbuf;
+    double *xl = sbuf;
+
+    if (2*nv > 64) {
+      hbuf.resize(2*nv);
+      xl = &hbuf[0];
+    }
+    multFlat_(x, xl, xl+nv);
+    for (UInt i=0; i<nv; ++i) {
+      grad_f[fVars_[i]->getIndex()] += xl[nv+i];
+    }
+  } else if (x) {
     for(VariablePairGroupConstIterator it = terms_.begin(); it != terms_.end(); ++it) {
       grad_f[it->first.first->getIndex()] +=  it->second * 
         x[it->first.second->getIndex()];
@@ -312,6 +399,10 @@ void QuadraticFunction::evalGradient(const double *x, double *grad_f)
 void QuadraticFunction::evalGradient(const std::vector<double> & x, 
     std::vector<double> & grad_f)
 {
+  if (flatOk_) {
+    evalGradient(x.empty() ? 0 : &x[0], grad_f.empty() ? 0 : &grad_f[0]);
+    return;
+  }
   for(VariablePairGroupConstIterator it = terms_.begin(); it != terms_.end(); ++it) {
     grad_f[it->first.first->getIndex()] +=  it->second * 
       x[it->first.second->getIndex()];
@@ -320,6 +411,144 @@ void QuadraticFunction::evalGradient(const std::vector<double> & x,
   }
 }
 
+void QuadraticFunction::evalGradientBatch(UInt k, UInt n, const double *x,
+                                          double *grad_f) const
+{
+  const UInt nt = terms_.size();
+  UIntVector ind1(nt), ind2(nt);
+  DoubleVector coef(nt);
+  UInt t = 0;
+
+  if (flatOk_) {
+    const UInt nv = fVars_.size();
+    DoubleVector buf(2*nv+1);
+    for (UInt p=0; p<k; ++p, x+=n, grad_f+=n) {
+      multFlat_(x, &buf[0], &buf[nv]);
+      for (t=0; t<nv; ++t) {
+        grad_f[fVars_[t]->getIndex()] += buf[nv+t];
+      }
+    }
+    return;
+  }
+
+  for (VariablePairGroupConstIterator it = begin(); it != end(); ++it, ++t) {
+    ind1[t] = it->first.first->getIndex();
+    ind2[t] = it->first.second->getIndex();
+    coef[t] = it->second;
+  }
+  for (UInt p=0; p<k; ++p, x+=n, grad_f+=n) {
+    for (t=0; t<nt; ++t) {
+      grad_f[ind1[t]] += coef[t] * x[ind2[t]];
+      grad_f[ind2[t]] += coef[t] * x[ind1[t]];
+    }
+  }
+}
+
+
+void QuadraticFunction::flatten()
+{
+  const UInt nv = varFreq_.size();
+  std::vector<std::pair<UInt, ConstVariablePtr> > order;
+  std::map<ConstVariablePtr, UInt> pos;
+  std::vector<std::vector<std::pair<UInt, double> > > rows;
+  UInt i, j;
+  double a;
+
+  if (flatOk_) {
+    return;
+  }
+  order.reserve(nv);
+  for (VarIntMapConstIterator it=varFreq_.begin(); it!=varFreq_.end();
+       ++it) {
+    order.push_back(std::make_pair(it->first->getIndex(), it->first));
+  }
+  std::sort(order.begin(), order.end());
+  fVars_.resize(nv);
+  for (i=0; i<nv; ++i) {
+    fVars_[i] = order[i].second;
+    pos[order[i].second] = i;
+  }
+
+  // M has a_ij in (i,j) and (j,i) for a term a_ij x_i x_j, and 2a_ii on the
+  // diagonal for a_ii x_i^2.
+  rows.resize(nv);
+  for (VariablePairGroupConstIterator it=terms_.begin(); it!=terms_.end();
+       ++it) {
+    i = pos[it->first.first];
+    j = pos[it->first.second];
+    a = it->second;
+    if (i==j) {
+      rows[i].push_back(std::make_pair(i, 2.0*a));
+    } else {
+      rows[i].push_back(std::make_pair(j, a));
+      rows[j].push_back(std::make_pair(i, a));
+    }
+  }
+
+  fDense_.clear();
+  fStart_.clear();
+  fInd_.clear();
+  fVal_.clear();
+  if (nv <= maxDense_ && 2*terms_.size() > denseTol_*nv*nv) {
+    fDense_.assign(nv*nv, 0.0);
+    for (i=0; i<nv; ++i) {
+      for (j=0; j<rows[i].size(); ++j) {
+        fDense_[i*nv+rows[i][j].first] = rows[i][j].second;
+      }
+    }
+  } else {
+    fStart_.reserve(nv+1);
+    fStart_.push_back(0);
+    for (i=0; i<nv; ++i) {
+      std::sort(rows[i].begin(), rows[i].end());
+      for (j=0; j<rows[i].size(); ++j) {
+        fInd_.push_back(rows[i][j].first);
+        fVal_.push_back(rows[i][j].second);
+      }
+      fStart_.push_back(fInd_.size());
+    }
+  }
+  flatOk_ = true;
+}
+
+
+void QuadraticFunction::multFlat_(const double *x, double *xl, double *y)
+  const
+{
+  const UInt nv = fVars_.size();
+
+  for (UInt i=0; i<nv; ++i) {
+    xl[i] = x[fVars_[i]->getIndex()];
+  }
+  if (!fDense_.empty()) {
+    char uplo = 'L';
+    int n = nv;
+    int inc = 1;
+    double alpha = 1.0;
+    double beta = 0.0;
+    // dsymv does not change a.
+    F77_FUNC(dsymv, DSYMV)(&uplo, &n, &alpha,
+                           const_cast<double *>(&fDense_[0]), &n, xl, &inc,
+                           &beta, y, &inc);
+  } else {
+    const UInt *start = &fStart_[0];
+    const UInt *ind = fInd_.empty() ? 0 : &fInd_[0];
+    const double *val = fVal_.empty() ? 0 : &fVal_[0];
+    for (UInt i=0; i<nv; ++i) {
+      const UInt end = start[i+1];
+      double s = 0.0;
+#if USE_OPENMP
+#pragma omp simd reduction(+:s)
+#endif
+      for (UInt k=start[i]; k<end; ++k) {
+        s += val[k]*xl[ind[k]];
+      }
+      y[i] = s;
+    }
+  }
+}
+
+
 QfVector QuadraticFunction::findSubgraphs()
 {
   QfVector qf_vector;
@@ -486,6 +715,16 @@ void QuadraticFunction::finalHessStor(const LTHessStor *stor)
 }
 
 
+bool QuadraticFunction::getHessOffs(UIntVector *offs) const
+{
+  if (!hOff_ && terms_.size()>0) {
+    return false;
+  }
+  offs->insert(offs->end(), hOff_, hOff_+terms_.size());
+  return true;
+}
+
+
 void QuadraticFunction::fillJac(const double *x, double *values, int *) 
 {
   UInt i=0;
@@ -513,6 +752,7 @@ void QuadraticFunction::addTerm(VariablePair vp, const double weight)
 {
   assert (vp.first->getId() <= vp.second->getId());
   if (fabs(weight) >= etol_) {
+    flatOk_ = false;
     terms_.insert(std::make_pair(vp, weight));
     varFreq_[vp.first] += 1;
     varFreq_[vp.second] += 1;
@@ -532,6 +772,7 @@ void QuadraticFunction::addTerm(ConstVariablePtr v1, ConstVariablePtr v2,
 void QuadraticFunction::incTerm(ConstVariablePair vp, const double a)
 {
   if (fabs(a) > etol_) {
+    flatOk_ = false;
     VariablePairGroupIterator it = terms_.find(vp);
     if (it == terms_.end()) {
       varFreq_[vp.first] += 1;
@@ -620,6 +861,7 @@ bool QuadraticFunction::hasVar(ConstVariablePtr v) const
 void QuadraticFunction::removeVar(VariablePtr v, double val, 
     LinearFunctionPtr lf) 
 {
+  flatOk_ = false;
   for (VariablePairGroupIterator it = terms_.begin(); it != terms_.end();) {
     if (it->first.first == v && it->first.first == it->first.second) {
       terms_.erase(it++);
@@ -762,6 +1004,7 @@ void QuadraticFunction::prepJac(VarSetConstIter vbeg, VarSetConstIter vend)
     jacInd_[i] = it->first.first->getIndex();
     ++i;
   }
+  flatten();
 }
 
 
@@ -829,6 +1072,7 @@ void QuadraticFunction::prepHess()
   hSecond_ = second;
   hCoeffs_ = coeffs;
   hOff_    = new UInt[nterms];
+  flatten();
 }
 
 
@@ -896,6 +1140,8 @@ void QuadraticFunction::subst(VariablePtr out, VariablePtr in, double rat)
   std::pair <VariablePair, double> vpg;
   std::map<ConstVariablePtr, UInt>::iterator vit;
 
+  flatOk_ = false;
+
   vit = varFreq_.find(out);
   if (vit==varFreq_.end()) {
     return;
@@ -974,6 +1220,7 @@ void QuadraticFunction::add(ConstQuadraticFunctionPtr q2)
 
 
 void QuadraticFunction::multiply(const double c) {
+  flatOk_ = false;
   if (fabs(c) < 1e-7) {
     terms_.clear();
     varFreq_.clear();
@@ -200,6 +200,12 @@ namespace Minotaur {
        */
       double eval(const double *x) const;
 
+      /**
+       * Evaluate the quadratic expression at k points. Point p starts at
+       * x+p*n, and f[p] is set to its value.
+       */
+      void evalBatch(UInt k, UInt n, const double *x, double *f) const;
+
 
 
 
@@ -244,6 +250,14 @@ namespace Minotaur {
        */
       void evalGradient(const std::vector<double> &x,
                         std::vector<double> &grad_f); 
+
+      /**
+       * Evaluate the gradient of the quadratic expression at k points. Point
+       * p starts at x+p*n, and its gradient is added to grad_f+p*n.
+       */
+      void evalGradientBatch(UInt k, UInt n, const double *x,
+                             double *grad_f) const;
+
       void evalHessian(const double mult, const double *x, 
                        const LTHessStor *stor, double *values , int *error);
       
@@ -263,6 +277,17 @@ namespace Minotaur {
        */
       QfVector findSubgraphs();
 
+      /**
+       * \brief Copy the terms into a symmetric sparse matrix M over the
+       * variables of the function, such that the function is x'Mx/2.
+       *
+       * eval(), evalGradient() and the batch versions then compute Mx once
+       * and do not visit the map of terms, until the function is changed.
+       * If M is dense enough, it is stored as a dense matrix and multiplied
+       * by BLAS. Called by prepJac() and prepHess().
+       */
+      void flatten();
+
       void prepJac(VarSetConstIter vbeg, VarSetConstIter vend);
       void prepHess();
 
@@ -270,6 +295,13 @@ namespace Minotaur {
       void fillJac(const double *x, double *values, int *error);
       void finalHessStor(const LTHessStor *hess);
 
+      /**
+       * Append to offs the positions in the Hessian values array to which
+       * evalHessian() adds, one for each term. Valid only after
+       * finalHessStor(). Return false if the positions are not known yet.
+       */
+      bool getHessOffs(UIntVector *offs) const;
+
       /// Get the number of terms in this expression
       UInt getNumTerms() const;
 
@@ -300,6 +332,33 @@ namespace Minotaur {
       /// Tolerance below which a coefficient is deemed zero
       const double etol_;
 
+      /**
+       * If M has more than this fraction of nonzeros, it is stored as a
+       * dense matrix.
+       */
+      static const double denseTol_;
+
+      /// M of flatten() as a dense column-major matrix, or empty.
+      DoubleVector fDense_;
+
+      /// Column of each nonzero of M. Columns are positions in fVars_.
+      UIntVector fInd_;
+
+      /// Start of each row of M in fInd_ and fVal_, and the end of the last.
+      UIntVector fStart_;
+
+      /// Nonzeros of M, row after row.
+      DoubleVector fVal_;
+
+      /// Variables of the rows and columns of M, sorted by index.
+      std::vector<ConstVariablePtr> fVars_;
+
+      /// True if M has the same terms as terms_.
+      bool flatOk_;
+
+      /// Largest number of variables for which M may be stored as dense.
+      static const UInt maxDense_;
+
       double *hCoeffs_;
       UInt *hFirst_;
       UInt *hOff_;
@@ -324,6 +383,15 @@ namespace Minotaur {
 
       Convexity convex_;
 
+      /**
+       * \brief Find y = Mx for the matrix M of flatten().
+       *
+       * \param [in] x Values of all variables of the problem.
+       * \param [out] xl Values of fVars_, gathered from x.
+       * \param [out] y The product, one entry for each of fVars_.
+       */
+      void multFlat_(const double *x, double *xl, double *y) const;
+
       void sortLT_(UInt n, UInt *f, UInt *s, double *c);
   };
 
@@ -31,6 +31,7 @@
 #include "ReliabilityBrancher.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StrBrPool.h"
 #include "Timer.h"
 #include "Variable.h"
 
@@ -49,6 +50,7 @@ ReliabilityBrancher::ReliabilityBrancher(EnvPtr env, HandlerVector & handlers)
   maxIterations_(25),
   maxStrongCands_(20),
   minNodeDist_(50),
+  pool_(0),
   rel_(RelaxationPtr()),            // NULL
   status_(NotModifiedByBrancher),
   thresh_(4),
@@ -64,6 +66,7 @@ ReliabilityBrancher::ReliabilityBrancher(EnvPtr env, HandlerVector & handlers)
   stats_->bndChange = 0;
   stats_->iters = 0;
   stats_->strTime = 0.0;
+  pool_ = StrBrPool::create(env);
 }
 
 
@@ -71,6 +74,9 @@ ReliabilityBrancher::~ReliabilityBrancher()
 {
   delete stats_;
   delete timer_;
+  if (pool_) {
+    delete pool_;
+  }
 }
 
 
@@ -79,7 +85,7 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
 {
   double best_score = -INFINITY;
   double score, change_up, change_down, maxchange;
-  UInt cnt, maxcnt;
+  UInt cnt, maxcnt, batch = 0;
   EngineStatus status_up, status_down;
   BrCandPtr cand, best_cand = 0;
 
@@ -105,10 +111,26 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
     engine_->setIterationLimit(maxIterations_); // TODO: make limit dynamic.
     cnt = 0;
     maxcnt = (node->getDepth()>maxDepth_) ? 0 : maxStrongCands_;
+    if (pool_ && maxcnt>0 && pool_->setup(rel_, engine_, maxIterations_)) {
+      // solve as many candidates at a time as there are threads. Results
+      // are used in the same order as below, so that the choice does not
+      // depend on which thread finished first.
+      batch = pool_->getNumThreads();
+    }
     for (it=unrelCands_.begin(); it!=unrelCands_.end() && 
         cnt < maxcnt; ++it, ++cnt) {
       cand = *it;
-      strongBranch_(cand, change_up, change_down, status_up, status_down);
+      if (batch>0) {
+        timer_->start();
+        stats_->strBrCalls += pool_->strongBranch(it, unrelCands_.end(), cnt,
+                                                  maxcnt, x_, change_down,
+                                                  change_up, status_down,
+                                                  status_up);
+        stats_->strTime += timer_->query();
+        timer_->stop();
+      } else {
+        strongBranch_(cand, change_up, change_down, status_up, status_down);
+      }
       change_up    = std::max(change_up - objval, 0.0);
       change_down  = std::max(change_down - objval, 0.0);
       useStrongBranchInfo_(cand, maxchange, change_up, change_down, 
@@ -133,6 +155,9 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
     }
     engine_->resetIterationLimit(); 
     engine_->disableStrBrSetup();
+    if (batch>0) {
+      pool_->finish();
+    }
     if (NotModifiedByBrancher == status_) {
       // get score of remaining unreliable candidates as well.
       for (;it!=unrelCands_.end(); ++it) {
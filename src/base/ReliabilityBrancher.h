@@ -19,8 +19,10 @@
 namespace Minotaur {
 
 class Engine;
+class StrBrPool;
 class Timer;
 typedef Engine* EnginePtr;
+typedef StrBrPool* StrBrPoolPtr;
 
 struct RelBrStats {
   UInt bndChange;  /// Number of times variable bounds were changed.
@@ -294,6 +296,12 @@ private:
   /// Modifications that can be applied to the problem.
   ModVector mods_;
 
+  /**
+   * \brief Engines that solve the problems of strong branching in parallel.
+   * NULL if option strbr_threads is less than two.
+   */
+  StrBrPoolPtr pool_;
+
   /// Vector of pseudocosts for rounding down.
   DoubleVector pseudoDown_;
 
@@ -0,0 +1,221 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2017 The MINOTAUR Team.
+// 
+
+/**
+ * \file SpillFile.cpp
+ * \brief Define class SpillFile for keeping information about active nodes
+ * on disk.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "MinotaurConfig.h"
+#include "SpillFile.h"
+
+using namespace Minotaur;
+
+// size of the header of each record, which keeps the size of the record.
+const size_t SPILL_HEAD = sizeof(size_t);
+
+// size class of the smallest records, whose space is 2^SPILL_MINBUCKET
+// bytes.
+const UInt SPILL_MINBUCKET = 5;
+
+// the file grows by at least this much.
+const size_t SPILL_CHUNK = 1<<20;
+
+
+SpillFile::SpillFile(std::string dir)
+  : cap_(0),
+    dir_(dir),
+    end_(0),
+    fd_(-1),
+    failed_(false),
+    free_(),
+    live_(0),
+    liveRecs_(0),
+    mem_(0)
+{
+}
+
+
+SpillFile::~SpillFile()
+{
+  if (mem_) {
+    munmap(mem_, cap_);
+    mem_ = 0;
+  }
+  if (fd_>=0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+
+size_t SpillFile::getBytes() const
+{
+  size_t bytes;
+#if USE_OPENMP
+#pragma omp critical (spillFile)
+#endif
+  bytes = live_;
+  return bytes;
+}
+
+
+UInt SpillFile::bucket_(size_t n) const
+{
+  UInt k = SPILL_MINBUCKET;
+
+  while (((size_t) 1 << k) < SPILL_HEAD+n) {
+    ++k;
+  }
+  return k;
+}
+
+
+bool SpillFile::grow_(size_t n)
+{
+  size_t cap = cap_;
+  void *mem;
+
+  if (n<=cap_) {
+    return true;
+  }
+  while (cap<n) {
+    cap = (cap<SPILL_CHUNK) ? SPILL_CHUNK : 2*cap;
+  }
+  if (0!=ftruncate(fd_, (off_t) cap)) {
+    return false;
+  }
+  mem = mmap(0, cap, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (MAP_FAILED==mem) {
+    return false;
+  }
+  if (mem_) {
+    munmap(mem_, cap_);
+  }
+  mem_ = (char *) mem;
+  cap_ = cap;
+  return true;
+}
+
+
+bool SpillFile::open_()
+{
+  std::string name = dir_ + "/minotaur-spill-XXXXXX";
+  std::vector<char> tmpl(name.begin(), name.end());
+
+  tmpl.push_back('\0');
+  fd_ = mkstemp(&tmpl[0]);
+  if (fd_<0) {
+    std::cerr << "cannot create file in " << dir_
+              << " for storing active nodes." << std::endl;
+    failed_ = true;
+    return false;
+  }
+  // the file is not needed once the process ends.
+  unlink(&tmpl[0]);
+  return true;
+}
+
+
+void SpillFile::read(size_t at, std::vector<char> &buf)
+{
+#if USE_OPENMP
+#pragma omp critical (spillFile)
+#endif
+  {
+    size_t n;
+
+    memcpy(&n, mem_+at, SPILL_HEAD);
+    buf.resize(n);
+    if (n>0) {
+      memcpy(&buf[0], mem_+at+SPILL_HEAD, n);
+    }
+  }
+}
+
+
+void SpillFile::release(size_t at)
+{
+#if USE_OPENMP
+#pragma omp critical (spillFile)
+#endif
+  {
+    size_t n;
+    UInt k;
+
+    memcpy(&n, mem_+at, SPILL_HEAD);
+    k = bucket_(n);
+    live_ -= n;
+    --liveRecs_;
+    if (0==liveRecs_) {
+      end_ = 0;
+      free_.clear();
+    } else if (at+((size_t) 1 << k)==end_) {
+      end_ = at;
+    } else {
+      if (free_.size()<=k) {
+        free_.resize(k+1);
+      }
+      free_[k].push_back(at);
+    }
+  }
+}
+
+
+bool SpillFile::write(const char *buf, size_t n, size_t *at)
+{
+  bool ok = false;
+
+#if USE_OPENMP
+#pragma omp critical (spillFile)
+#endif
+  {
+    UInt k = bucket_(n);
+    size_t len = (size_t) 1 << k;
+
+    if (fd_<0 && false==failed_) {
+      open_();
+    }
+    if (k<free_.size() && !free_[k].empty()) {
+      *at = free_[k].back();
+      free_[k].pop_back();
+      ok = true;
+    } else if (fd_>=0 && grow_(end_+len)) {
+      *at = end_;
+      end_ += len;
+      ok = true;
+    }
+    if (ok) {
+      memcpy(mem_+*at, &n, SPILL_HEAD);
+      if (n>0) {
+        memcpy(mem_+*at+SPILL_HEAD, buf, n);
+      }
+      live_ += n;
+      ++liveRecs_;
+    }
+  }
+  return ok;
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,138 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2017 The MINOTAUR Team.
+// 
+
+/**
+ * \file SpillFile.h
+ * \brief Declare class SpillFile for keeping information about active nodes
+ * on disk.
+ */
+
+
+#ifndef MINOTAURSPILLFILE_H
+#define MINOTAURSPILLFILE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  /**
+   * \brief A temporary file, mapped to memory, into which the tree manager
+   * moves information about active nodes that will not be processed soon.
+   *
+   * The space of each record is rounded up to a power of two. When a
+   * record is released, its space is kept in a free list of its size, and a
+   * later record of the same size is written there instead of being
+   * appended to the file. If it was the last record, the file is shortened
+   * instead, and when no records are left, the file is filled again from
+   * the start. The pages of the file are written back by the operating
+   * system, so that they do not stay in memory.
+   *
+   * The file is removed from the directory as soon as it is created. It is
+   * only valid while this object exists, and records may contain pointers
+   * to objects of this process. All functions may be called by several
+   * threads at once.
+   */
+  class SpillFile {
+
+  public:
+    /**
+     * \brief Constructor. The file is created when the first record is
+     * written.
+     *
+     * \param[in] dir The directory in which the file is created.
+     */
+    SpillFile(std::string dir);
+
+    /// Destroy. Unmap and close the file.
+    ~SpillFile();
+
+    /// Return the number of bytes in records that are not released yet.
+    size_t getBytes() const;
+
+    /**
+     * \brief Copy a record to a buffer.
+     *
+     * \param[in] at The position returned by write().
+     * \param[out] buf The buffer. It is resized to the size of the record.
+     */
+    void read(size_t at, std::vector<char> &buf);
+
+    /**
+     * \brief Give back the space of a record. It must not be read after
+     * this.
+     *
+     * \param[in] at The position returned by write().
+     */
+    void release(size_t at);
+
+    /**
+     * \brief Append a record to the file.
+     *
+     * \param[in] buf The bytes to be written.
+     * \param[in] n Number of bytes.
+     * \param[out] at The position of the record, used to read or release it.
+     * \return False if the file could not be created or enlarged. Nothing is
+     * written then.
+     */
+    bool write(const char *buf, size_t n, size_t *at);
+
+  private:
+    /// Size of the file, and of the mapped memory.
+    size_t cap_;
+
+    /// The directory in which the file is created.
+    std::string dir_;
+
+    /// Position at which the next record is written.
+    size_t end_;
+
+    /// Descriptor of the file. -1 if it is not open.
+    int fd_;
+
+    /// True if the file could not be created, and no further attempt is made.
+    bool failed_;
+
+    /**
+     * Positions of released records that are not at the end of the file.
+     * free_[k] has the records whose space is 2^k bytes.
+     */
+    std::vector<std::vector<size_t> > free_;
+
+    /// Number of bytes in records that are not released yet.
+    size_t live_;
+
+    /// Number of records that are not released yet.
+    UInt liveRecs_;
+
+    /// Start of the mapped memory.
+    char *mem_;
+
+    /// Return the size class of a record of n bytes: its space is 2^k bytes.
+    UInt bucket_(size_t n) const;
+
+    /// Make the file and the mapped memory at least n bytes long.
+    bool grow_(size_t n);
+
+    /// Create and map the file.
+    bool open_();
+  };
+  typedef SpillFile* SpillFilePtr;
+}
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
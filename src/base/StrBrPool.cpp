@@ -0,0 +1,377 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file StrBrPool.cpp
+ * \brief Define class StrBrPool for solving strong-branching problems in
+ * parallel.
+ */
+
+#include <iostream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "MinotaurConfig.h"
+#include "BrCand.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "Handler.h"
+#include "LinearFunction.h"
+#include "Logger.h"
+#include "Modification.h"
+#include "Objective.h"
+#include "Option.h"
+#include "Relaxation.h"
+#include "StrBrPool.h"
+#include "Variable.h"
+#include "WarmStart.h"
+
+using namespace Minotaur;
+
+const std::string StrBrPool::me_ = "strong branching pool: ";
+
+StrBrPool::StrBrPool(EnvPtr env, UInt n)
+  : borrowDer_(false),
+    engine_(0),
+    env_(env),
+    failed_(false),
+    n_(n),
+    rel_(0),
+    srcObj_(0),
+    ws_(0)
+{
+}
+
+
+StrBrPool::~StrBrPool()
+{
+  clearRels_();
+  for (UInt i=0; i<engines_.size(); ++i) {
+    delete engines_[i];
+  }
+  engines_.clear();
+}
+
+
+void StrBrPool::clearRels_()
+{
+  for (UInt i=0; i<rels_.size(); ++i) {
+    engines_[i]->clear();
+    if (borrowDer_) {
+      // derivatives belong to rel_, do not let the copy delete them.
+      rels_[i]->setJacobian(0);
+      rels_[i]->setHessian(0);
+    }
+    delete rels_[i];
+  }
+  rels_.clear();
+  srcCons_.clear();
+  srcNlfs_.clear();
+  srcQfs_.clear();
+  srcVars_.clear();
+  srcObj_ = 0;
+  if (ws_) {
+    delete ws_;
+    ws_ = 0;
+  }
+  rel_ = 0;
+}
+
+
+void StrBrPool::copyRels_(RelaxationPtr rel)
+{
+  OptionDBPtr options = env_->getOptions();
+  ConstraintPtr c;
+  FunctionPtr f;
+  RelaxationPtr r;
+
+  clearRels_();
+  rel_ = rel;
+  borrowDer_ = !(options->findBool("use_native_cgraph")->getValue() ||
+                 rel->isQP() || rel->isQuadratic());
+  for (UInt i=0; i<n_; ++i) {
+    r = (RelaxationPtr) new Relaxation(rel, env_);
+    r->calculateSize();
+    if (borrowDer_) {
+      r->setJacobian(rel->getJacobian());
+      r->setHessian(rel->getHessian());
+    } else {
+      r->setNativeDer();
+    }
+    engines_[i]->load(r);
+    rels_.push_back(r);
+  }
+
+  srcVars_.assign(rel->varsBegin(), rel->varsEnd());
+  for (ConstraintConstIterator it=rel->consBegin(); it!=rel->consEnd();
+       ++it) {
+    c = *it;
+    f = c->getFunction();
+    srcCons_.push_back(c);
+    srcNlfs_.push_back(f ? f->getNonlinearFunction() : 0);
+    srcQfs_.push_back(f ? f->getQuadraticFunction() : 0);
+  }
+  srcObj_ = rel->getObjective() ? rel->getObjective()->getFunction() : 0;
+}
+
+
+StrBrPool* StrBrPool::create(EnvPtr env)
+{
+  int n = env->getOptions()->findInt("strbr_threads")->getValue();
+
+  if (n>1) {
+    return (StrBrPool*) new StrBrPool(env, n);
+  }
+  return 0;
+}
+
+
+void StrBrPool::finish()
+{
+  for (UInt i=0; i<rels_.size(); ++i) {
+    engines_[i]->resetIterationLimit();
+    engines_[i]->disableStrBrSetup();
+  }
+  if (ws_) {
+    delete ws_;
+    ws_ = 0;
+  }
+  engine_ = 0;
+}
+
+
+UInt StrBrPool::getNumThreads() const
+{
+  return n_;
+}
+
+
+bool StrBrPool::sameStructure_(RelaxationPtr rel) const
+{
+  ConstraintPtr c;
+  FunctionPtr f;
+  UInt i;
+
+  if (rel!=rel_ || rels_.empty() || rel->getNumVars()!=srcVars_.size() ||
+      rel->getNumCons()!=srcCons_.size()) {
+    return false;
+  }
+  if (borrowDer_ && (rel->getJacobian()!=rels_[0]->getJacobian() ||
+                     rel->getHessian()!=rels_[0]->getHessian())) {
+    return false;
+  }
+  i = 0;
+  for (VariableConstIterator it=rel->varsBegin(); it!=rel->varsEnd();
+       ++it, ++i) {
+    if (*it!=srcVars_[i]) {
+      return false;
+    }
+  }
+  i = 0;
+  for (ConstraintConstIterator it=rel->consBegin(); it!=rel->consEnd();
+       ++it, ++i) {
+    c = *it;
+    f = c->getFunction();
+    if (c!=srcCons_[i] ||
+        (f ? f->getNonlinearFunction() : 0)!=srcNlfs_[i] ||
+        (f ? f->getQuadraticFunction() : 0)!=srcQfs_[i]) {
+      return false;
+    }
+  }
+  f = rel->getObjective() ? rel->getObjective()->getFunction() : 0;
+  return (f==srcObj_);
+}
+
+
+bool StrBrPool::setup(RelaxationPtr rel, EnginePtr engine, UInt iter_lim)
+{
+  EnginePtr e;
+
+  if (n_<2 || failed_) {
+    return false;
+  }
+
+  if (engines_.empty()) {
+    for (UInt i=0; i<n_; ++i) {
+      e = engine->emptyCopy();
+      if (!e) {
+        env_->getLogger()->msgStream(LogInfo) << me_ << "engine "
+          << engine->getName() << " can not be copied. Solving "
+          << "strong-branching problems in one thread." << std::endl;
+        for (UInt j=0; j<engines_.size(); ++j) {
+          delete engines_[j];
+        }
+        engines_.clear();
+        failed_ = true;
+        return false;
+      }
+      engines_.push_back(e);
+    }
+  }
+
+  // the relaxation may have different bounds, constraints or cuts since the
+  // last node.
+  if (sameStructure_(rel)) {
+    syncRels_();
+  } else {
+    copyRels_(rel);
+  }
+  if (ws_) {
+    delete ws_;
+  }
+  ws_ = engine->getWarmStartCopy();
+  engine_ = engine;
+  for (UInt i=0; i<n_; ++i) {
+    engines_[i]->enableStrBrSetup();
+    engines_[i]->setIterationLimit(iter_lim);
+  }
+  return true;
+}
+
+
+void StrBrPool::solve(ModVector &mods, DoubleVector &obj,
+                      std::vector<EngineStatus> &status)
+{
+  int n = mods.size();
+  UIntVector serial(n, 0);
+
+  obj.resize(n);
+  status.resize(n);
+
+#if USE_OPENMP
+#pragma omp parallel for num_threads(n_) schedule(static, 1)
+#endif
+  for (int j=0; j<n; ++j) {
+    // each thread uses its own engine and copy of the relaxation.
+#if USE_OPENMP
+    UInt i = omp_get_thread_num();
+#else
+    UInt i = 0;
+#endif
+    ModificationPtr mod = mods[j]->toRel(rel_, rels_[i]);
+
+    if (!mod) {
+      serial[j] = 1;
+      continue;
+    }
+    mod->applyToProblem(rels_[i]);
+    if (ws_) {
+      engines_[i]->loadFromWarmStart(ws_);
+    }
+    status[j] = engines_[i]->solve();
+    obj[j] = engines_[i]->getSolutionValue();
+    mod->undoToProblem(rels_[i]);
+    delete mod;
+  }
+
+  // modifications that are not translated to the copies, e.g. LinMods,
+  // are solved as in serial strong branching.
+  for (int j=0; j<n; ++j) {
+    if (1==serial[j]) {
+      mods[j]->applyToProblem(rel_);
+      status[j] = engine_->solve();
+      obj[j] = engine_->getSolutionValue();
+      mods[j]->undoToProblem(rel_);
+    }
+  }
+}
+
+
+UInt StrBrPool::strongBranch(BrCandVIter it, BrCandVIter end, UInt cnt,
+                             UInt maxcnt, DoubleVector &x, double &obj_down,
+                             double &obj_up, EngineStatus &status_down,
+                             EngineStatus &status_up)
+{
+  UInt k = cnt%n_;
+  UInt nsolved = 0;
+
+  if (0==k) {
+    ModVector mods;
+    HandlerPtr h;
+
+    // modifications are created here, in one thread, because handlers are
+    // not thread-safe.
+    for (UInt i=0; i<n_ && cnt+i<maxcnt && it!=end; ++i, ++it) {
+      h = (*it)->getHandler();
+      mods.push_back(h->getBrMod(*it, x, rel_, DownBranch));
+      mods.push_back(h->getBrMod(*it, x, rel_, UpBranch));
+    }
+    solve(mods, obj_, status_);
+    nsolved = mods.size();
+    for (ModificationConstIterator m=mods.begin(); m!=mods.end(); ++m) {
+      delete *m;
+    }
+  }
+  obj_down    = obj_[2*k];
+  obj_up      = obj_[2*k+1];
+  status_down = status_[2*k];
+  status_up   = status_[2*k+1];
+  return nsolved;
+}
+
+
+void StrBrPool::syncRels_()
+{
+  ConstraintPtr c, c2;
+  LinearFunctionPtr lf, lf2;
+  VariablePtr v, v2;
+  RelaxationPtr r;
+  bool same;
+
+  for (UInt i=0; i<rels_.size(); ++i) {
+    r = rels_[i];
+    r->beginBoundBatch();
+    for (UInt j=0; j<srcVars_.size(); ++j) {
+      v = srcVars_[j];
+      v2 = r->getVariable(j);
+      if (v->getLb()!=v2->getLb() || v->getUb()!=v2->getUb()) {
+        r->changeBound(v2, v->getLb(), v->getUb());
+      }
+    }
+    r->endBoundBatch();
+
+    for (UInt j=0; j<srcCons_.size(); ++j) {
+      c = srcCons_[j];
+      c2 = r->getConstraint(j);
+      lf = c->getLinearFunction();
+      lf2 = c2->getLinearFunction();
+      same = (lf ? lf->getNumTerms() : 0) == (lf2 ? lf2->getNumTerms() : 0);
+      if (same && lf) {
+        for (VariableGroupConstIterator it=lf->termsBegin();
+             it!=lf->termsEnd() && same; ++it) {
+          same = (lf2->getWeight(r->getVariable(it->first->getIndex()))
+                  == it->second);
+        }
+      }
+      if (false==same) {
+        lf2 = lf ? lf->cloneWithVars(r->varsBegin()) :
+          (LinearFunctionPtr) new LinearFunction();
+        r->changeConstraint(c2, lf2, c->getLb(), c->getUb());
+      } else {
+        if (c->getLb()!=c2->getLb()) {
+          r->changeBound(c2, Lower, c->getLb());
+        }
+        if (c->getUb()!=c2->getUb()) {
+          r->changeBound(c2, Upper, c->getUb());
+        }
+      }
+    }
+  }
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
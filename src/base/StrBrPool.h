@@ -0,0 +1,208 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file StrBrPool.h
+ * \brief Declare class StrBrPool for solving strong-branching problems in
+ * parallel.
+ */
+
+
+#ifndef MINOTAURSTRBRPOOL_H
+#define MINOTAURSTRBRPOOL_H
+
+#include "Types.h"
+#include "Engine.h"
+
+namespace Minotaur {
+
+  class Relaxation;
+  typedef Relaxation* RelaxationPtr;
+
+  /**
+   * \brief A pool of engines, each with its own copy of the relaxation,
+   * that solves the relaxations of strong branching in parallel.
+   *
+   * Before strong branching at a node, setup() brings the copies of the
+   * relaxation up to date and saves the warm start of the engine that
+   * solved the node. The copies are made once and kept across nodes.
+   * Bounds and linear functions that changed since the last node are
+   * copied into them. They are made again only if variables, constraints,
+   * nonlinear or quadratic functions, or the objective of the relaxation
+   * were replaced. Each problem given to solve() is then solved by one of
+   * the engines of the pool, starting from the saved warm start. Since no
+   * problem starts from the solution of another, the results do not depend
+   * on which thread solved which problem, or in what order.
+   *
+   * A modification that can not be translated to a copy of the relaxation
+   * (Modification::toRel() returns NULL) is applied to the relaxation
+   * itself and solved by the engine given to setup(), after the parallel
+   * solves.
+   *
+   * Engines are obtained by Engine::emptyCopy(). If the engine can not be
+   * copied, setup() returns false and the brancher should solve the
+   * problems itself.
+   */
+  class StrBrPool {
+  public:
+    /**
+     * \brief Construct a pool.
+     *
+     * \param[in] env Environment from which options are obtained.
+     * \param[in] n Number of engines (and threads) in the pool.
+     */
+    StrBrPool(EnvPtr env, UInt n);
+
+    /// Destroy the pool, its engines and the copies of the relaxation.
+    ~StrBrPool();
+
+    /**
+     * \brief Create a pool if option strbr_threads is larger than one.
+     *
+     * \param[in] env Environment from which options are obtained.
+     * \return The new pool, or NULL if strong branching is done in one
+     * thread.
+     */
+    static StrBrPool* create(EnvPtr env);
+
+    /// Restore settings of the engines after strong branching at a node.
+    void finish();
+
+    /// Return the number of engines in the pool.
+    UInt getNumThreads() const;
+
+    /**
+     * \brief Prepare the pool for strong branching at a node.
+     *
+     * \param[in] rel The relaxation of the node. Its changes since the last
+     * call are copied.
+     * \param[in] engine The engine that solved rel. Its warm start is
+     * used for all problems solved by the pool.
+     * \param[in] iter_lim Limit on the iterations of each solve.
+     * \return False if the pool can not be used, true otherwise.
+     */
+    bool setup(RelaxationPtr rel, EnginePtr engine, UInt iter_lim);
+
+    /**
+     * \brief Solve the relaxation with each of the given modifications.
+     *
+     * \param[in] mods Modifications of the relaxation given to setup(). The
+     * i-th problem is the relaxation with mods[i] applied. The
+     * modifications are not changed or deleted.
+     * \param[out] obj The optimal value of the i-th problem is saved in
+     * obj[i].
+     * \param[out] status The status of the engine after solving the i-th
+     * problem is saved in status[i].
+     */
+    void solve(ModVector &mods, DoubleVector &obj,
+               std::vector<EngineStatus> &status);
+
+    /**
+     * \brief Get the strong-branching results of a candidate, solving the
+     * candidates in batches of getNumThreads().
+     *
+     * When cnt is a multiple of getNumThreads(), the down and up problems
+     * of the candidates from it onwards, at most getNumThreads() of them
+     * and at most maxcnt-cnt, are solved in parallel. Results of the
+     * candidate at it are then returned from this batch.
+     *
+     * \param[in] it The candidate.
+     * \param[in] end End of the vector of candidates.
+     * \param[in] cnt Number of candidates strong-branched before it.
+     * \param[in] maxcnt Limit on the number of candidates strong-branched.
+     * \param[in] x Point at which the branching modifications are made.
+     * \param[out] obj_down Objective value estimate in down branch.
+     * \param[out] obj_up Objective value estimate in up branch.
+     * \param[out] status_down Engine status in down branch.
+     * \param[out] status_up Engine status in up branch.
+     * \return The number of problems solved in this call.
+     */
+    UInt strongBranch(BrCandVIter it, BrCandVIter end, UInt cnt,
+                      UInt maxcnt, DoubleVector &x, double &obj_down,
+                      double &obj_up, EngineStatus &status_down,
+                      EngineStatus &status_up);
+
+  private:
+    /// Delete the copies of the relaxation, if any.
+    void clearRels_();
+
+    /// Copy rel into each engine and save the functions it is made of.
+    void copyRels_(RelaxationPtr rel);
+
+    /**
+     * Return true if the copies can be brought up to date with rel by
+     * changing bounds and linear functions only.
+     */
+    bool sameStructure_(RelaxationPtr rel) const;
+
+    /// Copy bounds and linear functions of rel_ that changed into rels_.
+    void syncRels_();
+
+    /// True if rels_ use the derivatives of the relaxation given to setup().
+    bool borrowDer_;
+
+    /// Engine given to setup(). Solves problems that can not be copied.
+    EnginePtr engine_;
+
+    /// Engines, one for each thread.
+    std::vector<EnginePtr> engines_;
+
+    /// Environment.
+    EnvPtr env_;
+
+    /// True if the engine could not be copied.
+    bool failed_;
+
+    /// Name.
+    static const std::string me_;
+
+    /// Number of engines and threads.
+    UInt n_;
+
+    /// Results of the last batch solved by strongBranch().
+    DoubleVector obj_;
+
+    /// Relaxation given to setup().
+    RelaxationPtr rel_;
+
+    /// Copies of the relaxation, one for each engine.
+    std::vector<RelaxationPtr> rels_;
+
+    /// Constraints of rel_ when it was copied.
+    ConstraintVector srcCons_;
+
+    /// Nonlinear functions of srcCons_ when rel_ was copied.
+    std::vector<NonlinearFunctionPtr> srcNlfs_;
+
+    /// Objective function of rel_ when it was copied.
+    FunctionPtr srcObj_;
+
+    /// Quadratic functions of srcCons_ when rel_ was copied.
+    std::vector<QuadraticFunctionPtr> srcQfs_;
+
+    /// Variables of rel_ when it was copied.
+    VarVector srcVars_;
+
+    /// Statuses of the last batch solved by strongBranch().
+    std::vector<EngineStatus> status_;
+
+    /// Warm start from which each problem is solved.
+    WarmStartPtr ws_;
+  };
+  typedef StrBrPool* StrBrPoolPtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
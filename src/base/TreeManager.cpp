@@ -20,8 +20,10 @@
 #include "NodeStack.h"
 #include "Operations.h"
 #include "Option.h"
+#include "SpillFile.h"
 #include "Timer.h"
 #include "TreeManager.h"
+#include "WarmStart.h"
 
 using namespace Minotaur;
     
@@ -32,8 +34,11 @@ TreeManager::TreeManager(EnvPtr env)
   cutOff_(INFINITY),
   doVbc_(false),
   etol_(1e-6),
+  maxMemNodes_(0),
+  numSpilled_(0),
   size_(0),
-  timer_(0)
+  timer_(0),
+  spill_(0)
 {
   std::string s = env->getOptions()->findString("tree_search")->getValue();
   if ("dfs"==s) {
@@ -60,6 +65,15 @@ TreeManager::TreeManager(EnvPtr env)
 
   aNode_ = NodePtr();
   cutOff_ = env->getOptions()->findDouble("obj_cut_off")->getValue();
+
+  // the newest nodes are processed first in depth first search, so there
+  // are no cold nodes to move to the spill file.
+  maxMemNodes_ = env->getOptions()->findInt("bnb_spill_nodes")->getValue();
+  if (maxMemNodes_>0 && DepthFirst!=searchType_) {
+    s = env->getOptions()->findString("bnb_spill_dir")->getValue();
+    spill_ = (SpillFilePtr) new SpillFile(s);
+  }
+
   s = env->getOptions()->findString("vbc_file")->getValue();
   if (s!="") {
     vbcFile_.open(s.c_str());
@@ -83,6 +97,9 @@ TreeManager::~TreeManager()
 {
   clearAll();
   delete activeNodes_;
+  if (spill_) {
+    delete spill_;
+  }
   if (doVbc_) {
     vbcFile_.close();
     delete timer_;
@@ -102,10 +119,19 @@ NodePtr TreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
   NodePtr new_cand = NodePtr(); // NULL
   NodePtr child;
   bool is_first = false;
+  bool spill = false;
 
   if (searchType_ == DepthFirst || searchType_ == BestThenDive) {
     is_first = true;
   }
+  if (spill_ && shouldSpill_(node)) {
+    spill = true;
+    // the first child is processed right away while diving, and it needs
+    // the warm start.
+    if (ws && false==is_first) {
+      ws->spill(spill_);
+    }
+  }
   for (BranchConstIterator br_iter=branches->begin(); br_iter!=branches->end();
       ++br_iter) {
     branch_p = *br_iter;
@@ -123,6 +149,10 @@ NodePtr TreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
       // We make a copy of the pointer to warm-start, not the full copy of the
       // warm-start.
       child->setWarmStart(ws);
+      if (spill) {
+        child->spill(spill_);
+        ++numSpilled_;
+      }
       insertCandidate_(child);
     }
   }
@@ -144,13 +174,17 @@ void TreeManager::clearAll()
   NodePtr n;
   NodePtrIterator node_i;
 
+  while (false==held_.empty()) {
+    releaseNode(held_.back());
+  }
+
   if (aNode_) {
     removeNodeAndUp_(aNode_);
   }
   while (false==activeNodes_->isEmpty()) {
     n = activeNodes_->top();
-    removeNodeAndUp_(n);
     activeNodes_->pop();
+    removeNodeAndUp_(n);
   }
 }
 
@@ -178,6 +212,10 @@ NodePtr TreeManager::getCandidate()
         vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1
                  << " " << VbcSolving << std::endl;
       }
+      if (node->isSpilled()) {
+        node->unspill(spill_);
+        --numSpilled_;
+      }
       break;
     }
   } 
@@ -255,6 +293,13 @@ void TreeManager::insertCandidate_(NodePtr node, bool pop_now)
 }
 
 
+void TreeManager::holdNode(NodePtr node)
+{
+  held_.push_back(node);
+  heldRemoved_.push_back(false);
+}
+
+
 void TreeManager::insertRoot(NodePtr node)
 {
   assert(size_==0);
@@ -279,6 +324,24 @@ void TreeManager::pruneNode(NodePtr node)
 }
 
 
+void TreeManager::releaseNode(NodePtr node)
+{
+  bool removed;
+
+  for (UInt i=0; i<held_.size(); ++i) {
+    if (held_[i]==node) {
+      removed = heldRemoved_[i];
+      held_.erase(held_.begin()+i);
+      heldRemoved_.erase(heldRemoved_.begin()+i);
+      if (removed) {
+        removeNodeAndUp_(node);
+      }
+      break;
+    }
+  }
+}
+
+
 void TreeManager::removeActiveNode(NodePtr node)
 {
   if (doVbc_) {
@@ -296,6 +359,18 @@ void TreeManager::removeActiveNode(NodePtr node)
 }
 
 
+bool TreeManager::markHeld_(NodePtr node)
+{
+  for (UInt i=0; i<held_.size(); ++i) {
+    if (held_[i]==node) {
+      heldRemoved_[i] = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+
 void TreeManager::removeNode_(NodePtr node) 
 {
   NodePtr cNode, parent;
@@ -333,6 +408,10 @@ void TreeManager::removeNode_(NodePtr node)
       assert (!"Current node is not in its parent's list of children!");
     }
   } 
+  if (node->isSpilled()) {
+    node->dropSpill(spill_);
+    --numSpilled_;
+  }
   delete node;
 }
 
@@ -341,11 +420,16 @@ void TreeManager::removeNodeAndUp_(NodePtr node)
 {
   NodePtr parent = node->getParent();
 
+  // a held node is removed when it is released.
+  if (markHeld_(node)) {
+    return;
+  }
+
   // remove the given node
   removeNode_(node);
 
   // remove the ancestors of the given node, if they have no children left
-  while (parent && parent->getNumChildren()==0) {
+  while (parent && parent->getNumChildren()==0 && !markHeld_(parent)) {
     node = parent;
     parent = node->getParent();
     removeNode_(node);
@@ -389,6 +473,14 @@ bool TreeManager::shouldPrune_(NodePtr node)
 }
 
 
+bool TreeManager::shouldSpill_(NodePtr node)
+{
+  // nodes with the best bound are likely to be processed soon.
+  return (activeNodes_->getSize()-numSpilled_ >= maxMemNodes_ &&
+          node->getLb() > bestLowerBound_+etol_);
+}
+
+
 double TreeManager::updateLb()
 {
   // this could be an expensive operation. Try to avoid it.
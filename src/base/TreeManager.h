@@ -21,8 +21,10 @@
 namespace Minotaur {
   
   class ActiveNodeStore;
+  class SpillFile;
   class WarmStart;
   typedef ActiveNodeStore* ActiveNodeStorePtr;
+  typedef SpillFile* SpillFilePtr;
   typedef WarmStart* WarmStartPtr;
 
   // 1=like_red, 2=blue, 4=red, 5=yellow, 6=black, 7=pink, 8=cyan, 9=green
@@ -110,6 +112,17 @@ namespace Minotaur {
      */
     NodePtr getCandidate();
 
+    /**
+     * \brief Keep a node in memory, even if it is pruned, until
+     * releaseNode() is called.
+     *
+     * A node relaxer may keep the modifications of a node applied after the
+     * node is processed, and undo them only when the next node is known. It
+     * needs the node and its ancestors until then.
+     * \param[in] node The node that must not be freed.
+     */
+    void holdNode(NodePtr node);
+
     /**
      * \brief Insert the root node into the tree.
      *
@@ -124,6 +137,14 @@ namespace Minotaur {
      */
     void pruneNode(NodePtr node);
 
+    /**
+     * \brief Stop holding a node. The node is freed now if it was pruned
+     * while it was held.
+     *
+     * \param[in] node A node passed to holdNode() earlier.
+     */
+    void releaseNode(NodePtr node);
+
     /**
      * \brief Remove a given active node from storage.
      *
@@ -190,6 +211,21 @@ namespace Minotaur {
     /// Tolerance for pruning nodes on the basis of bounds.
     const double etol_;
 
+    /**
+     * Number of active nodes above which new nodes are moved to spill_. 0
+     * if nodes are never moved.
+     */
+    UInt maxMemNodes_;
+
+    /// Number of active nodes that are in spill_ now.
+    UInt numSpilled_;
+
+    /// Nodes passed to holdNode() that have not been released yet.
+    NodePtrVector held_;
+
+    /// Entry i is true if held_[i] was pruned while it was held.
+    BoolVector heldRemoved_;
+
     /// The search order: depth first, best first or something else.
     TreeSearchOrder searchType_;
 
@@ -205,9 +241,26 @@ namespace Minotaur {
     /// File name to store tree information for vbc.
     std::ofstream vbcFile_;
 
+    /**
+     * File to which the warm starts and branches of active nodes are moved
+     * when there are too many active nodes. NULL if they are always kept in
+     * memory.
+     */
+    SpillFilePtr spill_;
+
     /// Check if the node can be pruned because of its bound.
     bool shouldPrune_(NodePtr node);
 
+    /**
+     * \brief Check if the children of a node should be moved to the spill
+     * file when they are created.
+     *
+     * \param[in] node The node that is branched upon.
+     * \return True if there are too many active nodes in memory and the
+     * children are not among the best active nodes.
+     */
+    bool shouldSpill_(NodePtr node);
+
     /**
      * \brief Insert a candidate (that is not root) into the tree.
      *
@@ -216,6 +269,15 @@ namespace Minotaur {
      */
     void insertCandidate_(NodePtr node, bool pop_now = false);
 
+    /**
+     * \brief Check if a node is held. If so, mark it as pruned so that it
+     * is removed when it is released.
+     *
+     * \param[in] node The node that is about to be removed.
+     * \return True if the node is held and must not be removed now.
+     */
+    bool markHeld_(NodePtr node);
+
     /**
      * \brief Remove a node from the tree. Ancestors are removed if their
      * single child is removed.
@@ -314,12 +314,7 @@ void UnambRelBrancher::findCandidates_(NodePtr node, IntVector & candsPos,
   //check if the a candidate's information is present with the parent node
   //NodePtr parent = node->getParent();
   //if (parent) {
-    //node->setBrCands(parent->getBrCands());
-    //node->setPCDown(parent->getPCDown());
-    //node->setPCUp(parent->getPCUp());
-    //node->setTimesDown(parent->getTimesDown());
-    //node->setTimesUp(parent->getTimesUp());
-    //node->setLastStrongBranched(parent->getLastStrongBranched());
+    //node->setPCostsFromParent();
   //}
   UIntVector brCands = node->getBrCands();
   DoubleVector pCDown = node->getPCDown();
@@ -621,12 +616,7 @@ void UnambRelBrancher::updateAfterSolve(NodePtr node, ConstSolutionPtr sol)
     int index = cand->getPCostIndex();
     if (index>-1) {
       UInt vindex;
-      node->setBrCands(parent->getBrCands());
-      node->setPCDown(parent->getPCDown());
-      node->setPCUp(parent->getPCUp());
-      node->setTimesDown(parent->getTimesDown());
-      node->setTimesUp(parent->getTimesUp());
-      node->setLastStrongBranched(parent->getLastStrongBranched());
+      node->setPCostsFromParent();
       
       UIntVector brCands = node->getBrCands();
       DoubleVector pCDown = node->getPCDown();
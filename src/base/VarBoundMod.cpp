@@ -43,6 +43,16 @@ VarBoundMod::VarBoundMod(VariablePtr var, BoundType lu, double new_val)
 }
 
 
+VarBoundMod::VarBoundMod(VariablePtr var, BoundType lu, double new_val,
+                         double old_val)
+  : lu_(lu),
+    newVal_(new_val),
+    oldVal_(old_val),
+    var_(var)
+{
+}
+
+
 VarBoundMod::~VarBoundMod()
 {
   var_= 0;
@@ -77,6 +87,12 @@ double VarBoundMod::getNewVal() const
 }
 
 
+double VarBoundMod::getOldVal() const
+{
+  return oldVal_;
+}
+
+
 void VarBoundMod::applyToProblem(ProblemPtr problem) 
 {
   problem->changeBound(var_, lu_, newVal_);
@@ -162,6 +178,18 @@ double VarBoundMod2::getNewUb() const
 }
 
 
+double VarBoundMod2::getOldLb() const
+{
+  return oldLb_;
+}
+
+
+double VarBoundMod2::getOldUb() const
+{
+  return oldUb_;
+}
+
+
 void VarBoundMod2::applyToProblem(ProblemPtr problem)
 {
   problem->changeBound(var_, newLb_, newUb_);
@@ -34,6 +34,14 @@ namespace Minotaur {
       /// Construct.
       VarBoundMod(VariablePtr var, BoundType lu, double new_val);
 
+      /**
+       * Construct with a given old value of the bound, rather than the
+       * current bound of the variable. Used when a modification is recreated
+       * after it was saved elsewhere.
+       */
+      VarBoundMod(VariablePtr var, BoundType lu, double new_val,
+                  double old_val);
+
       /// Destroy.
       ~VarBoundMod();
 
@@ -52,6 +60,9 @@ namespace Minotaur {
       /// Get new value of the bound.
       double getNewVal() const;
 
+      /// Get the value of the bound before the modification.
+      double getOldVal() const;
+
       // Implement Modification::applyToProblem().
       void applyToProblem(ProblemPtr problem);
 
@@ -106,6 +117,12 @@ namespace Minotaur {
       /// Get new value of the bound.
       double getNewUb() const;
 
+      /// Get the lower bound before the modification.
+      double getOldLb() const;
+
+      /// Get the upper bound before the modification.
+      double getOldUb() const;
+
       // base class method.
       ModificationPtr toRel(ProblemPtr, RelaxationPtr) const;
 
@@ -19,7 +19,9 @@
 
 namespace Minotaur {
 
+  class SpillFile;
   class WarmStart;
+  typedef SpillFile* SpillFilePtr;
   typedef WarmStart* WarmStartPtr;
   typedef const WarmStart* ConstWarmStartPtr;
 
@@ -63,6 +65,21 @@ namespace Minotaur {
       virtual void incrUseCnt()
       {++cnt_;} ;
       
+      /// Return true if the information is in a spill file now.
+      virtual bool isSpilled() const
+      {return false;} ;
+
+      /// Move the information to a spill file and free it from memory. It
+      /// is read back by unspill(). Return false if it was not moved, e.g.
+      /// if the type of warm start does not support it.
+      virtual bool spill(SpillFilePtr)
+      {return false;} ;
+
+      /// Read back the information moved by spill(). Do nothing if it is
+      /// not in a spill file.
+      virtual void unspill()
+      {} ;
+
       /// Write to an output stream
       virtual void write(std::ostream &out) const = 0;
 
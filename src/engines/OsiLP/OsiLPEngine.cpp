@@ -11,6 +11,7 @@
  */
 
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 
@@ -23,6 +24,7 @@
 #endif
 #include "coin/CoinPackedMatrix.hpp"
 #include "coin/CoinWarmStart.hpp"
+#include "coin/CoinWarmStartBasis.hpp"
 
 #undef F77_FUNC_
 #undef F77_FUNC
@@ -39,6 +41,7 @@
 #include "OsiLPEngine.h"
 #include "Problem.h"
 #include "Solution.h"
+#include "SpillFile.h"
 #include "Timer.h"
 #include "Variable.h"
 
@@ -53,7 +56,9 @@ const std::string OsiLPEngine::me_ = "OsiLPEngine: ";
 
 OsiLPWarmStart::OsiLPWarmStart()
   : coinWs_(0),
-    mustDelete_(true)
+    mustDelete_(true),
+    spillAt_(0),
+    spillFile_(0)
 {
 }
 
@@ -64,6 +69,10 @@ OsiLPWarmStart::~OsiLPWarmStart()
     delete coinWs_;
     coinWs_ = 0;
   }
+  if (spillFile_) {
+    spillFile_->release(spillAt_);
+    spillFile_ = 0;
+  }
 }
 
 
@@ -77,6 +86,12 @@ bool OsiLPWarmStart::hasInfo()
 }
 
 
+bool OsiLPWarmStart::isSpilled() const
+{
+  return (spillFile_!=0);
+}
+
+
 CoinWarmStart * OsiLPWarmStart::getCoinWarmStart() const
 {
   return coinWs_;
@@ -95,6 +110,66 @@ void OsiLPWarmStart::setCoinWarmStart(CoinWarmStart *coin_ws, bool must_delete)
 }
 
 
+bool OsiLPWarmStart::spill(SpillFilePtr f)
+{
+  CoinWarmStartBasis *basis;
+  std::vector<char> buf;
+  int ns, na;
+  size_t sbytes, abytes;
+
+  if (spillFile_ || !coinWs_ || !mustDelete_) {
+    return false;
+  }
+  basis = dynamic_cast<CoinWarmStartBasis *>(coinWs_);
+  if (!basis) {
+    return false;
+  }
+
+  // the status of four variables is packed in each byte.
+  ns = basis->getNumStructural();
+  na = basis->getNumArtificial();
+  sbytes = 4*((ns+15)>>4);
+  abytes = 4*((na+15)>>4);
+  buf.resize(2*sizeof(int)+sbytes+abytes);
+  memcpy(&buf[0], &ns, sizeof(int));
+  memcpy(&buf[sizeof(int)], &na, sizeof(int));
+  if (sbytes>0) {
+    memcpy(&buf[2*sizeof(int)], basis->getStructuralStatus(), sbytes);
+  }
+  if (abytes>0) {
+    memcpy(&buf[2*sizeof(int)+sbytes], basis->getArtificialStatus(), abytes);
+  }
+  if (false==f->write(&buf[0], buf.size(), &spillAt_)) {
+    return false;
+  }
+  delete coinWs_;
+  coinWs_ = 0;
+  spillFile_ = f;
+  return true;
+}
+
+
+void OsiLPWarmStart::unspill()
+{
+  std::vector<char> buf;
+  int ns, na;
+  size_t sbytes;
+
+  if (!spillFile_) {
+    return;
+  }
+  spillFile_->read(spillAt_, buf);
+  memcpy(&ns, &buf[0], sizeof(int));
+  memcpy(&na, &buf[sizeof(int)], sizeof(int));
+  sbytes = 4*((ns+15)>>4);
+  coinWs_ = new CoinWarmStartBasis(ns, na, &buf[0]+2*sizeof(int),
+                                   &buf[0]+2*sizeof(int)+sbytes);
+  mustDelete_ = true;
+  spillFile_->release(spillAt_);
+  spillFile_ = 0;
+}
+
+
 void OsiLPWarmStart::write(std::ostream &) const
 {
   assert(!"implement me!");
@@ -224,6 +299,25 @@ void OsiLPEngine::changeBound(VariablePtr var, double new_lb, double new_ub)
 }
 
 
+void OsiLPEngine::changeBounds(const VarVector &vars, const DoubleVector &lb,
+                               const DoubleVector &ub)
+{
+  const UInt n = vars.size();
+  int *cols = new int[n];
+  double *bnds = new double[2*n];
+
+  for (UInt i=0; i<n; ++i) {
+    cols[i] = vars[i]->getIndex();
+    bnds[2*i] = lb[i];
+    bnds[2*i+1] = ub[i];
+  }
+  osilp_->setColSetBounds(cols, cols+n, bnds);
+  bndChanged_ = true;
+  delete [] cols;
+  delete [] bnds;
+}
+
+
 #if MNTROSICLP
 void OsiLPEngine::changeConstraint(ConstraintPtr c, LinearFunctionPtr lf, 
                                    double lb, double ub)
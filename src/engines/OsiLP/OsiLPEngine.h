@@ -70,12 +70,24 @@ namespace Minotaur {
     // Implement Engine::hasInfo().
     bool hasInfo();
 
+    // Implement WarmStart::isSpilled().
+    bool isSpilled() const;
+
     /** 
      * Save the given coin-warm start. If must_delete is true, it is our
      * responsibility to free it.
      */
     void setCoinWarmStart(CoinWarmStart *coin_ws, bool must_delete);
 
+    /**
+     * Write the basis to the spill file and free it. Only a
+     * CoinWarmStartBasis that we must delete is written.
+     */
+    bool spill(SpillFilePtr f);
+
+    // Implement WarmStart::unspill().
+    void unspill();
+
     // Implement Engine::write().
     void write(std::ostream &out) const;
 
@@ -92,6 +104,12 @@ namespace Minotaur {
      */
     bool mustDelete_;
 
+    /// Position of the basis in spillFile_.
+    size_t spillAt_;
+
+    /// The file to which the basis was written. NULL if it is in memory.
+    SpillFilePtr spillFile_;
+
   };
   typedef OsiLPWarmStart* OsiLPWarmStartPtr;
   typedef const OsiLPWarmStart* ConstOsiLPWarmStartPtr;
@@ -118,6 +136,10 @@ namespace Minotaur {
     // Implement Engine::changeBound(VariablePtr, double, double).
     void changeBound(VariablePtr var, double new_lb, double new_ub);
 
+    // Implement Engine::changeBounds().
+    void changeBounds(const VarVector &vars, const DoubleVector &lb,
+                      const DoubleVector &ub);
+
     // Implement Engine::changeConstraint().
     void changeConstraint(ConstraintPtr con, LinearFunctionPtr lf, 
                           double lb, double ub);
@@ -5,11 +5,19 @@
 // 
 
 #include <cmath>
+#include <sstream>
 
 #include "MinotaurConfig.h"
 #include "CGraphUT.h"
 #include "CGraph.h"
 #include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "HessianOfLag.h"
+#include "Jacobian.h"
+#include "Objective.h"
+#include "Option.h"
 #include "Problem.h"
 #include "Variable.h"
 
@@ -17,6 +25,320 @@ CPPUNIT_TEST_SUITE_REGISTRATION(CGraphUT);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CGraphUT, "CGraphUT");
 using namespace Minotaur;
 
+void CGraphUT::testBatch()
+{
+  VariablePtr v0 = new Variable(0, 0, 0.0, 10.0, Continuous, "x0");
+  VariablePtr v1 = new Variable(1, 1, 0.0, 10.0, Continuous, "x1");
+  // three points, two variables each.
+  double x[6] = {1.0, 2.0, 0.5, -1.0, 3.0, 0.0};
+  double f[3];
+  double g[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double g1[2];
+  int error = 0;
+  CNode *n0, *n1;
+  CGraph cgraph;
+
+  // x0*exp(x1)
+  n0 = cgraph.newNode(v0);
+  n1 = cgraph.newNode(v1);
+  n1 = cgraph.newNode(OpExp, n1, 0);
+  n0 = cgraph.newNode(OpMult, n0, n1);
+  cgraph.setOut(n0);
+  cgraph.finalize();
+
+  cgraph.evalBatch(3, 2, x, f, &error);
+  cgraph.evalGradientBatch(3, 2, x, g, &error);
+  CPPUNIT_ASSERT(0==error);
+  for (UInt p=0; p<3; ++p) {
+    g1[0] = g1[1] = 0.0;
+    CPPUNIT_ASSERT(fabs(f[p] - cgraph.eval(x+2*p, &error))<1e-12);
+    cgraph.evalGradient(x+2*p, g1, &error);
+    CPPUNIT_ASSERT(fabs(g[2*p] - g1[0])<1e-12);
+    CPPUNIT_ASSERT(fabs(g[2*p+1] - g1[1])<1e-12);
+  }
+  CPPUNIT_ASSERT(0==error);
+
+  delete v0;
+  delete v1;
+}
+
+
+void CGraphUT::testCloneLazy()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  ProblemPtr p = cloneProblem_(env);
+  ProblemPtr q;
+  CGraphPtr cg, cgq;
+  double x[4] = {0.5, 1.5, -0.7, 2.0};
+  DoubleVector vp, vq;
+
+  evalAll_(p, x, &vp);
+
+  // the graphs of the clone share the tapes of p, with the variables of the
+  // clone in place of those of p.
+  q = p->clone(env);
+  for (UInt i=0; i<2; ++i) {
+    if (0==i) {
+      cg = getCGraph_(p->getConstraint(0)->getFunction());
+      cgq = getCGraph_(q->getConstraint(0)->getFunction());
+    } else {
+      cg = getCGraph_(p->getObjective()->getFunction());
+      cgq = getCGraph_(q->getObjective()->getFunction());
+    }
+    CPPUNIT_ASSERT(true==cgq->lazy_);
+    CPPUNIT_ASSERT(cg->tape_==cgq->tape_);
+    CPPUNIT_ASSERT(2==cg->tape_->refs);
+    CPPUNIT_ASSERT(cg->sVars_.size()==cgq->sVars_.size());
+    for (UInt j=0; j<cg->sVars_.size(); ++j) {
+      CPPUNIT_ASSERT(cgq->sVars_[j]==
+                     q->getVariable(cg->sVars_[j]->getIndex()));
+    }
+  }
+
+  // the same values and derivatives without creating the nodes.
+  q->setNativeDer();
+  q->prepareForSolve();
+  evalAll_(q, x, &vq);
+  CPPUNIT_ASSERT(vp.size()==vq.size());
+  for (UInt i=0; i<vp.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(vp[i]-vq[i])<1e-12);
+  }
+  CPPUNIT_ASSERT(true==cgq->lazy_);
+
+  delete q;
+  delete p;
+  delete env;
+}
+
+
+void CGraphUT::testCloneLazyChange()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  ProblemPtr p = cloneProblem_(env);
+  ProblemPtr q[3];
+  CGraphPtr cg, cgq[3];
+  double x[4] = {0.5, 1.5, -0.7, 2.0};
+  DoubleVector vp, vq;
+  std::ostringstream out;
+  int error = 0;
+  double f;
+
+  evalAll_(p, x, &vp);
+  cg = getCGraph_(p->getConstraint(0)->getFunction());
+  for (UInt k=0; k<3; ++k) {
+    q[k] = p->clone(env);
+    q[k]->setNativeDer();
+    q[k]->prepareForSolve();
+    cgq[k] = getCGraph_(q[k]->getConstraint(0)->getFunction());
+  }
+  CPPUNIT_ASSERT(4==cg->tape_->refs);
+
+  // each change creates the nodes of the clone, which then gets a tape of
+  // its own.
+  cgq[0]->removeVar(q[0]->getVariable(3), 1.0);
+  CPPUNIT_ASSERT(false==cgq[0]->lazy_ && cg->tape_!=cgq[0]->tape_);
+  CPPUNIT_ASSERT(3==cg->tape_->refs);
+  cgq[1]->write(out);
+  CPPUNIT_ASSERT(false==cgq[1]->lazy_ && cg->tape_!=cgq[1]->tape_);
+  CPPUNIT_ASSERT(2==cg->tape_->refs);
+  CPPUNIT_ASSERT(false==out.str().empty());
+  CPPUNIT_ASSERT(cgq[2]->dNodes().size()==cg->dNodes().size());
+  CPPUNIT_ASSERT(false==cgq[2]->lazy_ && cg->tape_!=cgq[2]->tape_);
+  CPPUNIT_ASSERT(1==cg->tape_->refs);
+
+  // x0*exp(x2) + x3^2 with x3 fixed to 1.
+  f = cgq[0]->eval(x, &error);
+  CPPUNIT_ASSERT(0==error);
+  CPPUNIT_ASSERT(fabs(f - 0.5*exp(-0.7) - 1.0)<1e-12);
+
+  // the original and the other clones are not changed.
+  evalAll_(p, x, &vq);
+  for (UInt i=0; i<vp.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(vp[i]-vq[i])<1e-12);
+  }
+  for (UInt k=1; k<3; ++k) {
+    evalAll_(q[k], x, &vq);
+    CPPUNIT_ASSERT(vp.size()==vq.size());
+    for (UInt i=0; i<vp.size(); ++i) {
+      CPPUNIT_ASSERT(fabs(vp[i]-vq[i])<1e-12);
+    }
+  }
+
+  for (UInt k=0; k<3; ++k) {
+    delete q[k];
+  }
+  delete p;
+  delete env;
+}
+
+
+void CGraphUT::testCloneLazyDelete()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  ProblemPtr p = cloneProblem_(env);
+  ProblemPtr q[2];
+  CGraphPtr cgq[2];
+  double x[4] = {0.5, 1.5, -0.7, 2.0};
+  DoubleVector vp, vq;
+
+  evalAll_(p, x, &vp);
+  for (UInt k=0; k<2; ++k) {
+    q[k] = p->clone(env);
+    q[k]->setNativeDer();
+    q[k]->prepareForSolve();
+    cgq[k] = getCGraph_(q[k]->getConstraint(0)->getFunction());
+  }
+
+  // the tape lives on with the clones.
+  delete p;
+  CPPUNIT_ASSERT(cgq[0]->tape_==cgq[1]->tape_);
+  CPPUNIT_ASSERT(2==cgq[0]->tape_->refs);
+  for (UInt k=0; k<2; ++k) {
+    evalAll_(q[k], x, &vq);
+    CPPUNIT_ASSERT(vp.size()==vq.size());
+    for (UInt i=0; i<vp.size(); ++i) {
+      CPPUNIT_ASSERT(fabs(vp[i]-vq[i])<1e-12);
+    }
+    if (0==k) {
+      delete q[0];
+      CPPUNIT_ASSERT(1==cgq[1]->tape_->refs);
+    }
+  }
+  CPPUNIT_ASSERT(true==cgq[1]->lazy_);
+
+  delete q[1];
+  delete env;
+}
+
+void CGraphUT::testColorHess()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  const UInt n = 8;
+  const UInt ncolors[3] = {1, 2, 3};
+  ProblemPtr p;
+  VarVector v;
+  CGraphPtr cg;
+  CNodeVector kids;
+  CNode *n0, *n1;
+  DoubleVector hc, hv;
+  double x[n];
+  double mult = 0.0;
+  int error = 0;
+
+  for (UInt i=0; i<n; ++i) {
+    x[i] = 0.3 + 0.1*i;
+  }
+  for (UInt k=0; k<3; ++k) {
+    p = (ProblemPtr) new Problem(env);
+    v.clear();
+    for (UInt i=0; i<n; ++i) {
+      v.push_back(p->newVariable(-2.0, 2.0, Continuous));
+    }
+    cg = (CGraphPtr) new CGraph();
+    kids.clear();
+    if (0==k) {
+      // separable: sum of x_i*exp(x_i).
+      for (UInt i=0; i<n; ++i) {
+        n0 = cg->newNode(OpExp, cg->newNode(v[i]), 0);
+        kids.push_back(cg->newNode(OpMult, cg->newNode(v[i]), n0));
+      }
+      n0 = cg->newNode(OpSumList, &kids[0], kids.size());
+    } else if (1==k) {
+      // arrowhead: x_0 times the sum of exp(x_i), i>0.
+      for (UInt i=1; i<n; ++i) {
+        kids.push_back(cg->newNode(OpExp, cg->newNode(v[i]), 0));
+      }
+      n0 = cg->newNode(OpSumList, &kids[0], kids.size());
+      n0 = cg->newNode(OpMult, cg->newNode(v[0]), n0);
+    } else {
+      // banded: sum of (x_i*x_{i+1})^2.
+      for (UInt i=0; i+1<n; ++i) {
+        n1 = cg->newNode(OpMult, cg->newNode(v[i]), cg->newNode(v[i+1]));
+        kids.push_back(cg->newNode(OpSqr, n1, 0));
+      }
+      n0 = cg->newNode(OpSumList, &kids[0], kids.size());
+    }
+    cg->setOut(n0);
+    cg->finalize();
+    p->newObjective((FunctionPtr) new Function(cg), 0.0, Minimize);
+    p->setNativeDer();
+    p->prepareForSolve();
+
+    // one sweep per color.
+    hc.assign(p->getHessian()->getNumNz(), 0.0);
+    p->getHessian()->fillRowColValues(x, 1.0, &mult, &hc[0], &error);
+    CPPUNIT_ASSERT(0==error);
+    CPPUNIT_ASSERT(ncolors[k]+1==cg->hCEntB_.size());
+
+    // one sweep per variable.
+    cg->hCEntB_.clear();
+    hv.assign(hc.size(), 0.0);
+    p->getHessian()->fillRowColValues(x, 1.0, &mult, &hv[0], &error);
+    CPPUNIT_ASSERT(0==error);
+    CPPUNIT_ASSERT(true==cg->hCEntB_.empty());
+    for (UInt i=0; i<hc.size(); ++i) {
+      CPPUNIT_ASSERT(fabs(hc[i]-hv[i])<=1e-12*(1.0+fabs(hv[i])));
+    }
+    delete p;
+  }
+  delete env;
+}
+
+void CGraphUT::testDelVar()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  ProblemPtr p = (ProblemPtr) new Problem(env);
+  VariablePtr v0 = p->newVariable(0.0, 10.0, Continuous);
+  VariablePtr v1 = p->newVariable(0.0, 10.0, Continuous);
+  VariablePtr v2 = p->newVariable(0.0, 10.0, Continuous);
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  double x[2] = {2.0, 0.5};
+  double g[2] = {0.0, 0.0};
+  double h[2], mult = 1.0;
+  UInt irow[2], jcol[2];
+  int error = 0;
+  CNode *n0, *n1;
+
+  // x1*exp(x2)
+  n0 = cg->newNode(v1);
+  n1 = cg->newNode(v2);
+  n1 = cg->newNode(OpExp, n1, 0);
+  n0 = cg->newNode(OpMult, n0, n1);
+  cg->setOut(n0);
+  cg->finalize();
+  p->newConstraint((FunctionPtr) new Function(cg), -INFINITY, 10.0);
+
+  // deleting x0 renumbers x1 and x2 after the tape of cg is built.
+  p->markDelete(v0);
+  p->delMarkedVars();
+  CPPUNIT_ASSERT(0==v1->getIndex() && 1==v2->getIndex());
+
+  CPPUNIT_ASSERT(fabs(cg->eval(x, &error) - 2.0*exp(0.5))<1e-12);
+  cg->evalGradient(x, g, &error);
+  CPPUNIT_ASSERT(0==error);
+  CPPUNIT_ASSERT(fabs(g[0] - exp(0.5))<1e-12);
+  CPPUNIT_ASSERT(fabs(g[1] - 2.0*exp(0.5))<1e-12);
+
+  p->setNativeDer();
+  p->prepareForSolve();
+  CPPUNIT_ASSERT(2==p->getHessian()->getNumNz());
+  p->getHessian()->fillRowColIndices(irow, jcol);
+  p->getHessian()->fillRowColValues(x, 0.0, &mult, h, &error);
+  CPPUNIT_ASSERT(0==error);
+  for (UInt i=0; i<2; ++i) {
+    CPPUNIT_ASSERT(1==irow[i]);
+    if (0==jcol[i]) {
+      CPPUNIT_ASSERT(fabs(h[i] - exp(0.5))<1e-12);
+    } else {
+      CPPUNIT_ASSERT(fabs(h[i] - 2.0*exp(0.5))<1e-12);
+    }
+  }
+
+  delete p;
+  delete env;
+}
+
+
 void CGraphUT::testIdentical()
 {
   VariablePtr v0 = new Variable(0, 0, 0.0, 10.0, Continuous, "x0");
@@ -146,6 +468,253 @@ void CGraphUT::testQuad()
 }
 
 
+void CGraphUT::testRemoveVar()
+{
+  VariablePtr v0 = new Variable(0, 0, 0.0, 10.0, Continuous, "x0");
+  VariablePtr v1 = new Variable(1, 1, 0.0, 10.0, Continuous, "x1");
+  double x[2] = {3.0, 1.0};
+  double g[2] = {0.0, 0.0};
+  int error = 0;
+  CNode *n0, *n1, *n2;
+  CGraph cgraph;
+
+  // x0*x1 + exp(x1)
+  n0 = cgraph.newNode(v0);
+  n1 = cgraph.newNode(v1);
+  n2 = cgraph.newNode(OpMult, n0, n1);
+  n1 = cgraph.newNode(OpExp, n1, 0);
+  n0 = cgraph.newNode(OpPlus, n2, n1);
+  cgraph.setOut(n0);
+  cgraph.finalize();
+
+  CPPUNIT_ASSERT(fabs(cgraph.eval(x, &error) - 3.0 - exp(1.0))<1e-10);
+  CPPUNIT_ASSERT(0==error);
+
+  // fix x1 = 2. Evaluation must use the new constant.
+  cgraph.removeVar(v1, 2.0);
+  CPPUNIT_ASSERT(cgraph.numVars() == 1);
+  CPPUNIT_ASSERT(fabs(cgraph.eval(x, &error) - 6.0 - exp(2.0))<1e-10);
+  cgraph.evalGradient(x, g, &error);
+  CPPUNIT_ASSERT(0==error);
+  CPPUNIT_ASSERT(fabs(g[0]-2.0)<1e-10);
+  CPPUNIT_ASSERT(fabs(g[1])<1e-10);
+
+  delete v0;
+  delete v1;
+}
+
+
+void CGraphUT::testShare()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  ProblemPtr p[2];
+  CGraphPtr cg[2][3];
+  CGraphPtr sh;
+  double x[3] = {0.5, 1.5, -0.7};
+  double y[3] = {-1.2, 0.3, 2.0};
+  DoubleVector v0, v1;
+  int error = 0;
+
+  for (UInt k=0; k<2; ++k) {
+    env->getOptions()->findBool("nlp_share_subexpr")->setValue(1==k);
+    p[k] = shareProblem_(env);
+    p[k]->setNativeDer();
+    p[k]->prepareForSolve();
+    cg[k][0] = getCGraph_(p[k]->getConstraint(0)->getFunction());
+    cg[k][1] = getCGraph_(p[k]->getConstraint(1)->getFunction());
+    cg[k][2] = getCGraph_(p[k]->getObjective()->getFunction());
+  }
+
+  // all three graphs copy their values from one graph, in which the common
+  // subexpressions and the constants appear once.
+  sh = cg[1][0]->shared_;
+  CPPUNIT_ASSERT(sh);
+  for (UInt i=0; i<3; ++i) {
+    CPPUNIT_ASSERT(0==cg[0][i]->shared_);
+    CPPUNIT_ASSERT(sh==cg[1][i]->shared_);
+  }
+  CPPUNIT_ASSERT(3==sh->shGraphs_.size());
+  CPPUNIT_ASSERT(15==sh->getNumNodes());
+
+  // the same values and derivatives, also at a second point.
+  evalAll_(p[0], x, &v0);
+  evalAll_(p[1], x, &v1);
+  CPPUNIT_ASSERT(v0.size()==v1.size());
+  for (UInt i=0; i<v0.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(v0[i]-v1[i])<1e-12);
+  }
+  evalAll_(p[0], y, &v0);
+  evalAll_(p[1], y, &v1);
+  for (UInt i=0; i<v0.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(v0[i]-v1[i])<1e-12);
+  }
+
+  // values of the shared graph at y are not copied when evaluating at x.
+  CPPUNIT_ASSERT(fabs(cg[1][1]->eval(x, &error) -
+                      cg[0][1]->eval(x, &error))<1e-12);
+  CPPUNIT_ASSERT(0==error);
+
+  // a changed function stops copying, the others go on.
+  cg[0][1]->multiply(3.0);
+  cg[1][1]->multiply(3.0);
+  CPPUNIT_ASSERT(0==cg[1][1]->shared_);
+  CPPUNIT_ASSERT(sh==cg[1][0]->shared_ && sh==cg[1][2]->shared_);
+  CPPUNIT_ASSERT(2==sh->shGraphs_.size());
+  evalAll_(p[0], x, &v0);
+  evalAll_(p[1], x, &v1);
+  for (UInt i=0; i<v0.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(v0[i]-v1[i])<1e-12);
+  }
+
+  delete p[0];
+  delete p[1];
+  delete env;
+}
+
+
+void CGraphUT::testShareDelete()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  ProblemPtr p = shareProblem_(env);
+  std::vector<CGraphPtr> cgs;
+  CGraphPtr sh = (CGraphPtr) new CGraph();
+  double x[3] = {0.5, 1.5, -0.7};
+  double y[3] = {-1.2, 0.3, 2.0};
+  DoubleVector vx, vy, v;
+  int error = 0;
+
+  p->setNativeDer();
+  p->prepareForSolve();
+  evalAll_(p, x, &vx);
+  evalAll_(p, y, &vy);
+
+  cgs.push_back(getCGraph_(p->getConstraint(0)->getFunction()));
+  cgs.push_back(getCGraph_(p->getConstraint(1)->getFunction()));
+  cgs.push_back(getCGraph_(p->getObjective()->getFunction()));
+  sh->share(cgs);
+  sh->eval(x, &error);
+  CPPUNIT_ASSERT(0==error);
+  evalAll_(p, x, &v);
+  for (UInt i=0; i<v.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(v[i]-vx[i])<1e-12);
+  }
+
+  // the functions outlive the shared graph.
+  delete sh;
+  for (UInt i=0; i<cgs.size(); ++i) {
+    CPPUNIT_ASSERT(0==cgs[i]->shared_);
+  }
+  evalAll_(p, y, &v);
+  for (UInt i=0; i<v.size(); ++i) {
+    CPPUNIT_ASSERT(fabs(v[i]-vy[i])<1e-12);
+  }
+
+  delete p;
+  delete env;
+}
+
+
+ProblemPtr CGraphUT::cloneProblem_(EnvPtr env)
+{
+  ProblemPtr p = (ProblemPtr) new Problem(env);
+  VariablePtr v0 = p->newVariable(-2.0, 2.0, Continuous);
+  VariablePtr v1 = p->newVariable(-2.0, 2.0, Continuous);
+  VariablePtr v2 = p->newVariable(-2.0, 2.0, Continuous);
+  VariablePtr v3 = p->newVariable(-2.0, 2.0, Continuous);
+  CGraphPtr cg;
+  CNode *n0, *n1;
+
+  // x0*exp(x2) + x3^2
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpExp, cg->newNode(v2), 0);
+  n0 = cg->newNode(OpMult, cg->newNode(v0), n0);
+  n1 = cg->newNode(OpSqr, cg->newNode(v3), 0);
+  cg->setOut(cg->newNode(OpPlus, n0, n1));
+  cg->finalize();
+  p->newConstraint((FunctionPtr) new Function(cg), -INFINITY, 10.0);
+
+  // x1*x3 + exp(x0)
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpMult, cg->newNode(v1), cg->newNode(v3));
+  n1 = cg->newNode(OpExp, cg->newNode(v0), 0);
+  cg->setOut(cg->newNode(OpPlus, n0, n1));
+  cg->finalize();
+  p->newObjective((FunctionPtr) new Function(cg), 0.0, Minimize);
+
+  // the hessian sparsity is needed for cloning lazily.
+  p->setNativeDer();
+  p->prepareForSolve();
+  return p;
+}
+
+void CGraphUT::evalAll_(ProblemPtr p, const double *x, DoubleVector *vals)
+{
+  double mult[2] = {0.7, -1.3};
+  int error = 0;
+  UInt n;
+
+  // the jacobian and the hessian evaluate the shared graph, if any, before
+  // the functions.
+  vals->assign(p->getJacobian()->getNumNz(), 0.0);
+  p->getJacobian()->fillRowColValues(x, &(*vals)[0], &error);
+  n = vals->size();
+  vals->resize(n+p->getHessian()->getNumNz(), 0.0);
+  p->getHessian()->fillRowColValues(x, 0.5, mult, &(*vals)[n], &error);
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd(); ++it) {
+    vals->push_back((*it)->getActivity(x, &error));
+  }
+  vals->push_back(p->getObjValue(x, &error));
+  CPPUNIT_ASSERT(0==error);
+}
+
+
+CGraphPtr CGraphUT::getCGraph_(FunctionPtr f)
+{
+  return dynamic_cast<CGraphPtr>(f->getNonlinearFunction());
+}
+
+
+ProblemPtr CGraphUT::shareProblem_(EnvPtr env)
+{
+  ProblemPtr p = (ProblemPtr) new Problem(env);
+  VariablePtr v0 = p->newVariable(-2.0, 2.0, Continuous);
+  VariablePtr v1 = p->newVariable(-2.0, 2.0, Continuous);
+  VariablePtr v2 = p->newVariable(-2.0, 2.0, Continuous);
+  CGraphPtr cg;
+  CNode *n0, *n1, *n2;
+
+  // exp(x0*x1) + 2*x2
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpMult, cg->newNode(v0), cg->newNode(v1));
+  n0 = cg->newNode(OpExp, n0, 0);
+  n1 = cg->newNode(OpMult, cg->newNode(2.0), cg->newNode(v2));
+  cg->setOut(cg->newNode(OpPlus, n0, n1));
+  cg->finalize();
+  p->newConstraint((FunctionPtr) new Function(cg), -INFINITY, 10.0);
+
+  // exp(x1*x0)*x2 + x0*2
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpMult, cg->newNode(v1), cg->newNode(v0));
+  n0 = cg->newNode(OpExp, n0, 0);
+  n0 = cg->newNode(OpMult, n0, cg->newNode(v2));
+  n1 = cg->newNode(OpMult, cg->newNode(v0), cg->newNode(2.0));
+  cg->setOut(cg->newNode(OpPlus, n0, n1));
+  cg->finalize();
+  p->newConstraint((FunctionPtr) new Function(cg), -INFINITY, 10.0);
+
+  // 2*x1 + exp(x0*x1)^2
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpMult, cg->newNode(v0), cg->newNode(v1));
+  n0 = cg->newNode(OpExp, n0, 0);
+  n0 = cg->newNode(OpSqr, n0, 0);
+  n2 = cg->newNode(OpMult, cg->newNode(2.0), cg->newNode(v1));
+  cg->setOut(cg->newNode(OpPlus, n2, n0));
+  cg->finalize();
+  p->newObjective((FunctionPtr) new Function(cg), 0.0, Minimize);
+  return p;
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -14,6 +14,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <Types.h>
+#include "CGraph.h"
 using namespace Minotaur;
 
 class CGraphUT : public CppUnit::TestCase {
@@ -24,16 +25,50 @@ public:
 
   void setUp() { }      // need not implement
   void tearDown() { }   // need not implement
+  void testBatch();
+  void testCloneLazy();
+  void testCloneLazyChange();
+  void testCloneLazyDelete();
+  void testColorHess();
+  void testDelVar();
   void testIdentical();
   void testLin();
   void testQuad();
+  void testRemoveVar();
+  void testShare();
+  void testShareDelete();
 
   CPPUNIT_TEST_SUITE(CGraphUT);
+  CPPUNIT_TEST(testBatch);
+  CPPUNIT_TEST(testCloneLazy);
+  CPPUNIT_TEST(testCloneLazyChange);
+  CPPUNIT_TEST(testCloneLazyDelete);
+  CPPUNIT_TEST(testColorHess);
+  CPPUNIT_TEST(testDelVar);
   CPPUNIT_TEST(testIdentical);
   CPPUNIT_TEST(testLin);
   CPPUNIT_TEST(testQuad);
+  CPPUNIT_TEST(testRemoveVar);
+  CPPUNIT_TEST(testShare);
+  CPPUNIT_TEST(testShareDelete);
   CPPUNIT_TEST_SUITE_END();
 
+private:
+  // Return a problem with four variables and two nonlinear functions, ready
+  // to be cloned with lazy graphs.
+  ProblemPtr cloneProblem_(EnvPtr env);
+
+  // Fill vals with the activities of the constraints, the objective value,
+  // the jacobian and the hessian of the lagrangian of p at x.
+  void evalAll_(ProblemPtr p, const double *x, DoubleVector *vals);
+
+  // Return the graph of the nonlinear part of function f.
+  CGraphPtr getCGraph_(FunctionPtr f);
+
+  // Return a problem whose three nonlinear functions have common
+  // subexpressions, written with commutative children in different orders
+  // and with separate nodes for equal constants.
+  ProblemPtr shareProblem_(EnvPtr env);
 };
 
 #endif
@@ -0,0 +1,97 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#include <algorithm>
+
+#include "MinotaurConfig.h"
+#include "CoverCutGenerator.h"
+#include "CoverCutGeneratorUT.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CoverCutGeneratorUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CoverCutGeneratorUT,
+                                      "CoverCutGeneratorUT");
+
+using namespace Minotaur;
+
+void CoverCutGeneratorUT::testKnapsack()
+{
+  CoverCutGenerator ccg;
+  // max 10x1 + 7x2 + 6x3 + 3x4 s.t. 5x1 + 4x2 + 4x3 + 3x4 <= 9.
+  // Sorted by c/a already. Optimum is 17, x = (1,1,0,0).
+  double c[4] = {10, 7, 6, 3};
+  double a[4] = {5, 4, 4, 3};
+  int x[4];
+  double z = 0.0;
+
+  ccg.binaryKnapsackSolver(4, 9.0, c, a, z, x);
+  CPPUNIT_ASSERT(z == 17.0);
+  CPPUNIT_ASSERT(x[0]==1 && x[1]==1 && x[2]==0 && x[3]==0);
+
+  z = 0.0;
+  CPPUNIT_ASSERT(true == ccg.dpKnapsackSolver(4, 9.0, c, a, z));
+  CPPUNIT_ASSERT(z == 17.0);
+
+  // Fractional weights are left to the branch-and-bound solver.
+  a[2] = 3.5;
+  CPPUNIT_ASSERT(false == ccg.dpKnapsackSolver(4, 9.0, c, a, z));
+}
+
+
+void CoverCutGeneratorUT::testDpKnapsack()
+{
+  CoverCutGenerator ccg;
+  // Items with integral data, sorted by c/a.
+  std::vector<std::pair<double, double> > items;
+  DoubleVector c, a;
+  std::vector<int> x;
+  UInt seed = 1;
+  double z1, z2, suma;
+
+  // Both solvers must find the same optimal value.
+  for (UInt t=0; t<200; ++t) {
+    UInt n = 1 + t%12;
+    items.clear();
+    suma = 0.0;
+    for (UInt i=0; i<n; ++i) {
+      seed = seed*1103515245 + 12345;
+      double ci = 1 + (seed>>16)%20;
+      seed = seed*1103515245 + 12345;
+      double ai = 1 + (seed>>16)%30;
+      items.push_back(std::make_pair(ci, ai));
+      suma += ai;
+    }
+    std::sort(items.begin(), items.end(),
+              [](const std::pair<double, double> &p,
+                 const std::pair<double, double> &q)
+              { return p.first/p.second > q.first/q.second; });
+    c.resize(n);
+    a.resize(n);
+    x.resize(n);
+    for (UInt i=0; i<n; ++i) {
+      c[i] = items[i].first;
+      a[i] = items[i].second;
+    }
+    double b = (double) (t%(UInt) suma);
+
+    z1 = z2 = -1.0;
+    ccg.binaryKnapsackSolver(n, b, c.data(), a.data(), z1, x.data());
+    CPPUNIT_ASSERT(true == ccg.dpKnapsackSolver(n, b, c.data(), a.data(),
+                                                z2));
+    CPPUNIT_ASSERT(z1 == z2);
+  }
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
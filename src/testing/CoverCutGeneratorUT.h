@@ -0,0 +1,49 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#ifndef COVERCUTGENERATORUT_H
+#define COVERCUTGENERATORUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+// Test the knapsack solvers used for lifting cover cuts.
+class CoverCutGeneratorUT : public CppUnit::TestCase {
+  public:
+    CoverCutGeneratorUT(std::string name) : TestCase(name) {}
+    CoverCutGeneratorUT() {}
+
+    void setUp() {};
+    void tearDown() {};
+
+    CPPUNIT_TEST_SUITE(CoverCutGeneratorUT);
+    CPPUNIT_TEST(testKnapsack);
+    CPPUNIT_TEST(testDpKnapsack);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testKnapsack();
+    void testDpKnapsack();
+};
+
+#endif     // #define COVERCUTGENERATORUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,272 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Constraint.h"
+#include "CsrCutMan.h"
+#include "CsrCutManUT.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Problem.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CsrCutManUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CsrCutManUT, "CsrCutManUT");
+
+using namespace Minotaur;
+
+void CsrCutManUT::setUp()
+{
+  env_ = (EnvPtr) new Environment();
+  p_ = (ProblemPtr) new Problem(env_);
+  p_->newVariable(-10.0, 10.0, Continuous);
+  p_->newVariable(-10.0, 10.0, Continuous);
+  p_->newVariable(-10.0, 10.0, Continuous);
+}
+
+
+void CsrCutManUT::tearDown()
+{
+  delete p_;
+  delete env_;
+}
+
+
+FunctionPtr CsrCutManUT::f_(double a0, double a1, double a2)
+{
+  LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+
+  if (a0!=0.0) {
+    lf->addTerm(p_->getVariable(0), a0);
+  }
+  if (a1!=0.0) {
+    lf->addTerm(p_->getVariable(1), a1);
+  }
+  if (a2!=0.0) {
+    lf->addTerm(p_->getVariable(2), a2);
+  }
+  return (FunctionPtr) new Function(lf);
+}
+
+
+bool CsrCutManUT::hasCoeffs_(ConstraintPtr c, double a0, double a1,
+                             double a2)
+{
+  LinearFunctionPtr lf = c->getLinearFunction();
+  double a[3] = {a0, a1, a2};
+  UInt nnz = 0;
+
+  for (UInt j=0; j<3; ++j) {
+    if (fabs(lf->getWeight(p_->getVariable(j))-a[j]) > 1e-12) {
+      return false;
+    }
+    if (a[j]!=0.0) {
+      ++nnz;
+    }
+  }
+  return (nnz == lf->getNumTerms());
+}
+
+
+SolutionPtr CsrCutManUT::sol_(double x0, double x1, double x2)
+{
+  double x[3] = {x0, x1, x2};
+
+  return (SolutionPtr) new Solution(0.0, x, p_);
+}
+
+
+void CsrCutManUT::testDupInProblem()
+{
+  CsrCutMan cman(env_, p_);
+  ConstraintPtr c, c2;
+
+  // x0 + x1 <= 1 in the problem.
+  c = cman.addCut(p_, f_(1.0, 1.0, 0.0), -INFINITY, 1.0, true, false);
+  CPPUNIT_ASSERT(c && 1 == p_->getNumCons());
+
+  // a duplicate that is not tighter is dropped.
+  c2 = cman.addCut(p_, f_(2.0, 2.0, 0.0), -INFINITY, 2.0, true, false);
+  CPPUNIT_ASSERT(c2 == c && 1 == p_->getNumCons());
+  CPPUNIT_ASSERT(fabs(c->getUb()-1.0) < 1e-12);
+
+  // a tighter duplicate changes the bound of the existing cut.
+  c2 = cman.addCut(p_, f_(2.0, 2.0, 0.0), -INFINITY, 1.0, true, false);
+  CPPUNIT_ASSERT(c2 == c && 1 == p_->getNumCons());
+  CPPUNIT_ASSERT(fabs(c->getUb()-0.5) < 1e-12);
+  CPPUNIT_ASSERT(1 == cman.getNumCuts());
+}
+
+
+void CsrCutManUT::testDupInPool()
+{
+  CsrCutMan cman(env_, p_);
+  ConstraintPtr c;
+
+  // x0 - x2 >= 0 in the pool.
+  c = cman.addCut(p_, f_(1.0, 0.0, -1.0), 0.0, INFINITY, false, false);
+  CPPUNIT_ASSERT(!c && 0 == p_->getNumCons());
+  CPPUNIT_ASSERT(1 == cman.getNumDisabledCuts());
+
+  // a duplicate meant for the pool only tightens the row.
+  c = cman.addCut(p_, f_(1.0, 0.0, -1.0), 1.0, INFINITY, false, false);
+  CPPUNIT_ASSERT(!c && 1 == cman.getNumDisabledCuts());
+
+  // a duplicate meant for the problem moves the row to the problem.
+  c = cman.addCut(p_, f_(1.0, 0.0, -1.0), 0.0, INFINITY, true, false);
+  CPPUNIT_ASSERT(c && 1 == p_->getNumCons());
+  CPPUNIT_ASSERT(0 == cman.getNumDisabledCuts());
+  CPPUNIT_ASSERT(1 == cman.getNumEnabledCuts());
+  CPPUNIT_ASSERT(fabs(c->getLb()-1.0) < 1e-12);
+  CPPUNIT_ASSERT(2 == c->getLinearFunction()->getNumTerms());
+}
+
+
+void CsrCutManUT::testParallel()
+{
+  CsrCutMan cman(env_, p_);
+  ConstraintPtr c, c2, c3;
+
+  // within -10 <= x <= 10, x0 + x1 <= 1 does not imply
+  // x0 + 1.001x1 <= 1.001.
+  c = cman.addCut(p_, f_(1.0, 1.0, 0.0), -INFINITY, 1.0, true, false);
+  c2 = cman.addCut(p_, f_(1.0, 1.001, 0.0), -INFINITY, 1.001, true, false);
+  CPPUNIT_ASSERT(c && c2 && c != c2);
+  CPPUNIT_ASSERT(2 == p_->getNumCons());
+
+  // x0 + 0.999x1 <= 1.2 is implied by both and is dropped.
+  c3 = cman.addCut(p_, f_(1.0, 0.999, 0.0), -INFINITY, 1.2, true, false);
+  CPPUNIT_ASSERT(c3 == c || c3 == c2);
+  CPPUNIT_ASSERT(2 == p_->getNumCons());
+  CPPUNIT_ASSERT(2 == cman.getNumCuts());
+}
+
+
+void CsrCutManUT::testSeparate()
+{
+  CsrCutMan cman(env_, p_);
+  SolutionPtr sol = sol_(1.0, 1.0, 1.0);
+  bool separated = false;
+  UInt added = 0;
+
+  // x0 + x1 <= 1, x1 + x2 <= 3 and x0 - x2 >= 0.5 in the pool.
+  cman.addCut(p_, f_(1.0, 1.0, 0.0), -INFINITY, 1.0, false, false);
+  cman.addCut(p_, f_(0.0, 1.0, 1.0), -INFINITY, 3.0, false, false);
+  cman.addCut(p_, f_(1.0, 0.0, -1.0), 0.5, INFINITY, false, false);
+  CPPUNIT_ASSERT(3 == cman.getNumDisabledCuts());
+  CPPUNIT_ASSERT(0 == p_->getNumCons());
+
+  // (1, 1, 1) violates the first and the last row only.
+  cman.separate(p_, sol, &separated, &added);
+  CPPUNIT_ASSERT(true == separated && 2 == added);
+  CPPUNIT_ASSERT(2 == p_->getNumCons());
+  CPPUNIT_ASSERT(1 == cman.getNumDisabledCuts());
+  CPPUNIT_ASSERT(2 == cman.getNumEnabledCuts());
+  CPPUNIT_ASSERT(hasCoeffs_(p_->getConstraint(0), 1.0, 1.0, 0.0));
+  CPPUNIT_ASSERT(fabs(p_->getConstraint(0)->getUb()-1.0) < 1e-12);
+  CPPUNIT_ASSERT(hasCoeffs_(p_->getConstraint(1), 1.0, 0.0, -1.0));
+  CPPUNIT_ASSERT(fabs(p_->getConstraint(1)->getLb()-0.5) < 1e-12);
+
+  // nothing more is violated.
+  cman.separate(p_, sol, &separated, &added);
+  CPPUNIT_ASSERT(false == separated && 0 == added);
+  CPPUNIT_ASSERT(2 == p_->getNumCons());
+  delete sol;
+}
+
+
+void CsrCutManUT::testCompact()
+{
+  CsrCutMan cman(env_, p_);
+  SolutionPtr sol = sol_(0.0, 0.0, 0.0);
+  SolutionPtr sol2 = sol_(5.0, 5.0, -5.0);
+  UInt added = 0;
+
+  // four rows in the pool, the third may never be deleted.
+  cman.addCut(p_, f_(1.0, 1.0, 0.0), -INFINITY, 1.0, false, false);
+  cman.addCut(p_, f_(0.0, 2.0, 3.0), -INFINITY, 1.0, false, false);
+  cman.addCut(p_, f_(0.0, 1.0, -1.0), -INFINITY, 2.0, false, true);
+  cman.addCut(p_, f_(1.0, 0.0, 1.0), -1.0, INFINITY, false, false);
+
+  // the origin is feasible for all rows. Rows that are never violated are
+  // dropped once they are old enough.
+  for (UInt i=0; i<200; ++i) {
+    cman.separate(p_, sol, 0, &added);
+    CPPUNIT_ASSERT(0 == added);
+  }
+  CPPUNIT_ASSERT(1 == cman.getNumDisabledCuts());
+  CPPUNIT_ASSERT(0 == p_->getNumCons());
+
+  // the row that is left is intact after the others were removed.
+  cman.separate(p_, sol2, 0, &added);
+  CPPUNIT_ASSERT(1 == added && 1 == p_->getNumCons());
+  CPPUNIT_ASSERT(hasCoeffs_(p_->getConstraint(0), 0.0, 1.0, -1.0));
+  CPPUNIT_ASSERT(fabs(p_->getConstraint(0)->getUb()-2.0) < 1e-12);
+  CPPUNIT_ASSERT(0 == cman.getNumDisabledCuts());
+
+  // a row that is dropped is not found as a duplicate anymore.
+  CPPUNIT_ASSERT(cman.addCut(p_, f_(1.0, 1.0, 0.0), -INFINITY, 1.0, true,
+                             false));
+  CPPUNIT_ASSERT(2 == p_->getNumCons());
+  delete sol2;
+  delete sol;
+}
+
+
+void CsrCutManUT::testUpdateRel()
+{
+  CsrCutMan cman(env_, p_);
+  SolutionPtr sol, sol2;
+  ConstraintPtr c;
+  double y[2] = {0.0, 1.0};
+  UInt added = 0;
+
+  // x0 + x1 <= 1 and x0 - x2 <= 1 in the problem. The second one is
+  // always active.
+  c = cman.addCut(p_, f_(1.0, 1.0, 0.0), -INFINITY, 1.0, true, false);
+  cman.addCut(p_, f_(1.0, 0.0, -1.0), -INFINITY, 1.0, true, false);
+  CPPUNIT_ASSERT(c && 2 == p_->getNumCons());
+  sol = sol_(0.0, 0.0, 0.0);
+  sol->setDualOfCons(y);
+
+  // the first cut is moved to the pool after being inactive for long.
+  for (UInt i=0; i<20 && 2 == p_->getNumCons(); ++i) {
+    cman.updateRel(sol, p_);
+  }
+  CPPUNIT_ASSERT(1 == p_->getNumCons());
+  CPPUNIT_ASSERT(1 == cman.getNumEnabledCuts());
+  CPPUNIT_ASSERT(1 == cman.getNumDisabledCuts());
+  CPPUNIT_ASSERT(hasCoeffs_(p_->getConstraint(0), 1.0, 0.0, -1.0));
+
+  // the row is still known: a duplicate meant for the pool is dropped.
+  CPPUNIT_ASSERT(0 == cman.addCut(p_, f_(2.0, 2.0, 0.0), -INFINITY, 2.0,
+                                  false, false));
+  CPPUNIT_ASSERT(1 == cman.getNumDisabledCuts());
+
+  // and it comes back to the problem unchanged when it is violated.
+  sol2 = sol_(5.0, 5.0, 0.0);
+  cman.separate(p_, sol2, 0, &added);
+  CPPUNIT_ASSERT(1 == added && 2 == p_->getNumCons());
+  CPPUNIT_ASSERT(hasCoeffs_(p_->getConstraint(1), 1.0, 1.0, 0.0));
+  CPPUNIT_ASSERT(fabs(p_->getConstraint(1)->getUb()-1.0) < 1e-12);
+  CPPUNIT_ASSERT(0 == cman.getNumDisabledCuts());
+  delete sol2;
+  delete sol;
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,71 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#ifndef CSRCUTMANUT_H
+#define CSRCUTMANUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Solution.h"
+#include "Types.h"
+
+using namespace Minotaur;
+
+// Test the cut manager that keeps its pool in a sparse matrix.
+class CsrCutManUT : public CppUnit::TestCase {
+  public:
+    CsrCutManUT(std::string name) : TestCase(name) {}
+    CsrCutManUT() {}
+
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(CsrCutManUT);
+    CPPUNIT_TEST(testDupInProblem);
+    CPPUNIT_TEST(testDupInPool);
+    CPPUNIT_TEST(testParallel);
+    CPPUNIT_TEST(testSeparate);
+    CPPUNIT_TEST(testCompact);
+    CPPUNIT_TEST(testUpdateRel);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testDupInProblem();
+    void testDupInPool();
+    void testParallel();
+    void testSeparate();
+    void testCompact();
+    void testUpdateRel();
+
+  private:
+    EnvPtr env_;
+    ProblemPtr p_;
+
+    // Return a new function a0*x0 + a1*x1 + a2*x2.
+    FunctionPtr f_(double a0, double a1, double a2);
+
+    // Return true if the linear function of c is a0*x0 + a1*x1 + a2*x2.
+    bool hasCoeffs_(ConstraintPtr c, double a0, double a1, double a2);
+
+    // Return a new solution of p_ at (x0, x1, x2).
+    SolutionPtr sol_(double x0, double x1, double x2);
+};
+
+#endif     // #define CSRCUTMANUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,180 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "CutHash.h"
+#include "CutHashUT.h"
+#include "Environment.h"
+#include "LinearFunction.h"
+#include "Problem.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CutHashUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CutHashUT, "CutHashUT");
+
+using namespace Minotaur;
+
+void CutHashUT::setUp()
+{
+  env_ = (EnvPtr) new Environment();
+  p_ = (ProblemPtr) new Problem(env_);
+  p_->newVariable(-10.0, 10.0, Continuous);
+  p_->newVariable(-10.0, 10.0, Continuous);
+  p_->newVariable(-10.0, 10.0, Continuous);
+}
+
+
+void CutHashUT::tearDown()
+{
+  delete p_;
+  delete env_;
+}
+
+
+LinearFunctionPtr CutHashUT::lf_(double a0, double a1, double a2)
+{
+  LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+
+  if (a0!=0.0) {
+    lf->addTerm(p_->getVariable(0), a0);
+  }
+  if (a1!=0.0) {
+    lf->addTerm(p_->getVariable(1), a1);
+  }
+  if (a2!=0.0) {
+    lf->addTerm(p_->getVariable(2), a2);
+  }
+  return lf;
+}
+
+
+void CutHashUT::testDuplicate()
+{
+  CutHash hash(1e-4);
+  CutHashMatch match;
+  LinearFunctionPtr lf = lf_(1.0, 1.0, 0.0);
+  LinearFunctionPtr lf2 = lf_(2.0, 2.0, 0.0);
+  LinearFunctionPtr lf3 = lf_(-1.0, -1.0, 0.0);
+  UInt id;
+
+  // x0 + x1 <= 1
+  id = hash.insert(lf, -INFINITY, 1.0);
+  CPPUNIT_ASSERT(1 == hash.getNumCuts());
+
+  // 2x0 + 2x1 <= 2 and -x0 - x1 >= -2 are not tighter.
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf2, -INFINITY, 2.0, &match));
+  CPPUNIT_ASSERT(id == match.id && false == match.tighter);
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf3, -2.0, INFINITY, &match));
+  CPPUNIT_ASSERT(false == match.tighter);
+
+  // 2x0 + 2x1 <= 1 is tighter. The stored cut becomes x0 + x1 <= 0.5.
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf2, -INFINITY, 1.0, &match));
+  CPPUNIT_ASSERT(id == match.id && true == match.tighter);
+  CPPUNIT_ASSERT(true == match.isUb && fabs(match.bnd-0.5) < 1e-12);
+  hash.tighten(match);
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf, -INFINITY, 0.7, &match));
+  CPPUNIT_ASSERT(false == match.tighter);
+
+  // Cuts with two finite bounds are never matched.
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf, 0.0, 1.0, &match));
+
+  delete lf;
+  delete lf2;
+  delete lf3;
+}
+
+
+void CutHashUT::testParallel()
+{
+  CutHash hash(1e-4);
+  CutHashMatch match;
+  LinearFunctionPtr lf = lf_(1.0, 1.0, 0.0);
+  LinearFunctionPtr lf2 = lf_(1.0, 1.001, 0.0);
+  LinearFunctionPtr lf3 = lf_(1.0, 2.0, 0.0);
+  UInt id;
+
+  // without bounds on the variables no nearly parallel cut is implied.
+  id = hash.insert(lf, -INFINITY, 1.0);
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf2, -INFINITY, 1.2, &match));
+
+  // within -10 <= x <= 10, x0 + x1 <= 1 implies x0 + 1.001x1 <= 1.2 but
+  // not x0 + 1.001x1 <= 1.01.
+  hash.setVarBounds(p_);
+  CPPUNIT_ASSERT(CutHashParallel == hash.find(lf2, -INFINITY, 1.2, &match));
+  CPPUNIT_ASSERT(id == match.id && false == match.tighter);
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf2, -INFINITY, 1.01, &match));
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf2, -INFINITY, 0.5, &match));
+
+  // a cut that is not nearly parallel is never implied.
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf3, -INFINITY, 100.0, &match));
+
+  // with a variable that is not bounded, the cut is not implied.
+  p_->changeBound(p_->getVariable(1), Upper, INFINITY);
+  hash.setVarBounds(p_);
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf2, -INFINITY, 1.2, &match));
+
+  delete lf;
+  delete lf2;
+  delete lf3;
+}
+
+
+void CutHashUT::testPreferDuplicate()
+{
+  CutHash hash(1e-4);
+  CutHashMatch match;
+  LinearFunctionPtr lf = lf_(1.0, 1.0, 0.0);
+  LinearFunctionPtr lf2 = lf_(1.0, 1.001, 0.0);
+  UInt id;
+
+  // a tight nearly parallel cut and a loose duplicate are stored. The
+  // duplicate is found.
+  hash.insert(lf2, -INFINITY, -1.0);
+  id = hash.insert(lf, -INFINITY, 5.0);
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf, -INFINITY, 1.0, &match));
+  CPPUNIT_ASSERT(id == match.id && true == match.tighter);
+
+  delete lf;
+  delete lf2;
+}
+
+
+void CutHashUT::testRemove()
+{
+  CutHash hash(1e-4);
+  CutHashMatch match;
+  LinearFunctionPtr lf = lf_(1.0, 0.0, -3.0);
+  LinearFunctionPtr lf2 = lf_(0.0, 1.0, 1.0);
+  UInt id, id2;
+
+  id = hash.insert(lf, -INFINITY, 2.0);
+  hash.insert(lf2, 1.0, INFINITY);
+  hash.remove(id);
+  CPPUNIT_ASSERT(1 == hash.getNumCuts());
+  CPPUNIT_ASSERT(CutHashNew == hash.find(lf, -INFINITY, 2.0, &match));
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf2, 2.0, INFINITY, &match));
+
+  // the id of a removed cut is reused.
+  id2 = hash.insert(lf, -INFINITY, 2.0);
+  CPPUNIT_ASSERT(id == id2);
+  CPPUNIT_ASSERT(CutHashDuplicate == hash.find(lf, -INFINITY, 3.0, &match));
+  CPPUNIT_ASSERT(id == match.id);
+
+  delete lf;
+  delete lf2;
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
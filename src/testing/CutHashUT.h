@@ -0,0 +1,60 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#ifndef CUTHASHUT_H
+#define CUTHASHUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+// Test finding duplicate and nearly parallel cuts.
+class CutHashUT : public CppUnit::TestCase {
+  public:
+    CutHashUT(std::string name) : TestCase(name) {}
+    CutHashUT() {}
+
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(CutHashUT);
+    CPPUNIT_TEST(testDuplicate);
+    CPPUNIT_TEST(testParallel);
+    CPPUNIT_TEST(testPreferDuplicate);
+    CPPUNIT_TEST(testRemove);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testDuplicate();
+    void testParallel();
+    void testPreferDuplicate();
+    void testRemove();
+
+  private:
+    EnvPtr env_;
+    ProblemPtr p_;
+
+    // Return a new linear function a0*x0 + a1*x1 + a2*x2.
+    LinearFunctionPtr lf_(double a0, double a1, double a2);
+};
+
+#endif     // #define CUTHASHUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
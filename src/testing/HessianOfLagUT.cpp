@@ -86,12 +86,8 @@ void HessianOfLagUT::testLinearEval()
 }
  
  
-void HessianOfLagUT::testQuadEval()
+void HessianOfLagUT::addQuads_()
 {
-  HessianOfLagPtr hess;
-  int error = 0;
-  double mults[] = {1.0, 1.0, 4.0, 7.0, -1.0};
-
   // add quadratics to instance
   // x_2^2 + 2x_3^2 <= 10
   // x_3^2 + 8x_3 + x_4_x_5 <= 10
@@ -119,7 +115,16 @@ void HessianOfLagUT::testQuadEval()
   lf_->addTerm(vars_[1], 1.0);
   f_ = (FunctionPtr) new Function(lf_, qf_);
   instance_->newConstraint(f_, -INFINITY, 10.0, "cons4");
+}
+
+
+void HessianOfLagUT::testQuadEval()
+{
+  HessianOfLagPtr hess;
+  int error = 0;
+  double mults[] = {1.0, 1.0, 4.0, 7.0, -1.0};
 
+  addQuads_();
   instance_->setNativeDer();
 
   // test size
@@ -173,6 +178,30 @@ void HessianOfLagUT::testQuadEval()
 }
 
 
+void HessianOfLagUT::testThreads()
+{
+  HessianOfLagPtr hess;
+  int error = 0;
+  double mults[] = {1.0, 0.0, 4.0, 7.0, -1.0};
+  double x[] = {0.0, 1.0, 2.0, -3.0, -3.0, 10.0};
+  double values[6], pvalues[6];
+
+  addQuads_();
+  instance_->setNativeDer();
+  hess = instance_->getHessian();
+  hess->fillRowColValues(x, 1, mults, values, &error);
+  CPPUNIT_ASSERT(0==error);
+
+  hess->setNumThreads(3);
+  std::fill(&pvalues[0], &pvalues[0]+6, -1.0);
+  hess->fillRowColValues(x, 1, mults, pvalues, &error);
+  CPPUNIT_ASSERT(0==error);
+  for (UInt i=0; i<6; ++i) {
+    CPPUNIT_ASSERT(values[i] == pvalues[i]);
+  }
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -38,11 +38,13 @@ class HessianOfLagUT : public CppUnit::TestCase {
     CPPUNIT_TEST(testEmpty);
     CPPUNIT_TEST(testLinearEval);
     CPPUNIT_TEST(testQuadEval);
+    CPPUNIT_TEST(testThreads);
     CPPUNIT_TEST_SUITE_END();
 
     void testEmpty();
     void testLinearEval();
     void testQuadEval();
+    void testThreads();
 
   private:
     EnvPtr env_;
@@ -52,6 +54,8 @@ class HessianOfLagUT : public CppUnit::TestCase {
     std::vector<ConstraintPtr> cons_;
     std::vector<VariablePtr> vars_;
     FunctionPtr f_;
+
+    void addQuads_();
 };
 
 #endif
@@ -0,0 +1,187 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Engine.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "NLPMultiStart.h"
+#include "NLPMultiStartUT.h"
+#include "Objective.h"
+#include "Option.h"
+#include "Problem.h"
+#include "QuadraticFunction.h"
+#include "Solution.h"
+#include "SolutionPool.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NLPMultiStartUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(NLPMultiStartUT, "NLPMultiStartUT");
+
+using namespace Minotaur;
+
+void NLPMultiStartUT::setUp()
+{
+  LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+  QuadraticFunctionPtr qf = (QuadraticFunctionPtr) new QuadraticFunction();
+  VariablePtr x0, x1;
+  int err = 0;
+
+  env_ = (EnvPtr) new Environment();
+  env_->startTimer(err);
+  p_ = (ProblemPtr) new Problem(env_);
+  x0 = p_->newVariable(-1.0, 1.0, Continuous);
+  x1 = p_->newVariable(-1.0, 1.0, Continuous);
+
+  // min -x0^2 + 0.6x0 - x1^2 - 0.4x1 has a local minimum at each of the
+  // four vertices of the box and the global minimum -3 at (-1, 1).
+  qf->addTerm(x0, x0, -1.0);
+  qf->addTerm(x1, x1, -1.0);
+  lf->addTerm(x0, 0.6);
+  lf->addTerm(x1, -0.4);
+  p_->newObjective((FunctionPtr) new Function(lf, qf), 0.0, Minimize);
+  p_->prepareForSolve();
+}
+
+
+void NLPMultiStartUT::tearDown()
+{
+  delete p_;
+  delete env_;
+}
+
+
+double NLPMultiStartUT::solve_(UInt samples, UInt threads,
+                               MSHeurStats *stats)
+{
+  SolutionPoolPtr pool = (SolutionPoolPtr) new SolutionPool(env_, p_, 10);
+  EnginePtr e = (EnginePtr) new myMSEngine();
+  NLPMSPtr ms;
+  double best = INFINITY;
+
+  env_->getOptions()->findInt("msheur_samples")->setValue(samples);
+  env_->getOptions()->findInt("msheur_threads")->setValue(threads);
+  env_->getOptions()->findDouble("heur_time_limit")->setValue(1e20);
+  ms = (NLPMSPtr) new NLPMultiStart(env_, p_, e);
+  ms->solve(NodePtr(), RelaxationPtr(), pool);
+  *stats = *(ms->getStats());
+  if (pool->getBestSolution()) {
+    best = pool->getBestSolution()->getObjValue();
+  }
+
+  delete ms;
+  delete e;
+  delete pool;
+  return best;
+}
+
+
+void NLPMultiStartUT::testGlobal()
+{
+  MSHeurStats stats;
+  double best = solve_(20, 1, &stats);
+
+  CPPUNIT_ASSERT(fabs(best+3.0) < 1e-6);
+  CPPUNIT_ASSERT(fabs(stats.bestObjValue+3.0) < 1e-6);
+  CPPUNIT_ASSERT(stats.numMinima >= 1 && stats.numMinima <= 4);
+  CPPUNIT_ASSERT(stats.numNLPs >= stats.numMinima);
+  CPPUNIT_ASSERT(stats.numSamples == 20*stats.iterations);
+}
+
+
+void NLPMultiStartUT::testCriticalDistance()
+{
+  MSHeurStats stats;
+
+  solve_(20, 1, &stats);
+
+  // without the critical distance, an NLP would be started from each of
+  // the best tenth of the points sampled in the last round alone.
+  CPPUNIT_ASSERT(stats.iterations > 1);
+  CPPUNIT_ASSERT(stats.numNLPs < ceil(0.1*stats.numSamples));
+
+  // the runs are repeatable.
+  MSHeurStats stats2;
+  solve_(20, 1, &stats2);
+  CPPUNIT_ASSERT(stats2.numNLPs == stats.numNLPs);
+  CPPUNIT_ASSERT(stats2.numMinima == stats.numMinima);
+}
+
+
+void NLPMultiStartUT::testThreads()
+{
+  MSHeurStats stats;
+  double best = solve_(20, 2, &stats);
+
+  CPPUNIT_ASSERT(fabs(best+3.0) < 1e-6);
+  CPPUNIT_ASSERT(stats.numMinima >= 1 && stats.numMinima <= 4);
+}
+
+
+myMSEngine::myMSEngine()
+  : p_(0),
+    sol_(0),
+    status_(EngineUnknownStatus)
+{
+}
+
+
+myMSEngine::~myMSEngine()
+{
+  if (sol_) {
+    delete sol_;
+  }
+}
+
+
+double myMSEngine::getSolutionValue()
+{
+  return sol_ ? sol_->getObjValue() : INFINITY;
+}
+
+
+EngineStatus myMSEngine::solve()
+{
+  UInt n = p_->getNumVars();
+  DoubleVector x(n), g(n);
+  VariablePtr v;
+  double obj;
+  int err = 0;
+
+  for (UInt j=0; j<n; ++j) {
+    x[j] = p_->getVariable(j)->getInitVal();
+  }
+  for (UInt k=0; k<200 && 0==err; ++k) {
+    std::fill(g.begin(), g.end(), 0.0);
+    p_->getObjective()->evalGradient(&x[0], &g[0], &err);
+    for (UInt j=0; j<n; ++j) {
+      v = p_->getVariable(j);
+      x[j] = std::max(v->getLb(), std::min(v->getUb(), x[j]-0.1*g[j]));
+    }
+  }
+  obj = p_->getObjective()->eval(&x[0], &err);
+  if (sol_) {
+    delete sol_;
+  }
+  sol_ = (SolutionPtr) new Solution(obj, &x[0], p_);
+  status_ = (0==err) ? ProvenLocalOptimal : EngineError;
+  return status_;
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,106 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#ifndef NLPMULTISTARTUT_H
+#define NLPMULTISTARTUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Engine.h"
+#include "NLPMultiStart.h"
+#include "Solution.h"
+
+using namespace Minotaur;
+
+// Test the MLSL starting points of the multistart heuristic.
+class NLPMultiStartUT : public CppUnit::TestCase {
+  public:
+    NLPMultiStartUT(std::string name) : TestCase(name) {}
+    NLPMultiStartUT() {}
+
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(NLPMultiStartUT);
+    CPPUNIT_TEST(testGlobal);
+    CPPUNIT_TEST(testCriticalDistance);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testGlobal();
+    void testCriticalDistance();
+    void testThreads();
+
+  private:
+    EnvPtr env_;
+    ProblemPtr p_;
+
+    // Run MLSL with the given number of samples per round and threads.
+    // Return the best objective value in the pool.
+    double solve_(UInt samples, UInt threads, MSHeurStats *stats);
+};
+
+// ------------------------------------------------------------------------- //
+// ------------------------------------------------------------------------- //
+// engine that finds a local minimum of a box constrained problem by
+// projected gradient descent from the initial point of the problem.
+class myMSEngine : public Engine {
+  public:
+    myMSEngine();
+    ~myMSEngine();
+
+    void addConstraint(ConstraintPtr) {};
+    void changeBound(ConstraintPtr, BoundType, double) {};
+    void changeBound(VariablePtr, BoundType, double) {};
+    void changeBound(VariablePtr, double, double) {};
+    void changeConstraint(ConstraintPtr, LinearFunctionPtr, double,
+                          double) {};
+    void changeConstraint(ConstraintPtr, NonlinearFunctionPtr) {};
+    void changeObj(FunctionPtr, double) {};
+    void clear() {p_ = 0;};
+    void disableStrBrSetup() {};
+    EnginePtr emptyCopy() {return (EnginePtr) new myMSEngine();};
+    void enableStrBrSetup() {};
+    std::string getName() const {return "myMSEngine";};
+    ConstSolutionPtr getSolution() {return sol_;};
+    double getSolutionValue();
+    EngineStatus getStatus() {return status_;};
+    ConstWarmStartPtr getWarmStart() {return ConstWarmStartPtr();};
+    WarmStartPtr getWarmStartCopy() {return WarmStartPtr();};
+    void load(ProblemPtr p) {p_ = p;};
+    void loadFromWarmStart(const WarmStartPtr) {};
+    void negateObj() {};
+    void removeCons(std::vector<ConstraintPtr> &) {};
+    void resetIterationLimit() {};
+    int setDualObjLimit(double) {return 0;};
+    void setIterationLimit(int) {};
+    EngineStatus solve();
+    void writeStats(std::ostream &) const {};
+
+  private:
+    ProblemPtr p_;
+    SolutionPtr sol_;
+    EngineStatus status_;
+};
+
+typedef myMSEngine* myMSEnginePtr;
+
+#endif     // #define NLPMULTISTARTUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
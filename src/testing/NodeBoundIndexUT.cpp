@@ -0,0 +1,188 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Node.h"
+#include "NodeBoundIndex.h"
+#include "NodeBoundIndexUT.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NodeBoundIndexUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(NodeBoundIndexUT, "NodeBoundIndexUT");
+
+using namespace Minotaur;
+
+void NodeBoundIndexUT::setUp()
+{
+  NodePtr node;
+
+  // 300 nodes with bounds that are not in the order of their ids.
+  for (UInt i=0; i<300; ++i) {
+    node = (NodePtr) new Node();
+    node->setId(i);
+    node->setLb((double) ((i*37)%101));
+    nodes_.push_back(node);
+  }
+}
+
+
+void NodeBoundIndexUT::tearDown()
+{
+  for (UInt i=0; i<nodes_.size(); ++i) {
+    delete nodes_[i];
+  }
+  nodes_.clear();
+}
+
+
+double NodeBoundIndexUT::bestLb_(const BoolVector &live)
+{
+  double lb = INFINITY;
+
+  for (UInt i=0; i<live.size(); ++i) {
+    if (live[i] && nodes_[i]->getLb()<lb) {
+      lb = nodes_[i]->getLb();
+    }
+  }
+  return lb;
+}
+
+
+void NodeBoundIndexUT::testEmpty()
+{
+  NodeBoundIndex lbs;
+
+  CPPUNIT_ASSERT(INFINITY==lbs.getBestLB());
+  lbs.add(nodes_[3]);
+  CPPUNIT_ASSERT(nodes_[3]->getLb()==lbs.getBestLB());
+  lbs.remove(nodes_[3]);
+  CPPUNIT_ASSERT(INFINITY==lbs.getBestLB());
+  lbs.add(nodes_[4]);
+  lbs.add(nodes_[5]);
+  lbs.clear();
+  CPPUNIT_ASSERT(INFINITY==lbs.getBestLB());
+}
+
+
+void NodeBoundIndexUT::testPushPop()
+{
+  NodeBoundIndex lbs;
+  BoolVector live(nodes_.size(), false);
+  UInt n = 0;
+
+  // use it like a stack of nodes: push two, pop one.
+  for (UInt k=0; k<100; ++k) {
+    for (UInt j=0; j<2; ++j, ++n) {
+      lbs.add(nodes_[n]);
+      live[n] = true;
+      CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+    }
+    lbs.remove(nodes_[n-1]);
+    live[n-1] = false;
+    CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+  }
+
+  // then pop all of them.
+  for (UInt i=n; i>0; --i) {
+    if (live[i-1]) {
+      lbs.remove(nodes_[i-1]);
+      live[i-1] = false;
+      CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+    }
+  }
+  CPPUNIT_ASSERT(INFINITY==lbs.getBestLB());
+}
+
+
+void NodeBoundIndexUT::testRemoveAny()
+{
+  NodeBoundIndex lbs;
+  BoolVector live(nodes_.size(), true);
+  UInt i;
+
+  for (i=0; i<nodes_.size(); ++i) {
+    lbs.add(nodes_[i]);
+  }
+  CPPUNIT_ASSERT(0.0==lbs.getBestLB());
+
+  // remove the nodes in an order unrelated to their bounds. Most removed
+  // nodes are not at the top of the heap and stay as stale entries until
+  // they reach the top or there are too many of them.
+  for (UInt k=0; k<nodes_.size(); ++k) {
+    i = (k*149+11)%nodes_.size();
+    lbs.remove(nodes_[i]);
+    live[i] = false;
+    CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+
+    // add some of the nodes again.
+    if (k%7==0 && k>0) {
+      i = ((k-7)*149+11)%nodes_.size();
+      lbs.add(nodes_[i]);
+      live[i] = true;
+      CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+    }
+  }
+  for (i=0; i<nodes_.size(); ++i) {
+    if (live[i]) {
+      lbs.remove(nodes_[i]);
+      live[i] = false;
+      CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+    }
+  }
+  CPPUNIT_ASSERT(INFINITY==lbs.getBestLB());
+}
+
+
+void NodeBoundIndexUT::testUpdateLb()
+{
+  NodeBoundIndex lbs;
+  BoolVector live(nodes_.size(), false);
+
+  for (UInt i=0; i<10; ++i) {
+    lbs.add(nodes_[i]);
+    live[i] = true;
+  }
+  CPPUNIT_ASSERT(0.0==lbs.getBestLB());
+
+  // the bound of a node is read when it is added. To update it, the node
+  // is removed and added again.
+  nodes_[0]->setLb(200.0);
+  CPPUNIT_ASSERT(0.0==lbs.getBestLB());
+  lbs.remove(nodes_[0]);
+  lbs.add(nodes_[0]);
+  CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+
+  // the same for a node that is not at the top of the heap.
+  nodes_[2]->setLb(300.0);
+  lbs.remove(nodes_[2]);
+  lbs.add(nodes_[2]);
+  CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+  for (UInt i=1; i<10; ++i) {
+    if (i!=2) {
+      lbs.remove(nodes_[i]);
+      live[i] = false;
+      CPPUNIT_ASSERT(bestLb_(live)==lbs.getBestLB());
+    }
+  }
+  CPPUNIT_ASSERT(200.0==lbs.getBestLB());
+  lbs.remove(nodes_[0]);
+  CPPUNIT_ASSERT(300.0==lbs.getBestLB());
+  lbs.remove(nodes_[2]);
+  CPPUNIT_ASSERT(INFINITY==lbs.getBestLB());
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,59 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#ifndef NODEBOUNDINDEXUT_H
+#define NODEBOUNDINDEXUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+// Test finding the best lower bound of active nodes.
+class NodeBoundIndexUT : public CppUnit::TestCase {
+  public:
+    NodeBoundIndexUT(std::string name) : TestCase(name) {}
+    NodeBoundIndexUT() {}
+
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(NodeBoundIndexUT);
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST(testPushPop);
+    CPPUNIT_TEST(testRemoveAny);
+    CPPUNIT_TEST(testUpdateLb);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testEmpty();
+    void testPushPop();
+    void testRemoveAny();
+    void testUpdateLb();
+
+  private:
+    NodePtrVector nodes_;
+
+    // Return the smallest lower bound of the nodes i with live[i] true.
+    double bestLb_(const BoolVector &live);
+};
+
+#endif     // #define NODEBOUNDINDEXUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,127 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#include <vector>
+
+#include "MinotaurConfig.h"
+#include "SpillFile.h"
+#include "SpillFileUT.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SpillFileUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SpillFileUT, "SpillFileUT");
+
+using namespace Minotaur;
+
+void SpillFileUT::setUp()
+{
+  f_ = (SpillFilePtr) new SpillFile("/tmp");
+}
+
+
+void SpillFileUT::tearDown()
+{
+  delete f_;
+}
+
+
+size_t SpillFileUT::write_(size_t n, char c)
+{
+  std::vector<char> buf(n, c);
+  size_t at = 0;
+
+  CPPUNIT_ASSERT(f_->write(n>0 ? &buf[0] : 0, n, &at));
+  return at;
+}
+
+
+void SpillFileUT::check_(size_t at, size_t n, char c)
+{
+  std::vector<char> buf;
+
+  f_->read(at, buf);
+  CPPUNIT_ASSERT(buf.size()==n);
+  for (UInt i=0; i<n; ++i) {
+    CPPUNIT_ASSERT(buf[i]==c);
+  }
+}
+
+
+void SpillFileUT::testWriteRead()
+{
+  size_t a, b, c;
+
+  a = write_(100, 'a');
+  b = write_(0, 'b');
+  c = write_(5000, 'c');
+  CPPUNIT_ASSERT(a!=b && b!=c && a!=c);
+  CPPUNIT_ASSERT(f_->getBytes()==5100);
+  check_(a, 100, 'a');
+  check_(b, 0, 'b');
+  check_(c, 5000, 'c');
+}
+
+
+void SpillFileUT::testReuse()
+{
+  size_t a, b, c, d, e;
+
+  a = write_(100, 'a');
+  b = write_(200, 'b');
+  c = write_(100, 'c');
+
+  // the space of a released record is used for a record of the same size.
+  f_->release(a);
+  d = write_(200, 'd');
+  CPPUNIT_ASSERT(d!=a);
+  e = write_(90, 'e');
+  CPPUNIT_ASSERT(e==a);
+
+  // a record of a different size does not overwrite the others.
+  f_->release(b);
+  check_(c, 100, 'c');
+  check_(d, 200, 'd');
+  check_(e, 90, 'e');
+  b = write_(150, 'b');
+  check_(b, 150, 'b');
+  check_(c, 100, 'c');
+  check_(e, 90, 'e');
+  CPPUNIT_ASSERT(f_->getBytes()==540);
+
+  // the space of the last record is used again, for a larger record.
+  f_->release(d);
+  a = write_(3000, 'a');
+  CPPUNIT_ASSERT(a==d);
+  check_(a, 3000, 'a');
+  check_(b, 150, 'b');
+}
+
+
+void SpillFileUT::testReleaseAll()
+{
+  size_t a, b;
+
+  a = write_(100, 'a');
+  b = write_(100, 'b');
+  f_->release(a);
+  f_->release(b);
+  CPPUNIT_ASSERT(f_->getBytes()==0);
+
+  // the file is filled again from the start.
+  b = write_(300, 'b');
+  CPPUNIT_ASSERT(b==a);
+  check_(b, 300, 'b');
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,60 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2017 The MINOTAUR Team.
+//
+
+#ifndef SPILLFILEUT_H
+#define SPILLFILEUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SpillFile.h"
+
+using namespace Minotaur;
+
+// Test writing, reading and releasing records of a spill file.
+class SpillFileUT : public CppUnit::TestCase {
+  public:
+    SpillFileUT(std::string name) : TestCase(name) {}
+    SpillFileUT() {}
+
+    void setUp();
+    void tearDown();
+
+    CPPUNIT_TEST_SUITE(SpillFileUT);
+    CPPUNIT_TEST(testWriteRead);
+    CPPUNIT_TEST(testReuse);
+    CPPUNIT_TEST(testReleaseAll);
+    CPPUNIT_TEST_SUITE_END();
+
+    void testWriteRead();
+    void testReuse();
+    void testReleaseAll();
+
+  private:
+    SpillFilePtr f_;
+
+    // Write a record of n bytes, all equal to c, and return its position.
+    size_t write_(size_t n, char c);
+
+    // Check that the record at position at has n bytes, all equal to c.
+    void check_(size_t at, size_t n, char c);
+};
+
+#endif     // #define SPILLFILEUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: